@@ -7,9 +7,14 @@
 #include <complex>
 #include <cuComplex.h>
 #include <stdio.h>
+#include <enum_quda.h>
 
 //MAGMA library interface
 //required for (incremental) EigCG solver
+//
+//Each method is also implemented with the built-in host dense linear
+//algebra (dense_linalg.h), selected per instance at construction, so
+//that the deflated solvers do not depend on MAGMA.
 
 
 
@@ -43,6 +48,9 @@
 
       int lwork_max;
 
+      //the backend used by this instance, fixed at construction
+      QudaDenseLinalgBackend backend;
+
       void *W;
       void *W2;
       void *hTau;
@@ -54,13 +62,13 @@
 
     public:
 
-      BlasMagmaArgs() : prec(8), info(-1), init(true), alloc(false) {  }
+      BlasMagmaArgs() : prec(8), info(-1), init(true), alloc(false), backend(DefaultBackend()) {  }
 
-      BlasMagmaArgs(const int prec);
+      BlasMagmaArgs(const int prec, QudaDenseLinalgBackend backend);
 
-      BlasMagmaArgs(const int m, const int max_nev, const int ldm, const int prec);
+      BlasMagmaArgs(const int m, const int max_nev, const int ldm, const int prec, QudaDenseLinalgBackend backend);
 
-      BlasMagmaArgs(const int m, const int ldm, const int prec);
+      BlasMagmaArgs(const int m, const int ldm, const int prec, QudaDenseLinalgBackend backend);
 
       ~BlasMagmaArgs();
 
@@ -68,6 +76,11 @@
       static void OpenMagma();
       //
       static void CloseMagma();
+      //
+      //the backend used when none is requested: MAGMA if QUDA was built with it, otherwise host
+      static QudaDenseLinalgBackend DefaultBackend();
+      //
+      QudaDenseLinalgBackend Backend() const { return backend; }
 
       //Collection of methods for EigCG solver:
       void MagmaHEEVD(void *dTvecm, void *hTvalm, const int problem_size, bool host = false);
@@ -228,6 +228,28 @@ namespace quda {
   */
   void cloverInvert(CloverField &clover, bool computeTraceLog, QudaFieldLocation location);
 
+  /**
+     Compute the clover field on the host directly from the gauge
+     field.  The field strength, the clover term and (optionally) the
+     Cholesky inverse of each chiral block are evaluated in a single
+     threaded pass over the lattice.
+     @param clover The host clover field (packed order)
+     @param gauge The host gauge field (extended if partitioned)
+     @param coeff The clover coefficient
+     @param invert Whether to also compute the clover inverse
+     @param computeTraceLog Whether to compute the trace logarithm of the clover term
+  */
+  void computeCloverCPU(CloverField &clover, const GaugeField &gauge, double coeff,
+			bool invert, bool computeTraceLog);
+
+  /**
+     Threaded host inversion of a packed clover field, storing the
+     inverse in the same field.
+     @param clover The host clover field (contains both the field itself and its inverse)
+     @param computeTraceLog Whether to compute the trace logarithm of the clover term
+  */
+  void cloverInvertCPU(CloverField &clover, bool computeTraceLog);
+
   /**
      Compute the force contribution from the solver solution fields
    
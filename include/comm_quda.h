@@ -111,13 +111,33 @@ extern "C" {
   int comm_dim_partitioned(int dim);
 
 
-  /* implemented in comm_single.cpp, comm_qmp.cpp, and comm_mpi.cpp */
+  /* implemented in comm_single.cpp, comm_qmp.cpp, comm_mpi.cpp, and comm_thread.cpp */
+
+#ifdef THREAD_COMMS
+  /**
+     Run func on size threads, each of which acts as one rank of the
+     threaded communications backend, and return once all of them
+     have returned.  Each thread should call initCommsGridQuda() with
+     a grid of size ranks before communicating.
+     @param size Number of ranks
+     @param func Function run by every rank
+     @param arg Argument passed to func
+  */
+  void comm_thread_run(int size, void (*func)(void *), void *arg);
+#endif
 
   void comm_init(int ndim, const int *dims, QudaCommsMap rank_from_coords, void *map_data);
   int comm_rank(void);
   int comm_size(void);
   int comm_gpuid(void);
 
+  /**
+     @return Whether the communications layer may be called from a
+     thread other than the one that initialized it, as long as the
+     calls are serialized (MPI_THREAD_SERIALIZED or higher)
+  */
+  int comm_serialized_threads(void);
+
   /**
      Create a persistent message handler for a relative send
      @param buffer Buffer from which message will be sent
@@ -166,6 +186,19 @@ extern "C" {
   void comm_allreduce_max(double* data);
   void comm_allreduce_array(double* data, size_t size);
   void comm_allreduce_int(int* data);
+
+  /**
+     Start a non-blocking sum reduction of an array over all
+     processes.  The result is only available in data once the
+     returned handle has been completed with comm_wait, after which
+     the handle must be released with comm_free (it cannot be
+     restarted with comm_start).  Backends without a non-blocking
+     reduction complete the reduction immediately and return NULL.
+     @param data Array to be reduced in place
+     @param size Length of the array
+     @return Message handle for the reduction (NULL if already complete)
+  */
+  MsgHandle *comm_iallreduce(double* data, size_t size);
   void comm_broadcast(void *data, size_t nbytes);
   void comm_barrier(void);
   void comm_abort(int status);
@@ -0,0 +1,209 @@
+#ifndef _COMPRESSED_VECTOR_SET_H
+#define _COMPRESSED_VECTOR_SET_H
+
+/**
+ * @file compressed_vector_set.h
+ *
+ * @section DESCRIPTION
+ *
+ * Compressed host storage for sets of color-spinor vectors, e.g., the
+ * null-space vectors of the multigrid transfer operators.  The
+ * vectors are stored in 16-bit fixed point with a float scale per
+ * block of sites, in the same way as the device half-precision format
+ * with its norm array.  The host transfer kernels decompress the
+ * vectors on the fly, so the set never has to be expanded back to
+ * full precision.
+ */
+
+#include <color_spinor_field.h>
+#include <color_spinor_field_order.h>
+#include <vector>
+
+namespace quda {
+
+  class CompressedVectorSet {
+
+    /** Parameters of the compressed vectors (used to recreate them) */
+    ColorSpinorParam param;
+
+    /** Number of vectors in the set */
+    const int nVec;
+
+    /** Number of sites per parity */
+    const int volumeCB;
+
+    /** Number of parities (1 or 2) */
+    const int nParity;
+
+    /** Number of reals per site */
+    const int site_reals;
+
+    /** Number of sites sharing one scale */
+    const int block_sites;
+
+    /** Number of scale blocks per vector */
+    const int nBlock;
+
+    /** Fixed-point data, vector i starts at i*nParity*volumeCB*site_reals */
+    short *data;
+
+    /** Block scales, vector i starts at i*nBlock */
+    float *norm;
+
+  public:
+
+    /**
+       Create an empty compressed set
+       @param meta Field whose geometry the vectors share (host field in
+       space-spin-color or space-color-spin order)
+       @param nVec Number of vectors
+       @param block_sites Number of consecutive sites sharing a scale (1
+       gives a per-site scale as in the device half format)
+     */
+    CompressedVectorSet(const ColorSpinorField &meta, int nVec, int block_sites=1);
+
+    /**
+       Create a compressed copy of a set of vectors
+       @param B The vectors to compress
+       @param block_sites Number of consecutive sites sharing a scale
+     */
+    CompressedVectorSet(const std::vector<ColorSpinorField*> &B, int block_sites=1);
+
+    virtual ~CompressedVectorSet();
+
+    /**
+       Compress a vector into slot i of the set
+       @param i The slot to fill
+       @param x The vector to compress
+     */
+    void Compress(int i, const ColorSpinorField &x);
+
+    /**
+       Decompress slot i of the set into x
+       @param x The output vector
+       @param i The slot to decompress
+     */
+    void Decompress(ColorSpinorField &x, int i) const;
+
+    /** @return Parameters describing the uncompressed vectors */
+    const ColorSpinorParam& Param() const { return param; }
+
+    int Nvec() const { return nVec; }
+    int VolumeCB() const { return volumeCB; }
+    int Nparity() const { return nParity; }
+    int SiteReals() const { return site_reals; }
+    int BlockSites() const { return block_sites; }
+    QudaFieldOrder FieldOrder() const { return param.fieldOrder; }
+    QudaFieldLocation Location() const { return QUDA_CPU_FIELD_LOCATION; }
+
+    /** @return Fixed-point data of vector i */
+    const short* V(int i) const { return data + (size_t)i*nParity*volumeCB*site_reals; }
+
+    /** @return Block scales of vector i */
+    const float* Norm(int i) const { return norm + (size_t)i*nBlock; }
+
+    /** @return Bytes used by the compressed set */
+    size_t Bytes() const {
+      return (size_t)nVec*nParity*volumeCB*site_reals*sizeof(short) + (size_t)nVec*nBlock*sizeof(float);
+    }
+  };
+
+  /**
+     Replace a set of host vectors with a compressed copy.  The
+     full-precision fields are freed and their entries in B are set to
+     zero.
+     @param B The vectors to compress
+     @param block_sites Number of consecutive sites sharing a scale
+     @return The compressed set
+   */
+  CompressedVectorSet* compressVectors(std::vector<ColorSpinorField*> &B, int block_sites=1);
+
+  /**
+     Expand a compressed set back into newly allocated host fields and
+     free the compressed set.
+     @param B The decompressed vectors
+     @param B_c The compressed set, which is set to zero
+   */
+  void decompressVectors(std::vector<ColorSpinorField*> &B, CompressedVectorSet *&B_c);
+
+  /**
+     Helper function for determining if the location of the fields is
+     the same as the compressed set, which always lives on the host.
+     @return The common location
+   */
+  inline QudaFieldLocation Location(const LatticeField &a, const LatticeField &b, const CompressedVectorSet &v) {
+    QudaFieldLocation location = Location(a, b);
+    if (location != v.Location()) errorQuda("Locations do not match: %d %d", location, v.Location());
+    return location;
+  }
+
+  namespace colorspinor {
+
+    /**
+       Read-only accessor for one vector of a CompressedVectorSet,
+       presenting the same interface as FieldOrderCB so that it can be
+       used as the rotator in the transfer kernels.  Only the
+       space-spin-color order is supported.
+     */
+    template <typename Float, int nSpin, int nColor, int nVec, QudaFieldOrder order>
+      class CompressedFieldOrderCB {
+
+    protected:
+      const short *v;
+      const float *norm;
+      const int volumeCB;
+      const int nParity;
+      const int block_sites;
+
+    public:
+      CompressedFieldOrderCB(const CompressedVectorSet &set, int i=0)
+	: v(set.V(i)), norm(set.Norm(i)), volumeCB(set.VolumeCB()),
+	nParity(set.Nparity()), block_sites(set.BlockSites())
+      {
+	if (order != QUDA_SPACE_SPIN_COLOR_FIELD_ORDER) errorQuda("Unsupported field order %d", order);
+	if (set.SiteReals() != 2*nSpin*nColor*nVec)
+	  errorQuda("Site length %d does not match accessor %d", set.SiteReals(), 2*nSpin*nColor*nVec);
+      }
+
+      /**
+       * Read-only complex-member accessor function, decompressing on
+       * the fly.  The last parameter n is only used for indexed into
+       * the packed null-space vectors.
+       */
+      __device__ __host__ inline complex<Float> operator()(int parity, int x_cb, int s, int c, int n=0) const {
+	const int site = parity*volumeCB + x_cb;
+	const int idx = 2*((site*nSpin + s)*nColor*nVec + c*nVec + n);
+	const Float scale = norm[site/block_sites] / static_cast<Float>(MAX_SHORT);
+	return complex<Float>(v[idx]*scale, v[idx+1]*scale);
+      }
+
+      __device__ __host__ inline int Ncolor() const { return nColor; }
+      __device__ __host__ inline int Nspin() const { return nSpin; }
+      __device__ __host__ inline int Nparity() const { return nParity; }
+      __device__ __host__ inline int Volume() const { return nParity*volumeCB; }
+      __device__ __host__ inline int VolumeCB() const { return volumeCB; }
+      __device__ __host__ inline int Nvec() const { return nVec; }
+
+      size_t Bytes() const {
+	return (size_t)nParity*volumeCB*2*nSpin*nColor*nVec*sizeof(short)
+	  + (size_t)((nParity*volumeCB + block_sites - 1)/block_sites)*sizeof(float);
+      }
+    };
+
+    /**
+       Maps the type of the null-space storage used by the transfer
+       operators to the accessor used by the kernels
+     */
+    template <typename Float, int nSpin, int nColor, int nVec, QudaFieldOrder order, typename V>
+      struct rotator_mapper { typedef FieldOrderCB<Float,nSpin,nColor,nVec,order> type; };
+
+    template <typename Float, int nSpin, int nColor, int nVec, QudaFieldOrder order>
+      struct rotator_mapper<Float,nSpin,nColor,nVec,order,CompressedVectorSet> {
+      typedef CompressedFieldOrderCB<Float,nSpin,nColor,nVec,order> type;
+    };
+
+  } // namespace colorspinor
+
+} // namespace quda
+
+#endif // _COMPRESSED_VECTOR_SET_H
@@ -0,0 +1,132 @@
+#ifndef _DENSE_LINALG_H
+#define _DENSE_LINALG_H
+
+#include <complex>
+
+/**
+ * @file dense_linalg.h
+ *
+ * @section DESCRIPTION
+ *
+ * Small dense linear algebra on the host, for the projected problems
+ * of the Krylov eigensolvers and deflated solvers.  The real
+ * symmetric eigensolver stores matrices row major with leading
+ * dimension equal to the number of columns.  The complex routines
+ * stand in for their LAPACK/MAGMA counterparts, so they follow the
+ * LAPACK conventions: matrices are column major with an explicit
+ * leading dimension.  These are computed redundantly on every
+ * process, so no communication is done here.
+ */
+
+namespace quda {
+
+  /**
+     Eigen-decomposition of a real symmetric matrix, using Householder
+     reduction to tridiagonal form followed by the implicit QL
+     algorithm.
+     @param evals The n eigenvalues in ascending order
+     @param evecs Matrix whose column j is the eigenvector of evals[j] (n x n)
+     @param A The symmetric matrix (n x n), only the lower triangle is read
+     @param n The order of the matrix
+   */
+  void symmetricEigensolve(double *evals, double *evecs, const double *A, int n);
+
+  /**
+     Eigen-decomposition of a Hermitian matrix (cf. zheevd), using
+     Householder reduction to real tridiagonal form followed by the
+     implicit QL algorithm.
+     @param evals The n eigenvalues in ascending order
+     @param A The Hermitian matrix, only the upper triangle is read.
+     On return it holds the orthonormal eigenvectors in its columns.
+     @param n The order of the matrix
+     @param lda The leading dimension of A
+   */
+  void hermitianEigensolve(double *evals, std::complex<double> *A, int n, int lda);
+
+  /**
+     Eigen-decomposition of a general complex matrix (cf. zgeev with
+     right eigenvectors only), using Householder reduction to
+     Hessenberg form followed by shifted QR iterations to the Schur
+     form.  The eigenvalues are returned in no particular order.
+     @param evals The n eigenvalues
+     @param evecs Matrix whose column j is the unit-norm eigenvector of evals[j]
+     @param ldv The leading dimension of evecs
+     @param A The matrix (n x n), overwritten on return
+     @param n The order of the matrix
+     @param lda The leading dimension of A
+   */
+  void generalEigensolve(std::complex<double> *evals, std::complex<double> *evecs, int ldv,
+			 std::complex<double> *A, int n, int lda);
+
+  /**
+     Householder QR factorization A = Q R of an m x n matrix (cf.
+     zgeqrf).  On return R is held in the upper triangle of A and the
+     Householder vectors of Q = H_0 H_1 ... H_{k-1}, k = min(m,n),
+     below the diagonal, with H_i = I - tau_i v_i v_i^H.
+     @param A The matrix to factorize
+     @param m The number of rows of A
+     @param n The number of columns of A
+     @param lda The leading dimension of A
+     @param tau The k scalar factors of the Householder reflectors
+   */
+  void householderQR(std::complex<double> *A, int m, int n, int lda, std::complex<double> *tau);
+
+  /**
+     Multiplies a matrix C by the unitary matrix Q of householderQR
+     (cf. zunmqr), computing Q C, Q^H C, C Q or C Q^H.
+     @param left Whether to apply Q from the left (otherwise the right)
+     @param conj_trans Whether to apply Q^H (otherwise Q)
+     @param rows The number of rows of C
+     @param cols The number of columns of C
+     @param k The number of reflectors that define Q
+     @param QR The reflectors as returned by householderQR
+     @param ldqr The leading dimension of QR
+     @param tau The scalar factors of the reflectors
+     @param C The matrix to be multiplied
+     @param ldc The leading dimension of C
+   */
+  void applyHouseholderQ(bool left, bool conj_trans, int rows, int cols, int k,
+			 const std::complex<double> *QR, int ldqr, const std::complex<double> *tau,
+			 std::complex<double> *C, int ldc);
+
+  /**
+     LU factorization with partial pivoting P A = L U (cf. zgetrf).
+     @param A The n x n matrix, overwritten with L (unit diagonal
+     implied) and U
+     @param n The order of the matrix
+     @param lda The leading dimension of A
+     @param ipiv Row i was interchanged with row ipiv[i]
+     @return 0 on success, otherwise j+1 where U(j,j) is exactly zero
+   */
+  int luFactor(std::complex<double> *A, int n, int lda, int *ipiv);
+
+  /**
+     Solves A x = b using the factorization computed by luFactor (cf.
+     zgetrs with a single right-hand side).
+     @param b The right-hand side, overwritten by the solution
+     @param A The factorized matrix
+     @param n The order of the matrix
+     @param lda The leading dimension of A
+     @param ipiv The pivots returned by luFactor
+   */
+  void luSolve(std::complex<double> *b, const std::complex<double> *A, int n, int lda, const int *ipiv);
+
+  /**
+     Multiplies a block of basis vectors by a small matrix in place,
+     V(:, 0:l) = V(:, 0:m) T, where V is tall and skinny.  The rows of
+     V are processed in blocks by multiple threads, with each block of
+     V loaded once and reused for all l output columns.
+     @param V The complex basis vectors, stored column major
+     @param vprec The size in bytes of each real component of V (4 or 8)
+     @param vld The leading dimension of V
+     @param vlen The number of rows of V
+     @param T The m x l rotation matrix
+     @param ldt The leading dimension of T
+     @param m The number of input columns
+     @param l The number of output columns, l <= m
+   */
+  void rotateBasis(void *V, int vprec, int vld, int vlen, const std::complex<double> *T, int ldt, int m, int l);
+
+} // namespace quda
+
+#endif // _DENSE_LINALG_H
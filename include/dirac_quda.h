@@ -10,12 +10,25 @@
 #include <blas_quda.h>
 
 #include <typeinfo>
+#include <stdint.h>
 
 namespace quda {
 
   class Transfer;
   class Dirac;
 
+  /**
+     @return Key of the contents of the resident gauge fields, which
+     changes whenever they are loaded or otherwise modified
+   */
+  uint64_t residentGaugeKey();
+
+  /**
+     @return Key of the contents of the resident clover fields, which
+     changes whenever they are loaded or otherwise modified
+   */
+  uint64_t residentCloverKey();
+
   // Params for Dirac operator
   class DiracParam {
 
@@ -157,6 +170,24 @@ namespace quda {
   protected:
     void initConstants();
     FaceBuffer face1, face2; // multi-gpu communication buffers
+    mutable cpuGaugeField *gauge_h; // host copy of the gauge field for the host dslash
+    mutable const cudaGaugeField *gauge_h_source; // the field gauge_h was copied from
+    mutable uint64_t gauge_h_key; // residentGaugeKey() when gauge_h was copied
+
+    /**
+       @param precision The precision of the host fields being operated on
+       @return Host copy of the gauge field, created on first use and
+       recreated when the precision, the source field or its contents change
+     */
+    const GaugeField& HostGauge(QudaPrecision precision) const;
+
+    /**
+       Applies M to host fields that the host dslash does not support
+       by staging them through device fields
+       @param clover Whether the operator has a clover term
+       @return Whether the fields were staged and M applied
+     */
+    bool MStaged(ColorSpinorField &out, const ColorSpinorField &in, bool clover) const;
 
   public:
     DiracWilson(const DiracParam &param);
@@ -207,9 +238,19 @@ namespace quda {
 
   protected:
     cudaCloverField &clover;
+    mutable cpuCloverField *clover_h; // host copy of the clover field for the host dslash
+    mutable const cudaCloverField *clover_h_source; // the field clover_h was copied from
+    mutable uint64_t clover_h_key; // residentCloverKey() when clover_h was copied
     void checkParitySpinor(const ColorSpinorField &, const ColorSpinorField &) const;
     void initConstants();
 
+    /**
+       @param precision The precision of the host fields being operated on
+       @return Host copy of the clover field, created on first use and
+       recreated when the precision, the source field or its contents change
+     */
+    const CloverField& HostClover(QudaPrecision precision) const;
+
   public:
     DiracClover(const DiracParam &param);
     DiracClover(const DiracClover &dirac);
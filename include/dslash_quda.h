@@ -62,9 +62,43 @@ namespace quda {
                             const QudaDslashPolicy &dslashPolicy=QUDA_DSLASH2);
 
   // solo clover term
-  void cloverCuda(cudaColorSpinorField *out, const cudaGaugeField &gauge, const FullClover clover, 
+  void cloverCuda(cudaColorSpinorField *out, const cudaGaugeField &gauge, const FullClover clover,
       const cudaColorSpinorField *in, const int oddBit);
 
+  /**
+     Applies the Wilson dslash to host fields in space-spin-color
+     order, out = D in, or out = x + k D in if x is given.  With a
+     clover field this is the asymmetric clover dslash, out = A x + k D in.
+     @param out The output field
+     @param gauge The host gauge field (QDP order, no reconstruction)
+     @param in The input field
+     @param parity The parity of the output field
+     @param dagger Whether to apply the adjoint
+     @param x The accumulation field (optional)
+     @param k The scale factor of the hopping term when accumulating
+     @param clover The host clover field applied to x (optional, packed order)
+   */
+  void wilsonDslashCPU(ColorSpinorField &out, const GaugeField &gauge, const ColorSpinorField &in,
+		       int parity, int dagger, const ColorSpinorField *x=0, double k=0.0,
+		       const CloverField *clover=0);
+
+  /**
+     @param in A host field
+     @param clover Whether a clover term is applied
+     @return Whether the host dslash supports the order, precision,
+     spin, color and gamma basis of the field
+   */
+  bool wilsonDslashCPUSupported(const ColorSpinorField &in, bool clover);
+
+  /**
+     Applies the clover term to host fields, out = A in
+     @param out The output field
+     @param clover The host clover field (packed order)
+     @param in The input field
+     @param parity The parity of the fields if single parity
+   */
+  void cloverCPU(ColorSpinorField &out, const CloverField &clover, const ColorSpinorField &in, int parity);
+
   // domain wall Dslash  
   void domainWallDslashCuda(cudaColorSpinorField *out, const cudaGaugeField &gauge, const cudaColorSpinorField *in, 
 			    const int parity, const int dagger, const cudaColorSpinorField *x, 
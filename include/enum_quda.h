@@ -112,6 +112,8 @@ extern "C" {
     QUDA_GMRESDR_SH_INVERTER,
     QUDA_FGMRESDR_INVERTER,
     QUDA_MG_INVERTER,
+    QUDA_PIPECG_INVERTER,
+    QUDA_BLOCKCG_INVERTER,
     QUDA_INVALID_INVERTER = QUDA_INVALID_ENUM
   } QudaInverterType;
 
@@ -381,6 +383,7 @@ extern "C" {
   typedef enum QudaComputeNullVector_s {
     QUDA_COMPUTE_NULL_VECTOR_NO,    
     QUDA_COMPUTE_NULL_VECTOR_YES,
+    QUDA_COMPUTE_NULL_VECTOR_BATCHED,
     QUDA_COMPUTE_NULL_VECTOR_INVALID = QUDA_INVALID_ENUM
   } QudaComputeNullVector;
 
@@ -437,6 +440,12 @@ extern "C" {
     QUDA_CONTRACT_INVALID = QUDA_INVALID_ENUM
   } QudaContractType;
 
+  typedef enum QudaDenseLinalgBackend_s {
+    QUDA_MAGMA_DENSE_LINALG, // MAGMA (requires QUDA to be built with MAGMA)
+    QUDA_HOST_DENSE_LINALG,  // built-in threaded host implementation
+    QUDA_INVALID_DENSE_LINALG = QUDA_INVALID_ENUM
+  } QudaDenseLinalgBackend;
+
 #ifdef __cplusplus
 }
 #endif
@@ -106,6 +106,8 @@
 #define QUDA_GMRESDR_SH_INVERTER 13
 #define QUDA_FGMRESDR_INVERTER 14
 #define QUDA_MG_INVERTER 15
+#define QUDA_PIPECG_INVERTER 16
+#define QUDA_BLOCKCG_INVERTER 17
 #define QUDA_INVALID_INVERTER QUDA_INVALID_ENUM
 
 #define QudaEigType integer(4)
@@ -339,6 +341,7 @@
 #define QudaComputeNullVector integer(4)
 #define QUDA_COMPUTE_NULL_VECTOR_NO  0 
 #define QUDA_COMPUTE_NULL_VECTOR_YES 1
+#define QUDA_COMPUTE_NULL_VECTOR_BATCHED 2
 #define QUDA_COMPUTE_NULL_VECTOR_INVALID QUDA_INVALID_ENUM
 
 #define QudaDirection integer(4)
@@ -386,4 +389,9 @@
 #define QUDA_CONTRACT_TSLICE_MINUS 8
 #define QUDA_CONTRACT_INVALID QUDA_INVALID_ENUM
 
+#define QudaDenseLinalgBackend integer(4)
+#define QUDA_MAGMA_DENSE_LINALG 0
+#define QUDA_HOST_DENSE_LINALG 1
+#define QUDA_INVALID_DENSE_LINALG QUDA_INVALID_ENUM
+
 #endif 
@@ -122,6 +122,15 @@ namespace quda {
 void reduceMaxDouble(double &);
 void reduceDouble(double &);
 void reduceDoubleArray(double *, const int len);
+
+/**
+   Start a non-blocking global sum of an array, which is a no-op when
+   global reductions are disabled.  The result is valid once
+   reduceDoubleArrayWait has returned.
+   @return Handle to pass to reduceDoubleArrayWait
+*/
+MsgHandle* reduceDoubleArrayStart(double *, const int len);
+void reduceDoubleArrayWait(MsgHandle *);
 int commDim(int);
 int commCoords(int);
 int commDimPartitioned(int dir);
@@ -331,6 +331,15 @@ namespace quda {
     void **gauge; // the actual gauge field
     int pinned;
 
+    /** Send buffers for exchangeGhost, kept between calls */
+    void *ghost_send[QUDA_MAX_DIM];
+
+    /** Send and receive buffers for exchangeExtendedGhost, kept
+	between calls and grown when a larger region is requested */
+    void *ext_send[QUDA_MAX_DIM];
+    void *ext_recv[QUDA_MAX_DIM];
+    size_t ext_bytes[QUDA_MAX_DIM];
+
   public:
     cpuGaugeField(const GaugeFieldParam &);
     virtual ~cpuGaugeField();
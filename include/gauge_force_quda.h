@@ -7,6 +7,23 @@ namespace quda {
 			QudaGaugeParam* param, int*** input_path, int* length,
 			double* path_coeff, int num_paths, int max_length);
 
+  /**
+     Compute the gauge force on the host and accumulate it into the
+     momentum field.  The loop paths are compiled into a prefix tree
+     so that products shared between loops are only computed once.
+     @param mom Momentum field (MILC order, 10 reconstruct)
+     @param eb3 Step size times beta/3
+     @param u Gauge field, extended by a radius of two in partitioned dimensions
+     @param input_path Loop paths for each direction
+     @param length Length of each path
+     @param path_coeff Coefficient of each path
+     @param num_paths Number of paths
+     @param max_length Maximum path length
+   */
+  void gauge_force_cpu(cpuGaugeField& mom, double eb3, cpuGaugeField& u,
+		       int*** input_path, int* length, double* path_coeff,
+		       int num_paths, int max_length);
+
 } // namespace quda
 
 
@@ -82,6 +82,48 @@ namespace quda {
 		       const unsigned int autotune,
                        const double tolerance,
 		       const unsigned int stopWtheta);
+
+  /**
+   * @brief Host gauge fixing with overrelaxation, using a threaded
+   * checkerboard sweep.  Parameters as for gaugefixingOVR; the field
+   * must be a QDP or MILC ordered field with no reconstruction and no
+   * partitioned dimensions.
+   * @param[in,out] data, host gauge field
+   */
+  void gaugefixingOVRCPU( cpuGaugeField& data,
+			  const unsigned int gauge_dir,
+			  const unsigned int Nsteps,
+			  const unsigned int verbose_interval,
+			  const double relax_boost,
+			  const double tolerance,
+			  const unsigned int reunit_interval,
+			  const unsigned int stopWtheta);
+
+  /**
+   * @brief Host gauge fixing with the Fourier accelerated steepest
+   * descent method.  Uses the bundled host FFT in place of cuFFT,
+   * with 4-d transforms for Landau gauge and 3-d transforms on each
+   * time slice for Coulomb gauge.  Parameters as for gaugefixingFFT.
+   * @param[in,out] data, host gauge field
+   */
+  void gaugefixingFFTCPU( cpuGaugeField& data,
+			  const unsigned int gauge_dir,
+			  const unsigned int Nsteps,
+			  const unsigned int verbose_interval,
+			  const double alpha,
+			  const unsigned int autotune,
+			  const double tolerance,
+			  const unsigned int stopWtheta);
+
+  /**
+   * @brief Measure the gauge fixing quality of a host gauge field.
+   * @param[in] data, host gauge field
+   * @param[in] gauge_dir, 3 for Coulomb gauge, other for Landau gauge
+   * @return The gauge fixing functional Fg and theta, normalized as
+   * in the gauge fixing output
+   */
+  double2 gaugeFixQualityCPU( cpuGaugeField& data, const unsigned int gauge_dir);
+
   /**
      Compute the Fmunu tensor
      @param Fmunu The Fmunu tensor
@@ -15,6 +15,23 @@ namespace quda {
   void updateGaugeField(GaugeField &out, double dt, const GaugeField& in, 
 			const GaugeField& mom, bool conj_mom, bool exact);
 
+  /**
+     Evolve a host gauge field by step size dt, U' = exp(dt mom) U,
+     using a threaded sweep over the lattice.  The exact exponential
+     is evaluated with the Cayley-Hamilton form.  Optionally the
+     momentum action is accumulated in the same sweep.  The update
+     may be performed in place (out == in).
+     @param out Updated gauge field
+     @param dt Step size
+     @param in Input gauge field
+     @param mom Momentum field (MILC order, reconstruct 10)
+     @param conj_mom Whether we conjugate the momentum in the exponential
+     @param exact Calculate exact exponential or use an expansion
+     @param action If non-null, returns the global momentum action
+   */
+  void updateGaugeFieldCPU(GaugeField &out, double dt, const GaugeField& in,
+			   const GaugeField& mom, bool conj_mom, bool exact, double *action=NULL);
+
 } // namespace quda
 
 #endif // _GAUGE_UPDATE_QUDA_H_
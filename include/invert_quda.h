@@ -174,6 +174,7 @@ namespace quda {
     int     max_restart_num;
     double  inc_tol;
     double  eigenval_tol;
+    QudaDenseLinalgBackend dense_linalg;
 
     QudaVerbosity verbosity_precondition; //! verbosity to use for preconditioner
 
@@ -208,7 +209,7 @@ namespace quda {
       deflation_grid(param.deflation_grid), rhs_idx(0), use_reduced_vector_set(param.use_reduced_vector_set),
       use_cg_updates(param.use_cg_updates), cg_iterref_tol(param.cg_iterref_tol),
       eigcg_max_restarts(param.eigcg_max_restarts), max_restart_num(param.max_restart_num),
-      inc_tol(param.inc_tol), eigenval_tol(param.eigenval_tol),
+      inc_tol(param.inc_tol), eigenval_tol(param.eigenval_tol), dense_linalg(param.dense_linalg),
       verbosity_precondition(param.verbosity_precondition), compute_true_res(true)
     {
       for (int i=0; i<num_offset; i++) {
@@ -217,7 +218,8 @@ namespace quda {
 	tol_hq_offset[i] = param.tol_hq_offset[i];
       }
 
-      if((param.inv_type == QUDA_INC_EIGCG_INVERTER || param.inv_type == QUDA_EIGCG_INVERTER) && m % 16){//current hack for the magma library
+      if((param.inv_type == QUDA_INC_EIGCG_INVERTER || param.inv_type == QUDA_EIGCG_INVERTER) &&
+	 param.dense_linalg == QUDA_MAGMA_DENSE_LINALG && m % 16){//current hack for the magma library
         m = (m / 16) * 16 + 16;
         warningQuda("\nSwitched eigenvector search dimension to %d\n", m);
       }
@@ -343,6 +345,28 @@ namespace quda {
 
 
 
+  /**
+     Pipelined CG (Ghysels and Vanroose).  The inner products of an
+     iteration are fused into a single global reduction that is
+     started non-blocking and overlapped with the next application of
+     the operator.  Mixed precision is handled with reliable updates
+     as in CG, where the residual replacement also recomputes the
+     auxiliary vectors w = A r, s = A p and z = A s.
+   */
+  class PipelinedCG : public Solver {
+
+  private:
+    const DiracMatrix &mat;
+    const DiracMatrix &matSloppy;
+
+  public:
+    PipelinedCG(DiracMatrix &mat, DiracMatrix &matSloppy, SolverParam &param, TimeProfile &profile);
+    virtual ~PipelinedCG();
+
+    void operator()(ColorSpinorField &out, ColorSpinorField &in);
+  };
+
+
   class MPCG : public Solver {
     private:
       const DiracMatrix &mat;
@@ -561,24 +585,126 @@ namespace quda {
     void operator()(std::vector<ColorSpinorField*> out, ColorSpinorField &in);
   };
 
+  /**
+     Base class for solvers that iterate on a block of independent
+     right-hand sides at once.
+   */
+  class BlockSolver {
+
+  protected:
+    SolverParam &param;
+    TimeProfile &profile;
+
+  public:
+    BlockSolver(SolverParam &param, TimeProfile &profile) :
+    param(param), profile(profile) { ; }
+    virtual ~BlockSolver() { ; }
+
+    /**
+       @param out The solution vectors
+       @param in The source vectors, one per solution vector
+     */
+    virtual void operator()(std::vector<ColorSpinorField*> out, std::vector<ColorSpinorField*> in) = 0;
+  };
+
+  /**
+     Breakdown-free block CG (Ji and Li).  The search directions are
+     re-orthonormalized every iteration with a rank-revealing pivoted
+     Cholesky factorization of their Gram matrix, so directions that
+     become linearly dependent (e.g., from near-degenerate sources or
+     converged columns) are dropped rather than causing a breakdown.
+     All inner products of a step are batched into a single global
+     reduction, and mixed precision is handled with reliable updates
+     as in CG.  On return param.true_res is the largest true relative
+     residual of the block.
+   */
+  class BlockCG : public BlockSolver {
+
+  protected:
+    const DiracMatrix &mat;
+    const DiracMatrix &matSloppy;
+
+  public:
+    BlockCG(DiracMatrix &mat, DiracMatrix &matSloppy, SolverParam &param, TimeProfile &profile);
+    virtual ~BlockCG();
+
+    void operator()(std::vector<ColorSpinorField*> out, std::vector<ColorSpinorField*> in);
+  };
+
   /**
      This computes the optimum guess for the system Ax=b in the L2
      residual norm.  For use in the HMD force calculations using a
      minimal residual chronological method This computes the guess
      solution as a linear combination of a given number of previous
      solutions.  Following Brower et al, only the orthogonalised vector
-     basis is stored to conserve memory.
+     basis is stored to conserve memory.  Works for both host and
+     device fields.
+
+     The object can also keep its own basis across solves with the
+     same operator: append() adds each new solution at O(N) cost, by
+     orthonormalizing it against the basis, applying the operator once
+     and extending the projected matrix by one row and column.
   */
   class MinResExt {
 
   protected:
-    const DiracMatrix &mat;
+    const DiracMatrix *mat;
     TimeProfile &profile;
 
+    /** Maximum dimension of the persistent basis */
+    int max_dim;
+
+    /** Persistent orthonormal basis and q = A p */
+    std::vector<ColorSpinorField*> p;
+    std::vector<ColorSpinorField*> q;
+
+    /** G_ij = p_i^dagger A p_j of the persistent basis, with leading dimension max_dim */
+    std::vector<Complex> G;
+
   public:
-    MinResExt(DiracMatrix &mat, TimeProfile &profile);
+    /**
+       @param mat The operator A of the systems to be solved
+       @param profile Profile to record to
+       @param max_dim Maximum dimension of the persistent basis
+    */
+    MinResExt(DiracMatrix &mat, TimeProfile &profile, int max_dim=0);
     virtual ~MinResExt();
 
+    /**
+       Sets the operator, e.g., when the caller recreates an identical
+       operator for each solve.  The persistent basis is only valid
+       for the operator it was built with, so reset() it otherwise.
+    */
+    void setMatrix(DiracMatrix &mat) { this->mat = &mat; }
+
+    /** @return The dimension of the persistent basis */
+    int Dim() const { return p.size(); }
+
+    /** @return The maximum dimension of the persistent basis */
+    int MaxDim() const { return max_dim; }
+
+    /** Frees the persistent basis */
+    void reset();
+
+    /**
+       Adds v to the persistent basis: v is orthonormalized against
+       the basis, multiplied by A and G gains one row and column.
+       When the basis is full the oldest direction is dropped first.
+       A vector that is numerically in the span of the basis is not
+       added.
+       @param v The vector to add, e.g., the latest solution
+       @return Whether v was added
+    */
+    bool append(const ColorSpinorField &v);
+
+    /**
+       Computes the guess from the persistent basis.
+       param x The optimum for the solution vector.
+       param b The source vector in the equation to be solved.  This is
+       not preserved, on return it holds the residual b - A x.
+    */
+    void operator()(ColorSpinorField &x, ColorSpinorField &b);
+
     /**
        param x The optimum for the solution vector.
        param b The source vector in the equation to be solved. This is not preserved.
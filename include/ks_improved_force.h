@@ -30,7 +30,32 @@ namespace quda {
                                  cudaGaugeField *force, 
 				 long long* flops = NULL);
 
+  /**
+     Host versions of the staples, long-link and completion stages
+     above.  The fields may be regular or extended by two sites in
+     each dimension, must share precision and (QDP or MILC) order,
+     and the outer products are accumulated into newOprod.  The site
+     loops are threaded with OpenMP.
+   */
+  void hisqStaplesForceCPU(const double path_coeff[6],
+                           const QudaGaugeParam& param,
+                           const cpuGaugeField& oprod,
+                           const cpuGaugeField& link,
+                           cpuGaugeField *newOprod,
+                           long long* flops = NULL);
 
+  void hisqLongLinkForceCPU(double coeff,
+                            const QudaGaugeParam& param,
+                            const cpuGaugeField &oprod,
+                            const cpuGaugeField &link,
+                            cpuGaugeField *newOprod,
+                            long long* flops = NULL);
+
+  void hisqCompleteForceCPU(const QudaGaugeParam &param,
+                            const cpuGaugeField &oprod,
+                            const cpuGaugeField &link,
+                            cpuGaugeField *force,
+                            long long* flops = NULL);
 
   void setUnitarizeForceConstants(double unitarize_eps, double hisq_force_filter, double max_det_error,
 				     bool allow_svd, bool svd_only,
@@ -45,7 +70,8 @@ namespace quda {
 
   void unitarizeForceCPU( cpuGaugeField &cpuOldForce,
                           cpuGaugeField &cpuGauge,
-                          cpuGaugeField *cpuNewForce);
+                          cpuGaugeField *cpuNewForce,
+                          int* unitarization_failed = NULL);
 
 
  } // namespace fermion_force
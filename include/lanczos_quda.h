@@ -87,6 +87,39 @@ namespace quda {
                     cudaColorSpinorField &r, cudaColorSpinorField &Apsi, int k0, int m);
   };
 
+  /**
+     Thick-restart Lanczos (Wu and Simon) for the lowest eigenpairs of
+     a Hermitian matrix, with the Chebyshev acceleration of RitzMat
+     when its polynomial order is non-zero.  The Lanczos vectors are
+     fully re-orthogonalized, converged Ritz pairs are locked and
+     excluded from the projected matrix, and the remaining wanted Ritz
+     vectors are kept across restarts.  The projected problem is
+     solved with the built-in dense eigensolver, so this works for
+     fields in any location without external libraries.
+   */
+  class ThickRestartLanczos {
+
+  protected:
+    const RitzMat &ritz_mat;
+    QudaEigParam &eigParam;
+    TimeProfile &profile;
+
+  public:
+    ThickRestartLanczos(RitzMat &ritz_mat, QudaEigParam &eigParam, TimeProfile &profile);
+    virtual ~ThickRestartLanczos();
+
+    /**
+       Computes the eigParam.nk lowest eigenpairs, using a Krylov space
+       of dimension eigParam.nk + eigParam.np, until the relative Ritz
+       residuals are below eigParam.Stp_residual or after
+       eigParam.max_restarts restarts.
+       @param evals The eigenvalues of the matrix in ascending order (nk)
+       @param evecs The corresponding eigenvectors (nk), evecs[0] holds
+       the starting vector on entry
+       @return The number of converged eigenpairs
+     */
+    int operator()(double *evals, std::vector<ColorSpinorField*> &evecs);
+  };
 
 } // namespace quda
 
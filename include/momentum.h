@@ -10,6 +10,14 @@ namespace quda {
    */
   double computeMomAction(const GaugeField &mom);
 
+  /**
+     @brief Compute and return the global momentum action of a host
+     momentum field using a threaded reduction
+     @param mom Momentum field (MILC order, reconstruct 10)
+     @return Momentum action contribution
+   */
+  double computeMomActionCPU(const GaugeField &mom);
+
   /**
      Update the momentum field from the force field
 
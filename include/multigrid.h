@@ -40,7 +40,8 @@ namespace quda {
       matResidual(matResidual),
       matSmooth(matSmooth),
       smoother(param.smoother[level]),
-      location(param.location[level])
+      location(param.location[level]),
+      reuse_null_vectors(false)
       { 
 	// set the block size
 	for (int i=0; i<QUDA_MAX_DIM; i++) geoBlockSize[i] = param.geo_block_size[level][i];
@@ -65,7 +66,8 @@ namespace quda {
       matResidual(matResidual),
       matSmooth(matSmooth),
       smoother(param.mg_global.smoother[level]),
-      location(param.mg_global.location[level])
+      location(param.mg_global.location[level]),
+      reuse_null_vectors(param.reuse_null_vectors)
       {
 	// set the block size
 	for (int i=0; i<QUDA_MAX_DIM; i++) geoBlockSize[i] = param.mg_global.geo_block_size[level][i];
@@ -117,6 +119,10 @@ namespace quda {
     /** Where to compute this level of multigrid */
     QudaFieldLocation location;
 
+    /** Whether B already holds the null space, which is then neither
+	generated nor loaded */
+    bool reuse_null_vectors;
+
     /** Filename for where to load/store the null space */
     char filename[100];
   };
@@ -166,6 +172,10 @@ namespace quda {
     /** The coarse-grid representation of the null space vectors */
     std::vector<ColorSpinorField*> *B_coarse;
 
+    /** Compressed copy of B_coarse, which replaces it once the coarser
+	levels have been built if compress_null_vectors is set */
+    CompressedVectorSet *B_coarse_c;
+
     /** Residual vector */
     ColorSpinorField *r;
 
@@ -175,6 +185,13 @@ namespace quda {
     /** Coarse solution vector */
     ColorSpinorField *x_coarse;
 
+    /** Solution and source vectors at this level's location, used
+	when the V-cycle is called with fields in another location */
+    ColorSpinorField *x_staged, *b_staged;
+
+    /** Time spent in the V-cycles at this level, including coarser levels */
+    Timer timer;
+
     /** The coarse grid operator */
     DiracCoarse *diracCoarse;
 
@@ -228,8 +245,69 @@ namespace quda {
      */
     void generateNullVectors(std::vector<ColorSpinorField*> B);
 
+    /**
+       Generate the null-space vectors by relaxing them all together,
+       so the setup cost is set by the number of operator applications
+       rather than by Nvec sequential solves
+       @param B Generated null-space vectors
+     */
+    void generateNullVectorsBatched(std::vector<ColorSpinorField*> B);
+
+    /**
+       Print the number of V-cycles, the smoother iterations and the
+       time spent at this level and all coarser levels
+     */
+    void printStats() const;
+
   };
 
+  /**
+     Generate a set of null-space vectors one at a time, each with a
+     BiCGstab solve of M x = 0 that reduces |M x| by tol, and
+     orthonormalize each against the previous ones
+     @param solverParam Parameters of the solves, of which the solver
+     type, iteration count and tolerance are set here
+     @param mat The operator M
+     @param matSloppy The sloppy operator M
+     @param B The null-space vectors, used as the starting vectors
+     unless random_start is set
+     @param maxiter Maximum number of iterations of each solve
+     @param tol Reduction of |M x| at which a vector has converged
+     @param random_start Whether to start from random vectors
+     @param location Where to do the solves
+     @param profile Profile of the solves
+   */
+  void solveNullVectors(SolverParam &solverParam, DiracMatrix &mat, DiracMatrix &matSloppy,
+			std::vector<ColorSpinorField*> &B, int maxiter, double tol, bool random_start,
+			QudaFieldLocation location, TimeProfile &profile);
+
+  /**
+     Relax a set of null-space vectors together, with CG on M^dagger M
+     x = 0 run in lock step for a batch of vectors, and then
+     orthonormalize them as a block.  CG needs the Hermitian normal
+     operator, unlike the BiCGstab solves of solveNullVectors, but the
+     convergence criterion is the same reduction of |M x| by tol.
+     @param mat The operator M
+     @param B The null-space vectors, used as the starting vectors
+     unless random_start is set
+     @param maxiter Maximum number of iterations of each batch
+     @param tol Reduction of |M x| at which a vector has converged
+     @param random_start Whether to start from random vectors
+     @param location Where to do the relaxation
+     @param batch The number of vectors relaxed together; if zero the
+     batch is sized to fit in free device memory
+     @return The number of iterations done over all batches
+   */
+  int relaxNullVectors(DiracMatrix &mat, std::vector<ColorSpinorField*> &B,
+		       int maxiter, double tol, bool random_start, QudaFieldLocation location, int batch=0);
+
+  /**
+     @param location Where to apply the operator
+     @return The mean of |M v_k| / |v_k| over the null-space vectors,
+     a measure of how well they approximate the low modes of M
+   */
+  double nullSpaceResidual(DiracMatrix &mat, std::vector<ColorSpinorField*> &B, QudaFieldLocation location);
+
   void CoarseOp(const Transfer &T, GaugeField &Y, GaugeField &X, QudaPrecision precision, const cudaGaugeField &gauge);
 
   void ApplyCoarse(ColorSpinorField &out, const ColorSpinorField &inA, const ColorSpinorField &inB,
@@ -238,6 +316,16 @@ namespace quda {
   void CoarseCoarseOp(const Transfer &T, GaugeField &Y, GaugeField &x, const cpuGaugeField &gauge, 
 		      const cpuGaugeField &clover, double kappa);
 
+  /**
+     Assemble the coarse operator of a single process as a dense matrix
+     @param A The column-major matrix, which must be zeroed beforehand
+     @param lda The leading dimension of A
+     @param Y The host coarse gauge field
+     @param X The host coarse clover field
+     @param kappa Kappa value
+   */
+  void CoarseMatrix(Complex *A, int lda, const GaugeField &Y, const GaugeField &X, double kappa);
+
   /**
      This class serves as a front-end to the coarse Dslash operator, similar to the other dslash operators.
    */
@@ -306,6 +394,56 @@ namespace quda {
      */
     virtual void createCoarseOp(const Transfer &T, GaugeField &Y, GaugeField &X) const;
 
+    /**
+       @return The number of complex degrees of freedom of this operator on this process
+     */
+    long Dimension() const { return (long)Y_h->Volume() * Y_h->Ncolor(); }
+
+    /**
+       Assemble this operator as a dense matrix
+       @param A The column-major matrix, which must be zeroed beforehand
+       @param lda The leading dimension of A
+     */
+    void createMatrix(Complex *A, int lda) const { CoarseMatrix(A, lda, *Y_h, *X_h, kappa); }
+
+  };
+
+  /**
+     Direct solver for the coarsest grid.  The coarse operator is
+     assembled and LU factorized once when the solver is created, and
+     each solve is then exact, at the cost of one pair of triangular
+     solves.  Only suitable for small coarse grids on a single process.
+   */
+  class CoarseLU : public Solver {
+
+  private:
+    /** The LU factors of the coarse operator */
+    std::vector<Complex> LU;
+
+    /** The row pivots of the factorization */
+    std::vector<int> ipiv;
+
+    /** The order of the matrix */
+    int n;
+
+    /** Host double-precision field used to stage the source and solution */
+    ColorSpinorField *tmp;
+
+  public:
+    CoarseLU(const DiracCoarse &dirac, SolverParam &param, TimeProfile &profile);
+    virtual ~CoarseLU();
+
+    /**
+       Solves out = M^{-1} in.  The source is left unchanged.
+     */
+    void operator()(ColorSpinorField &out, ColorSpinorField &in);
+
+    /**
+       Whether the coarse operator is small enough to be factorized
+       @param dirac The coarse operator
+       @param max_dim The maximum matrix order allowed
+     */
+    static bool Supported(const DiracCoarse &dirac, int max_dim);
   };
 
   /**
@@ -325,28 +463,49 @@ namespace quda {
 
     std::vector<ColorSpinorField*> B;
 
+    /** Compressed copy of B, which replaces it between setups if
+	compress_null_vectors is set */
+    CompressedVectorSet *B_c;
+
     MGParam *mgParam;
 
     MG *mg;
     TimeProfile &profile;
 
+    /** Wall-clock time in seconds of the last full setup */
+    double setup_time;
+
+    /** Null-space residual (see nullSpaceResidual) after the last full setup */
+    double null_residual;
+
     multigrid_solver(QudaMultigridParam &mg_param, TimeProfile &profile);
 
-    virtual ~multigrid_solver() {
-      profile.TPSTART(QUDA_PROFILE_FREE);
-      delete mg;
+    /**
+       Rebuild the hierarchy for the currently loaded gauge field.  The
+       existing null-space vectors are refined with a few iterations
+       against the new operator, and a full setup is done instead if
+       their residual has grown too much.
+       @param mg_param The multigrid parameters
+     */
+    void update(QudaMultigridParam &mg_param);
 
-      delete mgParam;
+  private:
+    /** Create the Dirac operators for the currently loaded gauge field */
+    void createOperators(QudaInvertParam &param);
 
-      for (unsigned int i=0; i<B.size(); i++) delete B[i];
+    /** Free the hierarchy and the Dirac operators, but not the null space */
+    void destroyOperators();
 
-      delete m;
-      delete mSloppy;
-      delete mPre;
+    /** Build the hierarchy on top of the current operators and null space */
+    void createHierarchy(QudaMultigridParam &mg_param, bool reuse_null_vectors);
 
-      delete d;
-      delete dSloppy;
-      delete dPre;
+  public:
+
+    virtual ~multigrid_solver() {
+      profile.TPSTART(QUDA_PROFILE_FREE);
+      destroyOperators();
+      for (unsigned int i=0; i<B.size(); i++) if (B[i]) delete B[i];
+      if (B_c) delete B_c;
       profile.TPSTOP(QUDA_PROFILE_FREE);
     }
   };
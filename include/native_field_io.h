@@ -0,0 +1,103 @@
+#ifndef _NATIVE_FIELD_IO_H
+#define _NATIVE_FIELD_IO_H
+
+#include <stddef.h>
+#include <vector>
+#include <gauge_field.h>
+#include <color_spinor_field.h>
+
+namespace quda {
+
+  /**
+     Native QUDA field file format.  A file holds the local part of a
+     single host field as a fixed header followed by the raw payload,
+     laid out exactly as the host field order in the header (QDP
+     order stores the siteDim arrays back to back).  The payload
+     starts on a page boundary so that the file can be mapped with
+     mmap and wrapped as a QUDA_REFERENCE_FIELD_CREATE field without
+     any copy or conversion.  In a partitioned job every process
+     writes and maps its own file, and the process grid is recorded in
+     the header and checked on load.
+   */
+  struct NativeFieldMapping {
+    void *base;      // start of the mapping
+    size_t length;   // length of the mapping in bytes
+    NativeFieldMapping() : base(0), length(0) { }
+  };
+
+  /**
+     Write a host gauge field in the native format.
+     @param filename Output file
+     @param u Host gauge field (QDP, MILC, CPS, BQCD or TIFR order)
+   */
+  void writeNativeGaugeField(const char *filename, const cpuGaugeField &u);
+
+  /**
+     Map a native gauge field file and return a host gauge field that
+     references the mapped payload.  The mapping is private, so
+     writes to the field are not propagated to the file.  The field
+     must be deleted before the mapping is released with
+     unmapNativeField.
+     @param filename Input file
+     @param mapping Returned mapping handle
+     @param verify Whether to verify the payload checksum (touches every page)
+     @return Newly created host gauge field
+   */
+  cpuGaugeField* mapNativeGaugeField(const char *filename, NativeFieldMapping &mapping, bool verify=true);
+
+  /**
+     Write a host color-spinor field in the native format.
+     @param filename Output file
+     @param v Host color-spinor field
+   */
+  void writeNativeColorSpinorField(const char *filename, const cpuColorSpinorField &v);
+
+  /**
+     Map a native color-spinor field file and return a host
+     color-spinor field referencing the mapped payload.  See
+     mapNativeGaugeField for the ownership rules.
+     @param filename Input file
+     @param mapping Returned mapping handle
+     @param verify Whether to verify the payload checksum
+     @return Newly created host color-spinor field
+   */
+  cpuColorSpinorField* mapNativeColorSpinorField(const char *filename, NativeFieldMapping &mapping, bool verify=true);
+
+  /**
+     Write a set of host color-spinor fields, e.g., the null-space
+     vectors of a multigrid level, to a single file.  Every process
+     writes its own block of the file with pwrite, the vectors of a
+     process are written concurrently, and a checksum is stored for
+     every vector on every process.  This function is collective.
+     @param filename Output file
+     @param B The vectors (host fields of equal size)
+     @param file_prec Precision to store the vectors in (QUDA_INVALID_PRECISION
+     for the precision of the vectors)
+   */
+  void writeNativeVectorSet(const char *filename, const std::vector<ColorSpinorField*> &B,
+			    QudaPrecision file_prec=QUDA_INVALID_PRECISION);
+
+  /**
+     Read a vector set written with writeNativeVectorSet, converting
+     to the precision of B if needed.  The process grid and local
+     volume must match those used when writing.  This function is
+     collective.
+     @param filename Input file
+     @param B The vectors to fill
+   */
+  void readNativeVectorSet(const char *filename, std::vector<ColorSpinorField*> &B);
+
+  /**
+     @return Whether filename is a native vector-set file
+   */
+  bool isNativeVectorSet(const char *filename);
+
+  /**
+     Release a mapping returned by one of the map functions.
+     @param mapping The mapping to release
+   */
+  void unmapNativeField(NativeFieldMapping &mapping);
+
+} // namespace quda
+
+#endif // _NATIVE_FIELD_IO_H
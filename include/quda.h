@@ -77,6 +77,8 @@ extern "C" {
     int return_result_gauge; /**< Return the result gauge field */
     int return_result_mom;   /**< Return the result momentum field */
 
+    QudaFieldLocation compute_location; /**< Where gauge-field algorithms (forces, updates, gauge fixing) are computed */
+
   } QudaGaugeParam;
 
 
@@ -170,6 +172,7 @@ extern "C" {
     QudaGammaBasis gamma_basis;            /**< Gamma basis of the input and output host fields */
 
     QudaFieldLocation clover_location;            /**< The location of the clover field */
+    QudaFieldLocation clover_calc_location;       /**< Where the clover field is computed from the resident gauge field */
     QudaPrecision clover_cpu_prec;         /**< The precision used for the input clover field */
     QudaPrecision clover_cuda_prec;        /**< The precision used for the clover field in the QUDA solver */
     QudaPrecision clover_cuda_prec_sloppy; /**< The precision used for the clover field in the QUDA sloppy operator */
@@ -194,6 +197,16 @@ extern "C" {
     double gflops;                         /**< The Gflops rate of the solver */
     double secs;                           /**< The time taken by the solver */
 
+    int num_src;                           /**< Number of sources solved by invertMultiSrcQuda */
+    double src_per_sec;                    /**< The aggregate throughput of invertMultiSrcQuda in sources per second */
+
+    /** Number of previous solutions kept by invertQuda to extrapolate
+	the initial guess of normal-operator solves with the same
+	operator, using the minimum residual extrapolation (0 disables).
+	Each solution costs two device spinor fields and one extra
+	operator application. */
+    int chrono_max_dim;
+
     QudaTune tune;                          /**< Enable auto-tuning? (default = QUDA_TUNE_YES) */
 
 
@@ -278,6 +291,8 @@ extern "C" {
     int max_restart_num;
     /** initCG tuning parameter:  decrease in absolute value of the residual within each restart cycle */
     double inc_tol;
+    /** Dense linear algebra used by the deflated solvers: MAGMA or the built-in threaded host backend */
+    QudaDenseLinalgBackend dense_linalg;
 
     /** Whether to make the solution vector(s) after the solve */
     int make_resident_solution;
@@ -311,6 +326,12 @@ extern "C" {
     int f_size;
     double eigen_shift;
 
+    /** Location of the fields used by eigensolveQuda */
+    QudaFieldLocation location;
+
+    /** Maximum number of restarts of eigensolveQuda */
+    int max_restarts;
+
   } QudaEigParam;
 
 
@@ -339,7 +360,11 @@ extern "C" {
     /** Smoother / solver to use on each level */
     QudaInverterType smoother[QUDA_MAX_MG_LEVEL];
 
-    /** Location where each level should be done */
+    /** Location where each level should be done.  With the fine
+	level on the CPU the null space is also generated there, and
+	the V-cycle copies to and from the fields of the outer solver.
+	The gauge and clover fields are still loaded through the device,
+	and the outer solve still runs there, so a device is required */
     QudaFieldLocation location[QUDA_MAX_MG_LEVEL];
 
     /** Whether to compute the null vectors or reload them */
@@ -351,6 +376,31 @@ extern "C" {
     /** Filename prefix for where to save the null-space vectors */
     char vec_outfile[256];
 
+    /** Whether to keep the host copies of the null-space vectors and
+        of the prolongator of each level compressed to 16 bits: 0
+        keeps them in full precision, n > 0 stores them with one scale
+        per n sites */
+    int compress_null_vectors;
+
+    /** Precision in which to store the saved null-space vectors
+        (QUDA_INVALID_PRECISION stores them in the precision they were
+        generated in) */
+    QudaPrecision vec_io_prec;
+
+    /** Solve the coarsest level exactly with a dense LU factorization,
+        computed once at setup, when its number of degrees of freedom
+        is at most this (0 always uses the iterative coarse solver) */
+    int coarse_direct_max_dim;
+
+    /** Number of refinement iterations done on the existing null-space
+        vectors by updateMultigridQuda (default 10) */
+    int setup_refine_iter;
+
+    /** updateMultigridQuda does a full setup instead when the refined
+        null space residual exceeds this factor times that of the last
+        full setup (default 2.0; 0 always does a full setup) */
+    double setup_refine_tol;
+
   } QudaMultigridParam;
 
 
@@ -490,6 +540,15 @@ extern "C" {
    */
   QudaEigParam newQudaEigParam(void);
 
+  /**
+   * A new QudaMultigridParam should always be initialized immediately
+   * after it's defined (and prior to explicitly setting its members)
+   * using this function.  Typical usage is as follows:
+   *
+   *   QudaMultigridParam mg_param = newQudaMultigridParam();
+   */
+  QudaMultigridParam newQudaMultigridParam(void);
+
   /**
    * Print the members of QudaGaugeParam.
    * @param param The QudaGaugeParam whose elements we are to print.
@@ -509,7 +568,15 @@ extern "C" {
   void printQudaEigParam(QudaEigParam *param);
 
   /**
-   * Load the gauge field from the host.
+   * Print the members of QudaMultigridParam.
+   * @param param The QudaMultigridParam whose elements we are to print.
+   */
+  void printQudaMultigridParam(QudaMultigridParam *param);
+
+  /**
+   * Load the gauge field from the host.  If the resident field was
+   * loaded from identical host data and parameters, the load is
+   * skipped (this is recorded as a "resident hit" in the profile).
    * @param h_gauge Base pointer to host gauge field (regardless of dimensionality)
    * @param param   Contains all metadata regarding host and device storage
    */
@@ -529,7 +596,12 @@ extern "C" {
 
   /**
    * Load the clover term and/or the clover inverse from the host.
-   * Either h_clover or h_clovinv may be set to NULL.
+   * Either h_clover or h_clovinv may be set to NULL.  If both are
+   * NULL the clover term is computed from the resident gauge field;
+   * with inv_param->clover_calc_location = QUDA_CPU_FIELD_LOCATION the
+   * clover term, its inverse and trace log are then built on the host.
+   * As with loadGaugeQuda, a load from unchanged input reuses the
+   * resident clover fields.
    * @param h_clover    Base pointer to host clover field
    * @param h_cloverinv Base pointer to host clover inverse field
    * @param inv_param   Contains all metadata regarding host and device storage
@@ -554,6 +626,24 @@ extern "C" {
   void lanczosQuda(int k0, int m, void *hp_Apsi, void *hp_r, void *hp_V,
                    void *hp_alpha, void *hp_beta, QudaEigParam *eig_param);
 
+  /**
+   * Compute the eig_param->nk lowest eigenpairs of the Hermitian
+   * operator selected by eig_param->RitzMat_lanczos using
+   * thick-restart Lanczos, with the fields in eig_param->location.
+   * For QUDA_MATPCDAG_MATPC_SHIFT_SOLUTION the operator is M^dag M +
+   * eig_param->eigen_shift, and the eigenvalues returned include the
+   * shift.
+   * It is assumed that the gauge field has already been loaded via
+   * loadGaugeQuda().
+   * @param h_evecs Array of nk host eigenvectors, the first of which
+   *                holds the starting vector on entry
+   * @param h_evals Array of nk eigenvalues in ascending order
+   * @param eig_param Contains all metadata regarding the eigensolver,
+   *                  with the operator given by eig_param->invert_param
+   * @return The number of converged eigenpairs
+   */
+  int eigensolveQuda(void **h_evecs, double *h_evals, QudaEigParam *eig_param);
+
   /**
    * Perform the solve, according to the parameters set in param.  It
    * is assumed that the gauge field has already been loaded via
@@ -565,6 +655,50 @@ extern "C" {
    */
   void invertQuda(void *h_x, void *h_b, QudaInvertParam *param);
 
+  /**
+   * Solve for param->num_src sources with the same operator.  The
+   * Dirac operators, solver and device fields are created once and
+   * reused for every source, and the host reorder of the next source
+   * and of the previous solution overlaps with the current solve.  On
+   * return param->iter, param->secs and param->gflops hold the totals
+   * over all sources and param->src_per_sec the aggregate throughput.
+   * @param h_x    Array of param->num_src solution spinor fields
+   * @param h_b    Array of param->num_src source spinor fields
+   * @param param  Contains all metadata regarding host and device
+   *               storage and solver parameters
+   */
+  void invertMultiSrcQuda(void **h_x, void **h_b, QudaInvertParam *param);
+
+  /**
+   * Queue a solve, as performed by invertQuda(), and return without
+   * waiting for it.  Requests are solved in order by a dedicated
+   * thread, so the host application may prepare the next source or
+   * post-process earlier solutions in the meantime, but it must not
+   * call any other QUDA function until all requests have been waited
+   * for.  The parameters are copied, so param may be reused at once;
+   * h_x and h_b must not be touched until waitQuda() returns.
+   * Parameter errors are reported in the calling thread.  With MPI,
+   * it must have been initialized with at least
+   * MPI_THREAD_SERIALIZED.
+   * @param h_x    Solution spinor field
+   * @param h_b    Source spinor field
+   * @param param  Contains all metadata regarding host and device
+   *               storage and solver parameters
+   * @return Handle to pass to waitQuda()
+   */
+  void* invertQudaAsync(void *h_x, void *h_b, QudaInvertParam *param);
+
+  /**
+   * Wait for a request made with invertQudaAsync() to complete and
+   * release its handle.
+   * @param handle  Handle returned by invertQudaAsync()
+   * @param param   If non-NULL, the solver results (iter, secs,
+   *                gflops, true_res, true_res_hq, spinorGiB) of the
+   *                request are returned here
+   * @return 0 if the solve converged, 1 otherwise
+   */
+  int waitQuda(void *handle, QudaInvertParam *param);
+
 
   /**
    * Solve for multiple shifts (e.g., masses).
@@ -584,6 +718,20 @@ extern "C" {
    */
   void* newMultigridQuda(QudaMultigridParam *param);
 
+  /**
+   * Update the multigrid solver for a new gauge field, e.g., between
+   * HMC trajectories.  The existing null-space vectors are refined
+   * with param->setup_refine_iter iterations against the new operator
+   * and the coarse operators are rebuilt.  A full setup is done
+   * instead if the refined null space is too poor (see
+   * param->setup_refine_tol).  It is assumed that the new gauge field
+   * has already been loaded via loadGaugeQuda().
+   * @param mg_instance The multigrid solver returned by newMultigridQuda
+   * @param param  Contains all metadata regarding host and device
+   *               storage and solver parameters
+   */
+  void updateMultigridQuda(void *mg_instance, QudaMultigridParam *param);
+
   /**
    * Free resources allocated by the multigrid solver
    */
@@ -702,6 +850,10 @@ extern "C" {
    * Evolve the gauge field by step size dt, using the momentum field
    * I.e., Evalulate U(t+dt) = e(dt pi) U(t)
    *
+   * If param->compute_location is QUDA_CPU_FIELD_LOCATION the update
+   * is performed in place on the host, with the momentum field in
+   * MILC order, and resident fields are not supported.
+   *
    * @param gauge The gauge field to be updated
    * @param momentum The momentum field
    * @param dt The integration step size step
@@ -712,6 +864,24 @@ extern "C" {
   void updateGaugeFieldQuda(void* gauge, void* momentum, double dt,
       int conj_mom, int exact, QudaGaugeParam* param);
 
+  /**
+   * Evolve the host gauge field in place by step size dt, as
+   * updateGaugeFieldQuda, and return the momentum action evaluated
+   * in the same sweep over the lattice.  This requires
+   * param->compute_location = QUDA_CPU_FIELD_LOCATION, and the
+   * momentum field is assumed to be in MILC order.
+   *
+   * @param gauge The gauge field to be updated
+   * @param momentum The momentum field
+   * @param dt The integration step size step
+   * @param conj_mom Whether to conjugate the momentum matrix
+   * @param exact Whether to use an exact exponential or Taylor expand
+   * @param param The parameters of the external fields and the computation settings
+   * @return momentum action
+   */
+  double updateGaugeFieldMomActionQuda(void* gauge, void* momentum, double dt,
+				       int conj_mom, int exact, QudaGaugeParam* param);
+
   /**
    * Apply the staggered phase factors to the gauge field.  If the
    * imaginary chemical potential is non-zero then the phase factor
@@ -792,6 +962,9 @@ extern "C" {
 
   /**
    * Compute the clover field and its inverse from the resident gauge field.
+   * If param->clover_calc_location is QUDA_CPU_FIELD_LOCATION the
+   * computation is performed on the host (not supported for twisted
+   * clover).
    *
    * @param param The parameters of the clover field to create
    */
@@ -917,7 +1090,28 @@ extern "C" {
     const QudaGaugeParam* param);
 
 
-
+  /**
+   * Compute the HISQ fermion force directly from the quark fields,
+   * fusing the outer products of all num_terms pseudofermion terms
+   * into a single pass before running the force paths once.  This is
+   * currently only implemented on the host, and so requires
+   * param->compute_location = QUDA_CPU_FIELD_LOCATION.  All fields are
+   * host fields in MILC order and cpu_prec precision.
+   *
+   * @param momentum        The momentum field (overwritten with the force)
+   * @param level2_coeff    The coefficients for the second level of smearing in the quark action.
+   * @param fat7_coeff      The coefficients for the first level of smearing (fat7) in the quark action.
+   * @param quark_array     The quark fields (even sites followed by odd sites)
+   * @param num_terms       The number of quark fields
+   * @param quark_coeff     The one-hop and three-hop coefficients for each quark field.  As
+   *                        for computeHISQForceQuda, the Naik coefficient is absorbed into
+   *                        the three-hop coefficient, while the one-hop product is weighted
+   *                        by level2_coeff[0] for the one-link term only.
+   * @param w_link          Unitarized link variables obtained by applying fat7 smearing and unitarization to the original links.
+   * @param v_link          Fat7 link variables.
+   * @param u_link          SU(3) think link variables.
+   * @param param.          The field parameters.
+   */
   void computeHISQForceCompleteQuda(void* momentum,
                       const double level2_coeff[6],
                       const double fat7_coeff[6],
@@ -964,7 +1158,9 @@ extern "C" {
    * @param[in] tolerance, torelance value to stop the method, if this value is zero then the method stops when iteration reachs the maximum number of steps defined by Nsteps
    * @param[in] reunit_interval, reunitarize gauge field when iteration count is a multiple of this
    * @param[in] stopWtheta, 0 for MILC criterium and 1 to use the theta value
-   * @param[in] param The parameters of the external fields and the computation settings
+   * @param[in] param The parameters of the external fields and the computation settings.
+   * If param->compute_location is QUDA_CPU_FIELD_LOCATION the gauge
+   * field is fixed in place on the host (single process only).
    * @param[out] timeinfo
    */
   int computeGaugeFixingOVRQuda(void* gauge,
@@ -987,7 +1183,9 @@ extern "C" {
    * @param[in] autotune, 1 to autotune the method, i.e., if the Fg inverts its tendency we decrease the alpha value
    * @param[in] tolerance, torelance value to stop the method, if this value is zero then the method stops when iteration reachs the maximum number of steps defined by Nsteps
    * @param[in] stopWtheta, 0 for MILC criterium and 1 to use the theta value
-   * @param[in] param The parameters of the external fields and the computation settings
+   * @param[in] param The parameters of the external fields and the computation settings.
+   * If param->compute_location is QUDA_CPU_FIELD_LOCATION the gauge
+   * field is fixed in place on the host using the bundled host FFT.
    * @param[out] timeinfo
    */
   int computeGaugeFixingFFTQuda(void* gauge,
@@ -7,12 +7,12 @@
 #include <string>
 #include <complex>
 
-#if ((defined(QMP_COMMS) || defined(MPI_COMMS)) && !defined(MULTI_GPU))
-#error "MULTI_GPU must be enabled to use MPI or QMP"
+#if ((defined(QMP_COMMS) || defined(MPI_COMMS) || defined(THREAD_COMMS)) && !defined(MULTI_GPU))
+#error "MULTI_GPU must be enabled to use MPI, QMP or threaded comms"
 #endif
 
-#if (!defined(QMP_COMMS) && !defined(MPI_COMMS) && defined(MULTI_GPU))
-#error "MPI or QMP must be enabled to use MULTI_GPU"
+#if (!defined(QMP_COMMS) && !defined(MPI_COMMS) && !defined(THREAD_COMMS) && defined(MULTI_GPU))
+#error "MPI, QMP or threaded comms must be enabled to use MULTI_GPU"
 #endif
 
 //#ifdef USE_QDPJIT
@@ -161,6 +161,9 @@ namespace quda {
     QUDA_PROFILE_COMPUTE, /**< The time in seconds taken for the actual computation */
     QUDA_PROFILE_EPILOGUE, /**< The time in seconds taken for any epilogue */
     QUDA_PROFILE_FREE, /**< The time in seconds for freeing resources */
+    QUDA_PROFILE_FINGERPRINT, /**< The time in seconds spent fingerprinting input fields */
+    QUDA_PROFILE_RESIDENT_HIT, /**< Loads skipped since the resident field matched the input */
+    QUDA_PROFILE_WAIT, /**< The time in seconds spent waiting for asynchronous requests */
 
     // lower level counters used in the dslash
     QUDA_PROFILE_LOWER_LEVEL, /**< dummy timer to mark beginning of lower level timers */
@@ -27,11 +27,11 @@ namespace quda {
     double shift;   // eigen shift offset 
     double *cheby_param;  // Chebychev polynomial coefficients values
 
-    mutable cudaColorSpinorField *tmp1; // temporary hack
-    mutable cudaColorSpinorField *tmp2; // temporary hack
+    mutable ColorSpinorField *tmp1; // temporary hack
+    mutable ColorSpinorField *tmp2; // temporary hack
 
-    bool newTmp(cudaColorSpinorField **tmp, const cudaColorSpinorField &a) const;
-    void deleteTmp(cudaColorSpinorField **a, const bool &reset) const;
+    bool newTmp(ColorSpinorField **tmp, const ColorSpinorField &a) const;
+    void deleteTmp(ColorSpinorField **a, const bool &reset) const;
 
     public:
     RitzMat(DiracMatrix &d, const QudaEigParam &param) 
@@ -44,7 +44,20 @@ namespace quda {
     {;}
     virtual ~RitzMat();
 
-    void operator()(cudaColorSpinorField &out, const cudaColorSpinorField &in) const;
+    /**
+       Applies the Chebyshev polynomial of degree N_Poly in the matrix,
+       which maps the interval [cheby_param[0]^2, (cheby_param[1] +
+       |shift|)^2] to [-1,1] and so amplifies the eigenvalues below
+       it.  With N_Poly == 0 the matrix itself is applied.  Works for
+       fields in any location supported by the matrix.
+     */
+    void operator()(ColorSpinorField &out, const ColorSpinorField &in) const;
+
+    /** @return Whether the polynomial acceleration is applied */
+    bool Polynomial() const { return N_Poly > 0; }
+
+    /** @return The matrix being accelerated */
+    const DiracMatrix& Matrix() const { return dirac_mat; }
 
     //    unsigned long long flops() const { return (dirac_mat->dirac)->Flops(); }
 
@@ -19,6 +19,18 @@ namespace quda {
                              cudaColorSpinorField& inOdd,
                              FaceBuffer& faceBuffer, const unsigned int parity, const double coeff[2]);
 
+  /**
+     Host staggered outer product, fused over num_terms quark fields:
+     outA += sum_t coeff[t][0] * q_t(x+mu) q_t(x)^dag and
+     outB += sum_t coeff[t][1] * q_t(x+3mu) q_t(x)^dag.
+     The quark fields are in MILC layout (even sites followed by odd
+     sites, three complex numbers per site) and in the same precision
+     as the outer-product fields.  Partitioned dimensions are not
+     supported.
+   */
+  void computeStaggeredOprod(cpuGaugeField& outA, cpuGaugeField& outB,
+                             void** quark, int num_terms, double** coeff);
+
 } // namespace quda
   
 
@@ -12,6 +12,7 @@
 
 #include <color_spinor_field.h>
 #include <dirac_quda.h>
+#include <compressed_vector_set.h>
 #include <vector>
 
 namespace quda {
@@ -43,6 +44,9 @@ namespace quda {
     /** GPU copy of the block-normalized null-space components that define the prolongator */
     ColorSpinorField *V_d;
 
+    /** Compressed CPU copy of the prolongator, replaces V_h once CompressVectors has been called */
+    CompressedVectorSet *V_c;
+
     /** A CPU temporary field with fine geometry and fine color we use for changing gamma basis */
     ColorSpinorField *fine_tmp_h;
 
@@ -182,10 +186,31 @@ namespace quda {
     void R(ColorSpinorField &out, const ColorSpinorField &in) const;
 
     /**
-     * Returns a const reference to the V field
+     * Returns a const reference to the V field.  This is only
+     * available while the vectors are not compressed.
      * @return The V field const reference
      */
-    const ColorSpinorField& Vectors() const { return *V_h; }
+    const ColorSpinorField& Vectors() const;
+
+    /**
+     * Returns a full-precision host copy of the V field, expanded
+     * from the compressed copy if the vectors have been compressed.
+     * @return The copy of the V field, which the caller must delete
+     */
+    ColorSpinorField* DecompressedVectors() const;
+
+    /**
+     * Replace the host copy of the prolongator with a compressed
+     * 16-bit copy.  The host transfer kernels then decompress the
+     * null-space components on the fly.
+     * @param block_sites Number of consecutive sites sharing a scale
+     */
+    void CompressVectors(int block_sites=1);
+
+    /**
+     * @return Whether the host prolongator is stored compressed
+     */
+    bool Compressed() const { return V_c != 0; }
 
     /**
      * Returns the number of near nullvectors
@@ -247,6 +272,13 @@ namespace quda {
   void Prolongate(ColorSpinorField &out, const ColorSpinorField &in, const ColorSpinorField &v, 
 		  int Nvec, const int *fine_to_coarse, const int *spin_map);
 
+  /**
+     Apply the prolongation operator using compressed null-space
+     components (host only)
+   */
+  void Prolongate(ColorSpinorField &out, const ColorSpinorField &in, const CompressedVectorSet &v,
+		  int Nvec, const int *fine_to_coarse, const int *spin_map);
+
   /**
      Apply the restriction operator
      @param out Resulting coarsened field
@@ -258,6 +290,13 @@ namespace quda {
    */
   void Restrict(ColorSpinorField &out, const ColorSpinorField &in, const ColorSpinorField &v, 
 		int Nvec, const int *fine_to_coarse, const int *coarse_to_fine, const int *spin_map);
+
+  /**
+     Apply the restriction operator using compressed null-space
+     components (host only)
+   */
+  void Restrict(ColorSpinorField &out, const ColorSpinorField &in, const CompressedVectorSet &v,
+		int Nvec, const int *fine_to_coarse, const int *coarse_to_fine, const int *spin_map);
   
 
 } // namespace quda
@@ -1,4 +1,5 @@
 #include <blas_magma.h>
+#include <dense_linalg.h>
 #include <string.h>
 
 #include <vector>
@@ -144,6 +145,111 @@ void sMM_v2(void *outBuff, const int bldm,  void *sMat, const int srows, const i
 #undef BLOCK_SIZE
 
 
+QudaDenseLinalgBackend BlasMagmaArgs::DefaultBackend(){
+#ifdef MAGMA_LIB
+  return QUDA_MAGMA_DENSE_LINALG;
+#else
+  return QUDA_HOST_DENSE_LINALG;
+#endif
+}
+
+static void checkBackend(QudaDenseLinalgBackend backend){
+
+    if(backend != QUDA_MAGMA_DENSE_LINALG && backend != QUDA_HOST_DENSE_LINALG) errorQuda("\nError: invalid dense linear algebra backend %d\n", backend);
+#ifndef MAGMA_LIB
+    if(backend == QUDA_MAGMA_DENSE_LINALG) errorQuda("\nError: MAGMA library was not compiled, check your compilation options...\n");
+#endif
+
+    return;
+}
+
+//Helpers for the host backend: the matrices may be in host or device
+//memory and in single or double precision, while the dense linear
+//algebra is done in double precision on the host.
+
+typedef std::complex<double> DenseComplex;
+
+static bool isDevicePointer(const void *ptr)
+{
+    cudaPointerAttributes ptr_attr;
+    if(cudaPointerGetAttributes(&ptr_attr, ptr) != cudaSuccess)
+    {
+      cudaGetLastError();//plain host memory, clear the error state
+      return false;
+    }
+    return (ptr_attr.memoryType == cudaMemoryTypeDevice);
+}
+
+template<typename Float>
+static void loadMatrix(DenseComplex *dst, const int ldd, const void *src, const int lds, const int rows, const int cols)
+{
+    std::vector<std::complex<Float> > buffer(rows*cols);
+    cudaMemcpy2D(&buffer[0], rows*sizeof(std::complex<Float>), src, lds*sizeof(std::complex<Float>), rows*sizeof(std::complex<Float>), cols, cudaMemcpyDefault);
+    for(int j = 0; j < cols; j++) for(int i = 0; i < rows; i++) dst[ldd*j+i] = DenseComplex(buffer[rows*j+i]);
+}
+
+template<typename Float>
+static void storeMatrix(void *dst, const int ldd, const DenseComplex *src, const int lds, const int rows, const int cols)
+{
+    std::vector<std::complex<Float> > buffer(rows*cols);
+    for(int j = 0; j < cols; j++) for(int i = 0; i < rows; i++) buffer[rows*j+i] = std::complex<Float>(src[lds*j+i]);
+    cudaMemcpy2D(dst, ldd*sizeof(std::complex<Float>), &buffer[0], rows*sizeof(std::complex<Float>), rows*sizeof(std::complex<Float>), cols, cudaMemcpyDefault);
+}
+
+static void loadMatrix(DenseComplex *dst, const int ldd, const void *src, const int lds, const int rows, const int cols, const int prec)
+{
+    if(prec == 4) loadMatrix<float>(dst, ldd, src, lds, rows, cols);
+    else          loadMatrix<double>(dst, ldd, src, lds, rows, cols);
+}
+
+static void storeMatrix(void *dst, const int ldd, const DenseComplex *src, const int lds, const int rows, const int cols, const int prec)
+{
+    if(prec == 4) storeMatrix<float>(dst, ldd, src, lds, rows, cols);
+    else          storeMatrix<double>(dst, ldd, src, lds, rows, cols);
+}
+
+//V(:, 0:l) = V(:, 0:m) T for a basis in host or device memory, device
+//bases are staged through host memory in blocks of rows
+static void hostRestartBasis(void *V, const int vld, const int vlen, const int vprec, const DenseComplex *T, const int ldt, const int m, const int l)
+{
+    if(!isDevicePointer(V))
+    {
+      quda::rotateBasis(V, vprec, vld, vlen, T, ldt, m, l);
+      return;
+    }
+
+    const size_t cvprec = 2*vprec;
+    const size_t max_bytes = 1 << 26;
+    const int bufferBlock = std::min(vlen, std::max(1, (int)(max_bytes / (m*cvprec))));
+
+    std::vector<char> buffer(bufferBlock*m*cvprec);
+
+    for (int blockOffset = 0; blockOffset < vlen; blockOffset += bufferBlock)
+    {
+      const int rows = std::min(bufferBlock, vlen-blockOffset);
+      char *ptrV = static_cast<char*>(V) + blockOffset*cvprec;
+
+      cudaMemcpy2D(&buffer[0], rows*cvprec, ptrV, vld*cvprec, rows*cvprec, m, cudaMemcpyDeviceToHost);
+      quda::rotateBasis(&buffer[0], vprec, rows, rows, T, ldt, m, l);
+      cudaMemcpy2D(ptrV, vld*cvprec, &buffer[0], rows*cvprec, rows*cvprec, l, cudaMemcpyHostToDevice);
+    }
+}
+
+static void hostSolve(void *rhs, const int n, const void *H, const int ldH, const int prec)
+{
+    std::vector<DenseComplex> A(n*n);
+    std::vector<DenseComplex> b(n);
+    std::vector<int> ipiv(n);
+
+    loadMatrix(&A[0], n, H, ldH, n, n, prec);
+    loadMatrix(&b[0], n, rhs, n, n, 1, prec);
+
+    if(quda::luFactor(&A[0], n, n, &ipiv[0]) != 0) errorQuda("\nError in SolveProjMatrix (singular matrix), exit ...\n");
+    quda::luSolve(&b[0], &A[0], n, n, &ipiv[0]);
+
+    storeMatrix(rhs, n, &b[0], n, n, 1, prec);
+}
+
 void BlasMagmaArgs::OpenMagma(){
 
 #ifdef MAGMA_LIB
@@ -173,10 +279,19 @@ void BlasMagmaArgs::CloseMagma(){
     return;
 }
 
- BlasMagmaArgs::BlasMagmaArgs(const int prec) : m(0), max_nev(0), prec(prec), ldm(0), info(-1), llwork(0),
-  lrwork(0), liwork(0), sideLR(0), htsize(0), dtsize(0), lwork_max(0), W(0), W2(0),
+ BlasMagmaArgs::BlasMagmaArgs(const int prec, QudaDenseLinalgBackend backend) : m(0), max_nev(0), prec(prec), ldm(0), info(-1), llwork(0),
+  lrwork(0), liwork(0), sideLR(0), htsize(0), dtsize(0), lwork_max(0), backend(backend), W(0), W2(0),
   hTau(0), dTau(0), lwork(0), rwork(0), iwork(0)
 {
+    checkBackend(backend);
+
+    if(backend == QUDA_HOST_DENSE_LINALG)
+    {
+      alloc = false;
+      init  = true;
+      return;
+    }
+
 
 #ifdef MAGMA_LIB
     magma_int_t dev_info = magma_getdevice_arch();//mostly to check whether magma is intialized...
@@ -194,10 +309,19 @@ void BlasMagmaArgs::CloseMagma(){
 }
 
 
-BlasMagmaArgs::BlasMagmaArgs(const int m, const int ldm, const int prec)
+BlasMagmaArgs::BlasMagmaArgs(const int m, const int ldm, const int prec, QudaDenseLinalgBackend backend)
   : m(m), max_nev(0),  prec(prec), ldm(ldm), info(-1), sideLR(0), htsize(0), dtsize(0),
-  W(0), hTau(0), dTau(0)
+  backend(backend), W(0), W2(0), hTau(0), dTau(0), lwork(0), rwork(0), iwork(0)
 {
+    checkBackend(backend);
+
+    if(backend == QUDA_HOST_DENSE_LINALG)
+    {
+      alloc = false;
+      init  = true;
+      return;
+    }
+
 
 #ifdef MAGMA_LIB
 
@@ -232,9 +356,21 @@ BlasMagmaArgs::BlasMagmaArgs(const int m, const int ldm, const int prec)
 
 
 
-BlasMagmaArgs::BlasMagmaArgs(const int m, const int max_nev, const int ldm, const int prec)
-  : m(m), max_nev(max_nev),  prec(prec), ldm(ldm), info(-1)
+BlasMagmaArgs::BlasMagmaArgs(const int m, const int max_nev, const int ldm, const int prec, QudaDenseLinalgBackend backend)
+  : m(m), max_nev(max_nev),  prec(prec), ldm(ldm), info(-1),
+  backend(backend), W(0), W2(0), hTau(0), dTau(0), lwork(0), rwork(0), iwork(0)
 {
+    checkBackend(backend);
+
+    if(backend == QUDA_HOST_DENSE_LINALG)
+    {
+      //only the Householder scalars are kept between calls
+      hTau  = new DenseComplex[max_nev];
+      alloc = true;
+      init  = true;
+      return;
+    }
+
 
 #ifdef MAGMA_LIB
 
@@ -281,6 +417,14 @@ BlasMagmaArgs::BlasMagmaArgs(const int m, const int max_nev, const int ldm, cons
 
 BlasMagmaArgs::~BlasMagmaArgs()
 {
+   if(backend == QUDA_HOST_DENSE_LINALG)
+   {
+     if(hTau) delete[] static_cast<DenseComplex*>(hTau);
+     alloc = false;
+     init  = false;
+     return;
+   }
+
 #ifdef MAGMA_LIB
 
    if(alloc == true)
@@ -307,6 +451,25 @@ BlasMagmaArgs::~BlasMagmaArgs()
 
 void BlasMagmaArgs::MagmaHEEVD(void *dTvecm, void *hTvalm, const int prob_size, bool host)
 {
+     if(backend == QUDA_HOST_DENSE_LINALG)
+     {
+       if(prob_size > m) errorQuda("\nError in MagmaHEEVD (problem size cannot exceed given search space %d), exit ...\n", m);
+
+       std::vector<DenseComplex> evecs(prob_size*prob_size);
+       std::vector<double> evals(prob_size);
+
+       loadMatrix(&evecs[0], prob_size, dTvecm, ldm, prob_size, prob_size, prec);
+       quda::hermitianEigensolve(&evals[0], &evecs[0], prob_size, prob_size);
+       storeMatrix(dTvecm, ldm, &evecs[0], prob_size, prob_size, prob_size, prec);
+
+       for(int i = 0; i < prob_size; i++)
+       {
+         if(prec == 4) ((float*)hTvalm)[i] = evals[i];
+         else          ((double*)hTvalm)[i] = evals[i];
+       }
+       return;
+     }
+
 #ifdef MAGMA_LIB
      if(prob_size > m) errorQuda("\nError in MagmaHEEVD (problem size cannot exceed given search space %d), exit ...\n", m);
 
@@ -356,6 +519,26 @@ int BlasMagmaArgs::MagmaORTH_2nev(void *dTvecm, void *dTm)
 {
      const int l = max_nev;
 
+     if(backend == QUDA_HOST_DENSE_LINALG)
+     {
+       DenseComplex *tau = static_cast<DenseComplex*>(hTau);
+       std::vector<DenseComplex> Q(m*l);
+       std::vector<DenseComplex> T(m*m);
+
+       loadMatrix(&Q[0], m, dTvecm, ldm, m, l, prec);
+       loadMatrix(&T[0], m, dTm, ldm, m, m, prec);
+
+       quda::householderQR(&Q[0], m, l, m, tau);
+       //compute QH*Tm*Q, first TQ and then QH(TQ) for the leading l columns
+       quda::applyHouseholderQ(false, false, m, m, l, &Q[0], m, tau, &T[0], m);
+       quda::applyHouseholderQ(true, true, m, l, l, &Q[0], m, tau, &T[0], m);
+
+       storeMatrix(dTvecm, ldm, &Q[0], m, m, l, prec);
+       storeMatrix(dTm, ldm, &T[0], m, m, m, prec);
+
+       return l;
+     }
+
 #ifdef MAGMA_LIB
      if(prec == 4)
      {
@@ -397,6 +580,25 @@ int BlasMagmaArgs::MagmaORTH_2nev(void *dTvecm, void *dTm)
 
 void BlasMagmaArgs::RestartV(void *dV, const int vld, const int vlen, const int vprec, void *dTevecm, void *dTm)
 {
+       if(backend == QUDA_HOST_DENSE_LINALG)
+       {
+         const int l = max_nev;
+
+         DenseComplex *tau = static_cast<DenseComplex*>(hTau);
+         std::vector<DenseComplex> Q(m*l);
+         std::vector<DenseComplex> T(m*l);
+
+         loadMatrix(&Q[0], m, dTevecm, ldm, m, l, prec);
+         loadMatrix(&T[0], m, dTm, ldm, m, l, prec);
+
+         //the Ritz vectors in the original basis, then V = V * Q * T
+         quda::applyHouseholderQ(true, false, m, l, l, &Q[0], m, tau, &T[0], m);
+         storeMatrix(dTm, ldm, &T[0], m, m, l, prec);
+
+         hostRestartBasis(dV, vld, vlen, vprec, &T[0], m, m, l);
+         return;
+       }
+
 #ifdef MAGMA_LIB
        if( (vld % 32) != 0) errorQuda("\nError: leading dimension must be multiple of the warp size\n");
 
@@ -468,6 +670,12 @@ void BlasMagmaArgs::RestartV(void *dV, const int vld, const int vlen, const int
 
 void BlasMagmaArgs::SolveProjMatrix(void* rhs, const int ldn, const int n, void* H, const int ldH)
 {
+       if(backend == QUDA_HOST_DENSE_LINALG)
+       {
+         hostSolve(rhs, n, H, ldH, prec);
+         return;
+       }
+
 #ifdef MAGMA_LIB
        const int complex_prec = 2*prec;
        void *tmp;
@@ -498,6 +706,12 @@ void BlasMagmaArgs::SolveProjMatrix(void* rhs, const int ldn, const int n, void*
 
 void BlasMagmaArgs::SolveGPUProjMatrix(void* rhs, const int ldn, const int n, void* H, const int ldH)
 {
+       if(backend == QUDA_HOST_DENSE_LINALG)
+       {
+         hostSolve(rhs, n, H, ldH, prec);
+         return;
+       }
+
 #ifdef MAGMA_LIB
        const int complex_prec = 2*prec;
        void *tmp;
@@ -529,6 +743,8 @@ void BlasMagmaArgs::SolveGPUProjMatrix(void* rhs, const int ldn, const int n, vo
 void BlasMagmaArgs::SpinorMatVec
 (void *spinorOut, const void *spinorSetIn, const int sld, const int slen, const void *vec, const int vlen)
 {
+       if(backend == QUDA_HOST_DENSE_LINALG) errorQuda("\nError: SpinorMatVec is not supported by the host backend\n");
+
 #ifdef MAGMA_LIB
        if (prec == 4)
        {
@@ -550,6 +766,8 @@ void BlasMagmaArgs::SpinorMatVec
 
 void BlasMagmaArgs::MagmaRightNotrUNMQR(const int clen, const int qrlen, const int nrefls, void *QR, const int ldqr, void *Vm, const int cldn)
 {
+     if(backend == QUDA_HOST_DENSE_LINALG) errorQuda("\nError: MagmaRightNotrUNMQR is not supported by the host backend\n");
+
 #ifdef MAGMA_LIB
      magma_int_t m = clen;
      magma_int_t n = qrlen;
@@ -652,6 +870,12 @@ void BlasMagmaArgs::Sort(const int m, const int ldm, void *eVecs, const int nev,
 
 void BlasMagmaArgs::ComputeQR(const int nev, Complex * evmat, const int m, const int ldm, Complex  *tau)
 {
+  if(backend == QUDA_HOST_DENSE_LINALG)
+  {
+    quda::householderQR(evmat, m, nev, ldm, tau);
+    return;
+  }
+
 #ifdef MAGMA_LIB
   magma_int_t _m   = m;//matrix size
 
@@ -689,6 +913,12 @@ void BlasMagmaArgs::ComputeQR(const int nev, Complex * evmat, const int m, const
 void BlasMagmaArgs::LeftConjZUNMQR(const int k /*number of reflectors*/, const int n /*number of columns of H*/, Complex *H, const int dh /*number of rows*/,
 const int ldh, Complex * QR,  const int ldqr, Complex *tau)//for vectors: n =1
 {
+  if(backend == QUDA_HOST_DENSE_LINALG)
+  {
+    quda::applyHouseholderQ(true, true, dh, n, k, QR, ldqr, tau, H, ldh);
+    return;
+  }
+
 #ifdef MAGMA_LIB
 //Note: # rows of QR = # rows of H.
   magma_int_t _h   = dh;//matrix size
@@ -736,6 +966,21 @@ const int ldh, Complex * QR,  const int ldqr, Complex *tau)//for vectors: n =1
 
 void BlasMagmaArgs::Construct_harmonic_matrix(Complex * const harmH, Complex * const conjH, const double beta2, const int m, const int ldH)
 {
+  if(backend == QUDA_HOST_DENSE_LINALG)
+  {
+    //Construct H + beta*H^{-H} e_m*e_m^{T}, solving H^{H}y = beta*e_m
+    std::vector<Complex> em(m, 0.0);
+    std::vector<int> ipiv(m);
+
+    em[m-1] = beta2;
+
+    if(quda::luFactor(conjH, m, ldH, &ipiv[0]) != 0) errorQuda("\nError in Construct_harmonic_matrix (singular matrix), exit ...\n");
+    quda::luSolve(&em[0], conjH, m, ldH, &ipiv[0]);
+
+    for(int i = 0; i < m; i++) harmH[ldH*(m-1)+i] += em[i];
+    return;
+  }
+
 #ifdef MAGMA_LIB
   //Lapack parameters:
   magma_int_t _m    = m;
@@ -783,6 +1028,12 @@ void BlasMagmaArgs::Construct_harmonic_matrix(Complex * const harmH, Complex * c
 
 void BlasMagmaArgs::Compute_harmonic_matrix_eigenpairs(Complex *harmH, const int m, const int ldH, Complex *vr, Complex *evalues, const int ldv)
 {
+  if(backend == QUDA_HOST_DENSE_LINALG)
+  {
+    quda::generalEigensolve(evalues, vr, ldv, harmH, m, ldH);
+    return;
+  }
+
 #ifdef MAGMA_LIB
   magma_int_t _m   = m;//matrix size
 
@@ -831,6 +1082,44 @@ void BlasMagmaArgs::Compute_harmonic_matrix_eigenpairs(Complex *harmH, const int
 
 void BlasMagmaArgs::RestartVH(void *dV, const int vlen, const int vld, const int vprec, void *sortedHarVecs, void *H, const int ldh)
 {
+    if(backend == QUDA_HOST_DENSE_LINALG)
+    {
+      if(prec == 4) errorQuda("\nError: single precision is not currently supported\n");
+
+      const int nev = (max_nev - 1); //(nev+1) - 1 for GMRESDR
+      const int l   = max_nev;
+      const int mp1 = (m+1);
+
+      Complex *harVecs = (Complex*)sortedHarVecs;
+      Complex *Hm      = (Complex*)H;
+
+      std::vector<Complex> tau(l);
+      std::vector<Complex> Qmat(ldh*mp1, 0.0);
+
+      ComputeQR(l, harVecs, mp1, ldh, &tau[0]);
+
+      //max_nev orthonormal vectors are stored in Qmat:
+      for(int d = 0; d < mp1; d++) Qmat[ldh*d+d] = Complex(1.0, 0.0);
+      quda::applyHouseholderQ(false, false, mp1, mp1, l, harVecs, ldh, &tau[0], &Qmat[0], ldh);
+
+      hostRestartBasis(dV, vld, vlen, vprec, &Qmat[0], ldh, mp1, l);
+
+      const size_t cvprec = 2*vprec;
+      char *tail = static_cast<char*>(dV) + vld*max_nev*cvprec;
+      if(isDevicePointer(dV)) cudaMemset(tail, 0, (m+1-max_nev)*vld*cvprec);
+      else memset(tail, 0, (m+1-max_nev)*vld*cvprec);
+
+      //Construct H_new = Pdagger_{k+1} \bar{H}_{m} P_{k}
+      quda::applyHouseholderQ(false, false, mp1, m, nev, harVecs, ldh, &tau[0], Hm, ldh);
+      quda::applyHouseholderQ(true, true, mp1, nev, l, harVecs, ldh, &tau[0], Hm, ldh);
+
+      const int len = ldh - nev-1;
+      for(int i = 0; i < nev; i++) memset(&Hm[ldh*i+nev+1], 0, len*sizeof(Complex));
+      memset(&Hm[ldh*nev], 0, (m-nev)*ldh*sizeof(Complex));
+
+      return;
+    }
+
 #ifdef MAGMA_LIB
     if(prec == 4)
     {
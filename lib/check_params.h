@@ -126,6 +126,12 @@ void printQudaGaugeParam(QudaGaugeParam *param) {
   P(return_result_mom, INVALID_INT);
 #endif
 
+#if defined INIT_PARAM
+  P(compute_location, QUDA_CUDA_FIELD_LOCATION);
+#else
+  P(compute_location, QUDA_INVALID_FIELD_LOCATION);
+#endif
+
 #ifdef INIT_PARAM
   return ret;
 #endif
@@ -153,6 +159,8 @@ void printQudaEigParam(QudaEigParam *param) {
   P(np, 0);
   P(f_size, 0);
   P(eigen_shift, 0.0);
+  P(location, QUDA_CUDA_FIELD_LOCATION);
+  P(max_restarts, 100);
 #else
   P(NPoly, INVALID_INT);
   P(Stp_residual, INVALID_DOUBLE);
@@ -160,12 +168,51 @@ void printQudaEigParam(QudaEigParam *param) {
   P(np, INVALID_INT);
   P(f_size, INVALID_INT);
   P(eigen_shift, INVALID_DOUBLE);
+  P(location, QUDA_INVALID_FIELD_LOCATION);
+  P(max_restarts, INVALID_INT);
 #endif
 
 #ifdef INIT_PARAM
   return ret;
 #endif
 }
+// define the appropriate function for MultigridParam
+
+#if defined INIT_PARAM
+QudaMultigridParam newQudaMultigridParam(void) {
+  QudaMultigridParam ret;
+#elif defined CHECK_PARAM
+static void checkMultigridParam(QudaMultigridParam *param) {
+#else
+void printQudaMultigridParam(QudaMultigridParam *param) {
+  printfQuda("QUDA Multigrid Parameters:\n");
+#endif
+
+#if defined INIT_PARAM
+  ret.invert_param = NULL;
+  ret.vec_infile[0] = '\0';
+  ret.vec_outfile[0] = '\0';
+  P(n_level, INVALID_INT);
+  P(compute_null_vector, QUDA_COMPUTE_NULL_VECTOR_YES);
+  P(compress_null_vectors, 0);
+  P(vec_io_prec, QUDA_INVALID_PRECISION);
+  P(coarse_direct_max_dim, 0);
+  P(setup_refine_iter, 10);
+  P(setup_refine_tol, 2.0);
+#else
+  P(n_level, INVALID_INT);
+  P(compute_null_vector, QUDA_COMPUTE_NULL_VECTOR_INVALID);
+  P(compress_null_vectors, INVALID_INT);
+  P(coarse_direct_max_dim, INVALID_INT);
+  P(setup_refine_iter, INVALID_INT);
+  P(setup_refine_tol, INVALID_DOUBLE);
+#endif
+
+#ifdef INIT_PARAM
+  return ret;
+#endif
+}
+
 // define the appropriate function for InvertParam
 
 #if defined INIT_PARAM
@@ -275,10 +322,12 @@ void printQudaInvertParam(QudaInvertParam *param) {
   P(input_location, QUDA_CPU_FIELD_LOCATION);
   P(output_location, QUDA_CPU_FIELD_LOCATION);
   P(clover_location, QUDA_CPU_FIELD_LOCATION);
+  P(clover_calc_location, QUDA_CUDA_FIELD_LOCATION);
 #else
   P(input_location, QUDA_INVALID_FIELD_LOCATION);
   P(output_location, QUDA_INVALID_FIELD_LOCATION);
   P(clover_location, QUDA_INVALID_FIELD_LOCATION);
+  P(clover_calc_location, QUDA_INVALID_FIELD_LOCATION);
 #endif
 
 #if defined INIT_PARAM
@@ -373,6 +422,7 @@ void printQudaInvertParam(QudaInvertParam *param) {
     P(cloverGiB, 0.0);
   P(gflops, 0.0);
   P(secs, 0.0);
+  P(src_per_sec, 0.0);
 #elif defined(PRINT_PARAM)
   P(iter, INVALID_INT);
   P(spinorGiB, INVALID_DOUBLE);
@@ -380,6 +430,17 @@ void printQudaInvertParam(QudaInvertParam *param) {
     P(cloverGiB, INVALID_DOUBLE);
   P(gflops, INVALID_DOUBLE);
   P(secs, INVALID_DOUBLE);
+  P(src_per_sec, INVALID_DOUBLE);
+#endif
+
+#if defined INIT_PARAM
+  P(num_src, 1);
+  P(chrono_max_dim, 0);
+#elif defined(PRINT_PARAM)
+  P(num_src, INVALID_INT);
+  P(chrono_max_dim, INVALID_INT);
+#else
+  if (param->chrono_max_dim < 0) errorQuda("Invalid chrono_max_dim %d", param->chrono_max_dim);
 #endif
 
 
@@ -405,6 +466,11 @@ void printQudaInvertParam(QudaInvertParam *param) {
   P(max_restart_num, 3);
   P(inc_tol, 1e-2);
   P(eigenval_tol, 1e-1);
+#ifdef MAGMA_LIB
+  P(dense_linalg, QUDA_MAGMA_DENSE_LINALG);
+#else
+  P(dense_linalg, QUDA_HOST_DENSE_LINALG);
+#endif
 #else
   //P(cuda_prec_ritz, QUDA_INVALID_PRECISION);
   P(nev, INVALID_INT);
@@ -416,6 +482,7 @@ void printQudaInvertParam(QudaInvertParam *param) {
   P(max_restart_num, INVALID_INT);
   P(inc_tol, INVALID_DOUBLE);
   P(eigenval_tol, INVALID_DOUBLE);
+  P(dense_linalg, QUDA_INVALID_DENSE_LINALG);
 #endif
 
 #if defined INIT_PARAM
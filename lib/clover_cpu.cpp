@@ -0,0 +1,375 @@
+#include <math.h>
+#include <typeinfo>
+
+#include <quda_internal.h>
+#include <gauge_field.h>
+#include <gauge_field_order.h>
+#include <clover_field.h>
+#include <clover_field_order.h>
+#include <quda_matrix.h>
+#include <complex_quda.h>
+#include <index_helper.cuh>
+#include <face_quda.h>
+
+namespace quda {
+
+#ifdef GPU_CLOVER_DIRAC
+
+  // mapping between the packed clover storage and the lower-triangular index k*(k-1)/2+j
+  static const int idtab[15] = {0,1,3,6,10,2,4,7,11,5,8,12,9,13,14};
+
+  /**
+     In-place inversion of a single 6x6 hermitian positive-definite
+     chiral block, stored as its real diagonal and packed lower
+     triangle (element (k,j), k>j, at index k*(k-1)/2+j).  The block
+     is Cholesky factored A = L L^dagger, the triangular factor is
+     inverted and the inverse formed as A^{-1} = L^{-dagger} L^{-1}.
+     All loop bounds are fixed so the compiler fully unrolls the
+     kernel.  Arithmetic is carried out in double precision.
+     @return log det A
+   */
+  inline double cholesky6x6Invert(double diag[6], complex<double> tri[15]) {
+    double logdet = 0.0;
+
+    // factorization: diag <- L(j,j), tri <- L(k,j)
+    for (int j=0; j<6; j++) {
+      diag[j] = sqrt(diag[j]);
+      logdet += 2.0*log(diag[j]);
+      const double inv = 1.0 / diag[j];
+      for (int k=j+1; k<6; k++) tri[k*(k-1)/2+j] *= complex<double>(inv);
+      for (int k=j+1; k<6; k++) {
+	const complex<double> Lkj = tri[k*(k-1)/2+j];
+	diag[k] -= norm(Lkj);
+	for (int l=k+1; l<6; l++) tri[l*(l-1)/2+k] -= tri[l*(l-1)/2+j] * conj(Lkj);
+      }
+    }
+
+    // triangular inverse: diag <- 1/L(j,j), tri <- L^{-1}(k,j)
+    for (int j=0; j<6; j++) diag[j] = 1.0 / diag[j];
+    for (int j=0; j<6; j++) {
+      for (int k=j+1; k<6; k++) {
+	complex<double> sum = tri[k*(k-1)/2+j] * diag[j];
+	for (int l=j+1; l<k; l++) sum += tri[k*(k-1)/2+l] * tri[l*(l-1)/2+j];
+	tri[k*(k-1)/2+j] = -diag[k] * sum;
+      }
+    }
+
+    // A^{-1}(i,j) = sum_{k >= i} conj(L^{-1}(k,i)) L^{-1}(k,j) for i >= j
+    double inv_diag[6];
+    complex<double> inv_tri[15];
+    for (int i=0; i<6; i++) {
+      double d = diag[i]*diag[i];
+      for (int k=i+1; k<6; k++) d += norm(tri[k*(k-1)/2+i]);
+      inv_diag[i] = d;
+
+      for (int j=0; j<i; j++) {
+	complex<double> sum = diag[i] * tri[i*(i-1)/2+j];
+	for (int k=i+1; k<6; k++) sum += conj(tri[k*(k-1)/2+i]) * tri[k*(k-1)/2+j];
+	inv_tri[i*(i-1)/2+j] = sum;
+      }
+    }
+
+    for (int i=0; i<6; i++) diag[i] = inv_diag[i];
+    for (int i=0; i<15; i++) tri[i] = inv_tri[i];
+    return logdet;
+  }
+
+  /**
+     Invert both chiral blocks of a clover matrix given in the QUDA
+     storage basis (which carries an inherent factor of one half).
+     @return The trace log of the clover matrix
+   */
+  template <typename Float>
+  inline double cloverInvertSite(Float A[72]) {
+    double trlog = 0.0;
+    for (int ch=0; ch<2; ch++) {
+      double diag[6];
+      complex<double> tri[15];
+      for (int i=0; i<6; i++) diag[i] = 2.0*A[ch*36+i];
+      for (int i=0; i<15; i++) tri[idtab[i]] = complex<double>(2.0*A[ch*36+6+2*i], 2.0*A[ch*36+6+2*i+1]);
+
+      trlog += cholesky6x6Invert(diag, tri);
+
+      for (int i=0; i<6; i++) A[ch*36+i] = 0.5*diag[i];
+      for (int i=0; i<15; i++) {
+	A[ch*36+6+2*i] = 0.5*tri[idtab[i]].real();
+	A[ch*36+6+2*i+1] = 0.5*tri[idtab[i]].imag();
+      }
+    }
+    return trlog;
+  }
+
+  template <typename Float, typename Gauge, typename Clover>
+  struct CloverCPUArg {
+    Gauge gauge;
+    Clover clover;
+    Clover inverse;
+    int X[4]; // the regular volume parameters
+    int E[4]; // the (possibly) extended volume parameters
+    int border[4];
+    int volumeCB;
+    Float cloverCoeff;
+    bool direct;
+    bool invert;
+
+    CloverCPUArg(const Gauge &gauge, const Clover &clover, const Clover &inverse, const GaugeField &meta,
+		 const CloverField &clover_meta, double cloverCoeff, bool direct, bool invert)
+      : gauge(gauge), clover(clover), inverse(inverse), volumeCB(clover_meta.VolumeCB()),
+	cloverCoeff(cloverCoeff), direct(direct), invert(invert) {
+      for (int d=0; d<4; d++) {
+	X[d] = clover_meta.X()[d];
+	E[d] = meta.X()[d];
+	border[d] = (E[d] - X[d]) / 2;
+      }
+    }
+  };
+
+  template <typename Float, typename Arg>
+  inline void loadLink(Matrix<typename ComplexTypeId<Float>::Type,3> &U, const Arg &arg,
+		       int x[4], int dx[4], int dim, int parity) {
+    const int nbr_parity = (parity + dx[0] + dx[1] + dx[2] + dx[3]) & 1;
+    arg.gauge.load((Float*)(U.data), linkIndexShift(x, dx, arg.E), dim, nbr_parity);
+  }
+
+  /**
+     Compute the clover-leaf field strength F[mu][nu] (mu > nu, stored
+     lower triangular) at a single site, matching computeFmunu.
+   */
+  template <typename Float, typename Arg>
+  void fmunuSite(Matrix<typename ComplexTypeId<Float>::Type,3> F[6], const Arg &arg, int x[4], int parity) {
+    typedef typename ComplexTypeId<Float>::Type Cmplx;
+    Matrix<Cmplx,3> U1, U2, U3, U4, Q;
+
+    for (int mu=0; mu<4; mu++) {
+      for (int nu=0; nu<mu; nu++) {
+	int dx[4] = {0, 0, 0, 0};
+
+	// U(x,mu) U(x+mu,nu) U[dagger](x+nu,mu) U[dagger](x,nu)
+	loadLink<Float>(U1, arg, x, dx, mu, parity);
+	dx[mu]++; loadLink<Float>(U2, arg, x, dx, nu, parity); dx[mu]--;
+	dx[nu]++; loadLink<Float>(U3, arg, x, dx, mu, parity); dx[nu]--;
+	loadLink<Float>(U4, arg, x, dx, nu, parity);
+	Q = U1 * U2 * conj(U3) * conj(U4);
+
+	// U(x,nu) U[dagger](x+nu-mu,mu) U[dagger](x-mu,nu) U(x-mu, mu)
+	loadLink<Float>(U1, arg, x, dx, nu, parity);
+	dx[nu]++; dx[mu]--; loadLink<Float>(U2, arg, x, dx, mu, parity); dx[nu]--;
+	loadLink<Float>(U3, arg, x, dx, nu, parity);
+	loadLink<Float>(U4, arg, x, dx, mu, parity); dx[mu]++;
+	Q += U1 * conj(U2) * conj(U3) * U4;
+
+	// U[dagger](x-nu,nu) U(x-nu,mu) U(x+mu-nu,nu) U[dagger](x,mu)
+	dx[nu]--; loadLink<Float>(U1, arg, x, dx, nu, parity);
+	loadLink<Float>(U2, arg, x, dx, mu, parity);
+	dx[mu]++; loadLink<Float>(U3, arg, x, dx, nu, parity); dx[mu]--; dx[nu]++;
+	loadLink<Float>(U4, arg, x, dx, mu, parity);
+	Q += conj(U1) * U2 * U3 * conj(U4);
+
+	// U[dagger](x-mu,mu) U[dagger](x-mu-nu,nu) U(x-mu-nu,mu) U(x-nu,nu)
+	dx[mu]--; loadLink<Float>(U1, arg, x, dx, mu, parity);
+	dx[nu]--; loadLink<Float>(U2, arg, x, dx, nu, parity);
+	loadLink<Float>(U3, arg, x, dx, mu, parity); dx[mu]++;
+	loadLink<Float>(U4, arg, x, dx, nu, parity);
+	Q += conj(U1) * conj(U2) * U3 * U4;
+
+	Q -= conj(Q);
+	F[(mu*(mu-1))/2 + nu] = static_cast<Float>(1.0/8.0) * Q;
+      }
+    }
+  }
+
+  /**
+     Build the clover term at a single site from the field strength
+     and, if requested, its inverse, in a single pass.  The layout
+     matches cloverComputeCore and cloverInvertCompute.
+   */
+  template <typename Float, typename Arg>
+  double cloverSite(Arg &arg, int x_cb, int parity) {
+    typedef typename ComplexTypeId<Float>::Type Cmplx;
+
+    int x[4];
+    getCoords(x, x_cb, arg.X, parity);
+    for (int d=0; d<4; d++) x[d] += arg.border[d];
+
+    Matrix<Cmplx,3> F[6];
+    fmunuSite<Float>(F, arg, x, parity);
+
+    Cmplx I = makeComplex(static_cast<Float>(0.0), static_cast<Float>(1.0));
+    Cmplx coeff = makeComplex(static_cast<Float>(0.0), arg.cloverCoeff);
+    Matrix<Cmplx,3> block1[2];
+    Matrix<Cmplx,3> block2[2];
+    block1[0] = coeff*(F[0]-F[5]);
+    block1[1] = coeff*(F[0]+F[5]);
+    block2[0] = arg.cloverCoeff*(F[1]+F[4] - I*(F[2]-F[3]));
+    block2[1] = arg.cloverCoeff*(F[1]-F[4] - I*(F[2]+F[3]));
+
+    Float A[72];
+    for (int ch=0; ch<2; ch++) {
+      Cmplx triangle[15];
+      for (int i=0; i<3; i++) {
+	A[ch*36+i]   = 0.5*(1.0 - block1[ch](i,i).x);
+	A[ch*36+i+3] = 0.5*(1.0 + block1[ch](i,i).x);
+      }
+
+      triangle[0]  = - block1[ch](1,0);
+      triangle[1]  = - block1[ch](2,0);
+      triangle[2]  = - block1[ch](2,1);
+      triangle[3]  =   block2[ch](0,0);
+      triangle[4]  =   block2[ch](0,1);
+      triangle[5]  =   block2[ch](0,2);
+      triangle[6]  =   block2[ch](1,0);
+      triangle[7]  =   block2[ch](1,1);
+      triangle[8]  =   block2[ch](1,2);
+      triangle[9]  =   block1[ch](1,0);
+      triangle[10] =   block2[ch](2,0);
+      triangle[11] =   block2[ch](2,1);
+      triangle[12] =   block2[ch](2,2);
+      triangle[13] =   block1[ch](2,0);
+      triangle[14] =   block1[ch](2,1);
+
+      for (int i=0; i<15; i++) {
+	A[ch*36+6+2*i]     = 0.5*triangle[idtab[i]].x;
+	A[ch*36+6+2*i + 1] = 0.5*triangle[idtab[i]].y;
+      }
+    }
+
+    if (arg.direct) arg.clover.save(A, x_cb, parity);
+
+    double trlog = 0.0;
+    if (arg.invert) {
+      trlog = cloverInvertSite(A);
+      arg.inverse.save(A, x_cb, parity);
+    }
+    return trlog;
+  }
+
+  template <typename Float, typename Gauge, typename Clover>
+  void computeCloverCPU(CloverCPUArg<Float,Gauge,Clover> arg, double trlog[2]) {
+    for (int parity=0; parity<2; parity++) {
+      double sum = 0.0;
+#pragma omp parallel for reduction(+:sum)
+      for (int x=0; x<arg.volumeCB; x++) sum += cloverSite<Float>(arg, x, parity);
+      trlog[parity] = sum;
+    }
+  }
+
+  template <typename Float, typename Gauge>
+  void computeCloverCPU(CloverField &clover, const Gauge &gauge, const GaugeField &meta,
+			double coeff, bool invert, double trlog[2]) {
+    if (clover.Order() == QUDA_PACKED_CLOVER_ORDER) {
+      typedef clover::QDPOrder<Float,72> C;
+      const bool direct = clover.V(false) != NULL;
+      CloverCPUArg<Float,Gauge,C> arg(gauge, C(clover, false), C(clover, invert), meta, clover, coeff, direct, invert);
+      computeCloverCPU<Float>(arg, trlog);
+    } else {
+      errorQuda("Clover field order %d not supported", clover.Order());
+    }
+  }
+
+  template <typename Float>
+  void computeCloverCPU(CloverField &clover, const GaugeField &gauge, double coeff, bool invert, double trlog[2]) {
+    if (gauge.Order() == QUDA_QDP_GAUGE_ORDER) {
+      computeCloverCPU<Float>(clover, gauge::QDPOrder<Float,18>(gauge), gauge, coeff, invert, trlog);
+    } else if (gauge.Order() == QUDA_MILC_GAUGE_ORDER) {
+      computeCloverCPU<Float>(clover, gauge::MILCOrder<Float,18>(gauge), gauge, coeff, invert, trlog);
+    } else {
+      errorQuda("Gauge field order %d not supported", gauge.Order());
+    }
+  }
+
+  template <typename Float, typename Clover>
+  void cloverInvertCPU(Clover inverse, const Clover clover, int volumeCB, double trlog[2]) {
+    for (int parity=0; parity<2; parity++) {
+      double sum = 0.0;
+#pragma omp parallel for reduction(+:sum)
+      for (int x=0; x<volumeCB; x++) {
+	Float A[72];
+	clover.load(A, x, parity);
+	sum += cloverInvertSite(A);
+	inverse.save(A, x, parity);
+      }
+      trlog[parity] = sum;
+    }
+  }
+
+  template <typename Float>
+  void cloverInvertCPU(CloverField &clover, double trlog[2]) {
+    if (clover.Order() == QUDA_PACKED_CLOVER_ORDER) {
+      typedef clover::QDPOrder<Float,72> C;
+      cloverInvertCPU<Float>(C(clover, true), C(clover, false), clover.VolumeCB(), trlog);
+    } else {
+      errorQuda("Clover field order %d not supported", clover.Order());
+    }
+  }
+
+#endif // GPU_CLOVER_DIRAC
+
+  void computeCloverCPU(CloverField &clover, const GaugeField &gauge, double coeff, bool invert, bool computeTraceLog)
+  {
+#ifdef GPU_CLOVER_DIRAC
+    if (clover.Precision() != gauge.Precision())
+      errorQuda("Clover precision %d must match gauge precision %d", clover.Precision(), gauge.Precision());
+
+    if (typeid(clover) != typeid(cpuCloverField) || gauge.Location() != QUDA_CPU_FIELD_LOCATION)
+      errorQuda("Host clover construction requires host fields");
+
+    if (clover.Twisted()) errorQuda("Twisted clover not supported");
+
+    if (invert && !clover.V(true)) errorQuda("Clover field has no inverse allocated");
+
+    if (gauge.Reconstruct() != QUDA_RECONSTRUCT_NO)
+      errorQuda("Reconstruction type %d not supported", gauge.Reconstruct());
+
+#ifdef MULTI_GPU
+    for (int d=0; d<4; d++) {
+      if (commDimPartitioned(d) && gauge.X()[d] == clover.X()[d])
+	errorQuda("Extended gauge field required for partitioned dimension %d", d);
+    }
+#endif
+
+    double trlog[2] = {0.0, 0.0};
+    if (clover.Precision() == QUDA_DOUBLE_PRECISION) {
+      computeCloverCPU<double>(clover, gauge, coeff, invert, trlog);
+    } else if (clover.Precision() == QUDA_SINGLE_PRECISION) {
+      computeCloverCPU<float>(clover, gauge, coeff, invert, trlog);
+    } else {
+      errorQuda("Precision %d not supported", clover.Precision());
+    }
+
+    if (invert && computeTraceLog) {
+      reduceDoubleArray(trlog, 2);
+      clover.TrLog()[0] = trlog[0];
+      clover.TrLog()[1] = trlog[1];
+    }
+#else
+    errorQuda("Clover has not been built");
+#endif
+  }
+
+  void cloverInvertCPU(CloverField &clover, bool computeTraceLog)
+  {
+#ifdef GPU_CLOVER_DIRAC
+    if (typeid(clover) != typeid(cpuCloverField)) errorQuda("Host clover inversion requires a host field");
+    if (clover.Twisted()) errorQuda("Twisted clover not supported");
+    if (!clover.V(false) || !clover.V(true)) errorQuda("Clover field must have both direct and inverse allocated");
+
+    double trlog[2] = {0.0, 0.0};
+    if (clover.Precision() == QUDA_DOUBLE_PRECISION) {
+      cloverInvertCPU<double>(clover, trlog);
+    } else if (clover.Precision() == QUDA_SINGLE_PRECISION) {
+      cloverInvertCPU<float>(clover, trlog);
+    } else {
+      errorQuda("Precision %d not supported", clover.Precision());
+    }
+
+    if (computeTraceLog) {
+      reduceDoubleArray(trlog, 2);
+      clover.TrLog()[0] = trlog[0];
+      clover.TrLog()[1] = trlog[1];
+    }
+#else
+    errorQuda("Clover has not been built");
+#endif
+  }
+
+} // namespace quda
@@ -284,6 +284,11 @@ namespace quda {
   void cloverInvert(CloverField &clover, bool computeTraceLog, QudaFieldLocation location) {
 
 #ifdef GPU_CLOVER_DIRAC
+    if (location == QUDA_CPU_FIELD_LOCATION && clover.Order() == QUDA_PACKED_CLOVER_ORDER) {
+      cloverInvertCPU(clover, computeTraceLog);
+      return;
+    }
+
     if (clover.Precision() == QUDA_HALF_PRECISION && clover.Order() > 4) 
       errorQuda("Half precision not supported for order %d", clover.Order());
 
@@ -0,0 +1,54 @@
+#include <multigrid.h>
+#include <dense_linalg.h>
+#include <comm_quda.h>
+
+namespace quda {
+
+  bool CoarseLU::Supported(const DiracCoarse &dirac, int max_dim) {
+    // the factorization is held redundantly, so the operator may not be distributed
+    for (int d=0; d<4; d++) if (comm_dim_partitioned(d)) return false;
+    return dirac.Dimension() <= max_dim;
+  }
+
+  CoarseLU::CoarseLU(const DiracCoarse &dirac, SolverParam &param, TimeProfile &profile)
+    : Solver(param, profile), n(dirac.Dimension()), tmp(0) {
+
+    profile.TPSTART(QUDA_PROFILE_INIT);
+    if (getVerbosity() >= QUDA_VERBOSE) printfQuda("Factorizing the coarse operator of order %d\n", n);
+
+    LU.assign((size_t)n*n, Complex(0.0, 0.0));
+    ipiv.resize(n);
+    dirac.createMatrix(&LU[0], n);
+
+    int info = luFactor(&LU[0], n, n, &ipiv[0]);
+    if (info != 0) errorQuda("Coarse operator is singular (U(%d,%d) = 0)", info-1, info-1);
+    profile.TPSTOP(QUDA_PROFILE_INIT);
+  }
+
+  CoarseLU::~CoarseLU() {
+    if (tmp) delete tmp;
+  }
+
+  void CoarseLU::operator()(ColorSpinorField &out, ColorSpinorField &in) {
+    profile.TPSTART(QUDA_PROFILE_COMPUTE);
+
+    if (!tmp) {
+      ColorSpinorParam csParam(in);
+      csParam.create = QUDA_NULL_FIELD_CREATE;
+      csParam.location = QUDA_CPU_FIELD_LOCATION;
+      csParam.fieldOrder = QUDA_SPACE_SPIN_COLOR_FIELD_ORDER;
+      csParam.precision = QUDA_DOUBLE_PRECISION;
+      csParam.pad = 0;
+      tmp = ColorSpinorField::Create(csParam);
+      if (tmp->Length() != 2*(size_t)n) errorQuda("Field length %lu does not match matrix order %d", tmp->Length(), n);
+    }
+
+    // the host field layout matches the row ordering of the assembled matrix
+    *tmp = in;
+    luSolve(static_cast<Complex*>(tmp->V()), &LU[0], n, n, &ipiv[0]);
+    out = *tmp;
+
+    profile.TPSTOP(QUDA_PROFILE_COMPUTE);
+  }
+
+} // namespace quda
@@ -8,92 +8,160 @@
 
 namespace quda {
 
+  /**
+     Small dense complex matrix product C += A B, or C += A^dagger B,
+     with all matrices row major: C is m x n, B is k x n and A is m x k
+     (k x m when dagger is set).  The innermost loop runs over the
+     contiguous columns of B and C so it can be vectorized.
+   */
+  template <typename Float, int m, int n, int k, bool dagger>
+  inline void smallGemm(complex<Float> *C, const complex<Float> *A, const complex<Float> *B) {
+    for (int i=0; i<m; i++) {
+      for (int l=0; l<k; l++) {
+	const complex<Float> a = dagger ? conj(A[l*m+i]) : A[i*k+l];
+	for (int j=0; j<n; j++) C[i*n+j] += a * B[l*n+j];
+      }
+    }
+  }
+
   //Compute "coarse coarse" UV
   //FIXME: Should be merged with computeUV to avoid code duplication.  Use C++ traits.
-  template<typename Float, int dim, typename F, typename fineGauge>
-  void computeUVcoarse(F &UV, const F &V, const fineGauge &G, int ndim, const int *x_size, int s_col, const int *comm_dim) {
-        
-    int coord[5];
-    coord[4] = 0;
-
-    for (int parity=0; parity<2; parity++) {
-      for (int x_cb=0; x_cb<V.VolumeCB(); x_cb++) {
-	getCoords(coord, x_cb, x_size, parity);
-
-	if ( comm_dim[dim] && (coord[dim] + 1 >= x_size[dim]) ) {
-	  int nFace = 1;
-	  int ghost_idx = ghostFaceIndex<1>(coord, x_size, dim, nFace);
-	  for(int s = 0; s < V.Nspin(); s++) {  //Fine Spin row
-	    for(int ic_c = 0; ic_c < V.Nvec(); ic_c++) {  //Coarse Color
-	      for(int ic = 0; ic < G.NcolorCoarse(); ic++) { //Fine Color rows of gauge field
-		for(int jc = 0; jc < G.NcolorCoarse(); jc++) {  //Fine Color columns of gauge field
-		  UV(parity, x_cb, s, ic, ic_c) += G(dim, parity, x_cb, s, s_col, ic, jc) * V.Ghost(dim, 1, (parity+1)&1, ghost_idx, s_col, jc, ic_c);
-		}  //Fine color columns
-	      }  //Fine color rows
-	    }  //Coarse color
-	  }  //Fine Spin row
-	} else {
-	  int y_cb = linkIndexP1(coord, x_size, dim);
-	  for(int s = 0; s < V.Nspin(); s++) {  //Fine Spin row
-	    for(int ic_c = 0; ic_c < V.Nvec(); ic_c++) {  //Coarse Color
-	      for(int ic = 0; ic < G.NcolorCoarse(); ic++) { //Fine Color rows of gauge field
-		for(int jc = 0; jc < G.NcolorCoarse(); jc++) {  //Fine Color columns of gauge field
-		  UV(parity, x_cb, s, ic, ic_c) += G(dim, parity, x_cb, s, s_col, ic, jc) * V((parity+1)&1, y_cb, s_col, jc, ic_c);
-		}  //Fine color columns
-	      }  //Fine color rows
-	    }  //Coarse color
-	  }  //Fine Spin row
-	}
-      } // c/b volume
-    } // parity
+  //Each site is independent, so sites are distributed over threads
+  //and each site's product is done on local copies of its blocks.
+  template<typename Float, int dim, int fineSpin, int fineColor, int coarseColor, typename F, typename fineGauge>
+  void computeUVcoarse(F &UV, const F &V, const fineGauge &G, const int *x_size, int s_col, const int *comm_dim) {
+
+#pragma omp parallel for
+    for (int site=0; site<2*V.VolumeCB(); site++) {
+      const int parity = site / V.VolumeCB();
+      const int x_cb = site - parity*V.VolumeCB();
+
+      int coord[5];
+      coord[4] = 0;
+      getCoords(coord, x_cb, x_size, parity);
+
+      complex<Float> v[fineColor*coarseColor];
+      complex<Float> g[fineColor*fineColor];
+      complex<Float> uv[fineColor*coarseColor];
+
+      if ( comm_dim[dim] && (coord[dim] + 1 >= x_size[dim]) ) {
+	int nFace = 1;
+	int ghost_idx = ghostFaceIndex<1>(coord, x_size, dim, nFace);
+	for(int jc = 0; jc < fineColor; jc++)
+	  for(int ic_c = 0; ic_c < coarseColor; ic_c++)
+	    v[jc*coarseColor+ic_c] = V.Ghost(dim, 1, (parity+1)&1, ghost_idx, s_col, jc, ic_c);
+      } else {
+	int y_cb = linkIndexP1(coord, x_size, dim);
+	for(int jc = 0; jc < fineColor; jc++)
+	  for(int ic_c = 0; ic_c < coarseColor; ic_c++)
+	    v[jc*coarseColor+ic_c] = V((parity+1)&1, y_cb, s_col, jc, ic_c);
+      }
+
+      for(int s = 0; s < fineSpin; s++) {  //Fine Spin row
+	for(int ic = 0; ic < fineColor; ic++)
+	  for(int jc = 0; jc < fineColor; jc++)
+	    g[ic*fineColor+jc] = G(dim, parity, x_cb, s, s_col, ic, jc);
+
+	for(int i = 0; i < fineColor*coarseColor; i++) uv[i] = static_cast<Float>(0.0);
+	smallGemm<Float,fineColor,coarseColor,fineColor,false>(uv, g, v);
+
+	for(int ic = 0; ic < fineColor; ic++)
+	  for(int ic_c = 0; ic_c < coarseColor; ic_c++)
+	    UV(parity, x_cb, s, ic, ic_c) += uv[ic*coarseColor+ic_c];
+      }  //Fine Spin row
+    } // site
 
   }  //UV
 
-  template<typename Float, int dir, typename F, typename coarseGauge, typename fineGauge>
-  void computeVUVcoarse(coarseGauge &Y, coarseGauge &X, const F &UV, const F &V, 
-			const fineGauge &G, const int *x_size,
-			const int *xc_size, const int *geo_bs, int spin_bs, int s_col) {
+  /**
+     Computes the coarse-lattice coordinate and checkerboard index of
+     coarse site coarse_idx (lexicographic), and the fine-lattice
+     coordinate and checkerboard index of site b (lexicographic) of its
+     aggregate.
+   */
+  inline void aggregateSite(int coord[], int &parity, int &x_cb, int coarse_idx, int b,
+			    const int *x_size, const int *xc_size, const int *geo_bs) {
+    for (int d=0; d<4; d++) {
+      coord[d] = (coarse_idx % xc_size[d]) * geo_bs[d] + b % geo_bs[d];
+      coarse_idx /= xc_size[d];
+      b /= geo_bs[d];
+    }
+    parity = (coord[0] + coord[1] + coord[2] + coord[3]) & 1;
+    x_cb = (((coord[3]*x_size[2] + coord[2])*x_size[1] + coord[1])*x_size[0] + coord[0]) >> 1;
+  }
+
+  //The coarse sites are distributed over threads.  Each thread sums
+  //V^dagger UV over the fine sites of its aggregate into local
+  //accumulators, so the coarse links are written once per aggregate
+  //and no two threads write the same coarse site.
+  template<typename Float, int dir, int fineSpin, int fineColor, int coarseColor, typename F, typename coarseGauge>
+  void computeVUVcoarse(coarseGauge &Y, coarseGauge &X, const F &UV, const F &V,
+			const int *x_size, const int *xc_size, const int *geo_bs, int s_col) {
 
     const int nDim = 4;
-    int coord[QUDA_MAX_DIM];
-    int coord_coarse[QUDA_MAX_DIM];
     int coarse_size = 1;
-    for(int d = 0; d<nDim; d++) coarse_size *= xc_size[d];
+    int block_size = 1;
+    for(int d = 0; d<nDim; d++) {
+      coarse_size *= xc_size[d];
+      block_size *= geo_bs[d];
+    }
+
+#pragma omp parallel for
+    for (int coarse_idx=0; coarse_idx<coarse_size; coarse_idx++) {
+      int coord[QUDA_MAX_DIM];
+      int coord_coarse[QUDA_MAX_DIM];
+      int rem = coarse_idx;
+      for (int d=0; d<nDim; d++) {
+	coord_coarse[d] = rem % xc_size[d];
+	rem /= xc_size[d];
+      }
+
+      int coarse_parity = 0;
+      for (int d=0; d<nDim; d++) coarse_parity += coord_coarse[d];
+      coarse_parity &= 1;
+      int coarse_x_cb = ((coord_coarse[3]*xc_size[2]+coord_coarse[2])*xc_size[1]+coord_coarse[1])*(xc_size[0]/2) + coord_coarse[0]/2;
+
+      complex<Float> accX[fineSpin][coarseColor*coarseColor];
+      complex<Float> accY[fineSpin][coarseColor*coarseColor];
+      for (int s = 0; s < fineSpin; s++) {
+	for (int i = 0; i < coarseColor*coarseColor; i++) {
+	  accX[s][i] = static_cast<Float>(0.0);
+	  accY[s][i] = static_cast<Float>(0.0);
+	}
+      }
+
+      complex<Float> v[fineColor*coarseColor];
+      complex<Float> uv[fineColor*coarseColor];
 
-    for (int parity=0; parity<2; parity++) {
-      for (int x_cb=0; x_cb<UV.VolumeCB(); x_cb++) {
-	getCoords(coord, x_cb, x_size, parity);
-	for (int d=0; d < nDim; d++) coord_coarse[d] = coord[d]/geo_bs[d];
+      for (int b=0; b<block_size; b++) {
+	int parity, x_cb;
+	aggregateSite(coord, parity, x_cb, coarse_idx, b, x_size, xc_size, geo_bs);
 
 	//Check to see if we are on the edge of a block, i.e.
 	//if this color matrix connects adjacent blocks.  If
 	//adjacent site is in same block, M = X, else M = Y
 	const bool isDiagonal = ((coord[dir]+1)%x_size[dir])/geo_bs[dir] == coord_coarse[dir] ? true : false;
-	coarseGauge &M =  isDiagonal ? X : Y;
-	const int dim_index = isDiagonal ? 0 : dir;
-              
-	int coarse_parity = 0;
-	for (int d=0; d<nDim; d++) coarse_parity += coord_coarse[d];
-	coarse_parity &= 1;
-	coord_coarse[0] /= 2;
-	int coarse_x_cb = ((coord_coarse[3]*xc_size[2]+coord_coarse[2])*xc_size[1]+coord_coarse[1])*(xc_size[0]/2) + coord_coarse[0];
-
-	coord[0] /= 2;
-
-	for(int s = 0; s < V.Nspin(); s++) { //Loop over fine spin row
-
-	  for(int ic_c = 0; ic_c < Y.NcolorCoarse(); ic_c++) { //Coarse Color row
-	    for(int jc_c = 0; jc_c < Y.NcolorCoarse(); jc_c++) { //Coarse Color column
-	      for(int ic = 0; ic < G.NcolorCoarse(); ic++) { //Sum over fine color
-		M(dim_index,coarse_parity,coarse_x_cb,s,s_col,ic_c,jc_c) +=
-		  conj(V(parity, x_cb, s, ic, ic_c)) * UV(parity, x_cb, s, ic, jc_c);
-	      } //Fine color
-	    } //Coarse Color column
-	  } //Coarse Color row
-	} //Fine spin
 
-      } // c/b volume
-    } // parity
+	for(int s = 0; s < fineSpin; s++) { //Loop over fine spin row
+	  for(int ic = 0; ic < fineColor; ic++) {
+	    for(int ic_c = 0; ic_c < coarseColor; ic_c++) {
+	      v[ic*coarseColor+ic_c] = V(parity, x_cb, s, ic, ic_c);
+	      uv[ic*coarseColor+ic_c] = UV(parity, x_cb, s, ic, ic_c);
+	    }
+	  }
+	  smallGemm<Float,coarseColor,coarseColor,fineColor,true>(isDiagonal ? accX[s] : accY[s], v, uv);
+	} //Fine spin
+      } // aggregate
+
+      for(int s = 0; s < fineSpin; s++) {
+	for(int ic_c = 0; ic_c < coarseColor; ic_c++) { //Coarse Color row
+	  for(int jc_c = 0; jc_c < coarseColor; jc_c++) { //Coarse Color column
+	    X(0,coarse_parity,coarse_x_cb,s,s_col,ic_c,jc_c) += accX[s][ic_c*coarseColor+jc_c];
+	    Y(dir,coarse_parity,coarse_x_cb,s,s_col,ic_c,jc_c) += accY[s][ic_c*coarseColor+jc_c];
+	  } //Coarse Color column
+	} //Coarse Color row
+      } //Fine spin
+    } // coarse volume
 
   }
 
@@ -104,41 +172,42 @@ namespace quda {
   template<typename Float, int nSpin, int nColor, typename Gauge>
   void createCoarseLocal(Gauge &X, int ndim, const int *xc_size, double kappa) {
     Float kap = (Float) kappa;
-    complex<Float> Xlocal[nSpin*nSpin*nColor*nColor];
-	
-    for (int parity=0; parity<2; parity++) {
-      for (int x_cb=0; x_cb<X.VolumeCB(); x_cb++) {
 
-	for(int s_row = 0; s_row < nSpin; s_row++) { //Spin row
-	  for(int s_col = 0; s_col < nSpin; s_col++) { //Spin column
+#pragma omp parallel for
+    for (int site=0; site<2*X.VolumeCB(); site++) {
+      const int parity = site / X.VolumeCB();
+      const int x_cb = site - parity*X.VolumeCB();
+      complex<Float> Xlocal[nSpin*nSpin*nColor*nColor];
+
+      for(int s_row = 0; s_row < nSpin; s_row++) { //Spin row
+	for(int s_col = 0; s_col < nSpin; s_col++) { //Spin column
 	    
-	    //Copy the Hermitian conjugate term to temp location 
-	    for(int ic_c = 0; ic_c < nColor; ic_c++) { //Color row
-	      for(int jc_c = 0; jc_c < nColor; jc_c++) { //Color column
-		//Flip s_col, s_row on the rhs because of Hermitian conjugation.  Color part left untransposed.
-		Xlocal[((nSpin*s_col+s_row)*nColor+ic_c)*nColor+jc_c] = X(0,parity,x_cb,s_row, s_col, ic_c, jc_c);
-	      }	
-	    }
+	  //Copy the Hermitian conjugate term to temp location 
+	  for(int ic_c = 0; ic_c < nColor; ic_c++) { //Color row
+	    for(int jc_c = 0; jc_c < nColor; jc_c++) { //Color column
+	      //Flip s_col, s_row on the rhs because of Hermitian conjugation.  Color part left untransposed.
+	      Xlocal[((nSpin*s_col+s_row)*nColor+ic_c)*nColor+jc_c] = X(0,parity,x_cb,s_row, s_col, ic_c, jc_c);
+	    }	
 	  }
 	}
+      }
 	      
-	for(int s_row = 0; s_row < nSpin; s_row++) { //Spin row
-	  for(int s_col = 0; s_col < nSpin; s_col++) { //Spin column
+      for(int s_row = 0; s_row < nSpin; s_row++) { //Spin row
+	for(int s_col = 0; s_col < nSpin; s_col++) { //Spin column
 	    
-	    const Float sign = (s_row == s_col) ? static_cast<Float>(1.0) : static_cast<Float>(-1.0);
+	  const Float sign = (s_row == s_col) ? static_cast<Float>(1.0) : static_cast<Float>(-1.0);
 		  
-	    for(int ic_c = 0; ic_c < nColor; ic_c++) { //Color row
-	      for(int jc_c = 0; jc_c < nColor; jc_c++) { //Color column
-		//Transpose color part
-		X(0,parity,x_cb,s_row,s_col,ic_c,jc_c) =  
-		  -2*kap*(sign*X(0,parity,x_cb,s_row,s_col,ic_c,jc_c)+conj(Xlocal[((nSpin*s_row+s_col)*nColor+jc_c)*nColor+ic_c]));
-	      } //Color column
-	    } //Color row
-	  } //Spin column
-	} //Spin row
-
-      } // x_cb
-    } //parity
+	  for(int ic_c = 0; ic_c < nColor; ic_c++) { //Color row
+	    for(int jc_c = 0; jc_c < nColor; jc_c++) { //Color column
+	      //Transpose color part
+	      X(0,parity,x_cb,s_row,s_col,ic_c,jc_c) =  
+		-2*kap*(sign*X(0,parity,x_cb,s_row,s_col,ic_c,jc_c)+conj(Xlocal[((nSpin*s_row+s_col)*nColor+jc_c)*nColor+ic_c]));
+	    } //Color column
+	  } //Color row
+	} //Spin column
+      } //Spin row
+
+    } // site
 
   }
 
@@ -146,6 +215,7 @@ namespace quda {
   template<typename Float, typename F>
   void setZero(F &f) {
     for(int parity = 0; parity < 2; parity++) {
+#pragma omp parallel for
       for(int x_cb = 0; x_cb < f.Volume()/2; x_cb++) {
 	for(int s = 0; s < f.Nspin(); s++) {
 	  for(int c = 0; c < f.Ncolor(); c++) {
@@ -159,50 +229,81 @@ namespace quda {
   }
 
   //Restrict the local clover term from the coarse lattice to the "coarse-coarse" lattice
-  template<typename Float, typename coarseGauge, typename F, typename fineGauge>
-  void createCoarseClover(coarseGauge &X, F &V, fineGauge &C, int ndim, const int *x_size, const int *xc_size, const int *geo_bs, int spin_bs)  {
+  //Threaded over the coarse sites as in computeVUVcoarse, with the
+  //triple product V^dagger C V of each fine site done as two small
+  //matrix products.
+  template<typename Float, int fineSpin, int fineColor, int coarseColor, typename coarseGauge, typename F, typename fineGauge>
+  void createCoarseClover(coarseGauge &X, F &V, fineGauge &C, const int *x_size, const int *xc_size, const int *geo_bs)  {
 
     const int nDim = 4;
-    int coord[QUDA_MAX_DIM];
-    int coord_coarse[QUDA_MAX_DIM];
     int coarse_size = 1;
-    for(int d = 0; d<nDim; d++) coarse_size *= xc_size[d];
+    int block_size = 1;
+    for(int d = 0; d<nDim; d++) {
+      coarse_size *= xc_size[d];
+      block_size *= geo_bs[d];
+    }
+
+#pragma omp parallel for
+    for (int coarse_idx=0; coarse_idx<coarse_size; coarse_idx++) {
+      int coord[QUDA_MAX_DIM];
+      int coord_coarse[QUDA_MAX_DIM];
+      int rem = coarse_idx;
+      for (int d=0; d<nDim; d++) {
+	coord_coarse[d] = rem % xc_size[d];
+	rem /= xc_size[d];
+      }
+
+      int coarse_parity = 0;
+      for (int d=0; d<nDim; d++) coarse_parity += coord_coarse[d];
+      coarse_parity &= 1;
+      int coarse_x_cb = ((coord_coarse[3]*xc_size[2]+coord_coarse[2])*xc_size[1]+coord_coarse[1])*(xc_size[0]/2) + coord_coarse[0]/2;
+
+      complex<Float> acc[fineSpin*fineSpin][coarseColor*coarseColor];
+      for (int i = 0; i < fineSpin*fineSpin; i++)
+	for (int j = 0; j < coarseColor*coarseColor; j++) acc[i][j] = static_cast<Float>(0.0);
 
-    for (int parity=0; parity<2; parity++) {
-      for (int x_cb = 0; x_cb<C.VolumeCB(); x_cb++) {
-	getCoords(coord, x_cb, x_size, parity);
-	for (int d=0; d<nDim; d++) coord_coarse[d] = coord[d]/geo_bs[d];
+      complex<Float> v[fineSpin][fineColor*coarseColor];
+      complex<Float> c[fineColor*fineColor];
+      complex<Float> cv[fineColor*coarseColor];
 
-	int coarse_parity = 0;
-	for (int d=0; d<nDim; d++) coarse_parity += coord_coarse[d];
-	coarse_parity &= 1;
-	coord_coarse[0] /= 2;
-	int coarse_x_cb = ((coord_coarse[3]*xc_size[2]+coord_coarse[2])*xc_size[1]+coord_coarse[1])*(xc_size[0]/2) + coord_coarse[0];
+      for (int b=0; b<block_size; b++) {
+	int parity, x_cb;
+	aggregateSite(coord, parity, x_cb, coarse_idx, b, x_size, xc_size, geo_bs);
 
-	coord[0] /= 2;
+	for(int s = 0; s < fineSpin; s++)
+	  for(int ic = 0; ic < fineColor; ic++)
+	    for(int ic_c = 0; ic_c < coarseColor; ic_c++)
+	      v[s][ic*coarseColor+ic_c] = V(parity, x_cb, s, ic, ic_c);
 
 	//If Nspin != 4, then spin structure is a dense matrix
 	//N.B. assumes that no further spin blocking is done in this case.
-	for(int s = 0; s < V.Nspin(); s++) { //Loop over fine spin row
-	  for(int s_col = 0; s_col < V.Nspin(); s_col++) { //Loop over fine spin column
-	    for(int ic_c = 0; ic_c < X.NcolorCoarse(); ic_c++) { //Coarse Color row
-	      for(int jc_c = 0; jc_c < X.NcolorCoarse(); jc_c++) { //Coarse Color column
-		for(int ic = 0; ic < C.NcolorCoarse(); ic++) { //Sum over fine color row
-		  for(int jc = 0; jc < C.NcolorCoarse(); jc++) {  //Sum over fine color column
-		    X(0,coarse_parity,coarse_x_cb,s,s_col,ic_c,jc_c) += conj(V(parity, x_cb, s, ic, ic_c)) * C(0, parity, x_cb, s, s_col, ic, jc) * V(parity, x_cb, s_col, jc, jc_c);
-		  } //Fine color column
-		}  //Fine color row
-	      } //Coarse Color column
-	    } //Coarse Color row
+	for(int s = 0; s < fineSpin; s++) { //Loop over fine spin row
+	  for(int s_col = 0; s_col < fineSpin; s_col++) { //Loop over fine spin column
+	    for(int ic = 0; ic < fineColor; ic++)
+	      for(int jc = 0; jc < fineColor; jc++)
+		c[ic*fineColor+jc] = C(0, parity, x_cb, s, s_col, ic, jc);
+
+	    for(int i = 0; i < fineColor*coarseColor; i++) cv[i] = static_cast<Float>(0.0);
+	    smallGemm<Float,fineColor,coarseColor,fineColor,false>(cv, c, v[s_col]);
+	    smallGemm<Float,coarseColor,coarseColor,fineColor,true>(acc[s*fineSpin+s_col], v[s], cv);
 	  }  //Fine spin column
 	} //Fine spin
+      } // aggregate
 
-      } // c/b volume
-    } // parity
+      for(int s = 0; s < fineSpin; s++) {
+	for(int s_col = 0; s_col < fineSpin; s_col++) {
+	  for(int ic_c = 0; ic_c < coarseColor; ic_c++) { //Coarse Color row
+	    for(int jc_c = 0; jc_c < coarseColor; jc_c++) { //Coarse Color column
+	      X(0,coarse_parity,coarse_x_cb,s,s_col,ic_c,jc_c) += acc[s*fineSpin+s_col][ic_c*coarseColor+jc_c];
+	    } //Coarse Color column
+	  } //Coarse Color row
+	}
+      }
+    } // coarse volume
 
   }
 
-  template<typename Float, int coarseSpin, int coarseColor,
+  template<typename Float, int fineSpin, int fineColor, int coarseSpin, int coarseColor,
 	   typename F, typename coarseGauge, typename fineGauge>
   void calculateYcoarse(coarseGauge &Y, coarseGauge &X, F &UV, F &V, fineGauge &G, fineGauge &C,
 			const int *xx_size, const int *xc_size, double kappa) {
@@ -220,27 +321,28 @@ namespace quda {
 
     int geo_bs[QUDA_MAX_DIM]; 
     for(int d = 0; d < nDim; d++) geo_bs[d] = x_size[d]/xc_size[d];
-    int spin_bs = V.Nspin()/Y.NspinCoarse();
+    if (V.Nspin() != fineSpin || G.NcolorCoarse() != fineColor || V.Nvec() != coarseColor)
+      errorQuda("Unexpected field dimensions Nspin=%d Ncolor=%d Nvec=%d", V.Nspin(), G.NcolorCoarse(), V.Nvec());
 
     for(int d = 0; d < nDim; d++) {
-      for(int s = 0; s < V.Nspin(); s++) {
+      for(int s = 0; s < fineSpin; s++) {
         //First calculate UV
         setZero<Float,F>(UV);
 
         printfQuda("Computing %d UV and VUV s=%d\n", d, s);
         //Calculate UV and then VUV for this direction, accumulating directly into the coarse gauge field Y
         if (d==0) {
-          computeUVcoarse<Float,0>(UV, V, G, nDim, x_size, s, comm_dim);
-          computeVUVcoarse<Float,0>(Y, X, UV, V, G, x_size, xc_size, geo_bs, spin_bs, s);
+          computeUVcoarse<Float,0,fineSpin,fineColor,coarseColor>(UV, V, G, x_size, s, comm_dim);
+          computeVUVcoarse<Float,0,fineSpin,fineColor,coarseColor>(Y, X, UV, V, x_size, xc_size, geo_bs, s);
         } else if (d==1) {
-          computeUVcoarse<Float,1>(UV, V, G, nDim, x_size, s, comm_dim);
-          computeVUVcoarse<Float,1>(Y, X, UV, V, G, x_size, xc_size, geo_bs, spin_bs, s);
+          computeUVcoarse<Float,1,fineSpin,fineColor,coarseColor>(UV, V, G, x_size, s, comm_dim);
+          computeVUVcoarse<Float,1,fineSpin,fineColor,coarseColor>(Y, X, UV, V, x_size, xc_size, geo_bs, s);
         } else if (d==2) {
-          computeUVcoarse<Float,2>(UV, V, G, nDim, x_size, s, comm_dim);
-          computeVUVcoarse<Float,2>(Y, X, UV, V, G, x_size, xc_size, geo_bs, spin_bs, s);
+          computeUVcoarse<Float,2,fineSpin,fineColor,coarseColor>(UV, V, G, x_size, s, comm_dim);
+          computeVUVcoarse<Float,2,fineSpin,fineColor,coarseColor>(Y, X, UV, V, x_size, xc_size, geo_bs, s);
         } else {
-          computeUVcoarse<Float,3>(UV, V, G, nDim, x_size, s, comm_dim);
-          computeVUVcoarse<Float,3>(Y, X, UV, V, G, x_size, xc_size, geo_bs, spin_bs, s);
+          computeUVcoarse<Float,3,fineSpin,fineColor,coarseColor>(UV, V, G, x_size, s, comm_dim);
+          computeVUVcoarse<Float,3,fineSpin,fineColor,coarseColor>(Y, X, UV, V, x_size, xc_size, geo_bs, s);
         }
       }
       printfQuda("UV2[%d] = %e\n", d, UV.norm2());
@@ -250,7 +352,7 @@ namespace quda {
     printfQuda("Computing coarse diagonal\n");
     createCoarseLocal<Float,coarseSpin,coarseColor>(X, nDim, xc_size, kappa);
 
-    createCoarseClover<Float>(X, V, C, nDim, x_size, xc_size, geo_bs, spin_bs);
+    createCoarseClover<Float,fineSpin,fineColor,coarseColor>(X, V, C, x_size, xc_size, geo_bs);
     printfQuda("X2 = %e\n", X.norm2(0));
   }
 
@@ -272,7 +374,7 @@ namespace quda {
     gCoarse yAccessor(const_cast<GaugeField&>(Y));
     gCoarse xAccessor(const_cast<GaugeField&>(X)); 
 
-    calculateYcoarse<Float,coarseSpin,coarseColor>
+    calculateYcoarse<Float,fineSpin,fineColor,coarseSpin,coarseColor>
       (yAccessor, xAccessor, uvAccessor, vAccessor, gAccessor, cloverAccessor, g.X(), Y.X(), kappa);
   }
 
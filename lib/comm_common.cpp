@@ -193,7 +193,12 @@ int comm_rank_displaced(const Topology *topo, const int displacement[])
 // FIXME: The following routines rely on a "default" topology.
 // They should probably be reworked or eliminated eventually.
 
+#ifdef THREAD_COMMS
+// every thread is a rank with its own position in the topology
+static __thread Topology *default_topo = NULL;
+#else
 Topology *default_topo = NULL;
+#endif
 
 void comm_set_default_topology(Topology *topo)
 {
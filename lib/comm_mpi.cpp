@@ -98,6 +98,14 @@ int comm_rank(void)
 }
 
 
+int comm_serialized_threads(void)
+{
+  int provided;
+  MPI_CHECK( MPI_Query_thread(&provided) );
+  return provided >= MPI_THREAD_SERIALIZED ? 1 : 0;
+}
+
+
 int comm_size(void)
 {
   return size;
@@ -192,7 +200,8 @@ MsgHandle *comm_declare_strided_receive_displaced(void *buffer, const int displa
 
 void comm_free(MsgHandle *mh)
 {
-  MPI_Request_free(&(mh->request));
+  // non-persistent requests (comm_iallreduce) are released on completion
+  if (mh->request != MPI_REQUEST_NULL) MPI_Request_free(&(mh->request));
   if (mh->custom) MPI_Type_free(&(mh->datatype));
   host_free(mh);
 }
@@ -243,6 +252,21 @@ void comm_allreduce_array(double* data, size_t size)
 }
 
 
+MsgHandle *comm_iallreduce(double* data, size_t size)
+{
+  MsgHandle *mh = (MsgHandle *)safe_malloc(sizeof(MsgHandle));
+  mh->custom = false;
+#if MPI_VERSION >= 3
+  MPI_CHECK( MPI_Iallreduce(MPI_IN_PLACE, data, size, MPI_DOUBLE, MPI_SUM, MPI_COMM_WORLD, &(mh->request)) );
+#else
+  // non-blocking collectives need MPI-3, so fall back to a blocking reduction
+  comm_allreduce_array(data, size);
+  mh->request = MPI_REQUEST_NULL;
+#endif
+  return mh;
+}
+
+
 void comm_allreduce_int(int* data)
 {
   int recvbuf;
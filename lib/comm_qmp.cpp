@@ -100,6 +100,13 @@ int comm_gpuid(void)
 }
 
 
+// QMP does not expose the thread level it was initialized with
+int comm_serialized_threads(void)
+{
+  return 0;
+}
+
+
 /**
  * Declare a message handle for sending to a node displaced in (x,y,z,t) according to "displacement"
  */
@@ -226,6 +233,14 @@ void comm_allreduce_array(double* data, size_t size)
 }
 
 
+MsgHandle *comm_iallreduce(double* data, size_t size)
+{
+  // QMP has no non-blocking reduction so this completes immediately
+  QMP_CHECK( QMP_sum_double_array(data, size) );
+  return NULL;
+}
+
+
 void comm_allreduce_int(int* data)
 {
   QMP_CHECK( QMP_sum_int(data) );
@@ -17,6 +17,8 @@ int comm_size(void) { return 1; }
 
 int comm_gpuid(void) { return 0; }
 
+int comm_serialized_threads(void) { return 1; }
+
 MsgHandle *comm_declare_send_displaced(void *buffer, const int displacement[], size_t nbytes) 
 { return NULL; }
 
@@ -47,6 +49,8 @@ void comm_allreduce_array(double* data, size_t size) {}
 
 void comm_allreduce_int(int* data) {}
 
+MsgHandle *comm_iallreduce(double* data, size_t size) { return NULL; }
+
 void comm_broadcast(void *data, size_t nbytes) {}
 
 void comm_barrier(void) {}
@@ -0,0 +1,414 @@
+/**
+ * Threaded communications layer: every rank is a thread in a single
+ * process.  Messages are handed over in shared memory, with the data
+ * copied directly from the send buffer into the receive buffer by
+ * whichever side starts its half of the message last, and the
+ * reductions and broadcasts are done through a shared table of
+ * per-rank buffer pointers.
+ *
+ * The ranks are created with comm_thread_run(), and each thread then
+ * calls initCommsGridQuda() as it would in an MPI job.  Note that
+ * the communications state is per thread but the rest of the library
+ * state is shared by the process, so this is intended for exercising
+ * the partitioned code paths on explicitly created fields, e.g., the
+ * ghost exchanges, rather than for running independent solvers on
+ * each rank.
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <pthread.h>
+#include <deque>
+#include <vector>
+#include <quda_internal.h>
+#include <comm_quda.h>
+
+
+struct MsgHandle_s {
+  /** Buffer being sent from or received into */
+  void *buffer;
+
+  /** Size of each contiguous block in bytes */
+  size_t blksize;
+
+  /** Number of blocks */
+  int nblocks;
+
+  /** Stride between blocks in bytes */
+  size_t stride;
+
+  /** The rank at the other end of the message */
+  int peer;
+
+  /** Whether this is a send or receive handle */
+  bool send;
+
+  /** Whether the current message has been delivered */
+  bool complete;
+};
+
+/**
+   State shared by all ranks.  Messages between a pair of ranks are
+   matched in the order they are started, as for MPI messages with
+   the same tag.
+ */
+struct ThreadComms {
+  int size;
+
+  pthread_mutex_t lock;
+  pthread_cond_t delivered;
+
+  // barrier state
+  pthread_cond_t barrier_cond;
+  int barrier_count;
+  unsigned long barrier_generation;
+
+  // pending sends and receives for each (source, destination) pair
+  std::vector< std::deque<MsgHandle*> > sends;
+  std::vector< std::deque<MsgHandle*> > recvs;
+
+  // per-rank pointers published for the collectives
+  std::vector<void*> slot;
+
+  ThreadComms(int size) : size(size), barrier_count(0), barrier_generation(0),
+			  sends(size*size), recvs(size*size), slot(size, (void*)0)
+  {
+    pthread_mutex_init(&lock, NULL);
+    pthread_cond_init(&delivered, NULL);
+    pthread_cond_init(&barrier_cond, NULL);
+  }
+
+  ~ThreadComms()
+  {
+    pthread_cond_destroy(&barrier_cond);
+    pthread_cond_destroy(&delivered);
+    pthread_mutex_destroy(&lock);
+  }
+};
+
+static ThreadComms *comms = NULL;
+
+static __thread int rank = -1;
+static int device_count = 0;
+
+
+struct ThreadRankArg {
+  int rank;
+  void (*func)(void *);
+  void *arg;
+};
+
+static void *threadRank(void *arg_)
+{
+  ThreadRankArg *arg = static_cast<ThreadRankArg*>(arg_);
+  rank = arg->rank;
+  arg->func(arg->arg);
+  return NULL;
+}
+
+
+void comm_thread_run(int size, void (*func)(void *), void *arg)
+{
+  if (comms) errorQuda("Threaded communications are already running");
+  if (size < 1) errorQuda("Invalid number of ranks %d", size);
+
+  comms = new ThreadComms(size);
+
+  std::vector<pthread_t> threads(size);
+  std::vector<ThreadRankArg> args(size);
+  for (int i=0; i<size; i++) {
+    args[i].rank = i;
+    args[i].func = func;
+    args[i].arg = arg;
+    if (pthread_create(&threads[i], NULL, threadRank, &args[i]))
+      errorQuda("Failed to create thread for rank %d", i);
+  }
+
+  for (int i=0; i<size; i++) pthread_join(threads[i], NULL);
+
+  delete comms;
+  comms = NULL;
+}
+
+
+void comm_init(int ndim, const int *dims, QudaCommsMap rank_from_coords, void *map_data)
+{
+  if (!comms || rank < 0) {
+    errorQuda("Threaded communications must be initialized from a thread created by comm_thread_run()");
+  }
+
+  int grid_size = 1;
+  for (int i = 0; i < ndim; i++) {
+    grid_size *= dims[i];
+  }
+  if (grid_size != comms->size) {
+    errorQuda("Communication grid size declared via initCommsGridQuda() does not match"
+              " total number of threaded ranks (%d != %d)", grid_size, comms->size);
+  }
+
+  Topology *topo = comm_create_topology(ndim, dims, rank_from_coords, map_data);
+  comm_set_default_topology(topo);
+
+  // all ranks are on this host, so they are spread over the devices;
+  // without a device the ranks are not bound to one, which leaves the
+  // communications usable on hosts without a GPU
+  int count = 0;
+  if (cudaGetDeviceCount(&count) != cudaSuccess) {
+    cudaGetLastError(); // clear the error state
+    count = 0;
+  }
+  device_count = count;
+}
+
+
+int comm_rank(void)
+{
+  return rank;
+}
+
+
+int comm_size(void)
+{
+  return comms ? comms->size : 1;
+}
+
+
+int comm_gpuid(void)
+{
+  return device_count ? rank % device_count : 0;
+}
+
+
+// the communications state belongs to the rank threads
+int comm_serialized_threads(void)
+{
+  return 0;
+}
+
+
+static MsgHandle *declare(void *buffer, int peer, bool send, size_t blksize, int nblocks, size_t stride)
+{
+  MsgHandle *mh = (MsgHandle *)safe_malloc(sizeof(MsgHandle));
+  mh->buffer = buffer;
+  mh->blksize = blksize;
+  mh->nblocks = nblocks;
+  mh->stride = stride;
+  mh->peer = peer;
+  mh->send = send;
+  mh->complete = true; // nothing is in flight until the handle is started
+  return mh;
+}
+
+
+/**
+ * Declare a message handle for sending to a node displaced in (x,y,z,t) according to "displacement"
+ */
+MsgHandle *comm_declare_send_displaced(void *buffer, const int displacement[], size_t nbytes)
+{
+  Topology *topo = comm_default_topology();
+  return declare(buffer, comm_rank_displaced(topo, displacement), true, nbytes, 1, nbytes);
+}
+
+
+/**
+ * Declare a message handle for receiving from a node displaced in (x,y,z,t) according to "displacement"
+ */
+MsgHandle *comm_declare_receive_displaced(void *buffer, const int displacement[], size_t nbytes)
+{
+  Topology *topo = comm_default_topology();
+  return declare(buffer, comm_rank_displaced(topo, displacement), false, nbytes, 1, nbytes);
+}
+
+
+/**
+ * Declare a message handle for sending to a node displaced in (x,y,z,t) according to "displacement"
+ */
+MsgHandle *comm_declare_strided_send_displaced(void *buffer, const int displacement[],
+					       size_t blksize, int nblocks, size_t stride)
+{
+  Topology *topo = comm_default_topology();
+  return declare(buffer, comm_rank_displaced(topo, displacement), true, blksize, nblocks, stride);
+}
+
+
+/**
+ * Declare a message handle for receiving from a node displaced in (x,y,z,t) according to "displacement"
+ */
+MsgHandle *comm_declare_strided_receive_displaced(void *buffer, const int displacement[],
+						  size_t blksize, int nblocks, size_t stride)
+{
+  Topology *topo = comm_default_topology();
+  return declare(buffer, comm_rank_displaced(topo, displacement), false, blksize, nblocks, stride);
+}
+
+
+void comm_free(MsgHandle *mh)
+{
+  host_free(mh);
+}
+
+
+/**
+   Copy a message from the send buffer straight into the receive
+   buffer.  When the block structure of the two sides differs the
+   message is gathered into a contiguous buffer first.
+ */
+static void deliver(MsgHandle *recv, const MsgHandle *send)
+{
+  size_t send_bytes = send->blksize * send->nblocks;
+  size_t recv_bytes = recv->blksize * recv->nblocks;
+  if (send_bytes != recv_bytes) {
+    errorQuda("Message size mismatch: rank %d sends %lu bytes but rank %d receives %lu bytes",
+	      recv->peer, send_bytes, send->peer, recv_bytes);
+  }
+
+  if (send->blksize == recv->blksize) {
+    for (int i=0; i<send->nblocks; i++) {
+      memcpy(static_cast<char*>(recv->buffer) + i*recv->stride,
+	     static_cast<const char*>(send->buffer) + i*send->stride, send->blksize);
+    }
+  } else {
+    char *tmp = (char *)safe_malloc(send_bytes);
+    for (int i=0; i<send->nblocks; i++)
+      memcpy(tmp + i*send->blksize, static_cast<const char*>(send->buffer) + i*send->stride, send->blksize);
+    for (int i=0; i<recv->nblocks; i++)
+      memcpy(static_cast<char*>(recv->buffer) + i*recv->stride, tmp + i*recv->blksize, recv->blksize);
+    host_free(tmp);
+  }
+}
+
+
+void comm_start(MsgHandle *mh)
+{
+  const int src = mh->send ? rank : mh->peer;
+  const int dst = mh->send ? mh->peer : rank;
+  const int channel = src*comms->size + dst;
+
+  pthread_mutex_lock(&comms->lock);
+  mh->complete = false;
+  std::deque<MsgHandle*> &match = mh->send ? comms->recvs[channel] : comms->sends[channel];
+  if (match.empty()) {
+    // the other side has not started yet, so it will do the copy
+    (mh->send ? comms->sends[channel] : comms->recvs[channel]).push_back(mh);
+    pthread_mutex_unlock(&comms->lock);
+    return;
+  }
+  MsgHandle *other = match.front();
+  match.pop_front();
+  pthread_mutex_unlock(&comms->lock);
+
+  // both handles are now owned by this thread, so copy outside the lock
+  if (mh->send) deliver(other, mh);
+  else deliver(mh, other);
+
+  pthread_mutex_lock(&comms->lock);
+  mh->complete = true;
+  other->complete = true;
+  pthread_cond_broadcast(&comms->delivered);
+  pthread_mutex_unlock(&comms->lock);
+}
+
+
+void comm_wait(MsgHandle *mh)
+{
+  pthread_mutex_lock(&comms->lock);
+  while (!mh->complete) pthread_cond_wait(&comms->delivered, &comms->lock);
+  pthread_mutex_unlock(&comms->lock);
+}
+
+
+int comm_query(MsgHandle *mh)
+{
+  pthread_mutex_lock(&comms->lock);
+  int query = mh->complete ? 1 : 0;
+  pthread_mutex_unlock(&comms->lock);
+  return query;
+}
+
+
+void comm_barrier(void)
+{
+  pthread_mutex_lock(&comms->lock);
+  unsigned long generation = comms->barrier_generation;
+  if (++comms->barrier_count == comms->size) {
+    comms->barrier_count = 0;
+    comms->barrier_generation++;
+    pthread_cond_broadcast(&comms->barrier_cond);
+  } else {
+    while (generation == comms->barrier_generation) pthread_cond_wait(&comms->barrier_cond, &comms->lock);
+  }
+  pthread_mutex_unlock(&comms->lock);
+}
+
+
+/**
+   Every rank publishes its buffer and then reduces all of the
+   published buffers in rank order, so every rank obtains the same,
+   reproducible, result.  The second barrier stops a rank from
+   overwriting its buffer while another rank is still reading it.
+ */
+template <typename T, typename Reducer>
+static void allreduce(T *data, size_t size, Reducer reduce)
+{
+  std::vector<T> local(data, data+size);
+  comms->slot[rank] = &local[0];
+  comm_barrier();
+
+  for (size_t i=0; i<size; i++) {
+    T sum = static_cast<T*>(comms->slot[0])[i];
+    for (int r=1; r<comms->size; r++) sum = reduce(sum, static_cast<T*>(comms->slot[r])[i]);
+    data[i] = sum;
+  }
+  comm_barrier();
+}
+
+template <typename T> static T reduce_sum(T a, T b) { return a + b; }
+template <typename T> static T reduce_max(T a, T b) { return a > b ? a : b; }
+
+
+void comm_allreduce(double* data)
+{
+  allreduce(data, 1, reduce_sum<double>);
+}
+
+
+void comm_allreduce_max(double* data)
+{
+  allreduce(data, 1, reduce_max<double>);
+}
+
+void comm_allreduce_array(double* data, size_t size)
+{
+  allreduce(data, size, reduce_sum<double>);
+}
+
+
+void comm_allreduce_int(int* data)
+{
+  allreduce(data, 1, reduce_sum<int>);
+}
+
+
+MsgHandle *comm_iallreduce(double* data, size_t size)
+{
+  // the shared-memory reduction is cheap so this completes immediately
+  allreduce(data, size, reduce_sum<double>);
+  return NULL;
+}
+
+
+/**  broadcast from rank 0 */
+void comm_broadcast(void *data, size_t nbytes)
+{
+  if (rank == 0) comms->slot[0] = data;
+  comm_barrier();
+  if (rank != 0) memcpy(data, comms->slot[0], nbytes);
+  comm_barrier();
+}
+
+
+void comm_abort(int status)
+{
+  exit(status);
+}
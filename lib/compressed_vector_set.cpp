@@ -0,0 +1,149 @@
+#include <compressed_vector_set.h>
+#include <malloc_quda.h>
+#include <math.h>
+
+#ifdef _OPENMP
+#include <omp.h>
+#endif
+
+namespace quda {
+
+  /**
+     Helper that resolves the site index of the compressed set to the
+     site in a host field, taking into account that the parities of a
+     full field are stored in the two (aligned) halves of the field.
+   */
+  template <typename Float>
+  struct HostSites {
+    Float *parity[2];
+    const int volumeCB;
+    const int site_reals;
+    HostSites(const ColorSpinorField &x, int site_reals) : volumeCB(x.VolumeCB()), site_reals(site_reals) {
+      parity[0] = static_cast<Float*>(const_cast<void*>(x.V()));
+      parity[1] = x.SiteSubset() == QUDA_FULL_SITE_SUBSET ?
+	reinterpret_cast<Float*>(static_cast<char*>(const_cast<void*>(x.V())) + x.Bytes()/2) : parity[0];
+    }
+    inline Float* operator()(int site) const {
+      return parity[site/volumeCB] + (size_t)(site%volumeCB)*site_reals;
+    }
+  };
+
+  static void checkField(const CompressedVectorSet &set, const ColorSpinorField &x) {
+    if (x.Location() != QUDA_CPU_FIELD_LOCATION) errorQuda("Compressed vector sets only support host fields");
+    if (x.FieldOrder() != set.FieldOrder()) errorQuda("Field order %d does not match set %d", x.FieldOrder(), set.FieldOrder());
+    if (x.VolumeCB() != set.VolumeCB() || (int)x.SiteSubset() != set.Nparity() ||
+	2*x.Nspin()*x.Ncolor() != set.SiteReals())
+      errorQuda("Field geometry does not match compressed vector set");
+  }
+
+  CompressedVectorSet::CompressedVectorSet(const ColorSpinorField &meta, int nVec, int block_sites)
+    : param(meta), nVec(nVec), volumeCB(meta.VolumeCB()), nParity(meta.SiteSubset()),
+      site_reals(2*meta.Nspin()*meta.Ncolor()), block_sites(block_sites),
+      nBlock((nParity*volumeCB + block_sites - 1) / block_sites), data(0), norm(0)
+  {
+    if (meta.FieldOrder() != QUDA_SPACE_SPIN_COLOR_FIELD_ORDER && meta.FieldOrder() != QUDA_SPACE_COLOR_SPIN_FIELD_ORDER)
+      errorQuda("Field order %d not supported", meta.FieldOrder());
+    if (nVec < 1) errorQuda("Invalid number of vectors %d", nVec);
+    if (block_sites < 1) errorQuda("Invalid block size %d", block_sites);
+
+    param.location = QUDA_CPU_FIELD_LOCATION;
+    param.create = QUDA_NULL_FIELD_CREATE;
+
+    data = static_cast<short*>(safe_malloc((size_t)nVec*nParity*volumeCB*site_reals*sizeof(short)));
+    norm = static_cast<float*>(safe_malloc((size_t)nVec*nBlock*sizeof(float)));
+  }
+
+  CompressedVectorSet::CompressedVectorSet(const std::vector<ColorSpinorField*> &B, int block_sites)
+    : CompressedVectorSet(*B[0], B.size(), block_sites)
+  {
+    for (int i=0; i<nVec; i++) Compress(i, *B[i]);
+  }
+
+  CompressedVectorSet::~CompressedVectorSet() {
+    if (data) host_free(data);
+    if (norm) host_free(norm);
+  }
+
+  template <typename Float>
+  static void compress(short *q, float *norm, const HostSites<const Float> &x,
+		       int sites, int site_reals, int block_sites, int nBlock) {
+#pragma omp parallel for
+    for (int b=0; b<nBlock; b++) {
+      const int begin = b*block_sites;
+      const int end = begin + block_sites < sites ? begin + block_sites : sites;
+
+      double max = 0.0;
+      for (int site=begin; site<end; site++) {
+	const Float *v = x(site);
+	for (int j=0; j<site_reals; j++) max = fabs(v[j]) > max ? fabs(v[j]) : max;
+      }
+      norm[b] = max;
+
+      const double scale = max > 0.0 ? MAX_SHORT / max : 0.0;
+      for (int site=begin; site<end; site++) {
+	const Float *v = x(site);
+	short *s = q + (size_t)site*site_reals;
+	for (int j=0; j<site_reals; j++) s[j] = static_cast<short>(lrint(v[j]*scale));
+      }
+    }
+  }
+
+  void CompressedVectorSet::Compress(int i, const ColorSpinorField &x) {
+    checkField(*this, x);
+    short *q = data + (size_t)i*nParity*volumeCB*site_reals;
+    float *n = norm + (size_t)i*nBlock;
+    if (x.Precision() == QUDA_DOUBLE_PRECISION) {
+      compress(q, n, HostSites<const double>(x, site_reals), nParity*volumeCB, site_reals, block_sites, nBlock);
+    } else if (x.Precision() == QUDA_SINGLE_PRECISION) {
+      compress(q, n, HostSites<const float>(x, site_reals), nParity*volumeCB, site_reals, block_sites, nBlock);
+    } else {
+      errorQuda("Precision %d not supported", x.Precision());
+    }
+  }
+
+  template <typename Float>
+  static void decompress(const HostSites<Float> &x, const short *q, const float *norm,
+			 int sites, int site_reals, int block_sites) {
+#pragma omp parallel for
+    for (int site=0; site<sites; site++) {
+      const double scale = norm[site/block_sites] / MAX_SHORT;
+      const short *s = q + (size_t)site*site_reals;
+      Float *v = x(site);
+      for (int j=0; j<site_reals; j++) v[j] = s[j]*scale;
+    }
+  }
+
+  void CompressedVectorSet::Decompress(ColorSpinorField &x, int i) const {
+    checkField(*this, x);
+    if (x.Precision() == QUDA_DOUBLE_PRECISION) {
+      decompress(HostSites<double>(x, site_reals), V(i), Norm(i), nParity*volumeCB, site_reals, block_sites);
+    } else if (x.Precision() == QUDA_SINGLE_PRECISION) {
+      decompress(HostSites<float>(x, site_reals), V(i), Norm(i), nParity*volumeCB, site_reals, block_sites);
+    } else {
+      errorQuda("Precision %d not supported", x.Precision());
+    }
+  }
+
+  CompressedVectorSet* compressVectors(std::vector<ColorSpinorField*> &B, int block_sites) {
+    CompressedVectorSet *B_c = new CompressedVectorSet(B, block_sites);
+    size_t bytes = 0;
+    for (unsigned int i=0; i<B.size(); i++) {
+      bytes += B[i]->Bytes();
+      delete B[i];
+      B[i] = 0;
+    }
+    printfQuda("Compressed %lu null-space vectors from %lu to %lu bytes\n", B.size(), bytes, B_c->Bytes());
+    return B_c;
+  }
+
+  void decompressVectors(std::vector<ColorSpinorField*> &B, CompressedVectorSet *&B_c) {
+    if ((int)B.size() != B_c->Nvec()) errorQuda("Vector count %lu does not match compressed set %d", B.size(), B_c->Nvec());
+    for (int i=0; i<B_c->Nvec(); i++) {
+      B[i] = ColorSpinorField::Create(B_c->Param());
+      B_c->Decompress(*B[i], i);
+    }
+    delete B_c;
+    B_c = 0;
+  }
+
+} // namespace quda
@@ -29,32 +29,37 @@ namespace quda {
   __host__ __device__ inline constexpr int Ncolor(int length) { return ct_sqrt(length/2); }
 
   /**
-     Generic CPU gauge reordering and packing 
+     Generic CPU gauge reordering and packing.  The parity, dimension
+     and site loops are flattened into a single loop that is threaded
+     with OpenMP, with each thread taking a contiguous range of sites
+     so that the host orders are streamed through link by link and any
+     reconstruct compression of the output is done in blocks of sites.
   */
   template <typename FloatOut, typename FloatIn, int length, typename OutOrder, typename InOrder>
   void copyGauge(CopyGaugeArg<OutOrder,InOrder> arg) {  
     typedef typename mapper<FloatIn>::type RegTypeIn;
     typedef typename mapper<FloatOut>::type RegTypeOut;
 
-    for (int parity=0; parity<2; parity++) {
+    const int volumeCB = arg.volume/2;
+    const long total = 2l * arg.geometry * volumeCB;
 
-      for (int d=0; d<arg.geometry; d++) {
-	for (int x=0; x<arg.volume/2; x++) {
+#pragma omp parallel for schedule(static)
+    for (long idx=0; idx<total; idx++) {
+      const int x = idx % volumeCB;
+      const int d = (idx / volumeCB) % arg.geometry;
+      const int parity = idx / ((long)volumeCB * arg.geometry);
 #ifdef FINE_GRAINED_ACCESS
-	  for (int i=0; i<Ncolor(length); i++)
-	    for (int j=0; j<Ncolor(length); j++) {
-	      arg.out(d, parity, x, i, j) = arg.in(d, parity, x, i, j);
-	    }
+      for (int i=0; i<Ncolor(length); i++)
+	for (int j=0; j<Ncolor(length); j++) {
+	  arg.out(d, parity, x, i, j) = arg.in(d, parity, x, i, j);
+	}
 #else
-	  RegTypeIn in[length];
-	  RegTypeOut out[length];
-	  arg.in.load(in, x, d, parity);
-	  for (int i=0; i<length; i++) out[i] = in[i];
-	  arg.out.save(out, x, d, parity);
+      RegTypeIn in[length];
+      RegTypeOut out[length];
+      arg.in.load(in, x, d, parity);
+      for (int i=0; i<length; i++) out[i] = in[i];
+      arg.out.save(out, x, d, parity);
 #endif
-	}
-      }
-
     }
   }
 
@@ -65,29 +70,30 @@ namespace quda {
   void checkNan(Arg arg) {  
     typedef typename mapper<Float>::type RegType;
 
-    for (int parity=0; parity<2; parity++) {
+    const int volumeCB = arg.volume/2;
+    const long total = 2l * arg.geometry * volumeCB;
 
-      for (int d=0; d<arg.geometry; d++) {
-	for (int x=0; x<arg.volume/2; x++) {
+#pragma omp parallel for schedule(static)
+    for (long idx=0; idx<total; idx++) {
+      const int x = idx % volumeCB;
+      const int d = (idx / volumeCB) % arg.geometry;
+      const int parity = idx / ((long)volumeCB * arg.geometry);
 #ifdef FINE_GRAINED_ACCESS
-	  for (int i=0; i<Ncolor(length); i++)
-	    for (int j=0; j<Ncolor(length); j++) {
-              complex<Float> u = arg.in(d, parity, x, i, j);
-	      if (isnan(u.real()))
-	        errorQuda("Nan detected at parity=%d, dir=%d, x=%d, i=%d", parity, d, x, 2*(i*Ncolor(length)+j));
-	      if (isnan(u.imag()))
-		errorQuda("Nan detected at parity=%d, dir=%d, x=%d, i=%d", parity, d, x, 2*(i*Ncolor(length)+j+1));
+      for (int i=0; i<Ncolor(length); i++)
+	for (int j=0; j<Ncolor(length); j++) {
+	  complex<Float> u = arg.in(d, parity, x, i, j);
+	  if (isnan(u.real()))
+	    errorQuda("Nan detected at parity=%d, dir=%d, x=%d, i=%d", parity, d, x, 2*(i*Ncolor(length)+j));
+	  if (isnan(u.imag()))
+	    errorQuda("Nan detected at parity=%d, dir=%d, x=%d, i=%d", parity, d, x, 2*(i*Ncolor(length)+j+1));
 	}
 #else
-	  RegType u[length];
-	  arg.in.load(u, x, d, parity);
-	  for (int i=0; i<length; i++) 
-	    if (isnan(u[i])) 
-	      errorQuda("Nan detected at parity=%d, dir=%d, x=%d, i=%d", parity, d, x, i);
+      RegType u[length];
+      arg.in.load(u, x, d, parity);
+      for (int i=0; i<length; i++) 
+	if (isnan(u[i])) 
+	  errorQuda("Nan detected at parity=%d, dir=%d, x=%d, i=%d", parity, d, x, i);
 #endif
-	}
-      }
-
     }
   }
 
@@ -122,7 +128,8 @@ namespace quda {
   }
 
   /**
-     Generic CPU gauge ghost reordering and packing 
+     Generic CPU gauge ghost reordering and packing.  The face volumes
+     differ between dimensions, so only the site loop is threaded.
   */
   template <typename FloatOut, typename FloatIn, int length, typename OutOrder, typename InOrder>
     void copyGhost(CopyGaugeArg<OutOrder,InOrder> arg) {  
@@ -132,6 +139,7 @@ namespace quda {
     for (int parity=0; parity<2; parity++) {
 
       for (int d=0; d<arg.nDim; d++) {
+#pragma omp parallel for schedule(static)
 	for (int x=0; x<arg.faceVolumeCB[d]; x++) {
 #ifdef FINE_GRAINED_ACCESS
 	  for (int i=0; i<Ncolor(length); i++)
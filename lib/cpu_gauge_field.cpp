@@ -9,6 +9,13 @@ namespace quda {
   cpuGaugeField::cpuGaugeField(const GaugeFieldParam &param) : 
     GaugeField(param), pinned(param.pinned)
   {
+    for (int d=0; d<QUDA_MAX_DIM; d++) {
+      ghost_send[d] = 0;
+      ext_send[d] = 0;
+      ext_recv[d] = 0;
+      ext_bytes[d] = 0;
+    }
+
     if (precision == QUDA_HALF_PRECISION) {
       errorQuda("CPU fields do not support half precision");
     }
@@ -109,36 +116,52 @@ namespace quda {
 	if (ghost[i]) host_free(ghost[i]);
       }
     }
+
+    for (int d=0; d<QUDA_MAX_DIM; d++) {
+      if (ghost_send[d]) host_free(ghost_send[d]);
+      if (ext_send[d]) host_free(ext_send[d]);
+      if (ext_recv[d]) host_free(ext_recv[d]);
+    }
   }
 
   // This does the exchange of the gauge field ghost zone and places it
-  // into the ghost array.
+  // into the ghost array.  The send buffers are allocated on first use
+  // and reused by subsequent exchanges, and all dimensions are
+  // communicated concurrently.
   void cpuGaugeField::exchangeGhost() {
-    void *send[QUDA_MAX_DIM];
-    for (int d=0; d<nDim; d++) send[d] = safe_malloc(nFace*surface[d]*nInternal*precision);
+    for (int d=0; d<nDim; d++) {
+      size_t bytes = nFace*surface[d]*nInternal*precision;
+      if (!ghost_send[d] && bytes) ghost_send[d] = safe_malloc(bytes);
+    }
 
     // get the links into contiguous buffers
-    extractGaugeGhost(*this, send);
+    extractGaugeGhost(*this, ghost_send);
 
     // communicate between nodes
-    exchange(ghost, send);
-
-    for (int d=0; d<nDim; d++) host_free(send[d]);
+    exchange(ghost, ghost_send);
   }
 
   void cpuGaugeField::exchangeExtendedGhost(const int *R, bool no_comms_fill) {
     
-    void *send[QUDA_MAX_DIM];
-    void *recv[QUDA_MAX_DIM];
+    void **send = ext_send;
+    void **recv = ext_recv;
     size_t bytes[QUDA_MAX_DIM];
     // store both parities and directions in each
     for (int d=0; d<nDim; d++) {
       if (!commDimPartitioned(d) && !no_comms_fill) continue;
       bytes[d] = surface[d] * R[d] * geometry * nInternal * precision;
-      send[d] = safe_malloc(2 * bytes[d]);
-      recv[d] = safe_malloc(2 * bytes[d]);
+      if (2*bytes[d] > ext_bytes[d]) {
+	if (send[d]) host_free(send[d]);
+	if (recv[d]) host_free(recv[d]);
+	send[d] = safe_malloc(2 * bytes[d]);
+	recv[d] = safe_malloc(2 * bytes[d]);
+	ext_bytes[d] = 2 * bytes[d];
+      }
     }
 
+    // The dimensions are exchanged in order since the faces extracted
+    // in a given dimension include the halo filled in the preceding
+    // dimensions (this is what fills the corners of the extended region)
     for (int d=0; d<nDim; d++) {
       if (!commDimPartitioned(d) && !no_comms_fill) continue;
       //extract into a contiguous buffer
@@ -179,12 +202,6 @@ namespace quda {
       extractExtendedGaugeGhost(*this, d, R, recv, false);
     }
 
-    for (int d=0; d<nDim; d++) {
-      if (!commDimPartitioned(d) && !no_comms_fill) continue;
-      host_free(send[d]);
-      host_free(recv[d]);
-    }
-
   }
 
   void cpuGaugeField::setGauge(void **gauge_)
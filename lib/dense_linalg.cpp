@@ -0,0 +1,614 @@
+#include <math.h>
+#include <algorithm>
+#include <vector>
+#include <quda_internal.h>
+#include <dense_linalg.h>
+
+#ifdef _OPENMP
+#include <omp.h>
+#endif
+
+/**
+   The symmetric eigensolver follows the EISPACK routines tred2 and
+   tql2, in the form used by the public-domain JAMA package.
+ */
+
+namespace quda {
+
+  /**
+     Householder reduction of the symmetric matrix V to tridiagonal
+     form, with d the diagonal and e the sub-diagonal, accumulating the
+     transformations in V.
+   */
+  static void tred2(double *V, double *d, double *e, int n)
+  {
+    for (int j=0; j<n; j++) d[j] = V[(n-1)*n+j];
+
+    for (int i=n-1; i>0; i--) {
+      // scale to avoid under/overflow
+      double scale = 0.0;
+      double h = 0.0;
+      for (int k=0; k<i; k++) scale += fabs(d[k]);
+
+      if (scale == 0.0) {
+	e[i] = d[i-1];
+	for (int j=0; j<i; j++) {
+	  d[j] = V[(i-1)*n+j];
+	  V[i*n+j] = 0.0;
+	  V[j*n+i] = 0.0;
+	}
+      } else {
+	// generate the Householder vector
+	for (int k=0; k<i; k++) {
+	  d[k] /= scale;
+	  h += d[k] * d[k];
+	}
+	double f = d[i-1];
+	double g = sqrt(h);
+	if (f > 0) g = -g;
+	e[i] = scale * g;
+	h = h - f * g;
+	d[i-1] = f - g;
+	for (int j=0; j<i; j++) e[j] = 0.0;
+
+	// apply the similarity transformation to the remaining columns
+	for (int j=0; j<i; j++) {
+	  f = d[j];
+	  V[j*n+i] = f;
+	  g = e[j] + V[j*n+j] * f;
+	  for (int k=j+1; k<=i-1; k++) {
+	    g += V[k*n+j] * d[k];
+	    e[k] += V[k*n+j] * f;
+	  }
+	  e[j] = g;
+	}
+	f = 0.0;
+	for (int j=0; j<i; j++) {
+	  e[j] /= h;
+	  f += e[j] * d[j];
+	}
+	double hh = f / (h + h);
+	for (int j=0; j<i; j++) e[j] -= hh * d[j];
+	for (int j=0; j<i; j++) {
+	  f = d[j];
+	  g = e[j];
+	  for (int k=j; k<=i-1; k++) V[k*n+j] -= (f * e[k] + g * d[k]);
+	  d[j] = V[(i-1)*n+j];
+	  V[i*n+j] = 0.0;
+	}
+      }
+      d[i] = h;
+    }
+
+    // accumulate the transformations
+    for (int i=0; i<n-1; i++) {
+      V[(n-1)*n+i] = V[i*n+i];
+      V[i*n+i] = 1.0;
+      double h = d[i+1];
+      if (h != 0.0) {
+	for (int k=0; k<=i; k++) d[k] = V[k*n+i+1] / h;
+	for (int j=0; j<=i; j++) {
+	  double g = 0.0;
+	  for (int k=0; k<=i; k++) g += V[k*n+i+1] * V[k*n+j];
+	  for (int k=0; k<=i; k++) V[k*n+j] -= g * d[k];
+	}
+      }
+      for (int k=0; k<=i; k++) V[k*n+i+1] = 0.0;
+    }
+    for (int j=0; j<n; j++) {
+      d[j] = V[(n-1)*n+j];
+      V[(n-1)*n+j] = 0.0;
+    }
+    V[(n-1)*n+n-1] = 1.0;
+    e[0] = 0.0;
+  }
+
+  /**
+     Implicit QL iterations on the symmetric tridiagonal matrix (d,e),
+     accumulating the rotations in V, followed by sorting of the
+     eigenvalues into ascending order.
+   */
+  static void tql2(double *V, double *d, double *e, int n)
+  {
+    for (int i=1; i<n; i++) e[i-1] = e[i];
+    e[n-1] = 0.0;
+
+    double f = 0.0;
+    double tst1 = 0.0;
+    const double eps = pow(2.0,-52.0);
+    const int max_iter = 30*n;
+
+    for (int l=0; l<n; l++) {
+
+      // find a small sub-diagonal element
+      tst1 = std::max(tst1, fabs(d[l]) + fabs(e[l]));
+      int m = l;
+      while (m < n-1) {
+	if (fabs(e[m]) <= eps*tst1) break;
+	m++;
+      }
+
+      // if m == l, d[l] is already an eigenvalue, otherwise iterate
+      if (m > l) {
+	int iter = 0;
+	do {
+	  if (++iter > max_iter) errorQuda("Symmetric eigensolver failed to converge");
+
+	  // compute the implicit shift
+	  double g = d[l];
+	  double p = (d[l+1] - g) / (2.0 * e[l]);
+	  double r = hypot(p, 1.0);
+	  if (p < 0) r = -r;
+	  d[l] = e[l] / (p + r);
+	  d[l+1] = e[l] * (p + r);
+	  double dl1 = d[l+1];
+	  double h = g - d[l];
+	  for (int i=l+2; i<n; i++) d[i] -= h;
+	  f = f + h;
+
+	  // implicit QL transformation
+	  p = d[m];
+	  double c = 1.0;
+	  double c2 = c;
+	  double c3 = c;
+	  double el1 = e[l+1];
+	  double s = 0.0;
+	  double s2 = 0.0;
+	  for (int i=m-1; i>=l; i--) {
+	    c3 = c2;
+	    c2 = c;
+	    s2 = s;
+	    g = c * e[i];
+	    h = c * p;
+	    r = hypot(p, e[i]);
+	    e[i+1] = s * r;
+	    s = e[i] / r;
+	    c = p / r;
+	    p = c * d[i] - s * g;
+	    d[i+1] = h + s * (c * g + s * d[i]);
+
+	    // accumulate the transformation
+	    for (int k=0; k<n; k++) {
+	      h = V[k*n+i+1];
+	      V[k*n+i+1] = s * V[k*n+i] + c * h;
+	      V[k*n+i] = c * V[k*n+i] - s * h;
+	    }
+	  }
+	  p = -s * s2 * c3 * el1 * e[l] / dl1;
+	  e[l] = s * p;
+	  d[l] = c * p;
+
+	} while (fabs(e[l]) > eps*tst1);
+      }
+      d[l] = d[l] + f;
+      e[l] = 0.0;
+    }
+
+    // sort the eigenvalues and corresponding vectors
+    for (int i=0; i<n-1; i++) {
+      int k = i;
+      double p = d[i];
+      for (int j=i+1; j<n; j++) {
+	if (d[j] < p) {
+	  k = j;
+	  p = d[j];
+	}
+      }
+      if (k != i) {
+	d[k] = d[i];
+	d[i] = p;
+	for (int j=0; j<n; j++) std::swap(V[j*n+i], V[j*n+k]);
+      }
+    }
+  }
+
+  // matrices smaller than this are not worth threading
+  static const int omp_threshold = 64;
+
+  void symmetricEigensolve(double *evals, double *evecs, const double *A, int n)
+  {
+    if (n < 1) return;
+
+    for (int i=0; i<n; i++) {
+      for (int j=0; j<=i; j++) {
+	evecs[i*n+j] = A[i*n+j];
+	evecs[j*n+i] = A[i*n+j];
+      }
+    }
+
+    std::vector<double> e(n);
+    tred2(evecs, evals, &e[0], n);
+    tql2(evecs, evals, &e[0], n);
+  }
+
+  /**
+     Generates the elementary reflector H = I - tau v v^H, with v[0] =
+     1, such that H^H (alpha, x) = (beta, 0) with beta real (cf.
+     zlarfg).  On return alpha holds beta and x holds v[1..n].
+   */
+  static Complex reflector(Complex &alpha, Complex *x, int n)
+  {
+    double xnorm2 = 0.0;
+    for (int i=0; i<n; i++) xnorm2 += norm(x[i]);
+    if (xnorm2 == 0.0 && alpha.imag() == 0.0) return 0.0;
+
+    const double beta = -copysign(sqrt(norm(alpha) + xnorm2), alpha.real());
+    const Complex tau((beta - alpha.real()) / beta, -alpha.imag() / beta);
+    const Complex scale = 1.0 / (alpha - beta);
+    for (int i=0; i<n; i++) x[i] *= scale;
+    alpha = beta;
+    return tau;
+  }
+
+  void householderQR(Complex *A, int m, int n, int lda, Complex *tau)
+  {
+    const int k = std::min(m, n);
+    for (int j=0; j<k; j++) {
+      Complex *v = &A[j+j*lda];
+      Complex alpha = v[0];
+      tau[j] = reflector(alpha, v+1, m-j-1);
+      if (tau[j] == 0.0) continue;
+      v[0] = 1.0;
+
+      // apply H_j^H to the trailing columns
+      const Complex t = conj(tau[j]);
+#pragma omp parallel for if (n-j > omp_threshold)
+      for (int c=j+1; c<n; c++) {
+	Complex *a = &A[j+c*lda];
+	Complex w = 0.0;
+	for (int r=0; r<m-j; r++) w += conj(v[r]) * a[r];
+	w *= t;
+	for (int r=0; r<m-j; r++) a[r] -= v[r] * w;
+      }
+      v[0] = alpha;
+    }
+  }
+
+  void applyHouseholderQ(bool left, bool conj_trans, int rows, int cols, int k,
+			 const Complex *QR, int ldqr, const Complex *tau, Complex *C, int ldc)
+  {
+    // Q = H_0 H_1 ... H_{k-1}: Q C and C Q^H apply the last reflector first
+    const bool reverse = (left != conj_trans);
+    std::vector<Complex> v(left ? rows : cols);
+
+    for (int s=0; s<k; s++) {
+      const int i = reverse ? k-1-s : s;
+      const Complex t = conj_trans ? conj(tau[i]) : tau[i];
+      if (t == 0.0) continue;
+
+      const int len = (left ? rows : cols) - i;
+      v[0] = 1.0;
+      for (int r=1; r<len; r++) v[r] = QR[i+r+i*ldqr];
+
+      if (left) {
+	// C(i:, :) -= t v (v^H C(i:, :))
+#pragma omp parallel for if (cols > omp_threshold)
+	for (int c=0; c<cols; c++) {
+	  Complex *x = &C[i+c*ldc];
+	  Complex w = 0.0;
+	  for (int r=0; r<len; r++) w += conj(v[r]) * x[r];
+	  w *= t;
+	  for (int r=0; r<len; r++) x[r] -= v[r] * w;
+	}
+      } else {
+	// C(:, i:) -= t (C(:, i:) v) v^H
+#pragma omp parallel for if (rows > omp_threshold)
+	for (int r=0; r<rows; r++) {
+	  Complex w = 0.0;
+	  for (int c=0; c<len; c++) w += C[r+(i+c)*ldc] * v[c];
+	  w *= t;
+	  for (int c=0; c<len; c++) C[r+(i+c)*ldc] -= w * conj(v[c]);
+	}
+      }
+    }
+  }
+
+  void hermitianEigensolve(double *evals, Complex *A, int n, int lda)
+  {
+    if (n < 1) return;
+
+    // full copy of the Hermitian matrix from its upper triangle
+    std::vector<Complex> W(n*n);
+    for (int j=0; j<n; j++) {
+      for (int i=0; i<j; i++) {
+	W[i+j*n] = A[i+j*lda];
+	W[j+i*n] = conj(A[i+j*lda]);
+      }
+      W[j+j*n] = A[j+j*lda].real();
+    }
+
+    // Householder reduction to real tridiagonal form (cf. zhetd2),
+    // with the reflector of step k stored below the sub-diagonal
+    std::vector<double> d(n), e(n, 0.0);
+    std::vector<Complex> tau(n, 0.0), w(n);
+    for (int k=0; k<n-1; k++) {
+      const int len = n-k-1;
+      Complex *v = &W[k+1+k*n];
+      Complex alpha = v[0];
+      tau[k] = reflector(alpha, v+1, len-1);
+      e[k+1] = alpha.real();
+      v[0] = 1.0;
+
+      if (tau[k] != 0.0) {
+	// w = tau A22 v
+	Complex *A22 = &W[k+1+(k+1)*n];
+#pragma omp parallel for if (len > omp_threshold)
+	for (int i=0; i<len; i++) {
+	  Complex sum = 0.0;
+	  for (int j=0; j<len; j++) sum += A22[i+j*n] * v[j];
+	  w[i] = tau[k] * sum;
+	}
+
+	// w -= (tau/2) (w^H v) v
+	Complex wv = 0.0;
+	for (int i=0; i<len; i++) wv += conj(w[i]) * v[i];
+	const Complex a = -0.5 * tau[k] * wv;
+	for (int i=0; i<len; i++) w[i] += a * v[i];
+
+	// A22 -= v w^H + w v^H
+#pragma omp parallel for if (len > omp_threshold)
+	for (int j=0; j<len; j++)
+	  for (int i=0; i<len; i++) A22[i+j*n] -= v[i] * conj(w[j]) + w[i] * conj(v[j]);
+      }
+      d[k] = W[k+k*n].real();
+    }
+    d[n-1] = W[n-1+(n-1)*n].real();
+
+    // eigenvectors of the tridiagonal matrix
+    std::vector<double> Z(n*n, 0.0);
+    for (int i=0; i<n; i++) Z[i*n+i] = 1.0;
+    tql2(&Z[0], &d[0], &e[0], n);
+    for (int i=0; i<n; i++) evals[i] = d[i];
+
+    // back-transform with Q = H_0 ... H_{n-2}, acting on rows 1..n-1
+    for (int j=0; j<n; j++)
+      for (int i=0; i<n; i++) A[i+j*lda] = Z[i*n+j];
+    if (n > 1) applyHouseholderQ(true, false, n-1, n, n-1, &W[1], n, &tau[0], &A[1], lda);
+  }
+
+  /**
+     Complex Givens rotation G = [c s; -conj(s) c] with c real, such
+     that G (a, b) = (r, 0).
+   */
+  static void givens(double &c, Complex &s, const Complex &a, const Complex &b)
+  {
+    const double abs_a = std::abs(a);
+    const double r = sqrt(norm(a) + norm(b));
+    if (r == 0.0) {
+      c = 1.0;
+      s = 0.0;
+    } else if (abs_a == 0.0) {
+      c = 0.0;
+      s = 1.0;
+    } else {
+      c = abs_a / r;
+      s = (a / abs_a) * conj(b) / r;
+    }
+  }
+
+  void generalEigensolve(Complex *evals, Complex *evecs, int ldv, Complex *A, int n, int lda)
+  {
+    if (n < 1) return;
+
+    const double eps = pow(2.0,-52.0);
+    std::vector<Complex> H(n*n), Z(n*n, 0.0), v(n);
+    for (int j=0; j<n; j++)
+      for (int i=0; i<n; i++) H[i+j*n] = A[i+j*lda];
+    for (int i=0; i<n; i++) Z[i+i*n] = 1.0;
+
+    // Householder reduction to upper Hessenberg form, H = Z^H A Z
+    for (int k=0; k<n-2; k++) {
+      const int len = n-k-1;
+      Complex alpha = H[k+1+k*n];
+      for (int i=1; i<len; i++) v[i] = H[k+1+i+k*n];
+      const Complex tau = reflector(alpha, &v[1], len-1);
+      if (tau == 0.0) continue;
+      v[0] = 1.0;
+      H[k+1+k*n] = alpha;
+      for (int i=1; i<len; i++) H[k+1+i+k*n] = 0.0;
+
+      // H(k+1:, k+1:) = H^H H(k+1:, k+1:)
+#pragma omp parallel for if (n > omp_threshold)
+      for (int c=k+1; c<n; c++) {
+	Complex w = 0.0;
+	for (int r=0; r<len; r++) w += conj(v[r]) * H[k+1+r+c*n];
+	w *= conj(tau);
+	for (int r=0; r<len; r++) H[k+1+r+c*n] -= v[r] * w;
+      }
+      // H(:, k+1:) = H(:, k+1:) H and Z(:, k+1:) = Z(:, k+1:) H
+#pragma omp parallel for if (n > omp_threshold)
+      for (int r=0; r<n; r++) {
+	Complex w = 0.0, z = 0.0;
+	for (int c=0; c<len; c++) {
+	  w += H[r+(k+1+c)*n] * v[c];
+	  z += Z[r+(k+1+c)*n] * v[c];
+	}
+	w *= tau;
+	z *= tau;
+	for (int c=0; c<len; c++) {
+	  H[r+(k+1+c)*n] -= w * conj(v[c]);
+	  Z[r+(k+1+c)*n] -= z * conj(v[c]);
+	}
+      }
+    }
+
+    // shifted QR iterations to the Schur form H = Z^H A Z upper triangular
+    std::vector<double> gc(n);
+    std::vector<Complex> gs(n);
+    int hi = n-1;
+    int iter = 0;
+    while (hi > 0) {
+      // find the start of the active unreduced block
+      int lo = hi;
+      while (lo > 0) {
+	const double tst = std::abs(H[lo-1+(lo-1)*n]) + std::abs(H[lo+lo*n]);
+	if (std::abs(H[lo+(lo-1)*n]) <= eps * tst) {
+	  H[lo+(lo-1)*n] = 0.0;
+	  break;
+	}
+	lo--;
+      }
+      if (lo == hi) {
+	hi--;
+	iter = 0;
+	continue;
+      }
+      if (++iter > 30*n) errorQuda("General eigensolver failed to converge");
+
+      // Wilkinson shift from the trailing 2x2 block, with an
+      // exceptional shift to break cycles
+      Complex mu;
+      if (iter % 10 == 0) {
+	mu = H[hi+hi*n] + std::abs(H[hi+(hi-1)*n].real());
+	if (hi-2 >= lo) mu += std::abs(H[hi-1+(hi-2)*n].real());
+      } else {
+	const Complex a = H[hi-1+(hi-1)*n], b = H[hi-1+hi*n], c = H[hi+(hi-1)*n], d = H[hi+hi*n];
+	const Complex half_tr = 0.5 * (a + d);
+	const Complex disc = std::sqrt(0.25 * (a - d) * (a - d) + b * c);
+	const Complex l1 = half_tr + disc, l2 = half_tr - disc;
+	mu = std::abs(l1 - d) < std::abs(l2 - d) ? l1 : l2;
+      }
+
+      // H - mu = Q R via Givens rotations, then H = R Q + mu
+      for (int i=lo; i<=hi; i++) H[i+i*n] -= mu;
+      for (int i=lo; i<hi; i++) {
+	givens(gc[i], gs[i], H[i+i*n], H[i+1+i*n]);
+	for (int j=i; j<n; j++) {
+	  const Complex x = H[i+j*n], y = H[i+1+j*n];
+	  H[i+j*n] = gc[i] * x + gs[i] * y;
+	  H[i+1+j*n] = -conj(gs[i]) * x + gc[i] * y;
+	}
+      }
+      for (int i=lo; i<hi; i++) {
+	const int rmax = std::min(i+2, hi);
+	for (int r=0; r<=rmax; r++) {
+	  const Complex x = H[r+i*n], y = H[r+(i+1)*n];
+	  H[r+i*n] = gc[i] * x + conj(gs[i]) * y;
+	  H[r+(i+1)*n] = -gs[i] * x + gc[i] * y;
+	}
+	for (int r=0; r<n; r++) {
+	  const Complex x = Z[r+i*n], y = Z[r+(i+1)*n];
+	  Z[r+i*n] = gc[i] * x + conj(gs[i]) * y;
+	  Z[r+(i+1)*n] = -gs[i] * x + gc[i] * y;
+	}
+      }
+      for (int i=lo; i<=hi; i++) H[i+i*n] += mu;
+    }
+
+    // eigenvectors of the triangular Schur form by back substitution
+    double hnorm = 0.0;
+    for (int j=0; j<n; j++)
+      for (int i=0; i<=j; i++) hnorm = std::max(hnorm, std::abs(H[i+j*n]));
+    const double smin = std::max(eps * hnorm, 1e-300);
+
+    std::vector<Complex> Y(n*n, 0.0);
+    for (int k=0; k<n; k++) {
+      const Complex lambda = H[k+k*n];
+      evals[k] = lambda;
+      Complex *y = &Y[k*n];
+      y[k] = 1.0;
+      for (int i=k-1; i>=0; i--) {
+	Complex sum = 0.0;
+	for (int j=i+1; j<=k; j++) sum += H[i+j*n] * y[j];
+	Complex denom = H[i+i*n] - lambda;
+	if (std::abs(denom) < smin) denom = smin;
+	y[i] = -sum / denom;
+      }
+    }
+
+    // back-transform and normalize
+#pragma omp parallel for if (n > omp_threshold)
+    for (int k=0; k<n; k++) {
+      double nrm2 = 0.0;
+      for (int r=0; r<n; r++) {
+	Complex sum = 0.0;
+	for (int j=0; j<=k; j++) sum += Z[r+j*n] * Y[k*n+j];
+	evecs[r+k*ldv] = sum;
+	nrm2 += norm(sum);
+      }
+      const double scale = 1.0 / sqrt(nrm2);
+      for (int r=0; r<n; r++) evecs[r+k*ldv] *= scale;
+    }
+  }
+
+  int luFactor(Complex *A, int n, int lda, int *ipiv)
+  {
+    int info = 0;
+    for (int j=0; j<n; j++) {
+      int p = j;
+      double amax = std::abs(A[j+j*lda]);
+      for (int i=j+1; i<n; i++) {
+	if (std::abs(A[i+j*lda]) > amax) {
+	  amax = std::abs(A[i+j*lda]);
+	  p = i;
+	}
+      }
+      ipiv[j] = p;
+      if (amax == 0.0) {
+	if (info == 0) info = j+1;
+	continue;
+      }
+      if (p != j) for (int c=0; c<n; c++) std::swap(A[j+c*lda], A[p+c*lda]);
+
+      const Complex inv = 1.0 / A[j+j*lda];
+      for (int i=j+1; i<n; i++) A[i+j*lda] *= inv;
+
+#pragma omp parallel for if (n-j > omp_threshold)
+      for (int c=j+1; c<n; c++) {
+	const Complex u = A[j+c*lda];
+	for (int i=j+1; i<n; i++) A[i+c*lda] -= A[i+j*lda] * u;
+      }
+    }
+    return info;
+  }
+
+  void luSolve(Complex *b, const Complex *A, int n, int lda, const int *ipiv)
+  {
+    for (int i=0; i<n; i++) if (ipiv[i] != i) std::swap(b[i], b[ipiv[i]]);
+    for (int j=0; j<n; j++)
+      for (int i=j+1; i<n; i++) b[i] -= A[i+j*lda] * b[j];
+    for (int j=n-1; j>=0; j--) {
+      b[j] /= A[j+j*lda];
+      for (int i=0; i<j; i++) b[i] -= A[i+j*lda] * b[j];
+    }
+  }
+
+  // number of rows of the basis per block of rotateBasis
+  static const int rotate_rows = 64;
+
+  template <typename Float>
+  static void rotateBasis(std::complex<Float> *V, int vld, int vlen, const Complex *T, int ldt, int m, int l)
+  {
+#pragma omp parallel
+    {
+      std::vector<Complex> in(rotate_rows*m), out(rotate_rows*l);
+#pragma omp for
+      for (int r0=0; r0<vlen; r0+=rotate_rows) {
+	const int rows = std::min(rotate_rows, vlen - r0);
+	for (int j=0; j<m; j++)
+	  for (int r=0; r<rows; r++) in[r+j*rotate_rows] = V[r0+r+(long)j*vld];
+
+	for (int c=0; c<l; c++) {
+	  Complex *o = &out[c*rotate_rows];
+	  for (int r=0; r<rows; r++) o[r] = 0.0;
+	  for (int j=0; j<m; j++) {
+	    const Complex t = T[j+c*ldt];
+	    const Complex *x = &in[j*rotate_rows];
+	    for (int r=0; r<rows; r++) o[r] += x[r] * t;
+	  }
+	}
+
+	for (int c=0; c<l; c++)
+	  for (int r=0; r<rows; r++) V[r0+r+(long)c*vld] = out[r+c*rotate_rows];
+      }
+    }
+  }
+
+  void rotateBasis(void *V, int vprec, int vld, int vlen, const Complex *T, int ldt, int m, int l)
+  {
+    if (vprec == sizeof(double)) rotateBasis(static_cast<std::complex<double>*>(V), vld, vlen, T, ldt, m, l);
+    else if (vprec == sizeof(float)) rotateBasis(static_cast<std::complex<float>*>(V), vld, vlen, T, ldt, m, l);
+    else errorQuda("Unsupported basis precision %d", vprec);
+  }
+
+} // namespace quda
@@ -13,7 +13,7 @@ namespace quda {
   }
 
   DiracClover::DiracClover(const DiracParam &param)
-    : DiracWilson(param), clover(*(param.clover))
+    : DiracWilson(param), clover(*(param.clover)), clover_h(0), clover_h_source(0), clover_h_key(0)
   {
     clover::initConstants(*param.gauge, profile);
     asym_clover::initConstants(*param.gauge, profile);
@@ -23,7 +23,7 @@ namespace quda {
   }
 
   DiracClover::DiracClover(const DiracClover &dirac) 
-    : DiracWilson(dirac), clover(dirac.clover)
+    : DiracWilson(dirac), clover(dirac.clover), clover_h(0), clover_h_source(0), clover_h_key(0)
   {
     clover::initConstants(*dirac.gauge, profile);
     asym_clover::initConstants(*dirac.gauge, profile);
@@ -32,17 +32,57 @@ namespace quda {
 #endif
   }
 
-  DiracClover::~DiracClover() { }
+  DiracClover::~DiracClover() { if (clover_h) delete clover_h; }
 
   DiracClover& DiracClover::operator=(const DiracClover &dirac)
   {
     if (&dirac != this) {
       DiracWilson::operator=(dirac);
       clover = dirac.clover;
+      if (clover_h) delete clover_h;
+      clover_h = 0;
+      clover_h_source = 0;
+      clover_h_key = 0;
     }
     return *this;
   }
 
+  const CloverField& DiracClover::HostClover(QudaPrecision precision) const
+  {
+    // the copy is stale once the resident clover field has been reloaded or modified
+    const uint64_t key = residentCloverKey();
+    if (clover_h && (clover_h->Precision() != precision || clover_h_source != &clover || clover_h_key != key)) {
+      delete clover_h;
+      clover_h = 0;
+    }
+
+    if (!clover_h) {
+      CloverFieldParam cf_param;
+      cf_param.nDim = 4;
+      cf_param.pad = 0;
+      cf_param.precision = precision;
+      for (int i=0; i<cf_param.nDim; i++) cf_param.x[i] = clover.X()[i];
+
+      // the device field aliases its inverse to the direct term when absent, so both parts are always copied
+      cf_param.order = QUDA_PACKED_CLOVER_ORDER;
+      cf_param.direct = true;
+      cf_param.inverse = true;
+      cf_param.clover = NULL;
+      cf_param.norm = 0;
+      cf_param.cloverInv = NULL;
+      cf_param.invNorm = 0;
+      cf_param.create = QUDA_NULL_FIELD_CREATE;
+      cf_param.siteSubset = QUDA_FULL_SITE_SUBSET;
+
+      clover_h = new cpuCloverField(cf_param);
+      clover.saveCPUField(*clover_h);
+      clover_h_source = &clover;
+      clover_h_key = key;
+    }
+
+    return *clover_h;
+  }
+
   void DiracClover::checkParitySpinor(const ColorSpinorField &out, const ColorSpinorField &in) const
   {
     Dirac::checkParitySpinor(out, in);
@@ -69,7 +109,7 @@ namespace quda {
 			   &static_cast<const cudaColorSpinorField&>(in), parity, dagger, 
 			   &static_cast<const cudaColorSpinorField&>(x), k, commDim, profile);
     } else {
-      errorQuda("Not implemented");
+      wilsonDslashCPU(out, HostGauge(in.Precision()), in, parity, dagger, &x, k, &HostClover(in.Precision()));
     }
 
     flops += 1872ll*in.Volume();
@@ -85,7 +125,7 @@ namespace quda {
       cloverCuda(&static_cast<cudaColorSpinorField&>(out), *gauge, cs, 
 		 &static_cast<const cudaColorSpinorField&>(in), parity);
     } else {
-      errorQuda("Not implemented");
+      cloverCPU(out, HostClover(in.Precision()), in, parity);
     }
 
     flops += 504ll*in.Volume();
@@ -93,36 +133,11 @@ namespace quda {
 
   void DiracClover::M(ColorSpinorField &out, const ColorSpinorField &in) const
   {
-    ColorSpinorField *In = &const_cast<ColorSpinorField&>(in);
-    if (in.Location() == QUDA_CPU_FIELD_LOCATION) {
-      ColorSpinorParam param(in);
-      param.location = QUDA_CUDA_FIELD_LOCATION;
-      param.fieldOrder =  param.precision == QUDA_DOUBLE_PRECISION ? QUDA_FLOAT2_FIELD_ORDER :
-        (param.nSpin == 4 ? QUDA_FLOAT4_FIELD_ORDER : QUDA_FLOAT2_FIELD_ORDER);
-      param.gammaBasis = QUDA_UKQCD_GAMMA_BASIS;
-      In = ColorSpinorField::Create(param);
-      *In = in;
-    }
-
-    ColorSpinorField *Out = &out;
-    if (out.Location() == QUDA_CPU_FIELD_LOCATION) {
-      ColorSpinorParam param(out);
-      param.location = QUDA_CUDA_FIELD_LOCATION;
-      param.fieldOrder =  param.precision == QUDA_DOUBLE_PRECISION ? QUDA_FLOAT2_FIELD_ORDER :
-        (param.nSpin == 4 ? QUDA_FLOAT4_FIELD_ORDER : QUDA_FLOAT2_FIELD_ORDER);
-      param.gammaBasis = QUDA_UKQCD_GAMMA_BASIS;
-      Out = ColorSpinorField::Create(param);
-    }
+    if (MStaged(out, in, true)) return;
 
-    checkFullSpinor(*Out, *In);
-    DslashXpay(Out->Odd(), In->Even(), QUDA_ODD_PARITY, In->Odd(), -kappa);
-    DslashXpay(Out->Even(), In->Odd(), QUDA_EVEN_PARITY, In->Even(), -kappa);
-
-    if (in.Location() == QUDA_CPU_FIELD_LOCATION) delete In;
-    if (out.Location() == QUDA_CPU_FIELD_LOCATION) {
-      out = *Out;
-      delete Out;
-    }
+    checkFullSpinor(out, in);
+    DslashXpay(out.Odd(), in.Even(), QUDA_ODD_PARITY, in.Odd(), -kappa);
+    DslashXpay(out.Even(), in.Odd(), QUDA_EVEN_PARITY, in.Even(), -kappa);
   }
 
   void DiracClover::MdagM(ColorSpinorField &out, const ColorSpinorField &in) const
@@ -10,26 +10,28 @@ namespace quda {
 
   DiracWilson::DiracWilson(const DiracParam &param) : 
     Dirac(param), face1(param.gauge->X(), 4, 12, 1, param.gauge->Precision()),
-                  face2(param.gauge->X(), 4, 12, 1, param.gauge->Precision()) 
+                  face2(param.gauge->X(), 4, 12, 1, param.gauge->Precision()), gauge_h(0),
+                  gauge_h_source(0), gauge_h_key(0)
     { 
       wilson::initConstants(*param.gauge, profile);
     }
 
   DiracWilson::DiracWilson(const DiracWilson &dirac) : 
-    Dirac(dirac), face1(dirac.face1), face2(dirac.face2) 
+    Dirac(dirac), face1(dirac.face1), face2(dirac.face2), gauge_h(0), gauge_h_source(0), gauge_h_key(0)
     { 
       wilson::initConstants(*dirac.gauge, profile);
     }
 
   DiracWilson::DiracWilson(const DiracParam &param, const int nDims) : 
     Dirac(param), face1(param.gauge->X(), nDims, 12, 1, param.gauge->Precision(), param.Ls),
-    face2(param.gauge->X(), nDims, 12, 1, param.gauge->Precision(), param.Ls) 
+    face2(param.gauge->X(), nDims, 12, 1, param.gauge->Precision(), param.Ls), gauge_h(0),
+    gauge_h_source(0), gauge_h_key(0)
   { 
     wilson::initConstants(*param.gauge, profile);
     
   }//temporal hack (for DW and TM operators) 
 
-  DiracWilson::~DiracWilson() { }
+  DiracWilson::~DiracWilson() { if (gauge_h) delete gauge_h; }
 
   DiracWilson& DiracWilson::operator=(const DiracWilson &dirac)
   {
@@ -37,10 +39,44 @@ namespace quda {
       Dirac::operator=(dirac);
       face1 = dirac.face1;
       face2 = dirac.face2;
+      if (gauge_h) delete gauge_h;
+      gauge_h = 0;
+      gauge_h_source = 0;
+      gauge_h_key = 0;
     }
     return *this;
   }
 
+  const GaugeField& DiracWilson::HostGauge(QudaPrecision precision) const
+  {
+    // the copy is stale once the resident gauge field has been reloaded or modified
+    const uint64_t key = residentGaugeKey();
+    if (gauge_h && (gauge_h->Precision() != precision || gauge_h_source != gauge || gauge_h_key != key)) {
+      delete gauge_h;
+      gauge_h = 0;
+    }
+
+    if (!gauge_h) {
+      GaugeFieldParam gf_param(gauge->X(), precision, QUDA_RECONSTRUCT_NO, 0, gauge->Geometry());
+      gf_param.order = QUDA_QDP_GAUGE_ORDER;
+      gf_param.fixed = gauge->GaugeFixed();
+      gf_param.link_type = gauge->LinkType();
+      gf_param.t_boundary = gauge->TBoundary();
+      gf_param.anisotropy = gauge->Anisotropy();
+      gf_param.gauge = NULL;
+      gf_param.create = QUDA_NULL_FIELD_CREATE;
+      gf_param.siteSubset = QUDA_FULL_SITE_SUBSET;
+
+      gauge_h = new cpuGaugeField(gf_param);
+      gauge->saveCPUField(*gauge_h, QUDA_CPU_FIELD_LOCATION);
+      gauge_h->exchangeGhost();
+      gauge_h_source = gauge;
+      gauge_h_key = key;
+    }
+
+    return *gauge_h;
+  }
+
   void DiracWilson::Dslash(ColorSpinorField &out, const ColorSpinorField &in, 
 			   const QudaParity parity) const
   {
@@ -52,7 +88,7 @@ namespace quda {
       wilsonDslashCuda(&static_cast<cudaColorSpinorField&>(out), *gauge, 
 		       &static_cast<const cudaColorSpinorField&>(in), parity, dagger, 0, 0.0, commDim, profile);
     } else {
-      errorQuda("Not supported");
+      wilsonDslashCPU(out, HostGauge(in.Precision()), in, parity, dagger);
     }
 
     flops += 1320ll*in.Volume();
@@ -71,14 +107,20 @@ namespace quda {
 		       &static_cast<const cudaColorSpinorField&>(in), parity, dagger, 
 		       &static_cast<const cudaColorSpinorField&>(x), k, commDim, profile);
     } else {
-      errorQuda("Not supported");
+      wilsonDslashCPU(out, HostGauge(in.Precision()), in, parity, dagger, &x, k);
     }
 
     flops += 1368ll*in.Volume();
   }
 
-  void DiracWilson::M(ColorSpinorField &out, const ColorSpinorField &in) const
+  bool DiracWilson::MStaged(ColorSpinorField &out, const ColorSpinorField &in, bool clover) const
   {
+    bool stage_in = in.Location() == QUDA_CPU_FIELD_LOCATION && !wilsonDslashCPUSupported(in, clover);
+    bool stage_out = out.Location() == QUDA_CPU_FIELD_LOCATION && !wilsonDslashCPUSupported(out, clover);
+    if (!stage_in && !stage_out && in.Location() == out.Location()) return false;
+
+    // the host dslash does not support this field, so apply the
+    // operator on device copies of the host fields
     ColorSpinorField *In = &const_cast<ColorSpinorField&>(in);
     if (in.Location() == QUDA_CPU_FIELD_LOCATION) {
       ColorSpinorParam param(in);
@@ -100,15 +142,23 @@ namespace quda {
       Out = ColorSpinorField::Create(param);
     }
 
-    checkFullSpinor(*Out, *In);
-    DslashXpay(Out->Odd(), In->Even(), QUDA_ODD_PARITY, In->Odd(), -kappa);
-    DslashXpay(Out->Even(), In->Odd(), QUDA_EVEN_PARITY, In->Even(), -kappa);
+    M(*Out, *In);
 
     if (in.Location() == QUDA_CPU_FIELD_LOCATION) delete In;
     if (out.Location() == QUDA_CPU_FIELD_LOCATION) {
       out = *Out;
       delete Out;
     }
+    return true;
+  }
+
+  void DiracWilson::M(ColorSpinorField &out, const ColorSpinorField &in) const
+  {
+    if (MStaged(out, in, false)) return;
+
+    checkFullSpinor(out, in);
+    DslashXpay(out.Odd(), in.Even(), QUDA_ODD_PARITY, in.Odd(), -kappa);
+    DslashXpay(out.Even(), in.Odd(), QUDA_EVEN_PARITY, in.Even(), -kappa);
   }
 
   void DiracWilson::MdagM(ColorSpinorField &out, const ColorSpinorField &in) const
@@ -176,7 +176,7 @@ namespace quda {
       // for full fields then set parity from loop else use arg setting
       parity = (arg.nParity == 2) ? parity : arg.parity;
 
-      //#pragma omp parallel for
+#pragma omp parallel for
       for(int x_cb = 0; x_cb < arg.volumeCB; x_cb++) { //Volume
 	for (int s=0; s<2; s++) {
 	  for (int color_block=0; color_block<Nc; color_block+=Mc) { // Mc=Nc means all colors in a thread
@@ -399,6 +399,86 @@ namespace quda {
     }
   }
 
+  /**
+     Assembles the coarse operator on a single process as a dense
+     matrix, where each row is computed from the stencil of
+     coarseDslash.  The rows of each site are computed by a single
+     thread, so no two threads write the same element.
+   */
+  template <typename Float, QudaGaugeFieldOrder gOrder, int nColor>
+  void CoarseMatrix(Complex *A, int lda, const GaugeField &Y, const GaugeField &X, double kappa) {
+    typedef typename gauge::FieldOrder<Float,nColor,2,gOrder> G;
+    const G yAccessor(const_cast<GaugeField&>(Y));
+    const G xAccessor(const_cast<GaugeField&>(X));
+
+    const int Nc = nColor/2; // the number of coarse colors per coarse spin
+    const int volumeCB = Y.VolumeCB();
+    int dim[4];
+    for (int i=0; i<4; i++) dim[i] = Y.X()[i];
+
+#pragma omp parallel for
+    for (int site=0; site<2*volumeCB; site++) {
+      const int parity = site / volumeCB;
+      const int x_cb = site - parity*volumeCB;
+      const long row0 = (long)site * nColor;
+
+      int coord[4];
+      getCoords(coord, x_cb, dim, parity);
+
+      for (int d=0; d<4; d++) {
+	// forward hopping term
+	const long fwd0 = (long)((1-parity)*volumeCB + linkIndexP1(coord, dim, d)) * nColor;
+	for (int row=0; row<nColor; row++) {
+	  for (int col=0; col<nColor; col++) {
+	    const double sign = (row/Nc == col/Nc) ? 1.0 : -1.0;
+	    const complex<Float> y = yAccessor(d, parity, x_cb, row, col);
+	    A[row0+row + (fwd0+col)*lda] += -2.0*kappa*sign*Complex(y.real(), y.imag());
+	  }
+	}
+
+	// backward hopping term
+	const int back_idx = linkIndexM1(coord, dim, d);
+	const long back0 = (long)((1-parity)*volumeCB + back_idx) * nColor;
+	for (int row=0; row<nColor; row++) {
+	  for (int col=0; col<nColor; col++) {
+	    const complex<Float> y = yAccessor(d, 1-parity, back_idx, col, row);
+	    A[row0+row + (back0+col)*lda] += -2.0*kappa*Complex(y.real(), -y.imag());
+	  }
+	}
+      }
+
+      // site-local clover term
+      for (int row=0; row<nColor; row++) {
+	for (int col=0; col<nColor; col++) {
+	  const complex<Float> x = xAccessor(0, parity, x_cb, row, col);
+	  A[row0+row + (row0+col)*lda] += Complex(x.real(), x.imag());
+	}
+      }
+    }
+  }
+
+  // template on the number of coarse degrees of freedom per site
+  template <typename Float, QudaGaugeFieldOrder gOrder>
+  void CoarseMatrix(Complex *A, int lda, const GaugeField &Y, const GaugeField &X, double kappa) {
+    if (Y.Ncolor() == 4) {
+      CoarseMatrix<Float,gOrder,4>(A, lda, Y, X, kappa);
+    } else if (Y.Ncolor() == 8) {
+      CoarseMatrix<Float,gOrder,8>(A, lda, Y, X, kappa);
+    } else if (Y.Ncolor() == 16) {
+      CoarseMatrix<Float,gOrder,16>(A, lda, Y, X, kappa);
+    } else if (Y.Ncolor() == 24) {
+      CoarseMatrix<Float,gOrder,24>(A, lda, Y, X, kappa);
+    } else if (Y.Ncolor() == 32) {
+      CoarseMatrix<Float,gOrder,32>(A, lda, Y, X, kappa);
+    } else if (Y.Ncolor() == 40) {
+      CoarseMatrix<Float,gOrder,40>(A, lda, Y, X, kappa);
+    } else if (Y.Ncolor() == 48) {
+      CoarseMatrix<Float,gOrder,48>(A, lda, Y, X, kappa);
+    } else {
+      errorQuda("Unsupported number of coarse dof %d\n", Y.Ncolor());
+    }
+  }
+
 #endif // GPU_MULTIGRID
 
   //Apply the coarse Dirac matrix to a coarse grid vector
@@ -438,4 +518,29 @@ namespace quda {
 #endif
   }//ApplyCoarse
 
+  //Assemble the coarse Dirac matrix of a single process, in the
+  //same normalization as ApplyCoarse, as a dense column-major matrix.
+  //Row and column indices follow the site-major, even-then-odd,
+  //spin-color ordering of a host field with SPACE_SPIN_COLOR order.
+  void CoarseMatrix(Complex *A, int lda, const GaugeField &Y, const GaugeField &X, double kappa) {
+#ifdef GPU_MULTIGRID
+    if (Y.Location() != QUDA_CPU_FIELD_LOCATION || X.Location() != QUDA_CPU_FIELD_LOCATION)
+      errorQuda("Coarse matrix assembly requires host gauge fields");
+    if (Y.FieldOrder() != QUDA_QDP_GAUGE_ORDER || X.FieldOrder() != QUDA_QDP_GAUGE_ORDER)
+      errorQuda("Unsupported field order Y = %d, X = %d", Y.FieldOrder(), X.FieldOrder());
+    if (X.Precision() != Y.Precision())
+      errorQuda("Precision mismatch Y=%d X=%d", Y.Precision(), X.Precision());
+
+    if (Y.Precision() == QUDA_DOUBLE_PRECISION) {
+      CoarseMatrix<double,QUDA_QDP_GAUGE_ORDER>(A, lda, Y, X, kappa);
+    } else if (Y.Precision() == QUDA_SINGLE_PRECISION) {
+      CoarseMatrix<float,QUDA_QDP_GAUGE_ORDER>(A, lda, Y, X, kappa);
+    } else {
+      errorQuda("Unsupported precision %d\n", Y.Precision());
+    }
+#else
+    errorQuda("Multigrid has not been built");
+#endif
+  }
+
 } // namespace quda
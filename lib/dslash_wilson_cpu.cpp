@@ -0,0 +1,318 @@
+#include <quda_internal.h>
+#include <color_spinor_field.h>
+#include <color_spinor_field_order.h>
+#include <gauge_field.h>
+#include <gauge_field_order.h>
+#include <clover_field.h>
+#include <clover_field_order.h>
+#include <complex_quda.h>
+#include <index_helper.cuh>
+#include <gamma.cuh>
+#include <dslash_quda.h>
+#include <comm_quda.h>
+
+namespace quda {
+
+#ifdef GPU_WILSON_DIRAC
+
+  template <typename Float, typename F, typename G, typename C>
+  struct WilsonDslashCPUArg {
+    F out;
+    const F in;
+    const F x;
+    const G U;
+    const C *A; // clover term applied to x, if any
+    Float k;
+    bool xpay;
+    int parity; // only use this for single parity fields
+    int nParity; // number of parities we're working on
+    int dagger;
+    int volumeCB;
+    int dim[5];   // full lattice dimensions
+    int commDim[4]; // whether a given dimension is partitioned or not
+    int nFace;
+
+    WilsonDslashCPUArg(F &out, const F &in, const F &x, const G &U, const C *A, Float k, bool xpay,
+		       int parity, int dagger, const ColorSpinorField &meta)
+      : out(out), in(in), x(x), U(U), A(A), k(k), xpay(xpay), parity(parity),
+	nParity(meta.SiteSubset()), dagger(dagger), volumeCB(meta.VolumeCB()), nFace(1) {
+      for (int i=0; i<4; i++) {
+	dim[i] = meta.X(i);
+	commDim[i] = comm_dim_partitioned(i);
+      }
+      dim[0] = (nParity == 1) ? 2 * dim[0] : dim[0];
+      dim[4] = 1; // ghost index expects a fifth dimension
+    }
+  };
+
+  /**
+     Applies the link U to the spin projection (1 + sign*gamma) psi and
+     accumulates the result.  The projector has rank two and each row
+     of gamma has a single non-zero element, so the pair of rows s and
+     t coupled by gamma satisfy chi_t = (sign*gamma_ts) chi_s and the
+     link is only applied to two of the four spin components.
+   */
+  template <typename Float, typename Gamma>
+  inline void projectMultiply(complex<Float> out[4][3], const complex<Float> psi[4][3],
+			      const complex<Float> U[3][3], const Gamma &gamma, Float sign) {
+    for (int s=0; s<4; s++) {
+      int t;
+      const complex<Float> g = sign * gamma.getrowelem(s, t);
+      if (t < s) continue; // this row was reconstructed along with row t
+
+      complex<Float> chi[3], h[3];
+      for (int c=0; c<3; c++) chi[c] = psi[s][c] + g * psi[t][c];
+      for (int i=0; i<3; i++) {
+	h[i] = U[i][0] * chi[0];
+	for (int j=1; j<3; j++) h[i] += U[i][j] * chi[j];
+      }
+
+      for (int c=0; c<3; c++) out[s][c] += h[c];
+      if (t != s) {
+	int s_;
+	const complex<Float> g_t = sign * gamma.getrowelem(t, s_);
+	for (int c=0; c<3; c++) out[t][c] += g_t * h[c];
+      }
+    }
+  }
+
+  /**
+     Accumulates the forward and backward hopping terms in dimension d
+     at a given parity and checkerboarded site index:
+     out += (1 - gamma_d) U_d(x) in(x+d) + (1 + gamma_d) U_d^dagger(x-d) in(x-d),
+     with the sign of gamma_d reversed for the adjoint.
+   */
+  template <typename Float, int d, typename Gamma, typename Arg>
+  inline void hop(complex<Float> out[4][3], const Gamma &gamma, const Arg &arg,
+		  int coord[5], int x_cb, int parity) {
+    const int their_spinor_parity = (arg.nParity == 2) ? (parity+1)&1 : 0;
+    const Float fwd_sign = arg.dagger ? 1.0 : -1.0;
+
+    complex<Float> psi[4][3];
+    complex<Float> U[3][3];
+
+    //Forward link - compute fwd offset for spinor fetch
+    if ( arg.commDim[d] && (coord[d] + arg.nFace >= arg.dim[d]) ) {
+      const int ghost_idx = ghostFaceIndex<1>(coord, arg.dim, d, arg.nFace);
+      for (int s=0; s<4; s++)
+	for (int c=0; c<3; c++) psi[s][c] = arg.in.Ghost(d, 1, their_spinor_parity, ghost_idx, s, c);
+    } else {
+      const int fwd_idx = linkIndexP1(coord, arg.dim, d);
+      for (int s=0; s<4; s++)
+	for (int c=0; c<3; c++) psi[s][c] = arg.in(their_spinor_parity, fwd_idx, s, c);
+    }
+    for (int i=0; i<3; i++)
+      for (int j=0; j<3; j++) U[i][j] = arg.U(d, parity, x_cb, i, j);
+    projectMultiply(out, psi, U, gamma, fwd_sign);
+
+    //Backward link - compute back offset for spinor and gauge fetch
+    if ( arg.commDim[d] && (coord[d] - arg.nFace < 0) ) {
+      const int ghost_idx = ghostFaceIndex<0>(coord, arg.dim, d, arg.nFace);
+      for (int s=0; s<4; s++)
+	for (int c=0; c<3; c++) psi[s][c] = arg.in.Ghost(d, 0, their_spinor_parity, ghost_idx, s, c);
+      for (int i=0; i<3; i++)
+	for (int j=0; j<3; j++) U[i][j] = conj(arg.U.Ghost(d, (parity+1)&1, ghost_idx, j, i));
+    } else {
+      const int back_idx = linkIndexM1(coord, arg.dim, d);
+      for (int s=0; s<4; s++)
+	for (int c=0; c<3; c++) psi[s][c] = arg.in(their_spinor_parity, back_idx, s, c);
+      for (int i=0; i<3; i++)
+	for (int j=0; j<3; j++) U[i][j] = conj(arg.U(d, (parity+1)&1, back_idx, j, i));
+    }
+    projectMultiply(out, psi, U, gamma, -fwd_sign);
+  }
+
+  /**
+     Applies the clover term on a given parity and checkerboard site
+     index, out = A in.  The clover term is block diagonal in the two
+     chiral blocks of the DeGrand-Rossi basis.
+   */
+  template <typename Float, typename F, typename C>
+  inline void cloverApplySite(complex<Float> out[4][3], const C &A, const F &in, int x_cb, int parity, int spinor_parity) {
+    for (int s=0; s<4; s++) {
+      for (int ic=0; ic<3; ic++) {
+	out[s][ic] = 0.0;
+	for (int s_col=2*(s/2); s_col<2*(s/2)+2; s_col++)
+	  for (int jc=0; jc<3; jc++) out[s][ic] += A(parity, x_cb, s, s_col, ic, jc) * in(spinor_parity, x_cb, s_col, jc);
+      }
+    }
+  }
+
+  // CPU kernel for applying the Wilson dslash to a vector
+  template <typename Float, QudaGammaBasis basis, typename Arg>
+  void wilsonDslashCPU(Arg &arg) {
+    const Gamma<Float,basis,0> gamma0;
+    const Gamma<Float,basis,1> gamma1;
+    const Gamma<Float,basis,2> gamma2;
+    const Gamma<Float,basis,3> gamma3;
+
+    for (int p=0; p<arg.nParity; p++) {
+      // for full fields then set parity from loop else use arg setting
+      const int parity = (arg.nParity == 2) ? p : arg.parity;
+      const int my_spinor_parity = (arg.nParity == 2) ? parity : 0;
+
+#pragma omp parallel for
+      for (int x_cb=0; x_cb<arg.volumeCB; x_cb++) {
+	int coord[5];
+	getCoords(coord, x_cb, arg.dim, parity);
+	coord[4] = 0;
+
+	complex<Float> out[4][3];
+	for (int s=0; s<4; s++)
+	  for (int c=0; c<3; c++) out[s][c] = 0.0;
+
+	hop<Float,0>(out, gamma0, arg, coord, x_cb, parity);
+	hop<Float,1>(out, gamma1, arg, coord, x_cb, parity);
+	hop<Float,2>(out, gamma2, arg, coord, x_cb, parity);
+	hop<Float,3>(out, gamma3, arg, coord, x_cb, parity);
+
+	if (arg.xpay) {
+	  complex<Float> x[4][3];
+	  if (arg.A) {
+	    cloverApplySite(x, *arg.A, arg.x, x_cb, parity, my_spinor_parity);
+	  } else {
+	    for (int s=0; s<4; s++)
+	      for (int c=0; c<3; c++) x[s][c] = arg.x(my_spinor_parity, x_cb, s, c);
+	  }
+	  for (int s=0; s<4; s++)
+	    for (int c=0; c<3; c++) out[s][c] = x[s][c] + arg.k * out[s][c];
+	}
+
+	for (int s=0; s<4; s++)
+	  for (int c=0; c<3; c++) arg.out(my_spinor_parity, x_cb, s, c) = out[s][c];
+      } // x_cb
+    } // parity
+  }
+
+  template <typename Float>
+  void wilsonDslashCPU(ColorSpinorField &out, const GaugeField &gauge, const ColorSpinorField &in,
+		       int parity, int dagger, const ColorSpinorField *x, double k, const CloverField *clover) {
+    typedef typename colorspinor::FieldOrderCB<Float,4,3,1,QUDA_SPACE_SPIN_COLOR_FIELD_ORDER> F;
+    typedef typename gauge::FieldOrder<Float,3,1,QUDA_QDP_GAUGE_ORDER> G;
+    typedef typename clover::FieldOrder<Float,3,4,QUDA_PACKED_CLOVER_ORDER> C;
+
+    F outAccessor(out);
+    F inAccessor(in);
+    F xAccessor(x ? *x : in);
+    G gAccessor(const_cast<GaugeField&>(gauge));
+    C *cAccessor = clover ? new C(const_cast<CloverField&>(*clover)) : 0;
+    WilsonDslashCPUArg<Float,F,G,C> arg(outAccessor, inAccessor, xAccessor, gAccessor, cAccessor,
+					(Float)k, x != 0, parity, dagger, in);
+
+    if (in.GammaBasis() == QUDA_DEGRAND_ROSSI_GAMMA_BASIS) {
+      wilsonDslashCPU<Float,QUDA_DEGRAND_ROSSI_GAMMA_BASIS>(arg);
+    } else if (in.GammaBasis() == QUDA_UKQCD_GAMMA_BASIS && !clover) {
+      wilsonDslashCPU<Float,QUDA_UKQCD_GAMMA_BASIS>(arg);
+    } else {
+      errorQuda("Unsupported gamma basis %d", in.GammaBasis());
+    }
+
+    if (cAccessor) delete cAccessor;
+  }
+
+  template <typename Float>
+  void cloverCPU(ColorSpinorField &out, const CloverField &clover, const ColorSpinorField &in, int parity) {
+    typedef typename colorspinor::FieldOrderCB<Float,4,3,1,QUDA_SPACE_SPIN_COLOR_FIELD_ORDER> F;
+    typedef typename clover::FieldOrder<Float,3,4,QUDA_PACKED_CLOVER_ORDER> C;
+
+    F outAccessor(out);
+    F inAccessor(in);
+    C cAccessor(const_cast<CloverField&>(clover));
+
+    const int nParity = in.SiteSubset();
+    for (int p=0; p<nParity; p++) {
+      const int site_parity = (nParity == 2) ? p : parity;
+      const int spinor_parity = (nParity == 2) ? p : 0;
+#pragma omp parallel for
+      for (int x_cb=0; x_cb<in.VolumeCB(); x_cb++) {
+	complex<Float> tmp[4][3];
+	cloverApplySite(tmp, cAccessor, inAccessor, x_cb, site_parity, spinor_parity);
+	for (int s=0; s<4; s++)
+	  for (int c=0; c<3; c++) outAccessor(spinor_parity, x_cb, s, c) = tmp[s][c];
+      }
+    }
+  }
+
+  static void checkFields(const ColorSpinorField &out, const ColorSpinorField &in) {
+    if (out.Location() != QUDA_CPU_FIELD_LOCATION || in.Location() != QUDA_CPU_FIELD_LOCATION)
+      errorQuda("Host dslash requires host fields");
+    if (out.FieldOrder() != QUDA_SPACE_SPIN_COLOR_FIELD_ORDER || in.FieldOrder() != QUDA_SPACE_SPIN_COLOR_FIELD_ORDER)
+      errorQuda("Unsupported field order out=%d in=%d", out.FieldOrder(), in.FieldOrder());
+    if (in.Nspin() != 4 || in.Ncolor() != 3)
+      errorQuda("Unsupported number of spins %d and colors %d", in.Nspin(), in.Ncolor());
+    if (out.Precision() != in.Precision())
+      errorQuda("Precision mismatch out=%d in=%d", out.Precision(), in.Precision());
+    if (out.GammaBasis() != in.GammaBasis())
+      errorQuda("Gamma basis mismatch out=%d in=%d", out.GammaBasis(), in.GammaBasis());
+  }
+
+#endif // GPU_WILSON_DIRAC
+
+  void wilsonDslashCPU(ColorSpinorField &out, const GaugeField &gauge, const ColorSpinorField &in,
+		       int parity, int dagger, const ColorSpinorField *x, double k, const CloverField *clover) {
+#ifdef GPU_WILSON_DIRAC
+    checkFields(out, in);
+    if (x) checkFields(*x, in);
+    if (in.V() == out.V()) errorQuda("Aliasing pointers");
+
+    if (gauge.Location() != QUDA_CPU_FIELD_LOCATION || gauge.Order() != QUDA_QDP_GAUGE_ORDER ||
+	gauge.Reconstruct() != QUDA_RECONSTRUCT_NO)
+      errorQuda("Host dslash requires an unreconstructed host gauge field in QDP order");
+    if (gauge.Precision() != in.Precision())
+      errorQuda("Precision mismatch gauge=%d in=%d", gauge.Precision(), in.Precision());
+    if (clover) {
+      if (clover->Location() != QUDA_CPU_FIELD_LOCATION || clover->Order() != QUDA_PACKED_CLOVER_ORDER)
+	errorQuda("Host dslash requires a packed host clover field");
+      if (clover->Precision() != in.Precision())
+	errorQuda("Precision mismatch clover=%d in=%d", clover->Precision(), in.Precision());
+    }
+
+    in.exchangeGhost((QudaParity)(1-parity), dagger);
+
+    if (in.Precision() == QUDA_DOUBLE_PRECISION) {
+      wilsonDslashCPU<double>(out, gauge, in, parity, dagger, x, k, clover);
+    } else if (in.Precision() == QUDA_SINGLE_PRECISION) {
+      wilsonDslashCPU<float>(out, gauge, in, parity, dagger, x, k, clover);
+    } else {
+      errorQuda("Unsupported precision %d\n", in.Precision());
+    }
+#else
+    errorQuda("Wilson dslash has not been built");
+#endif
+  }
+
+  bool wilsonDslashCPUSupported(const ColorSpinorField &in, bool clover) {
+#ifdef GPU_WILSON_DIRAC
+    if (in.Location() != QUDA_CPU_FIELD_LOCATION || in.FieldOrder() != QUDA_SPACE_SPIN_COLOR_FIELD_ORDER ||
+	in.Nspin() != 4 || in.Ncolor() != 3)
+      return false;
+    if (in.Precision() != QUDA_DOUBLE_PRECISION && in.Precision() != QUDA_SINGLE_PRECISION) return false;
+    return in.GammaBasis() == QUDA_DEGRAND_ROSSI_GAMMA_BASIS || (in.GammaBasis() == QUDA_UKQCD_GAMMA_BASIS && !clover);
+#else
+    return false;
+#endif
+  }
+
+  void cloverCPU(ColorSpinorField &out, const CloverField &clover, const ColorSpinorField &in, int parity) {
+#ifdef GPU_WILSON_DIRAC
+    checkFields(out, in);
+    if (in.GammaBasis() != QUDA_DEGRAND_ROSSI_GAMMA_BASIS)
+      errorQuda("Unsupported gamma basis %d", in.GammaBasis());
+    if (clover.Location() != QUDA_CPU_FIELD_LOCATION || clover.Order() != QUDA_PACKED_CLOVER_ORDER)
+      errorQuda("Host clover requires a packed host clover field");
+    if (clover.Precision() != in.Precision())
+      errorQuda("Precision mismatch clover=%d in=%d", clover.Precision(), in.Precision());
+
+    if (in.Precision() == QUDA_DOUBLE_PRECISION) {
+      cloverCPU<double>(out, clover, in, parity);
+    } else if (in.Precision() == QUDA_SINGLE_PRECISION) {
+      cloverCPU<float>(out, clover, in, parity);
+    } else {
+      errorQuda("Unsupported precision %d\n", in.Precision());
+    }
+#else
+    errorQuda("Wilson dslash has not been built");
+#endif
+  }
+
+} // namespace quda
@@ -12,8 +12,15 @@
 #include <lanczos_quda.h>
 
 #include <face_quda.h>
+#include <dense_linalg.h>
 
 #include <iostream>
+#include <vector>
+#include <algorithm>
+
+#ifdef _OPENMP
+#include <omp.h>
+#endif
 
 namespace quda {
 
@@ -105,4 +112,264 @@ namespace quda {
   void ImpRstLanczos::operator()(double *alpha, double *beta, cudaColorSpinorField **Eig_Vec, cudaColorSpinorField &r, cudaColorSpinorField &Apsi, int k0, int m) 
   {
   }
+
+  ThickRestartLanczos::ThickRestartLanczos(RitzMat &ritz_mat, QudaEigParam &eigParam, TimeProfile &profile) :
+    ritz_mat(ritz_mat), eigParam(eigParam), profile(profile)
+  {
+
+  }
+
+  ThickRestartLanczos::~ThickRestartLanczos()
+  {
+
+  }
+
+  /**
+     Orthogonalizes w against V[0..n) with classical Gram-Schmidt,
+     applied twice, using a single reduction per pass.  The projection
+     coefficients of both passes are accumulated in coeff.
+   */
+  static void orthogonalize(double *coeff, std::vector<ColorSpinorField*> &V, int n, ColorSpinorField &w)
+  {
+    std::vector<Complex> c(n);
+    for (int i=0; i<n; i++) coeff[i] = 0.0;
+
+    for (int pass=0; pass<2; pass++) {
+      bool reduceState = globalReduce;
+      globalReduce = false;
+      for (int i=0; i<n; i++) c[i] = blas::cDotProduct(*V[i], w);
+      globalReduce = reduceState;
+      reduceDoubleArray(reinterpret_cast<double*>(&c[0]), 2*n);
+
+      for (int i=0; i<n; i++) {
+	blas::caxpy(-c[i], *V[i], w);
+	coeff[i] += c[i].real();
+      }
+    }
+  }
+
+  // number of reals per block of the host basis rotation
+  static const long rotate_block = 64;
+
+  /**
+     In-place V[begin+j] = sum_i V[begin+i] Y(i,j) for host fields.
+     Each block of the n vectors is loaded into a buffer before being
+     overwritten, so no temporary fields are needed.
+   */
+  template <typename Float>
+  static void hostRotate(std::vector<ColorSpinorField*> &V, int begin, int n, const double *Y, int k)
+  {
+    const long length = V[begin]->Length();
+
+#pragma omp parallel
+    {
+      std::vector<double> buf(n*rotate_block);
+#pragma omp for
+      for (long s0=0; s0<length; s0+=rotate_block) {
+	const long len = s0 + rotate_block < length ? rotate_block : length - s0;
+	for (int i=0; i<n; i++) {
+	  const Float *v = static_cast<const Float*>(V[begin+i]->V()) + s0;
+	  for (long s=0; s<len; s++) buf[i*rotate_block+s] = v[s];
+	}
+	for (int j=0; j<k; j++) {
+	  Float *v = static_cast<Float*>(V[begin+j]->V()) + s0;
+	  for (long s=0; s<len; s++) {
+	    double sum = 0.0;
+	    for (int i=0; i<n; i++) sum += buf[i*rotate_block+s] * Y[i*k+j];
+	    v[s] = sum;
+	  }
+	}
+      }
+    }
+  }
+
+  /**
+     Rotates the basis, V[begin+j] = sum_i V[begin+i] Y(i,j) for
+     0 <= j < k, where Y is n x k and row major.  Device fields are
+     rotated through the workspace W, which is allocated on first use.
+   */
+  static void rotate(std::vector<ColorSpinorField*> &V, int begin, int n, const double *Y, int k,
+		     std::vector<ColorSpinorField*> &W)
+  {
+    bool host = true;
+    for (int i=begin; i<begin+n; i++) {
+      if (V[i]->Location() != QUDA_CPU_FIELD_LOCATION || V[i]->Precision() != V[begin]->Precision())
+	host = false;
+    }
+    if (V[begin]->Precision() != QUDA_DOUBLE_PRECISION && V[begin]->Precision() != QUDA_SINGLE_PRECISION)
+      host = false;
+
+    if (host) {
+      if (V[begin]->Precision() == QUDA_DOUBLE_PRECISION) hostRotate<double>(V, begin, n, Y, k);
+      else hostRotate<float>(V, begin, n, Y, k);
+      return;
+    }
+
+    if ((int)W.size() < k) {
+      ColorSpinorParam csParam(*V[begin]);
+      csParam.create = QUDA_ZERO_FIELD_CREATE;
+      while ((int)W.size() < k) W.push_back(ColorSpinorField::Create(csParam));
+    }
+
+    for (int j=0; j<k; j++) {
+      blas::zero(*W[j]);
+      for (int i=0; i<n; i++) blas::axpy(Y[i*k+j], *V[begin+i], *W[j]);
+    }
+    for (int j=0; j<k; j++) blas::copy(*V[begin+j], *W[j]);
+  }
+
+  int ThickRestartLanczos::operator()(double *evals, std::vector<ColorSpinorField*> &evecs)
+  {
+    using namespace blas;
+
+    const int nk = eigParam.nk;
+    const int m = eigParam.nk + eigParam.np;
+    const double tol = eigParam.Stp_residual;
+
+    if (nk < 1 || eigParam.np < 1) errorQuda("Invalid eigensolver dimensions nk = %d np = %d", nk, eigParam.np);
+    if ((int)evecs.size() < nk) errorQuda("Insufficient eigenvectors %lu for nk = %d", evecs.size(), nk);
+
+    // the polynomial maps the lowest eigenvalues of the matrix to the
+    // largest eigenvalues of the Ritz matrix
+    const bool largest = ritz_mat.Polynomial();
+
+    profile.TPSTART(QUDA_PROFILE_INIT);
+
+    const double r2 = norm2(*evecs[0]);
+    if (r2 == 0.0) errorQuda("Starting vector has zero norm");
+
+    ColorSpinorParam csParam(*evecs[0]);
+    csParam.create = QUDA_ZERO_FIELD_CREATE;
+    std::vector<ColorSpinorField*> V(m+1);
+    for (int i=0; i<=m; i++) V[i] = ColorSpinorField::Create(csParam);
+    std::vector<ColorSpinorField*> W;
+
+    copy(*V[0], *evecs[0]);
+    ax(1.0/sqrt(r2), *V[0]);
+
+    // projected matrix, tridiagonal apart from the arrow coupling the
+    // kept Ritz vectors to the first new Lanczos vector
+    std::vector<double> H(m*m, 0.0);
+    std::vector<double> Ha(m*m), theta(m), Y(m*m), Ysel(m*m), coeff(m+1), res(m);
+    std::vector<int> order(m);
+
+    profile.TPSTOP(QUDA_PROFILE_INIT);
+    profile.TPSTART(QUDA_PROFILE_COMPUTE);
+
+    int nlock = 0; // converged Ritz vectors at the front of V
+    int keep = 0;  // unconverged Ritz vectors kept after the locked ones
+    int restart = 0;
+    double beta = 0.0;
+
+    while (true) {
+      // extend the factorization to m vectors
+      int mlast = m;
+      bool breakdown = false;
+      for (int j=nlock+keep; j<m; j++) {
+	ritz_mat(*V[j+1], *V[j]);
+	orthogonalize(&coeff[0], V, j+1, *V[j+1]);
+	H[j*m+j] = coeff[j];
+	beta = sqrt(norm2(*V[j+1]));
+	if (beta <= 1e-14 * fabs(coeff[j])) {
+	  // invariant subspace, so the current Ritz pairs are exact
+	  mlast = j+1;
+	  beta = 0.0;
+	  breakdown = true;
+	  break;
+	}
+	ax(1.0/beta, *V[j+1]);
+	if (j+1 < m) H[(j+1)*m+j] = H[j*m+j+1] = beta;
+      }
+
+      // Ritz pairs of the active part of the projected matrix
+      const int na = mlast - nlock;
+      for (int i=0; i<na; i++)
+	for (int j=0; j<na; j++) Ha[i*na+j] = H[(nlock+i)*m+nlock+j];
+      symmetricEigensolve(&theta[0], &Y[0], &Ha[0], na);
+
+      // wanted Ritz pairs first
+      for (int i=0; i<na; i++) {
+	order[i] = largest ? na-1-i : i;
+	res[i] = fabs(beta * Y[(na-1)*na+order[i]]);
+      }
+
+      int nconv = 0;
+      while (nlock + nconv < nk && nconv < na && res[nconv] <= tol * fabs(theta[order[nconv]])) nconv++;
+
+      if (getVerbosity() >= QUDA_VERBOSE)
+	printfQuda("ThickRestartLanczos: restart %d, %d locked, %d newly converged, residual %e\n",
+		   restart, nlock, nconv, nlock + nconv < nk && nconv < na ? res[nconv] : 0.0);
+
+      const bool done = nlock + nconv >= nk || breakdown || restart == eigParam.max_restarts;
+
+      // unconverged Ritz vectors to keep, leaving room for at least
+      // one new Lanczos vector
+      int nwant = nk - nlock - nconv;
+      keep = done ? std::min(nwant, na - nconv) : std::min(nwant + (m - nk)/2, m - 1 - nlock - nconv);
+      if (keep < 0) keep = 0;
+
+      const int nrot = nconv + keep;
+      for (int i=0; i<na; i++)
+	for (int j=0; j<nrot; j++) Ysel[i*nrot+j] = Y[i*na+order[j]];
+      rotate(V, nlock, na, &Ysel[0], nrot, W);
+
+      if (done) {
+	nlock += nconv;
+	if (nlock < nk) {
+	  if (breakdown) warningQuda("ThickRestartLanczos: invariant subspace of dimension %d found", mlast);
+	  else warningQuda("ThickRestartLanczos: only %d of %d eigenpairs converged after %d restarts",
+			   nlock, nk, restart);
+	}
+	break;
+      }
+
+      // thick restart: the residual vector follows the kept Ritz
+      // vectors, coupled to them by the arrow of the projected matrix
+      std::fill(H.begin(), H.end(), 0.0);
+      copy(*V[nlock+nrot], *V[m]);
+      for (int i=0; i<keep; i++) {
+	const int idx = nlock + nconv + i;
+	const int last = nlock + nrot;
+	H[idx*m+idx] = theta[order[nconv+i]];
+	H[idx*m+last] = H[last*m+idx] = beta * Y[(na-1)*na+order[nconv+i]];
+      }
+      nlock += nconv;
+      restart++;
+    }
+
+    profile.TPSTOP(QUDA_PROFILE_COMPUTE);
+    profile.TPSTART(QUDA_PROFILE_EPILOGUE);
+
+    // eigenvalues of the matrix itself from the Rayleigh quotients
+    const DiracMatrix &mat = ritz_mat.Matrix();
+    std::vector<double> lambda(nk), rsd(nk);
+    std::vector<int> index(nk);
+    for (int i=0; i<nk; i++) {
+      mat(*V[m], *V[i]);
+      lambda[i] = reDotProduct(*V[i], *V[m]);
+      rsd[i] = sqrt(axpyNorm(-lambda[i], *V[i], *V[m]));
+      index[i] = i;
+    }
+
+    for (int i=0; i<nk; i++)
+      for (int j=i+1; j<nk; j++)
+	if (lambda[index[j]] < lambda[index[i]]) std::swap(index[i], index[j]);
+
+    for (int i=0; i<nk; i++) {
+      evals[i] = lambda[index[i]];
+      copy(*evecs[i], *V[index[i]]);
+      if (getVerbosity() >= QUDA_VERBOSE)
+	printfQuda("ThickRestartLanczos: eigenvalue %d = %e, |r| = %e\n", i, evals[i], rsd[index[i]]);
+    }
+
+    if (getVerbosity() >= QUDA_SUMMARIZE)
+      printfQuda("ThickRestartLanczos: %d of %d eigenpairs converged after %d restarts\n", nlock, nk, restart);
+
+    for (unsigned int i=0; i<W.size(); i++) delete W[i];
+    for (int i=0; i<=m; i++) delete V[i];
+
+    profile.TPSTOP(QUDA_PROFILE_EPILOGUE);
+
+    return nlock;
+  }
 } // namespace quda
@@ -87,11 +87,20 @@ namespace quda {
   /**
      Generic CPU gauge ghost extraction and packing
      NB This routines is specialized to four dimensions
+
+     The sites of the region are threaded over using the same linear
+     index as the GPU kernel, so every thread reads and writes a
+     distinct link in both the extraction and injection.
   */
   template <typename Float, int length, int nDim, int dim, typename Order, bool extract>
   void extractGhostEx(ExtractGhostExArg<Order,nDim,dim> arg) {  
     typedef typename mapper<Float>::type RegType;
 
+    const int dA = arg.A1[dim]-arg.A0[dim];
+    const int dB = arg.B1[dim]-arg.B0[dim];
+    const int dC = arg.C1[dim]-arg.C0[dim];
+    const int size = arg.R[dim]*dA*dB*dC*arg.order.geometry;
+
     for (int parity=0; parity<2; parity++) {
 
       // the following 4-way loop means this is specialized for 4 dimensions 
@@ -99,24 +108,26 @@ namespace quda {
       for (int dir = 0; dir<2; dir++) {
 
 	int D0 = extract ? dir*arg.X[dim] + (1-dir)*arg.R[dim] : dir*(arg.X[dim] + arg.R[dim]); 
-	  
-	for (int d=D0; d<D0+arg.R[dim]; d++) {
-	  for (int a=arg.A0[dim]; a<arg.A1[dim]; a++) { // loop over the interior surface
-	    for (int b=arg.B0[dim]; b<arg.B1[dim]; b++) { // loop over the interior surface
-	      for (int c=arg.C0[dim]; c<arg.C1[dim]; c++) { // loop over the interior surface
-		for (int g=0; g<arg.order.geometry; g++) {
-
-		  // we only do the extraction for parity we are currently working on
-		  int oddness = (a+b+c+d) & 1;
-		  if (oddness == parity) {
-		    if (extract) extractor<Float,length,dim>(arg, dir, a, b, c, d, g, parity);
-		    else injector<Float,length,dim>(arg, dir, a, b, c, d, g, parity);
-		  } // oddness == parity
-		} // g
-	      } // c
-	    } // b
-	  } // a
-	} // d
+
+	// X = (((g*R + d) * dA + a)*dB + b)*dC + c
+#pragma omp parallel for schedule(static)
+	for (int X=0; X<size; X++) {
+	  int gdab = X / dC;
+	  int c    = arg.C0[dim] + X    - gdab*dC;
+	  int gda  = gdab / dB;
+	  int b    = arg.B0[dim] + gdab - gda *dB;
+	  int gd   = gda / dA;
+	  int a    = arg.A0[dim] + gda  - gd  *dA;
+	  int g    = gd / arg.R[dim];
+	  int d    = D0          + gd   - g   *arg.R[dim];
+
+	  // we only do the extraction for parity we are currently working on
+	  int oddness = (a+b+c+d) & 1;
+	  if (oddness == parity) {
+	    if (extract) extractor<Float,length,dim>(arg, dir, a, b, c, d, g, parity);
+	    else injector<Float,length,dim>(arg, dir, a, b, c, d, g, parity);
+	  } // oddness == parity
+	} // X
       } // dir
       
     } // parity
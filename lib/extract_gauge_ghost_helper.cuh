@@ -29,6 +29,10 @@ namespace quda {
   /**
      Generic CPU gauge ghost extraction and packing
      NB This routines is specialized to four dimensions
+
+     The face sites are threaded over using the same linear index as
+     the GPU kernel, X = ((d * A + a)*B + b)*C + c, so that each site
+     knows its position in the ghost buffer without a running count.
   */
   template <typename Float, int length, int nDim, typename Order>
   void extractGhost(ExtractGhostArg<Order,nDim> arg) {  
@@ -38,31 +42,27 @@ namespace quda {
 
       for (int dim=0; dim<nDim; dim++) {
 
-	// linear index used for writing into ghost buffer
-	int indexDst = 0;
-	// the following 4-way loop means this is specialized for 4 dimensions 
-
-	// FIXME redefine a, b, c, d such that we always optimize for locality
-	for (int d=arg.X[dim]-arg.nFace; d<arg.X[dim]; d++) { // loop over last nFace faces in this dimension
-	  for (int a=0; a<arg.A[dim]; a++) { // loop over the surface elements of this face
-	    for (int b=0; b<arg.B[dim]; b++) { // loop over the surface elements of this face
-	      for (int c=0; c<arg.C[dim]; c++) { // loop over the surface elements of this face
-		// index is a checkboarded spacetime coordinate
-		int indexCB = (a*arg.f[dim][0] + b*arg.f[dim][1] + c*arg.f[dim][2] + d*arg.f[dim][3]) >> 1;
-		// we only do the extraction for parity we are currently working on
-		int oddness = (a+b+c+d) & 1;
-		if (oddness == parity) {
-		  RegType u[length];
-		  arg.order.load(u, indexCB, dim, parity); // load the ghost element from the bulk
-		  arg.order.saveGhost(u, indexDst, dim, (parity+arg.localParity[dim])&1);
-		  indexDst++;
-		} // oddness == parity
-	      } // c
-	    } // b
-	  } // a
-	} // d
-
-	assert(indexDst == arg.order.faceVolumeCB[dim]);
+#pragma omp parallel for schedule(static)
+	for (int X=0; X<2*arg.order.faceVolumeCB[dim]; X++) {
+	  int dab = X/arg.C[dim];
+	  int c = X - dab*arg.C[dim];
+	  int da = dab/arg.B[dim];
+	  int b = dab - da*arg.B[dim];
+	  int d = da / arg.A[dim];
+	  int a = da - d * arg.A[dim];
+	  d += arg.X[dim]-arg.nFace;
+
+	  // index is a checkboarded spacetime coordinate
+	  int indexCB = (a*arg.f[dim][0] + b*arg.f[dim][1] + c*arg.f[dim][2] + d*arg.f[dim][3]) >> 1;
+	  // we only do the extraction for parity we are currently working on
+	  int oddness = (a+b+c+d) & 1;
+	  if (oddness == parity) {
+	    RegType u[length];
+	    arg.order.load(u, indexCB, dim, parity); // load the ghost element from the bulk
+	    arg.order.saveGhost(u, X>>1, dim, (parity+arg.localParity[dim])&1);
+	  } // oddness == parity
+	} // X
+
       } // dim
 
     } // parity
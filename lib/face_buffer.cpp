@@ -410,6 +410,12 @@ void reduceDouble(double &sum) { if (globalReduce) comm_allreduce(&sum); }
 void reduceDoubleArray(double *sum, const int len) 
 { if (globalReduce) comm_allreduce_array(sum, len); }
 
+MsgHandle* reduceDoubleArrayStart(double *sum, const int len)
+{ return globalReduce ? comm_iallreduce(sum, len) : NULL; }
+
+void reduceDoubleArrayWait(MsgHandle *mh)
+{ if (mh) { comm_wait(mh); comm_free(mh); } }
+
 int commDim(int dir) { return comm_dim(dir); }
 
 int commCoords(int dir) { return comm_coord(dir); }
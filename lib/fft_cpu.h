@@ -0,0 +1,91 @@
+#ifndef _FFT_CPU_H
+#define _FFT_CPU_H
+
+#include <complex>
+#include <vector>
+#include <math.h>
+
+namespace quda {
+
+  /**
+     Small mixed-radix complex FFT used by the host gauge-fixing
+     code in place of cuFFT.  The length is factorized into primes and
+     transformed with a recursive Cooley-Tukey decomposition, using a
+     generic butterfly for each prime factor, so any lattice extent is
+     supported (2^a 3^b lengths are the fast path).  Transforms are
+     unnormalized, as with cuFFT.
+   */
+  class FFTPlanCPU {
+
+    typedef std::complex<double> Complex;
+
+    int n;
+    int max_radix;
+    std::vector<int> factors; // (radix, remaining length) pairs
+    std::vector<Complex> twiddle;
+
+    void work(Complex *out, const Complex *in, int fstride, int in_stride,
+	      const int *f, int sign, Complex *scratch) const {
+      const int p = f[0];
+      const int m = f[1];
+
+      if (m == 1) {
+	for (int k=0; k<p; k++) out[k] = in[k*fstride*in_stride];
+      } else {
+	for (int k=0; k<p; k++)
+	  work(out + k*m, in + k*fstride*in_stride, fstride*p, in_stride, f+2, sign, scratch);
+      }
+
+      for (int u=0; u<m; u++) {
+	for (int q=0; q<p; q++) scratch[q] = out[u + q*m];
+	for (int q1=0; q1<p; q1++) {
+	  const int k = u + q1*m;
+	  Complex sum = scratch[0];
+	  long tw = 0;
+	  for (int q=1; q<p; q++) {
+	    tw = (tw + (long)fstride*k) % n;
+	    sum += scratch[q] * (sign < 0 ? twiddle[tw] : std::conj(twiddle[tw]));
+	  }
+	  out[k] = sum;
+	}
+      }
+    }
+
+  public:
+    FFTPlanCPU(int n) : n(n), max_radix(1), twiddle(n) {
+      for (int i=0; i<n; i++) twiddle[i] = std::polar(1.0, -2.0*M_PI*i/n);
+      int m = n;
+      for (int p=2; m>1; ) {
+	if (m % p == 0) {
+	  m /= p;
+	  factors.push_back(p);
+	  factors.push_back(m);
+	  if (p > max_radix) max_radix = p;
+	} else {
+	  p++;
+	}
+      }
+      if (n == 1) { factors.push_back(1); factors.push_back(1); }
+    }
+
+    int Length() const { return n; }
+
+    /** Size of the scratch buffer needed by apply() */
+    int ScratchSize() const { return max_radix; }
+
+    /**
+       Transform one strided line.
+       @param out Contiguous output of length n (must not alias in)
+       @param in Input, element i at in[i*in_stride]
+       @param in_stride Stride between input elements
+       @param sign -1 for the forward and +1 for the inverse transform
+       @param scratch Work buffer of at least ScratchSize() elements
+     */
+    void apply(Complex *out, const Complex *in, int in_stride, int sign, Complex *scratch) const {
+      work(out, in, 1, in_stride, &factors[0], sign, scratch);
+    }
+  };
+
+} // namespace quda
+
+#endif // _FFT_CPU_H
@@ -0,0 +1,516 @@
+#include <math.h>
+#include <vector>
+#include <complex>
+
+#include <quda_internal.h>
+#include <gauge_field.h>
+#include <gauge_field_order.h>
+#include <quda_matrix.h>
+#include <index_helper.cuh>
+#include <gauge_tools.h>
+#include <fft_cpu.h>
+
+namespace quda {
+
+#ifdef GPU_GAUGE_ALG
+
+  using namespace gauge;
+
+  typedef std::complex<double> Complex;
+
+  template <typename Gauge>
+  struct GaugeFixCPUArg {
+    Gauge dataOr;
+    int X[4];
+    int volume;
+    int volumeCB;
+    GaugeFixCPUArg(const Gauge &dataOr, const GaugeField &meta)
+      : dataOr(dataOr), volume(meta.Volume()), volumeCB(meta.VolumeCB()) {
+      for (int d=0; d<4; d++) X[d] = meta.X()[d];
+    }
+  };
+
+  /**
+     Gram-Schmidt projection back onto SU(3), as used by the device
+     FFT gauge fixing.
+   */
+  template <typename Cmplx>
+  inline void reunitLinkCPU(Matrix<Cmplx,3> &U) {
+    typedef typename RealTypeId<Cmplx>::Type Float;
+
+    Float t1 = 0.0;
+    for (int c=0; c<3; c++) t1 += U(0,c).x*U(0,c).x + U(0,c).y*U(0,c).y;
+    t1 = (Float)1.0 / sqrt(t1);
+    for (int c=0; c<3; c++) U(0,c) *= t1;
+
+    Cmplx t2 = makeComplex((Float)0.0, (Float)0.0);
+    for (int c=0; c<3; c++) t2 += Conj(U(0,c)) * U(1,c);
+    for (int c=0; c<3; c++) U(1,c) -= t2 * U(0,c);
+
+    t1 = 0.0;
+    for (int c=0; c<3; c++) t1 += U(1,c).x*U(1,c).x + U(1,c).y*U(1,c).y;
+    t1 = (Float)1.0 / sqrt(t1);
+    for (int c=0; c<3; c++) U(1,c) *= t1;
+
+    U(2,0) = Conj(U(0,1) * U(1,2) - U(0,2) * U(1,1));
+    U(2,1) = Conj(U(0,2) * U(1,0) - U(0,0) * U(1,2));
+    U(2,2) = Conj(U(0,0) * U(1,1) - U(0,1) * U(1,0));
+  }
+
+  template <typename Float, typename Gauge>
+  void reunitGaugeCPU(GaugeFixCPUArg<Gauge> &arg) {
+    typedef typename ComplexTypeId<Float>::Type Cmplx;
+#pragma omp parallel for
+    for (int i=0; i<2*arg.volumeCB; i++) {
+      const int parity = i / arg.volumeCB;
+      const int x_cb = i - parity*arg.volumeCB;
+      for (int mu=0; mu<4; mu++) {
+	Matrix<Cmplx,3> U;
+	arg.dataOr.load((Float*)(U.data), x_cb, mu, parity);
+	reunitLinkCPU(U);
+	arg.dataOr.save((Float*)(U.data), x_cb, mu, parity);
+      }
+    }
+  }
+
+  /**
+     Measure the gauge fixing functional Fg and theta with the same
+     normalization as the device quality kernels.  If delta is
+     non-NULL the traceless anti-hermitian Delta(x) is also stored
+     there (six upper-triangular elements with stride volume, in
+     lexicographical site order) for the FFT method.
+   */
+  template <typename Float, typename Gauge>
+  double2 gaugeFixQualityCPU(GaugeFixCPUArg<Gauge> &arg, int gauge_dir, Complex *delta) {
+    typedef typename ComplexTypeId<Float>::Type Cmplx;
+    double action = 0.0, theta = 0.0;
+
+#pragma omp parallel for reduction(+:action,theta)
+    for (int i=0; i<2*arg.volumeCB; i++) {
+      const int parity = i / arg.volumeCB;
+      const int x_cb = i - parity*arg.volumeCB;
+      int x[4];
+      getCoords(x, x_cb, arg.X, parity);
+
+      Matrix<Cmplx,3> D;
+      setZero(&D);
+      for (int mu=0; mu<gauge_dir; mu++) {
+	Matrix<Cmplx,3> U;
+	arg.dataOr.load((Float*)(U.data), x_cb, mu, parity);
+	D -= U;
+      }
+      action += -D(0,0).x - D(1,1).x - D(2,2).x;
+      for (int mu=0; mu<gauge_dir; mu++) {
+	Matrix<Cmplx,3> U;
+	arg.dataOr.load((Float*)(U.data), linkIndexM1(x,arg.X,mu), mu, 1-parity);
+	D += U;
+      }
+      D -= conj(D);
+      SubTraceUnit(D);
+
+      if (delta) {
+	const int idx = getIndexFull(x_cb, arg.X, parity);
+	delta[idx + 0*arg.volume] = Complex(D(0,0).x, D(0,0).y);
+	delta[idx + 1*arg.volume] = Complex(D(0,1).x, D(0,1).y);
+	delta[idx + 2*arg.volume] = Complex(D(0,2).x, D(0,2).y);
+	delta[idx + 3*arg.volume] = Complex(D(1,1).x, D(1,1).y);
+	delta[idx + 4*arg.volume] = Complex(D(1,2).x, D(1,2).y);
+	delta[idx + 5*arg.volume] = Complex(D(2,2).x, D(2,2).y);
+      }
+      theta += getRealTraceUVdagger(D, D);
+    }
+
+    return make_double2(action / (3.0 * gauge_dir * arg.volume), theta / (3.0 * arg.volume));
+  }
+
+  /**
+     Overrelaxed Cabibbo-Marinari hit at one site: the local gauge
+     transformation is accumulated over the three SU(2) subgroups
+     from the gauge_dir forward and backward links and then applied
+     to all eight links touching the site.  Sites of one parity only
+     share links with sites of the other parity, so a whole
+     checkerboard can be updated concurrently.
+   */
+  template <typename Float, typename Gauge>
+  void gaugeFixHitSite(GaugeFixCPUArg<Gauge> &arg, int x_cb, int parity, int gauge_dir, Float relax_boost) {
+    typedef typename ComplexTypeId<Float>::Type Cmplx;
+    const int block_p[3] = {0, 1, 0};
+    const int block_q[3] = {1, 2, 2};
+
+    int x[4];
+    getCoords(x, x_cb, arg.X, parity);
+
+    Matrix<Cmplx,3> up[4], down[4];
+    int down_idx[4];
+    for (int mu=0; mu<4; mu++) {
+      down_idx[mu] = linkIndexM1(x, arg.X, mu);
+      arg.dataOr.load((Float*)(up[mu].data), x_cb, mu, parity);
+      arg.dataOr.load((Float*)(down[mu].data), down_idx[mu], mu, 1-parity);
+    }
+
+    for (int block=0; block<3; block++) {
+      const int p = block_p[block];
+      const int q = block_q[block];
+
+      Float a0 = 0.0, a1 = 0.0, a2 = 0.0, a3 = 0.0;
+      for (int mu=0; mu<gauge_dir; mu++) {
+	const Matrix<Cmplx,3> &U = up[mu];
+	const Matrix<Cmplx,3> &V = down[mu];
+	a0 += U(p,p).x + U(q,q).x + V(p,p).x + V(q,q).x;
+	a1 += (V(p,q).y + V(q,p).y) - (U(p,q).y + U(q,p).y);
+	a2 += (V(p,q).x - V(q,p).x) - (U(p,q).x - U(q,p).x);
+	a3 += (V(p,p).y - V(q,q).y) - (U(p,p).y - U(q,q).y);
+      }
+
+      // over-relaxation boost
+      const Float asq = a1*a1 + a2*a2 + a3*a3;
+      const Float a0sq = a0*a0;
+      const Float xb = (relax_boost * a0sq + asq) / (a0sq + asq);
+      const Float r = (Float)1.0 / sqrt(a0sq + xb*xb*asq);
+      a0 *= r;
+      a1 *= xb*r;
+      a2 *= xb*r;
+      a3 *= xb*r;
+
+      for (int mu=0; mu<4; mu++) {
+	// left multiply the upward links by the su2 matrix
+	for (int j=0; j<3; j++) {
+	  Cmplx m0 = up[mu](p,j);
+	  up[mu](p,j) = makeComplex( a0, a3) * m0 + makeComplex( a2, a1) * up[mu](q,j);
+	  up[mu](q,j) = makeComplex(-a2, a1) * m0 + makeComplex( a0,-a3) * up[mu](q,j);
+	}
+	// right multiply the downward links by its adjoint
+	for (int j=0; j<3; j++) {
+	  Cmplx m0 = down[mu](j,p);
+	  down[mu](j,p) = makeComplex( a0,-a3) * m0 + makeComplex( a2,-a1) * down[mu](j,q);
+	  down[mu](j,q) = makeComplex(-a2,-a1) * m0 + makeComplex( a0, a3) * down[mu](j,q);
+	}
+      }
+    }
+
+    for (int mu=0; mu<4; mu++) {
+      arg.dataOr.save((Float*)(up[mu].data), x_cb, mu, parity);
+      arg.dataOr.save((Float*)(down[mu].data), down_idx[mu], mu, 1-parity);
+    }
+  }
+
+  template <typename Float, typename Gauge>
+  void gaugefixingOVRCPU(GaugeFixCPUArg<Gauge> &arg, const int gauge_dir, const unsigned int Nsteps,
+			 const unsigned int verbose_interval, const Float relax_boost, const double tolerance,
+			 const unsigned int reunit_interval, const unsigned int stopWtheta) {
+
+    TimeProfile profileInternalGaugeFixOVR("InternalGaugeFixQudaOVRCPU", false);
+    profileInternalGaugeFixOVR.TPSTART(QUDA_PROFILE_COMPUTE);
+
+    printfQuda("\tOverrelaxation boost parameter: %lf\n", (double)relax_boost);
+    printfQuda("\tStop criterium: %lf\n", tolerance);
+    if ( stopWtheta ) printfQuda("\tStop criterium method: theta\n");
+    else printfQuda("\tStop criterium method: Delta\n");
+    printfQuda("\tMaximum number of iterations: %d\n", Nsteps);
+    printfQuda("\tReunitarize at every %d steps\n", reunit_interval);
+    printfQuda("\tPrint convergence results at every %d steps\n", verbose_interval);
+
+    double2 quality = gaugeFixQualityCPU<Float>(arg, gauge_dir, NULL);
+    double action0 = quality.x;
+    printfQuda("Step: %d\tAction: %.16e\ttheta: %.16e\n", 0, quality.x, quality.y);
+
+    unsigned int iter = 0;
+    for ( iter = 0; iter < Nsteps; iter++ ) {
+      for ( int p = 0; p < 2; p++ ) {
+#pragma omp parallel for
+	for (int x_cb=0; x_cb<arg.volumeCB; x_cb++) gaugeFixHitSite<Float>(arg, x_cb, p, gauge_dir, relax_boost);
+      }
+      if ((iter % reunit_interval) == (reunit_interval - 1)) reunitGaugeCPU<Float>(arg);
+
+      quality = gaugeFixQualityCPU<Float>(arg, gauge_dir, NULL);
+      double diff = fabs(action0 - quality.x);
+      if ((iter % verbose_interval) == (verbose_interval - 1))
+	printfQuda("Step: %d\tAction: %.16e\ttheta: %.16e\tDelta: %.16e\n", iter + 1, quality.x, quality.y, diff);
+      if ( stopWtheta ) {
+	if ( quality.y < tolerance ) break;
+      } else {
+	if ( diff < tolerance ) break;
+      }
+      action0 = quality.x;
+    }
+    if ((iter % reunit_interval) != 0 ) reunitGaugeCPU<Float>(arg);
+    if ((iter % verbose_interval) != 0 ) {
+      quality = gaugeFixQualityCPU<Float>(arg, gauge_dir, NULL);
+      printfQuda("Step: %d\tAction: %.16e\ttheta: %.16e\tDelta: %.16e\n", iter + 1, quality.x, quality.y, fabs(action0 - quality.x));
+    }
+
+    profileInternalGaugeFixOVR.TPSTOP(QUDA_PROFILE_COMPUTE);
+    if (getVerbosity() > QUDA_SUMMARIZE)
+      printfQuda("Time: %6.6f s\n", profileInternalGaugeFixOVR.Last(QUDA_PROFILE_COMPUTE));
+  }
+
+  /**
+     Forward or inverse FFT of one Delta component over the first
+     ndim dimensions.  Each dimension is done as a batch of
+     independent lines that are distributed over the threads, so for
+     Coulomb gauge (ndim = 3) every time slice is transformed
+     concurrently.
+   */
+  inline void fftDeltaCPU(Complex *data, const int X[4], int ndim, const std::vector<FFTPlanCPU> &plans, int sign) {
+    const int volume = X[0]*X[1]*X[2]*X[3];
+    int stride = 1;
+    for (int d=0; d<ndim; d++) {
+      const FFTPlanCPU &plan = plans[d];
+      const int n = X[d];
+      const int lines = volume / n;
+#pragma omp parallel
+      {
+	std::vector<Complex> line(n), scratch(plan.ScratchSize());
+#pragma omp for
+	for (int l=0; l<lines; l++) {
+	  const int lo = l % stride;
+	  const int base = lo + (l / stride) * stride * n;
+	  plan.apply(&line[0], data + base, stride, sign, &scratch[0]);
+	  for (int i=0; i<n; i++) data[base + i*stride] = line[i];
+	}
+      }
+      stride *= n;
+    }
+  }
+
+  template <typename Float, typename Gauge>
+  void gaugefixingFFTCPU(GaugeFixCPUArg<Gauge> &arg, const int gauge_dir, const unsigned int Nsteps,
+			 const unsigned int verbose_interval, const Float alpha0, const unsigned int autotune,
+			 const double tolerance, const unsigned int stopWtheta) {
+    typedef typename ComplexTypeId<Float>::Type Cmplx;
+
+    TimeProfile profileInternalGaugeFixFFT("InternalGaugeFixQudaFFTCPU", false);
+    profileInternalGaugeFixFFT.TPSTART(QUDA_PROFILE_COMPUTE);
+
+    Float alpha = alpha0;
+    printfQuda("\tAlpha parameter of the Steepest Descent Method: %e\n", (double)alpha);
+    printfQuda("\tAuto tune active: %s\n", autotune ? "yes" : "no");
+    printfQuda("\tStop criterium: %e\n", tolerance);
+    if ( stopWtheta ) printfQuda("\tStop criterium method: theta\n");
+    else printfQuda("\tStop criterium method: Delta\n");
+    printfQuda("\tMaximum number of iterations: %d\n", Nsteps);
+    printfQuda("\tPrint convergence results at every %d steps\n", verbose_interval);
+
+    // Landau gauge uses 4-d transforms, Coulomb gauge 3-d transforms on each time slice
+    const int ndim = gauge_dir == 4 ? 4 : 3;
+    std::vector<FFTPlanCPU> plans;
+    for (int d=0; d<ndim; d++) plans.push_back(FFTPlanCPU(arg.X[d]));
+
+    // pmax^2/p^2 including the FFT normalization
+    std::vector<double> invpsq(arg.volume);
+    int fft_volume = 1;
+    for (int d=0; d<ndim; d++) fft_volume *= arg.X[d];
+#pragma omp parallel for
+    for (int idx=0; idx<arg.volume; idx++) {
+      int r = idx;
+      double sinsq = 0.0;
+      for (int d=0; d<4; d++) {
+	const int k = r % arg.X[d];
+	r /= arg.X[d];
+	if (d >= ndim) continue;
+	const double s = sin(k * M_PI / arg.X[d]);
+	sinsq += s*s;
+      }
+      invpsq[idx] = sinsq > 0.00001 ? (double)ndim / (sinsq * fft_volume) : 0.0;
+    }
+
+    std::vector<Complex> delta(6 * (size_t)arg.volume);
+    std::vector<Matrix<Cmplx,3> > gx(arg.volume);
+
+    double2 quality = gaugeFixQualityCPU<Float>(arg, gauge_dir, &delta[0]);
+    double action0 = quality.x;
+    printfQuda("Step: %d\tAction: %.16e\ttheta: %.16e\n", 0, quality.x, quality.y);
+
+    double diff = 0.0;
+    unsigned int iter = 0;
+    for ( iter = 0; iter < Nsteps; iter++ ) {
+      // Fourier accelerate Delta(x)
+      for ( int k = 0; k < 6; k++ ) {
+	Complex *component = &delta[k * (size_t)arg.volume];
+	fftDeltaCPU(component, arg.X, ndim, plans, -1);
+#pragma omp parallel for
+	for (int idx=0; idx<arg.volume; idx++) component[idx] *= invpsq[idx];
+	fftDeltaCPU(component, arg.X, ndim, plans, +1);
+      }
+
+      // g(x) = reunit(1 + alpha/2 Delta(x))
+      const Float half_alpha = 0.5 * alpha;
+#pragma omp parallel for
+      for (int idx=0; idx<arg.volume; idx++) {
+	Matrix<Cmplx,3> de;
+	const Complex *d = &delta[idx];
+	de(0,0) = makeComplex((Float)d[0].real(), (Float)d[0].imag());
+	de(0,1) = makeComplex((Float)d[1*arg.volume].real(), (Float)d[1*arg.volume].imag());
+	de(0,2) = makeComplex((Float)d[2*arg.volume].real(), (Float)d[2*arg.volume].imag());
+	de(1,1) = makeComplex((Float)d[3*arg.volume].real(), (Float)d[3*arg.volume].imag());
+	de(1,2) = makeComplex((Float)d[4*arg.volume].real(), (Float)d[4*arg.volume].imag());
+	de(2,2) = makeComplex((Float)d[5*arg.volume].real(), (Float)d[5*arg.volume].imag());
+	de(1,0) = makeComplex(-de(0,1).x, de(0,1).y);
+	de(2,0) = makeComplex(-de(0,2).x, de(0,2).y);
+	de(2,1) = makeComplex(-de(1,2).x, de(1,2).y);
+	Matrix<Cmplx,3> g;
+	setIdentity(&g);
+	g += de * half_alpha;
+	reunitLinkCPU(g);
+	gx[idx] = g;
+      }
+
+      // U_mu(x) -> g(x) U_mu(x) g^dagger(x+mu)
+#pragma omp parallel for
+      for (int i=0; i<2*arg.volumeCB; i++) {
+	const int parity = i / arg.volumeCB;
+	const int x_cb = i - parity*arg.volumeCB;
+	int x[4];
+	getCoords(x, x_cb, arg.X, parity);
+	const Matrix<Cmplx,3> &g = gx[getIndexFull(x_cb, arg.X, parity)];
+	for (int mu=0; mu<4; mu++) {
+	  Matrix<Cmplx,3> U;
+	  arg.dataOr.load((Float*)(U.data), x_cb, mu, parity);
+	  const int fwd = getIndexFull(linkIndexP1(x, arg.X, mu), arg.X, 1-parity);
+	  U = g * U * conj(gx[fwd]);
+	  arg.dataOr.save((Float*)(U.data), x_cb, mu, parity);
+	}
+      }
+
+      // measure gauge quality and recalculate Delta(x)
+      quality = gaugeFixQualityCPU<Float>(arg, gauge_dir, &delta[0]);
+      double action = quality.x;
+      diff = fabs(action0 - action);
+      if ((iter % verbose_interval) == (verbose_interval - 1))
+	printfQuda("Step: %d\tAction: %.16e\ttheta: %.16e\tDelta: %.16e\n", iter + 1, quality.x, quality.y, diff);
+      if ( autotune && ((action - action0) < -1e-14) ) {
+	if ( alpha > 0.01 ) {
+	  alpha = 0.95 * alpha;
+	  warningQuda("Changing alpha down -> %.4e", (double)alpha);
+	}
+      }
+      if ( stopWtheta ) { if ( quality.y < tolerance ) break; }
+      else { if ( diff < tolerance ) break; }
+
+      action0 = action;
+    }
+    if ((iter % verbose_interval) != 0 )
+      printfQuda("Step: %d\tAction: %.16e\ttheta: %.16e\tDelta: %.16e\n", iter, quality.x, quality.y, diff);
+
+    reunitGaugeCPU<Float>(arg);
+
+    profileInternalGaugeFixFFT.TPSTOP(QUDA_PROFILE_COMPUTE);
+    if (getVerbosity() > QUDA_SUMMARIZE)
+      printfQuda("Time: %6.6f s\n", profileInternalGaugeFixFFT.Last(QUDA_PROFILE_COMPUTE));
+  }
+
+  static void checkGaugeFixCPU(const cpuGaugeField &data) {
+    if (data.Reconstruct() != QUDA_RECONSTRUCT_NO)
+      errorQuda("Reconstruction type %d not supported", data.Reconstruct());
+    for (int d=0; d<4; d++) {
+      if (comm_dim_partitioned(d))
+	errorQuda("Host gauge fixing does not support partitioned dimension %d", d);
+    }
+  }
+
+  template <typename Float>
+  void gaugefixingOVRCPU(cpuGaugeField &data, const unsigned int gauge_dir, const unsigned int Nsteps,
+			 const unsigned int verbose_interval, const double relax_boost, const double tolerance,
+			 const unsigned int reunit_interval, const unsigned int stopWtheta) {
+    const int dir = gauge_dir == 3 ? 3 : 4;
+    if (dir == 4) printfQuda("Starting Landau gauge fixing...\n");
+    else printfQuda("Starting Coulomb gauge fixing...\n");
+
+    if (data.Order() == QUDA_QDP_GAUGE_ORDER) {
+      GaugeFixCPUArg<QDPOrder<Float,18> > arg(QDPOrder<Float,18>(data), data);
+      gaugefixingOVRCPU<Float>(arg, dir, Nsteps, verbose_interval, (Float)relax_boost, tolerance, reunit_interval, stopWtheta);
+    } else if (data.Order() == QUDA_MILC_GAUGE_ORDER) {
+      GaugeFixCPUArg<MILCOrder<Float,18> > arg(MILCOrder<Float,18>(data), data);
+      gaugefixingOVRCPU<Float>(arg, dir, Nsteps, verbose_interval, (Float)relax_boost, tolerance, reunit_interval, stopWtheta);
+    } else {
+      errorQuda("Gauge field order %d not supported", data.Order());
+    }
+  }
+
+  template <typename Float>
+  void gaugefixingFFTCPU(cpuGaugeField &data, const unsigned int gauge_dir, const unsigned int Nsteps,
+			 const unsigned int verbose_interval, const double alpha, const unsigned int autotune,
+			 const double tolerance, const unsigned int stopWtheta) {
+    const int dir = gauge_dir == 3 ? 3 : 4;
+    if (dir == 4) printfQuda("Starting Landau gauge fixing with FFTs...\n");
+    else printfQuda("Starting Coulomb gauge fixing with FFTs...\n");
+
+    if (data.Order() == QUDA_QDP_GAUGE_ORDER) {
+      GaugeFixCPUArg<QDPOrder<Float,18> > arg(QDPOrder<Float,18>(data), data);
+      gaugefixingFFTCPU<Float>(arg, dir, Nsteps, verbose_interval, (Float)alpha, autotune, tolerance, stopWtheta);
+    } else if (data.Order() == QUDA_MILC_GAUGE_ORDER) {
+      GaugeFixCPUArg<MILCOrder<Float,18> > arg(MILCOrder<Float,18>(data), data);
+      gaugefixingFFTCPU<Float>(arg, dir, Nsteps, verbose_interval, (Float)alpha, autotune, tolerance, stopWtheta);
+    } else {
+      errorQuda("Gauge field order %d not supported", data.Order());
+    }
+  }
+
+  template <typename Float>
+  double2 gaugeFixQualityCPU(cpuGaugeField &data, const unsigned int gauge_dir) {
+    const int dir = gauge_dir == 3 ? 3 : 4;
+    if (data.Order() == QUDA_QDP_GAUGE_ORDER) {
+      GaugeFixCPUArg<QDPOrder<Float,18> > arg(QDPOrder<Float,18>(data), data);
+      return gaugeFixQualityCPU<Float>(arg, dir, NULL);
+    } else if (data.Order() == QUDA_MILC_GAUGE_ORDER) {
+      GaugeFixCPUArg<MILCOrder<Float,18> > arg(MILCOrder<Float,18>(data), data);
+      return gaugeFixQualityCPU<Float>(arg, dir, NULL);
+    } else {
+      errorQuda("Gauge field order %d not supported", data.Order());
+    }
+    return make_double2(0.0, 0.0);
+  }
+
+#endif // GPU_GAUGE_ALG
+
+  double2 gaugeFixQualityCPU(cpuGaugeField &data, const unsigned int gauge_dir) {
+#ifdef GPU_GAUGE_ALG
+    checkGaugeFixCPU(data);
+    if (data.Precision() == QUDA_DOUBLE_PRECISION) {
+      return gaugeFixQualityCPU<double>(data, gauge_dir);
+    } else if (data.Precision() == QUDA_SINGLE_PRECISION) {
+      return gaugeFixQualityCPU<float>(data, gauge_dir);
+    } else {
+      errorQuda("Precision %d not supported", data.Precision());
+    }
+#else
+    errorQuda("Gauge fixing has not been built");
+#endif
+    return make_double2(0.0, 0.0);
+  }
+
+  void gaugefixingOVRCPU(cpuGaugeField &data, const unsigned int gauge_dir, const unsigned int Nsteps,
+			 const unsigned int verbose_interval, const double relax_boost, const double tolerance,
+			 const unsigned int reunit_interval, const unsigned int stopWtheta) {
+#ifdef GPU_GAUGE_ALG
+    checkGaugeFixCPU(data);
+    if (data.Precision() == QUDA_DOUBLE_PRECISION) {
+      gaugefixingOVRCPU<double>(data, gauge_dir, Nsteps, verbose_interval, relax_boost, tolerance, reunit_interval, stopWtheta);
+    } else if (data.Precision() == QUDA_SINGLE_PRECISION) {
+      gaugefixingOVRCPU<float>(data, gauge_dir, Nsteps, verbose_interval, relax_boost, tolerance, reunit_interval, stopWtheta);
+    } else {
+      errorQuda("Precision %d not supported", data.Precision());
+    }
+#else
+    errorQuda("Gauge fixing has not been built");
+#endif
+  }
+
+  void gaugefixingFFTCPU(cpuGaugeField &data, const unsigned int gauge_dir, const unsigned int Nsteps,
+			 const unsigned int verbose_interval, const double alpha, const unsigned int autotune,
+			 const double tolerance, const unsigned int stopWtheta) {
+#ifdef GPU_GAUGE_ALG
+    checkGaugeFixCPU(data);
+    if (data.Precision() == QUDA_DOUBLE_PRECISION) {
+      gaugefixingFFTCPU<double>(data, gauge_dir, Nsteps, verbose_interval, alpha, autotune, tolerance, stopWtheta);
+    } else if (data.Precision() == QUDA_SINGLE_PRECISION) {
+      gaugefixingFFTCPU<float>(data, gauge_dir, Nsteps, verbose_interval, alpha, autotune, tolerance, stopWtheta);
+    } else {
+      errorQuda("Precision %d not supported", data.Precision());
+    }
+#else
+    errorQuda("Gauge fixing has not been built");
+#endif
+  }
+
+} // namespace quda
@@ -0,0 +1,304 @@
+#include <vector>
+#include <map>
+#include <string.h>
+
+#include <quda_internal.h>
+#include <gauge_field.h>
+#include <gauge_field_order.h>
+#include <quda_matrix.h>
+#include <index_helper.cuh>
+#include <gauge_force_quda.h>
+
+namespace quda {
+
+#ifdef GPU_GAUGE_FORCE
+
+  using namespace gauge;
+
+  /**
+     Maximum loop length supported by the host gauge-force engine
+   */
+  static const int max_path_length = 16;
+
+  /**
+     A node in the prefix tree of loop paths for a given direction.
+     Nodes are stored in depth-first order, so the parent of a node is
+     always the most recently visited node at depth-1, and the path
+     product at a node is the parent product times this node's link.
+   */
+  struct GaugeForceNode {
+    int depth;      // depth in the tree (the first link of a path is at depth 1)
+    int dim;        // dimension of the link
+    bool forward;   // whether the link is traversed forwards (else daggered)
+    int dx[4];      // displacement of the link's site from the force site x
+    double coeff;   // sum of coefficients of all paths terminating here
+  };
+
+  /**
+     The compiled form of a set of gauge-force loop paths.  For each
+     direction the paths are merged into a prefix tree, so that
+     products common to several loops (e.g., the rectangle and
+     parallelogram terms share their leading links with the plaquette
+     and with each other) are computed once per site.
+   */
+  class GaugeForcePlan {
+
+    std::vector<GaugeForceNode> node[4];
+    std::vector<int> path[4];  // flattened input paths, used to detect plan reuse
+    std::vector<int> length;
+    std::vector<double> coeff;
+    int max_depth;
+    int links; // total number of links in the input paths (before merging)
+
+    struct Trie {
+      int step;
+      double coeff;
+      std::map<int,Trie> child;
+      Trie() : step(-1), coeff(0.0) { }
+    };
+
+    void flatten(std::vector<GaugeForceNode> &out, const Trie &t, int depth, const int x[4]) {
+      for (std::map<int,Trie>::const_iterator it=t.child.begin(); it!=t.child.end(); it++) {
+	const Trie &c = it->second;
+	GaugeForceNode n;
+	int y[4] = {x[0], x[1], x[2], x[3]};
+	n.depth = depth+1;
+	n.forward = c.step < 4;
+	n.dim = n.forward ? c.step : 7 - c.step;
+	if (!n.forward) y[n.dim]--;
+	for (int i=0; i<4; i++) n.dx[i] = y[i];
+	if (n.forward) y[n.dim]++;
+	n.coeff = c.coeff;
+	out.push_back(n);
+	flatten(out, c, depth+1, y);
+      }
+    }
+
+  public:
+    GaugeForcePlan(int ***input_path, const int *length_, const double *path_coeff, int num_paths)
+      : length(length_, length_+num_paths), coeff(path_coeff, path_coeff+num_paths), max_depth(0), links(0) {
+
+      for (int dir=0; dir<4; dir++) {
+	Trie root;
+	for (int p=0; p<num_paths; p++) {
+	  if (length[p] > max_path_length)
+	    errorQuda("Path length %d exceeds maximum %d", length[p], max_path_length);
+	  Trie *t = &root;
+	  for (int j=0; j<length[p]; j++) {
+	    int step = input_path[dir][p][j];
+	    if (step < 0 || step > 7) errorQuda("Invalid path step %d", step);
+	    t = &(t->child[step]);
+	    t->step = step;
+	    path[dir].push_back(step);
+	  }
+	  t->coeff += coeff[p];
+	  if (length[p] > max_depth) max_depth = length[p];
+	  links += length[p];
+	}
+
+	// loops start at the site x + dir
+	int x[4] = {0, 0, 0, 0};
+	x[dir] = 1;
+	flatten(node[dir], root, 0, x);
+      }
+
+      if (getVerbosity() >= QUDA_VERBOSE)
+	printfQuda("Gauge force plan: %d paths, %d links merged into %d products\n",
+		   num_paths, links, Products());
+    }
+
+    /**
+       @return Whether this plan was compiled from the given paths and coefficients
+     */
+    bool matches(int ***input_path, const int *length_, const double *path_coeff, int num_paths) const {
+      if ((int)length.size() != num_paths) return false;
+      for (int p=0; p<num_paths; p++)
+	if (length[p] != length_[p] || coeff[p] != path_coeff[p]) return false;
+      for (int dir=0; dir<4; dir++) {
+	int k = 0;
+	for (int p=0; p<num_paths; p++)
+	  for (int j=0; j<length[p]; j++)
+	    if (path[dir][k++] != input_path[dir][p][j]) return false;
+      }
+      return true;
+    }
+
+    const GaugeForceNode* Nodes(int dir) const { return &node[dir][0]; }
+    int NumNodes(int dir) const { return node[dir].size(); }
+    int MaxDepth() const { return max_depth; }
+    int Links() const { return links; }
+    int Products() const { int n=0; for (int d=0; d<4; d++) n += node[d].size(); return n; }
+  };
+
+  template <typename Float, typename Gauge, typename Mom>
+  struct GaugeForceCPUArg {
+    Gauge u;
+    Mom mom;
+    int X[4]; // the regular volume parameters
+    int E[4]; // the (possibly) extended volume parameters
+    int border[4];
+    int volumeCB;
+    Float epsilon;
+    const GaugeForcePlan &plan;
+
+    GaugeForceCPUArg(const Gauge &u, const Mom &mom, const GaugeField &meta, const GaugeField &mom_meta,
+		     double epsilon, const GaugeForcePlan &plan)
+      : u(u), mom(mom), volumeCB(mom_meta.VolumeCB()), epsilon(epsilon), plan(plan) {
+      for (int d=0; d<4; d++) {
+	X[d] = mom_meta.X()[d];
+	E[d] = meta.X()[d];
+	border[d] = (E[d] - X[d]) / 2;
+      }
+    }
+  };
+
+  /**
+     mom -= epsilon * force for momentum stored in the compressed
+     MILC format (the anti-hermitian upper triangle and diagonal)
+   */
+  template <typename Float, typename Cmplx>
+  inline void updateMom(MILCOrder<Float,10> &mom, const Matrix<Cmplx,3> &force, Float epsilon,
+			int x_cb, int dir, int parity) {
+    Float m[10];
+    mom.load(m, x_cb, dir, parity);
+    m[0] -= epsilon * force(0,1).x;
+    m[1] -= epsilon * force(0,1).y;
+    m[2] -= epsilon * force(0,2).x;
+    m[3] -= epsilon * force(0,2).y;
+    m[4] -= epsilon * force(1,2).x;
+    m[5] -= epsilon * force(1,2).y;
+    m[6] -= epsilon * force(0,0).y;
+    m[7] -= epsilon * force(1,1).y;
+    m[8] -= epsilon * force(2,2).y;
+    mom.save(m, x_cb, dir, parity);
+  }
+
+  /**
+     mom -= epsilon * force for momentum stored as full matrices
+     in the TIFR format
+   */
+  template <typename Float, typename Cmplx>
+  inline void updateMom(TIFROrder<Float,18> &mom, const Matrix<Cmplx,3> &force, Float epsilon,
+			int x_cb, int dir, int parity) {
+    Matrix<Cmplx,3> m;
+    mom.load((Float*)(m.data), x_cb, dir, parity);
+    m = m - epsilon * force;
+    mom.save((Float*)(m.data), x_cb, dir, parity);
+  }
+
+  template <typename Float, typename Gauge, typename Mom>
+  void gaugeForceSite(GaugeForceCPUArg<Float,Gauge,Mom> &arg, int x_cb, int parity) {
+    typedef typename ComplexTypeId<Float>::Type Cmplx;
+
+    int x[4];
+    getCoords(x, x_cb, arg.X, parity);
+    for (int d=0; d<4; d++) x[d] += arg.border[d];
+    const int e_cb = linkIndex(x, arg.E);
+
+    Matrix<Cmplx,3> P[max_path_length+1];
+    setIdentity(&P[0]);
+
+    for (int dir=0; dir<4; dir++) {
+      Matrix<Cmplx,3> staple, link;
+      setZero(&staple);
+
+      const GaugeForceNode *node = arg.plan.Nodes(dir);
+      for (int n=0; n<arg.plan.NumNodes(dir); n++) {
+	const GaugeForceNode &nd = node[n];
+	int dx[4] = {nd.dx[0], nd.dx[1], nd.dx[2], nd.dx[3]};
+	const int nbr_parity = (parity + dx[0] + dx[1] + dx[2] + dx[3]) & 1;
+	arg.u.load((Float*)(link.data), linkIndexShift(x, dx, arg.E), nd.dim, nbr_parity);
+
+	P[nd.depth] = nd.forward ? P[nd.depth-1] * link : P[nd.depth-1] * conj(link);
+	if (nd.coeff != 0.0) staple += static_cast<Float>(nd.coeff) * P[nd.depth];
+      }
+
+      // mom -= epsilon * TA(U * staple)
+      arg.u.load((Float*)(link.data), e_cb, dir, parity);
+      Matrix<Cmplx,3> force = link * staple;
+      makeAntiHerm(force);
+
+      updateMom(arg.mom, force, arg.epsilon, x_cb, dir, parity);
+    }
+  }
+
+  template <typename Float, typename Gauge, typename Mom>
+  void gaugeForceCPU(GaugeForceCPUArg<Float,Gauge,Mom> arg) {
+#pragma omp parallel for
+    for (int i=0; i<2*arg.volumeCB; i++) {
+      const int parity = i / arg.volumeCB;
+      gaugeForceSite<Float>(arg, i - parity*arg.volumeCB, parity);
+    }
+  }
+
+  template <typename Float, typename Gauge>
+  void gaugeForceCPU(const Gauge &u, GaugeField &mom, const GaugeField &meta,
+		     double epsilon, const GaugeForcePlan &plan) {
+    if (mom.Order() == QUDA_MILC_GAUGE_ORDER && mom.Reconstruct() == QUDA_RECONSTRUCT_10) {
+      GaugeForceCPUArg<Float,Gauge,MILCOrder<Float,10> > arg(u, MILCOrder<Float,10>(mom), meta, mom, epsilon, plan);
+      gaugeForceCPU<Float>(arg);
+    } else if (mom.Order() == QUDA_TIFR_GAUGE_ORDER && mom.Reconstruct() == QUDA_RECONSTRUCT_NO) {
+      GaugeForceCPUArg<Float,Gauge,TIFROrder<Float,18> > arg(u, TIFROrder<Float,18>(mom), meta, mom, epsilon, plan);
+      gaugeForceCPU<Float>(arg);
+    } else {
+      errorQuda("Momentum field order %d and reconstruct %d not supported", mom.Order(), mom.Reconstruct());
+    }
+  }
+
+  template <typename Float>
+  void gaugeForceCPU(GaugeField &mom, const GaugeField &u, double epsilon, const GaugeForcePlan &plan) {
+    if (u.Order() == QUDA_QDP_GAUGE_ORDER) {
+      gaugeForceCPU<Float>(QDPOrder<Float,18>(u), mom, u, epsilon, plan);
+    } else if (u.Order() == QUDA_MILC_GAUGE_ORDER) {
+      gaugeForceCPU<Float>(MILCOrder<Float,18>(u), mom, u, epsilon, plan);
+    } else if (u.Order() == QUDA_TIFR_GAUGE_ORDER) {
+      gaugeForceCPU<Float>(TIFROrder<Float,18>(u), mom, u, epsilon, plan);
+    } else {
+      errorQuda("Gauge field order %d not supported", u.Order());
+    }
+  }
+
+  // the most recently compiled plan, reused while the paths are unchanged
+  static GaugeForcePlan *plan_cache = NULL;
+
+#endif // GPU_GAUGE_FORCE
+
+  void gauge_force_cpu(cpuGaugeField& mom, double eb3, cpuGaugeField& u,
+		       int ***input_path, int *length, double *path_coeff, int num_paths, int max_length)
+  {
+#ifdef GPU_GAUGE_FORCE
+    if (mom.Precision() != u.Precision())
+      errorQuda("Gauge and momentum field precisions %d %d do not match", u.Precision(), mom.Precision());
+
+    if (u.Reconstruct() != QUDA_RECONSTRUCT_NO)
+      errorQuda("Reconstruction type %d not supported", u.Reconstruct());
+
+    for (int d=0; d<4; d++) {
+      int border = (u.X()[d] - mom.X()[d]) / 2;
+      if (border != 0 && border < 2) errorQuda("Extended field radius %d insufficient in dimension %d", border, d);
+#ifdef MULTI_GPU
+      if (commDimPartitioned(d) && border == 0)
+	errorQuda("Extended gauge field required for partitioned dimension %d", d);
+#endif
+    }
+
+    if (!plan_cache || !plan_cache->matches(input_path, length, path_coeff, num_paths)) {
+      if (plan_cache) delete plan_cache;
+      plan_cache = new GaugeForcePlan(input_path, length, path_coeff, num_paths);
+    }
+    if (plan_cache->MaxDepth() > max_length)
+      warningQuda("Path length %d exceeds declared max_length %d", plan_cache->MaxDepth(), max_length);
+
+    if (u.Precision() == QUDA_DOUBLE_PRECISION) {
+      gaugeForceCPU<double>(mom, u, eb3, *plan_cache);
+    } else if (u.Precision() == QUDA_SINGLE_PRECISION) {
+      gaugeForceCPU<float>(mom, u, eb3, *plan_cache);
+    } else {
+      errorQuda("Precision %d not supported", u.Precision());
+    }
+#else
+    errorQuda("Gauge force has not been built");
+#endif // GPU_GAUGE_FORCE
+  }
+
+} // namespace quda
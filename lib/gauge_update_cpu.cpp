@@ -0,0 +1,294 @@
+#include <math.h>
+
+#include <quda_internal.h>
+#include <gauge_field.h>
+#include <gauge_field_order.h>
+#include <quda_matrix.h>
+#include <gauge_update_quda.h>
+#include <momentum.h>
+
+namespace quda {
+
+#ifdef GPU_GAUGE_TOOLS
+
+  using namespace gauge;
+
+  template <typename Float, typename Gauge, typename Mom>
+  struct UpdateGaugeCPUArg {
+    Gauge out;
+    Gauge in;
+    Mom mom;
+    double dt;
+    int volumeCB;
+    UpdateGaugeCPUArg(const Gauge &out, const Gauge &in, const Mom &mom, double dt, const GaugeField &meta)
+      : out(out), in(in), mom(mom), dt(dt), volumeCB(meta.VolumeCB()) { }
+  };
+
+  /**
+     Contribution of a single momentum link to the action, in the
+     same normalization as the device reduction.
+   */
+  template <typename Float>
+  inline double momActionLink(const Float m[10]) {
+    double action = 0.0;
+    for (int j=0; j<6; j++) action += (double)m[j]*(double)m[j];
+    for (int j=6; j<9; j++) action += 0.5*(double)m[j]*(double)m[j];
+    return action - 4.0;
+  }
+
+  /**
+     Unpack a compressed anti-hermitian momentum link and remove its
+     trace.
+   */
+  template <typename Float, typename Cmplx>
+  inline void unpackMom(Matrix<Cmplx,3> &P, const Float m[10]) {
+    const Float trace = (m[6] + m[7] + m[8]) / static_cast<Float>(3.0);
+    P(0,0) = makeComplex(static_cast<Float>(0.0), m[6] - trace);
+    P(1,1) = makeComplex(static_cast<Float>(0.0), m[7] - trace);
+    P(2,2) = makeComplex(static_cast<Float>(0.0), m[8] - trace);
+    P(0,1) = makeComplex(m[0], m[1]);
+    P(0,2) = makeComplex(m[2], m[3]);
+    P(1,2) = makeComplex(m[4], m[5]);
+    P(1,0) = makeComplex(-m[0], m[1]);
+    P(2,0) = makeComplex(-m[2], m[3]);
+    P(2,1) = makeComplex(-m[4], m[5]);
+  }
+
+  /**
+     Compute exp(iQ) for traceless hermitian Q using the
+     Cayley-Hamilton form exp(iQ) = f0 + f1 Q + f2 Q^2 (Morningstar
+     and Peardon, hep-lat/0311018).  The coefficients are evaluated in
+     double precision irrespective of the field precision.  For small
+     Q, where the closed form loses precision, the exponential is
+     instead computed from its Taylor expansion.
+   */
+  inline void expCayleyHamilton(Matrix<double2,3> &expQ, const Matrix<double2,3> &Q) {
+    Matrix<double2,3> Q2 = Q*Q;
+
+    const double c0 = (1.0/3.0) * getTrace(Q2*Q).x;
+    const double c1 = 0.5 * getTrace(Q2).x;
+
+    if (c1 < 1e-4) {
+      // 8th-order expansion: the truncation error is O(c1^(9/2) / 9!)
+      const double2 i = makeComplex(0.0, 1.0);
+      Matrix<double2,3> iQ = i * Q;
+      setIdentity(&expQ);
+      for (int r=8; r>0; r--) {
+	expQ = iQ * expQ * (1.0/r);
+	expQ(0,0).x += 1.0; expQ(1,1).x += 1.0; expQ(2,2).x += 1.0;
+      }
+      return;
+    }
+
+    // use the symmetry f_j(-c0) = (-1)^j conj(f_j(c0))
+    const bool negative = c0 < 0.0;
+    const double c0_max = 2.0 * pow(c1/3.0, 1.5);
+    double ratio = fabs(c0) / c0_max;
+    if (ratio > 1.0) ratio = 1.0;
+    const double theta = acos(ratio);
+
+    const double u = sqrt(c1/3.0) * cos(theta/3.0);
+    const double w = sqrt(c1) * sin(theta/3.0);
+    const double u2 = u*u, w2 = w*w;
+    const double cos_w = cos(w);
+    const double xi0 = fabs(w) < 0.05 ? 1.0 - w2/6.0*(1.0 - w2/20.0*(1.0 - w2/42.0)) : sin(w)/w;
+
+    const double2 e2iu = makeComplex(cos(2.0*u), sin(2.0*u));
+    const double2 emiu = makeComplex(cos(u), -sin(u));
+
+    double2 h0 = (u2 - w2) * e2iu + emiu * makeComplex(8.0*u2*cos_w, 2.0*u*(3.0*u2 + w2)*xi0);
+    double2 h1 = (2.0*u) * e2iu - emiu * makeComplex(2.0*u*cos_w, -(3.0*u2 - w2)*xi0);
+    double2 h2 = e2iu - emiu * makeComplex(cos_w, 3.0*u*xi0);
+
+    const double denom = 1.0 / (9.0*u2 - w2);
+    double2 f0 = denom * h0, f1 = denom * h1, f2 = denom * h2;
+    if (negative) {
+      f0 = makeComplex(f0.x, -f0.y);
+      f1 = makeComplex(-f1.x, f1.y);
+      f2 = makeComplex(f2.x, -f2.y);
+    }
+
+    expQ = f1*Q + f2*Q2;
+    expQ(0,0) += f0; expQ(1,1) += f0; expQ(2,2) += f0;
+  }
+
+  template <typename Float, int N, bool conj_mom, bool exact, bool action, typename Gauge, typename Mom>
+  double updateGaugeFieldSite(UpdateGaugeCPUArg<Float,Gauge,Mom> &arg, int x, int parity) {
+    typedef typename ComplexTypeId<Float>::Type Cmplx;
+    double local_action = 0.0;
+
+    for (int dir=0; dir<4; dir++) {
+      Float m[10];
+      arg.mom.load(m, x, dir, parity);
+      if (action) local_action += momActionLink(m);
+
+      Matrix<Cmplx,3> link, result;
+      arg.in.load((Float*)(link.data), x, dir, parity);
+
+      if (!exact) {
+	Matrix<Cmplx,3> P;
+	unpackMom(P, m);
+	if (conj_mom) P = conj(P);
+	const Float dt = arg.dt;
+
+	// Nth order expansion of exponential
+	result = link;
+	for (int r=N; r>0; r--) result = (dt/r)*P*result + link;
+      } else {
+	double md[10];
+	for (int j=0; j<10; j++) md[j] = m[j];
+	Matrix<double2,3> P, expQ;
+	unpackMom(P, md);
+
+	// exp(dt P) = exp(iQ) with Q = -i dt P (+i dt P for conj_mom)
+	const double2 s = makeComplex(0.0, conj_mom ? arg.dt : -arg.dt);
+	expCayleyHamilton(expQ, s*P);
+
+	Matrix<Cmplx,3> E;
+	for (int i=0; i<9; i++) E.data[i] = makeComplex(static_cast<Float>(expQ.data[i].x),
+							static_cast<Float>(expQ.data[i].y));
+	result = E * link;
+      }
+
+      arg.out.save((Float*)(result.data), x, dir, parity);
+    }
+
+    return local_action;
+  }
+
+  template <typename Float, int N, bool conj_mom, bool exact, bool action, typename Gauge, typename Mom>
+  double updateGaugeFieldCPU(UpdateGaugeCPUArg<Float,Gauge,Mom> arg) {
+    double sum = 0.0;
+#pragma omp parallel for reduction(+:sum)
+    for (int i=0; i<2*arg.volumeCB; i++) {
+      const int parity = i / arg.volumeCB;
+      sum += updateGaugeFieldSite<Float,N,conj_mom,exact,action>(arg, i - parity*arg.volumeCB, parity);
+    }
+    return sum;
+  }
+
+  template <typename Float, bool action, typename Gauge, typename Mom>
+  double updateGaugeFieldCPU(const Gauge &out, const Gauge &in, const Mom &mom, double dt,
+			     const GaugeField &meta, bool conj_mom, bool exact) {
+    // degree of exponential expansion, matching the device update
+    const int N = 8;
+    UpdateGaugeCPUArg<Float,Gauge,Mom> arg(out, in, mom, dt, meta);
+    if (conj_mom) {
+      if (exact) return updateGaugeFieldCPU<Float,N,true,true,action>(arg);
+      else return updateGaugeFieldCPU<Float,N,true,false,action>(arg);
+    } else {
+      if (exact) return updateGaugeFieldCPU<Float,N,false,true,action>(arg);
+      else return updateGaugeFieldCPU<Float,N,false,false,action>(arg);
+    }
+  }
+
+  template <typename Float, typename Gauge>
+  double updateGaugeFieldCPU(const Gauge &out, const Gauge &in, const GaugeField &mom, double dt,
+			     const GaugeField &meta, bool conj_mom, bool exact, bool action) {
+    if (mom.Order() == QUDA_MILC_GAUGE_ORDER && mom.Reconstruct() == QUDA_RECONSTRUCT_10) {
+      if (action) return updateGaugeFieldCPU<Float,true>(out, in, MILCOrder<Float,10>(mom), dt, meta, conj_mom, exact);
+      else return updateGaugeFieldCPU<Float,false>(out, in, MILCOrder<Float,10>(mom), dt, meta, conj_mom, exact);
+    } else {
+      errorQuda("Momentum field order %d and reconstruct %d not supported", mom.Order(), mom.Reconstruct());
+    }
+    return 0.0;
+  }
+
+  template <typename Float>
+  double updateGaugeFieldCPU(GaugeField &out, const GaugeField &in, const GaugeField &mom, double dt,
+			     bool conj_mom, bool exact, bool action) {
+    if (out.Order() == QUDA_QDP_GAUGE_ORDER) {
+      return updateGaugeFieldCPU<Float>(QDPOrder<Float,18>(out), QDPOrder<Float,18>(in), mom, dt, out, conj_mom, exact, action);
+    } else if (out.Order() == QUDA_MILC_GAUGE_ORDER) {
+      return updateGaugeFieldCPU<Float>(MILCOrder<Float,18>(out), MILCOrder<Float,18>(in), mom, dt, out, conj_mom, exact, action);
+    } else {
+      errorQuda("Gauge field order %d not supported", out.Order());
+    }
+    return 0.0;
+  }
+
+  template <typename Float, typename Mom>
+  double momActionCPU(const Mom &mom, const GaugeField &meta) {
+    const int volumeCB = meta.VolumeCB();
+    double action = 0.0;
+#pragma omp parallel for reduction(+:action)
+    for (int i=0; i<2*volumeCB; i++) {
+      const int parity = i / volumeCB;
+      for (int dir=0; dir<4; dir++) {
+	Float m[10];
+	mom.load(m, i - parity*volumeCB, dir, parity);
+	action += momActionLink(m);
+      }
+    }
+    return action;
+  }
+
+  template <typename Float>
+  double momActionCPU(const GaugeField &mom) {
+    if (mom.Order() == QUDA_MILC_GAUGE_ORDER && mom.Reconstruct() == QUDA_RECONSTRUCT_10) {
+      return momActionCPU<Float>(MILCOrder<Float,10>(mom), mom);
+    } else {
+      errorQuda("Momentum field order %d and reconstruct %d not supported", mom.Order(), mom.Reconstruct());
+    }
+    return 0.0;
+  }
+
+#endif // GPU_GAUGE_TOOLS
+
+  void updateGaugeFieldCPU(GaugeField &out, double dt, const GaugeField &in, const GaugeField &mom,
+			   bool conj_mom, bool exact, double *action)
+  {
+#ifdef GPU_GAUGE_TOOLS
+    if (out.Precision() != in.Precision() || out.Precision() != mom.Precision())
+      errorQuda("Gauge and momentum fields must have matching precision");
+
+    if (out.Location() != QUDA_CPU_FIELD_LOCATION || in.Location() != QUDA_CPU_FIELD_LOCATION ||
+	mom.Location() != QUDA_CPU_FIELD_LOCATION)
+      errorQuda("Host gauge update requires host fields");
+
+    if (out.Order() != in.Order() || out.Reconstruct() != in.Reconstruct())
+      errorQuda("Input and output gauge field ordering and reconstruction must match");
+
+    if (out.Reconstruct() != QUDA_RECONSTRUCT_NO)
+      errorQuda("Reconstruction type %d not supported", out.Reconstruct());
+
+    double sum = 0.0;
+    if (out.Precision() == QUDA_DOUBLE_PRECISION) {
+      sum = updateGaugeFieldCPU<double>(out, in, mom, dt, conj_mom, exact, action != NULL);
+    } else if (out.Precision() == QUDA_SINGLE_PRECISION) {
+      sum = updateGaugeFieldCPU<float>(out, in, mom, dt, conj_mom, exact, action != NULL);
+    } else {
+      errorQuda("Precision %d not supported", out.Precision());
+    }
+
+    if (action) {
+      comm_allreduce(&sum);
+      *action = sum;
+    }
+#else
+    errorQuda("Gauge tools are not build");
+#endif
+  }
+
+  double computeMomActionCPU(const GaugeField &mom)
+  {
+    double action = 0.0;
+#ifdef GPU_GAUGE_TOOLS
+    if (mom.Location() != QUDA_CPU_FIELD_LOCATION)
+      errorQuda("Host momentum action requires a host field");
+
+    if (mom.Precision() == QUDA_DOUBLE_PRECISION) {
+      action = momActionCPU<double>(mom);
+    } else if (mom.Precision() == QUDA_SINGLE_PRECISION) {
+      action = momActionCPU<float>(mom);
+    } else {
+      errorQuda("Precision %d not supported", mom.Precision());
+    }
+    comm_allreduce(&action);
+#else
+    errorQuda("%s not build", __func__);
+#endif
+    return action;
+  }
+
+} // namespace quda
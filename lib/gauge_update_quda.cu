@@ -8,6 +8,7 @@
 #include <quda_matrix.h>
 #include <float_vector.h>
 #include <complex_quda.h>
+#include <gauge_update_quda.h>
 
 namespace quda {
 
@@ -321,6 +322,14 @@ namespace quda {
     if (out.Location() != in.Location() || out.Location() != mom.Location())
       errorQuda("Gauge and momentum fields must have matching location");
 
+    // use the threaded host engine where it supports the field layouts
+    if (out.Location() == QUDA_CPU_FIELD_LOCATION && out.Reconstruct() == QUDA_RECONSTRUCT_NO &&
+	(out.Order() == QUDA_QDP_GAUGE_ORDER || out.Order() == QUDA_MILC_GAUGE_ORDER) &&
+	mom.Order() == QUDA_MILC_GAUGE_ORDER && mom.Reconstruct() == QUDA_RECONSTRUCT_10) {
+      updateGaugeFieldCPU(out, dt, in, mom, conj_mom, exact);
+      return;
+    }
+
     if (out.Precision() == QUDA_DOUBLE_PRECISION) {
       updateGaugeField<double>(out, in, mom, dt, conj_mom, exact, out.Location());
     } else if (out.Precision() == QUDA_SINGLE_PRECISION) {
@@ -0,0 +1,571 @@
+#include <vector>
+
+#include <quda_internal.h>
+#include <gauge_field.h>
+#include <gauge_field_order.h>
+#include <quda_matrix.h>
+#include <index_helper.cuh>
+#include <ks_improved_force.h>
+
+namespace quda {
+  namespace fermion_force {
+
+#ifdef GPU_HISQ_FORCE
+
+    using namespace gauge;
+
+    static inline int posDir(int dir) { return (dir >= 4) ? 7-dir : dir; }
+    static inline int oppDir(int dir) { return 7-dir; }
+    static inline int CoeffSign(int pos_dir, int odd_lattice) { return 2*((pos_dir + odd_lattice + 1) & 1) - 1; }
+    static inline int Sign(int parity) { return parity ? -1 : 1; }
+
+    /**
+       Host analogue of the hisq_kernel_param_t / field pointers passed
+       to the device kernels.  The link, outer-product and force fields
+       may be extended (by two sites in each dimension) or regular, and
+       the scalar color-matrix temporaries (Pmu, P3, ...) are indexed as
+       parity*volumeCB + checkerboard index over the (extended) volume.
+     */
+    template <typename Float, typename Gauge>
+    struct HisqForceCPUArg {
+      typedef Matrix<typename ComplexTypeId<Float>::Type,3> Link;
+
+      Gauge link;
+      Gauge oprod;
+      Gauge force;
+      int X[4];           // the regular volume parameters
+      int E[4];           // the (possibly) extended volume parameters
+      int border[4];      // the radius of the extended region
+      int partitioned[4]; // whether the halo region is used rather than wrapping periodically
+      int volumeCB;       // the (possibly) extended checkerboard volume
+
+      HisqForceCPUArg(const Gauge &link, const Gauge &oprod, const Gauge &force,
+                      const GaugeField &meta, const int *X_)
+        : link(link), oprod(oprod), force(force), volumeCB(meta.VolumeCB()) {
+        for (int d=0; d<4; d++) {
+          X[d] = X_[d];
+          E[d] = meta.X()[d];
+          border[d] = (E[d] - X[d]) / 2;
+#ifdef MULTI_GPU
+          partitioned[d] = commDimPartitioned(d);
+#else
+          partitioned[d] = 0;
+#endif
+        }
+      }
+
+      /** Checkerboard index of the site y (which may lie outside the extended volume) */
+      int index(const int y[4]) const {
+        int z[4] = {y[0], y[1], y[2], y[3]};
+        int dx[4] = {0, 0, 0, 0};
+        return linkIndexShift(z, dx, E);
+      }
+
+      /** Same semantics as the device updateCoords: partitioned dimensions step into the halo */
+      void update(int y[4], int dir, int shift) const {
+        if (partitioned[dir]) y[dir] += shift;
+        else y[dir] = border[dir] + (y[dir] - border[dir] + shift + X[dir]) % X[dir];
+      }
+    };
+
+    template <typename Float, typename Gauge>
+    struct MiddleLinkCPU {
+      typedef typename HisqForceCPUArg<Float,Gauge>::Link Link;
+      int sig, mu;
+      Float coeff;
+      const Link *Pprev, *Qprev; // if NULL then this is the first link of the staple and we read oprod
+      Link *Pmu, *P3, *Qmu;      // Pmu and Qmu may be NULL
+
+      void operator()(HisqForceCPUArg<Float,Gauge> &arg, const int x[4], int parity) const {
+        const bool sig_positive = sig < 4, mu_positive = mu < 4;
+        const int mysig = posDir(sig), mymu = posDir(mu);
+        const int V = arg.volumeCB;
+
+        /*        A________B
+         *   mu   |        |
+         *       D|        |C
+         *
+         *   A is the current point (x)
+         */
+        int y[4] = {x[0], x[1], x[2], x[3]};
+        const int point_a = arg.index(y);
+        arg.update(y, mymu, mu_positive ? -1 : 1);
+        const int point_d = arg.index(y);
+        arg.update(y, mysig, sig_positive ? 1 : -1);
+        const int point_c = arg.index(y);
+        for (int d=0; d<4; d++) y[d] = x[d];
+        arg.update(y, mysig, sig_positive ? 1 : -1);
+        const int point_b = arg.index(y);
+
+        Link Uab, Ubc, Uad, Ow, Ox, Oy;
+        arg.link.load((Float*)(Uab.data), sig_positive ? point_a : point_b, mysig, sig_positive ? parity : 1-parity);
+        arg.link.load((Float*)(Ubc.data), mu_positive ? point_c : point_b, mymu, mu_positive ? parity : 1-parity);
+
+        if (!Pprev) {
+          arg.oprod.load((Float*)(Oy.data), sig_positive ? point_d : point_c, mysig, sig_positive ? 1-parity : parity);
+          if (!sig_positive) Oy = conj(Oy);
+        } else {
+          Oy = Pprev[parity*V + point_c];
+        }
+
+        Ow = mu_positive ? conj(Ubc)*Oy : Ubc*Oy;
+        if (Pmu) Pmu[(1-parity)*V + point_b] = Ow;
+
+        Oy = sig_positive ? Uab*Ow : conj(Uab)*Ow;
+        P3[parity*V + point_a] = Oy;
+
+        arg.link.load((Float*)(Uad.data), mu_positive ? point_d : point_a, mymu, mu_positive ? 1-parity : parity);
+        if (!mu_positive) Uad = conj(Uad);
+
+        if (!Qprev) {
+          if (sig_positive) Oy = Ow*Uad;
+          if (Qmu) Qmu[parity*V + point_a] = Uad;
+        } else {
+          if (Qmu || sig_positive) Ox = Qprev[(1-parity)*V + point_d] * Uad;
+          if (Qmu) Qmu[parity*V + point_a] = Ox;
+          if (sig_positive) Oy = Ow*Ox;
+        }
+
+        if (sig_positive) {
+          arg.force.load((Float*)(Ow.data), point_a, sig, parity);
+          Ow += coeff*Oy;
+          arg.force.save((Float*)(Ow.data), point_a, sig, parity);
+        }
+      }
+    };
+
+    template <typename Float, typename Gauge>
+    struct SideLinkCPU {
+      typedef typename HisqForceCPUArg<Float,Gauge>::Link Link;
+      int sig, mu;
+      Float coeff, accumu_coeff;
+      const Link *P3, *Qprod;
+      Link *shortP;
+
+      void operator()(HisqForceCPUArg<Float,Gauge> &arg, const int x[4], int parity) const {
+        const bool sig_positive = sig < 4, mu_positive = mu < 4;
+        const int mymu = posDir(mu);
+        const int V = arg.volumeCB;
+
+        int y[4] = {x[0], x[1], x[2], x[3]};
+        const int point_a = arg.index(y);
+        arg.update(y, mymu, mu_positive ? -1 : 1);
+        const int point_d = arg.index(y);
+
+        Link Uad, Ow, Ox, Oy, F;
+        Oy = P3[parity*V + point_a];
+        arg.link.load((Float*)(Uad.data), mu_positive ? point_d : point_a, mymu, mu_positive ? 1-parity : parity);
+
+        Ow = mu_positive ? Uad*Oy : conj(Uad)*Oy;
+        shortP[(1-parity)*V + point_d] += accumu_coeff*Ow;
+
+        Float mycoeff = CoeffSign(sig_positive, parity)*coeff;
+        Ox = Qprod[(1-parity)*V + point_d];
+        if (mu_positive) {
+          Ow = Oy*Ox;
+          if (!parity) mycoeff = -mycoeff;
+          arg.force.load((Float*)(F.data), point_d, mu, 1-parity);
+          F += mycoeff*Ow;
+          arg.force.save((Float*)(F.data), point_d, mu, 1-parity);
+        } else {
+          Ow = conj(Ox)*conj(Oy);
+          if (parity) mycoeff = -mycoeff;
+          arg.force.load((Float*)(F.data), point_a, oppDir(mu), parity);
+          F += mycoeff*Ow;
+          arg.force.save((Float*)(F.data), point_a, oppDir(mu), parity);
+        }
+      }
+    };
+
+    template <typename Float, typename Gauge>
+    struct SideLinkShortCPU {
+      typedef typename HisqForceCPUArg<Float,Gauge>::Link Link;
+      int sig, mu;
+      Float coeff;
+      const Link *P3;
+
+      void operator()(HisqForceCPUArg<Float,Gauge> &arg, const int x[4], int parity) const {
+        const bool sig_positive = sig < 4, mu_positive = mu < 4;
+        const int mymu = posDir(mu);
+
+        int y[4] = {x[0], x[1], x[2], x[3]};
+        const int point_a = arg.index(y);
+        arg.update(y, mymu, mu_positive ? -1 : 1);
+        const int point_d = arg.index(y);
+
+        const Link &Oy = P3[parity*arg.volumeCB + point_a];
+        Link F;
+        Float mycoeff = CoeffSign(sig_positive, parity)*coeff;
+        if (mu_positive) {
+          if (!parity) mycoeff = -mycoeff;
+          arg.force.load((Float*)(F.data), point_d, mu, 1-parity);
+          F += mycoeff*Oy;
+          arg.force.save((Float*)(F.data), point_d, mu, 1-parity);
+        } else {
+          if (parity) mycoeff = -mycoeff;
+          arg.force.load((Float*)(F.data), point_a, oppDir(mu), parity);
+          F += mycoeff*conj(Oy);
+          arg.force.save((Float*)(F.data), point_a, oppDir(mu), parity);
+        }
+      }
+    };
+
+    template <typename Float, typename Gauge>
+    struct AllLinkCPU {
+      typedef typename HisqForceCPUArg<Float,Gauge>::Link Link;
+      int sig, mu;
+      Float coeff, accumu_coeff;
+      const Link *Pprev, *Qprev;
+      Link *shortP;
+
+      void operator()(HisqForceCPUArg<Float,Gauge> &arg, const int x[4], int parity) const {
+        const bool sig_positive = sig < 4, mu_positive = mu < 4;
+        const int mysig = posDir(sig), mymu = posDir(mu);
+        const int V = arg.volumeCB;
+
+        int y[4] = {x[0], x[1], x[2], x[3]};
+        const int point_a = arg.index(y);
+        arg.update(y, mysig, sig_positive ? 1 : -1);
+        const int point_b = arg.index(y);
+        for (int d=0; d<4; d++) y[d] = x[d];
+        arg.update(y, mymu, mu_positive ? -1 : 1);
+        const int point_d = arg.index(y);
+        arg.update(y, mysig, sig_positive ? 1 : -1);
+        const int point_c = arg.index(y);
+
+        const Float mycoeff = CoeffSign(sig_positive, parity)*coeff;
+        Link Uab, Ubc, Uad, Ow, Ox, Oy, Oz, F;
+
+        Ox = Qprev[(1-parity)*V + point_d];
+        Oy = Pprev[parity*V + point_c];
+        arg.link.load((Float*)(Uab.data), sig_positive ? point_a : point_b, mysig, sig_positive ? parity : 1-parity);
+
+        if (mu_positive) {
+          arg.link.load((Float*)(Uad.data), point_d, mymu, 1-parity);
+          arg.link.load((Float*)(Ubc.data), point_c, mymu, parity);
+
+          Oz = conj(Ubc)*Oy;
+          if (sig_positive) {
+            Ow = Oz*Ox*Uad;
+            arg.force.load((Float*)(F.data), point_a, sig, parity);
+            F += (Sign(parity)*mycoeff)*Ow;
+            arg.force.save((Float*)(F.data), point_a, sig, parity);
+          }
+
+          Oy = sig_positive ? Uab*Oz : conj(Uab)*Oz;
+          Ow = Oy*Ox;
+          arg.force.load((Float*)(F.data), point_d, mymu, 1-parity);
+          F += (-Sign(parity)*mycoeff)*Ow;
+          arg.force.save((Float*)(F.data), point_d, mymu, 1-parity);
+
+          shortP[(1-parity)*V + point_d] += accumu_coeff*(Uad*Oy);
+        } else {
+          arg.link.load((Float*)(Uad.data), point_a, mymu, parity);
+          arg.link.load((Float*)(Ubc.data), point_b, mymu, 1-parity);
+
+          Oz = Ubc*Oy;
+          if (sig_positive) {
+            Ow = Oz*(Ox*conj(Uad));
+            arg.force.load((Float*)(F.data), point_a, sig, parity);
+            F += (Sign(parity)*mycoeff)*Ow;
+            arg.force.save((Float*)(F.data), point_a, sig, parity);
+          }
+
+          Oy = sig_positive ? Uab*Oz : conj(Uab)*Oz;
+          Ow = conj(Ox)*conj(Oy);
+          arg.force.load((Float*)(F.data), point_a, mymu, parity);
+          F += (Sign(parity)*mycoeff)*Ow;
+          arg.force.save((Float*)(F.data), point_a, mymu, parity);
+
+          shortP[(1-parity)*V + point_d] += accumu_coeff*(conj(Uad)*Oy);
+        }
+      }
+    };
+
+    template <typename Float, typename Gauge>
+    struct OneLinkTermCPU {
+      Float coeff;
+      void operator()(HisqForceCPUArg<Float,Gauge> &arg, const int x[4], int parity) const {
+        typename HisqForceCPUArg<Float,Gauge>::Link O, F;
+        int y[4] = {x[0], x[1], x[2], x[3]};
+        const int point_a = arg.index(y);
+        for (int sig=0; sig<4; sig++) {
+          arg.oprod.load((Float*)(O.data), point_a, sig, parity);
+          arg.force.load((Float*)(F.data), point_a, sig, parity);
+          F += coeff*O;
+          arg.force.save((Float*)(F.data), point_a, sig, parity);
+        }
+      }
+    };
+
+    template <typename Float, typename Gauge>
+    struct LongLinkTermCPU {
+      Float coeff;
+      void operator()(HisqForceCPUArg<Float,Gauge> &arg, const int x[4], int parity) const {
+        typename HisqForceCPUArg<Float,Gauge>::Link Uab, Ubc, Ude, Uef, Ox, Oy, Oz, F;
+        int y[4] = {x[0], x[1], x[2], x[3]};
+        const int point_c = arg.index(y);
+
+        /*
+         *    A   B    C    D    E
+         *    ---- ---- ---- ----
+         *
+         *   ---> sig direction, C is the current point
+         */
+        for (int sig=0; sig<4; sig++) {
+          int dx[4] = {0, 0, 0, 0};
+          dx[sig] = 1;  const int point_d = linkIndexShift(y, dx, arg.E);
+          dx[sig] = 2;  const int point_e = linkIndexShift(y, dx, arg.E);
+          dx[sig] = -1; const int point_b = linkIndexShift(y, dx, arg.E);
+          dx[sig] = -2; const int point_a = linkIndexShift(y, dx, arg.E);
+
+          arg.link.load((Float*)(Uab.data), point_a, sig, parity);
+          arg.link.load((Float*)(Ubc.data), point_b, sig, 1-parity);
+          arg.link.load((Float*)(Ude.data), point_d, sig, 1-parity);
+          arg.link.load((Float*)(Uef.data), point_e, sig, parity);
+
+          arg.oprod.load((Float*)(Oz.data), point_c, sig, parity);
+          arg.oprod.load((Float*)(Oy.data), point_b, sig, 1-parity);
+          arg.oprod.load((Float*)(Ox.data), point_a, sig, parity);
+
+          arg.force.load((Float*)(F.data), point_c, sig, parity);
+          F += coeff*(Ude*Uef*Oz - Ude*Oy*Ubc + Ox*Uab*Ubc);
+          arg.force.save((Float*)(F.data), point_c, sig, parity);
+        }
+      }
+    };
+
+    /**
+       Apply a site functor to every site of both parities in the
+       interior volume, grown by radius sites into the halo of each
+       partitioned dimension (radius 2 and 1 correspond to the device
+       kparam_2g and kparam_1g domains).  Each of the force-path
+       functors writes to sites and directions that are unique to the
+       site it is called on, so the loop can be threaded freely.
+     */
+    template <typename Float, typename Gauge, typename Functor>
+    void hisqForceSites(HisqForceCPUArg<Float,Gauge> &arg, int radius, const Functor &f) {
+      int lo[4], D[4];
+      for (int d=0; d<4; d++) {
+        const int r = arg.partitioned[d] ? radius : 0;
+        lo[d] = arg.border[d] - r;
+        D[d] = arg.X[d] + 2*r;
+      }
+      const int volume = D[0]*D[1]*D[2]*D[3];
+
+#pragma omp parallel for
+      for (int i=0; i<volume; i++) {
+        int x[4];
+        int j = i;
+        for (int d=0; d<4; d++) { x[d] = lo[d] + j % D[d]; j /= D[d]; }
+        const int parity = (x[0] + x[1] + x[2] + x[3]) & 1;
+        f(arg, x, parity);
+      }
+    }
+
+    template <typename Float, typename Gauge>
+    void hisqStaplesForceCPU(HisqForceCPUArg<Float,Gauge> &arg, const double path_coeff[6]) {
+      typedef typename HisqForceCPUArg<Float,Gauge>::Link Link;
+
+      const Float OneLink = path_coeff[0];
+      const Float ThreeSt = path_coeff[2], mThreeSt = -ThreeSt;
+      const Float FiveSt  = path_coeff[3], mFiveSt  = -FiveSt;
+      const Float SevenSt = path_coeff[4];
+      const Float Lepage  = path_coeff[5], mLepage  = -Lepage;
+
+      std::vector<Link> Pmu(2*arg.volumeCB), P3(2*arg.volumeCB), P5(2*arg.volumeCB);
+      std::vector<Link> Pnumu(2*arg.volumeCB), Qmu(2*arg.volumeCB), Qnumu(2*arg.volumeCB);
+
+      OneLinkTermCPU<Float,Gauge> oneLink = { OneLink };
+      hisqForceSites(arg, 0, oneLink);
+
+      for (int sig=0; sig<8; sig++) {
+        for (int mu=0; mu<8; mu++) {
+          if (mu == sig || mu == oppDir(sig)) continue;
+
+          // 3-link: middle link
+          MiddleLinkCPU<Float,Gauge> middleLink3 = { sig, mu, mThreeSt, NULL, NULL, &Pmu[0], &P3[0], &Qmu[0] };
+          hisqForceSites(arg, 2, middleLink3);
+
+          for (int nu=0; nu<8; nu++) {
+            if (nu == sig || nu == oppDir(sig) || nu == mu || nu == oppDir(mu)) continue;
+
+            // 5-link: middle link
+            MiddleLinkCPU<Float,Gauge> middleLink5 = { sig, nu, FiveSt, &Pmu[0], &Qmu[0], &Pnumu[0], &P5[0], &Qnumu[0] };
+            hisqForceSites(arg, 1, middleLink5);
+
+            for (int rho=0; rho<8; rho++) {
+              if (rho == sig || rho == oppDir(sig) || rho == mu || rho == oppDir(mu)
+                  || rho == nu || rho == oppDir(nu)) continue;
+
+              // 7-link: middle link and side link
+              AllLinkCPU<Float,Gauge> allLink = { sig, rho, SevenSt, FiveSt != 0 ? SevenSt/FiveSt : 0,
+                                                  &Pnumu[0], &Qnumu[0], &P5[0] };
+              hisqForceSites(arg, 1, allLink);
+            }
+
+            // 5-link: side link
+            SideLinkCPU<Float,Gauge> sideLink5 = { sig, nu, mFiveSt, ThreeSt != 0 ? FiveSt/ThreeSt : 0,
+                                                   &P5[0], &Qmu[0], &P3[0] };
+            hisqForceSites(arg, 1, sideLink5);
+          }
+
+          // Lepage
+          if (Lepage != 0.) {
+            MiddleLinkCPU<Float,Gauge> lepageMiddleLink = { sig, mu, Lepage, &Pmu[0], &Qmu[0], NULL, &P5[0], NULL };
+            hisqForceSites(arg, 2, lepageMiddleLink);
+
+            SideLinkCPU<Float,Gauge> lepageSideLink = { sig, mu, mLepage, ThreeSt != 0 ? Lepage/ThreeSt : 0,
+                                                        &P5[0], &Qmu[0], &P3[0] };
+            hisqForceSites(arg, 2, lepageSideLink);
+          }
+
+          // 3-link side link
+          SideLinkShortCPU<Float,Gauge> sideLinkShort = { sig, mu, ThreeSt, &P3[0] };
+          hisqForceSites(arg, 1, sideLinkShort);
+        }
+      }
+    }
+
+    template <typename Float, typename Gauge, typename Mom>
+    void hisqCompleteForceCPU(HisqForceCPUArg<Float,Gauge> &arg, Mom mom) {
+      const int volumeCB = arg.X[0]*arg.X[1]*arg.X[2]*arg.X[3]/2;
+
+#pragma omp parallel for
+      for (int i=0; i<2*volumeCB; i++) {
+        const int parity = i / volumeCB;
+        const int x_cb = i - parity*volumeCB;
+        int x[4];
+        getCoords(x, x_cb, arg.X, parity);
+        for (int d=0; d<4; d++) x[d] += arg.border[d];
+        const int e_cb = linkIndex(x, arg.E);
+
+        for (int sig=0; sig<4; sig++) {
+          typename HisqForceCPUArg<Float,Gauge>::Link Uw, Ox, Ow;
+          arg.link.load((Float*)(Uw.data), e_cb, sig, parity);
+          arg.oprod.load((Float*)(Ox.data), e_cb, sig, parity);
+          Ow = Uw*Ox;
+          makeAntiHerm(Ow);
+          const Float coeff = parity ? -1 : 1;
+
+          Float m[10];
+          m[0] = coeff*Ow(0,1).x; m[1] = coeff*Ow(0,1).y;
+          m[2] = coeff*Ow(0,2).x; m[3] = coeff*Ow(0,2).y;
+          m[4] = coeff*Ow(1,2).x; m[5] = coeff*Ow(1,2).y;
+          m[6] = coeff*Ow(0,0).y; m[7] = coeff*Ow(1,1).y; m[8] = coeff*Ow(2,2).y;
+          m[9] = 0.0;
+          mom.save(m, x_cb, sig, parity);
+        }
+      }
+    }
+
+    static void checkHisqForceFields(const QudaGaugeParam &param, const GaugeField &a, const GaugeField &b) {
+      if (a.Precision() != b.Precision())
+        errorQuda("Field precisions %d %d do not match", a.Precision(), b.Precision());
+      if (a.Order() != b.Order())
+        errorQuda("Field orders %d %d do not match", a.Order(), b.Order());
+      if (a.Reconstruct() != QUDA_RECONSTRUCT_NO || b.Reconstruct() != QUDA_RECONSTRUCT_NO)
+        errorQuda("Reconstruction types %d %d not supported", a.Reconstruct(), b.Reconstruct());
+      for (int d=0; d<4; d++) {
+        if (a.X()[d] != b.X()[d]) errorQuda("Field dimensions do not match");
+        const int border = (a.X()[d] - param.X[d]) / 2;
+        if (border != 0 && border != 2) errorQuda("Extended field radius %d not supported in dimension %d", border, d);
+#ifdef MULTI_GPU
+        if (commDimPartitioned(d) && border == 0)
+          errorQuda("Extended fields required for partitioned dimension %d", d);
+#endif
+      }
+    }
+
+    template <typename Float, typename Gauge>
+    void hisqStaplesForceCPU(const double path_coeff[6], const QudaGaugeParam &param,
+                             const GaugeField &oprod, const GaugeField &link, GaugeField &newOprod) {
+      HisqForceCPUArg<Float,Gauge> arg((Gauge(link)), Gauge(oprod), Gauge(newOprod), link, param.X);
+      hisqStaplesForceCPU(arg, path_coeff);
+    }
+
+    template <typename Float, typename Gauge>
+    void hisqLongLinkForceCPU(double coeff, const QudaGaugeParam &param,
+                              const GaugeField &oprod, const GaugeField &link, GaugeField &newOprod) {
+      HisqForceCPUArg<Float,Gauge> arg((Gauge(link)), Gauge(oprod), Gauge(newOprod), link, param.X);
+      LongLinkTermCPU<Float,Gauge> longLink = { static_cast<Float>(coeff) };
+      hisqForceSites(arg, 0, longLink);
+    }
+
+    template <typename Float, typename Gauge>
+    void hisqCompleteForceCPU(const QudaGaugeParam &param, const GaugeField &oprod,
+                              const GaugeField &link, GaugeField &mom) {
+      if (mom.Order() != QUDA_MILC_GAUGE_ORDER || mom.Reconstruct() != QUDA_RECONSTRUCT_10)
+        errorQuda("Momentum field order %d and reconstruct %d not supported", mom.Order(), mom.Reconstruct());
+      HisqForceCPUArg<Float,Gauge> arg((Gauge(link)), Gauge(oprod), Gauge(oprod), link, param.X);
+      hisqCompleteForceCPU<Float>(arg, MILCOrder<Float,10>(mom));
+    }
+
+    // instantiate the host force stages for each supported precision and field order
+#define HISQ_FORCE_CPU_DISPATCH(func, field, ...)                       \
+    if (field.Precision() == QUDA_DOUBLE_PRECISION) {                   \
+      if (field.Order() == QUDA_QDP_GAUGE_ORDER) func<double,QDPOrder<double,18> >(__VA_ARGS__); \
+      else if (field.Order() == QUDA_MILC_GAUGE_ORDER) func<double,MILCOrder<double,18> >(__VA_ARGS__); \
+      else errorQuda("Gauge field order %d not supported", field.Order()); \
+    } else if (field.Precision() == QUDA_SINGLE_PRECISION) {            \
+      if (field.Order() == QUDA_QDP_GAUGE_ORDER) func<float,QDPOrder<float,18> >(__VA_ARGS__); \
+      else if (field.Order() == QUDA_MILC_GAUGE_ORDER) func<float,MILCOrder<float,18> >(__VA_ARGS__); \
+      else errorQuda("Gauge field order %d not supported", field.Order()); \
+    } else {                                                            \
+      errorQuda("Precision %d not supported", field.Precision());      \
+    }
+
+#endif // GPU_HISQ_FORCE
+
+    void hisqStaplesForceCPU(const double path_coeff[6], const QudaGaugeParam &param,
+                             const cpuGaugeField &oprod, const cpuGaugeField &link,
+                             cpuGaugeField *newOprod, long long *flops)
+    {
+#ifdef GPU_HISQ_FORCE
+      checkHisqForceFields(param, oprod, link);
+      checkHisqForceFields(param, *newOprod, link);
+      HISQ_FORCE_CPU_DISPATCH(hisqStaplesForceCPU, link, path_coeff, param, oprod, link, *newOprod);
+
+      if (flops) {
+        // same accounting as hisqStaplesForceCuda
+        *flops = (134784 + 24192 + 103680 + 864 + 397440 + 72);
+        if (path_coeff[5] != 0.) *flops += 28944;
+        *flops *= (long long)param.X[0]*param.X[1]*param.X[2]*param.X[3];
+      }
+#else
+      errorQuda("HISQ force has not been built");
+#endif
+    }
+
+    void hisqLongLinkForceCPU(double coeff, const QudaGaugeParam &param,
+                              const cpuGaugeField &oprod, const cpuGaugeField &link,
+                              cpuGaugeField *newOprod, long long *flops)
+    {
+#ifdef GPU_HISQ_FORCE
+      checkHisqForceFields(param, oprod, link);
+      checkHisqForceFields(param, *newOprod, link);
+      HISQ_FORCE_CPU_DISPATCH(hisqLongLinkForceCPU, link, coeff, param, oprod, link, *newOprod);
+      if (flops) *flops = 4968ll*param.X[0]*param.X[1]*param.X[2]*param.X[3];
+#else
+      errorQuda("HISQ force has not been built");
+#endif
+    }
+
+    void hisqCompleteForceCPU(const QudaGaugeParam &param, const cpuGaugeField &oprod,
+                              const cpuGaugeField &link, cpuGaugeField *mom, long long *flops)
+    {
+#ifdef GPU_HISQ_FORCE
+      checkHisqForceFields(param, oprod, link);
+      if (mom->Precision() != link.Precision())
+        errorQuda("Momentum precision %d does not match link precision %d", mom->Precision(), link.Precision());
+      HISQ_FORCE_CPU_DISPATCH(hisqCompleteForceCPU, link, param, oprod, link, *mom);
+      if (flops) *flops = 792ll*param.X[0]*param.X[1]*param.X[2]*param.X[3];
+#else
+      errorQuda("HISQ force has not been built");
+#endif
+    }
+
+#undef HISQ_FORCE_CPU_DISPATCH
+
+  } // namespace fermion_force
+} // namespace quda
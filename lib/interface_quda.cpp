@@ -4,6 +4,7 @@
 #include <math.h>
 #include <string.h>
 #include <sys/time.h>
+#include <pthread.h>
 
 #include <quda.h>
 #include <quda_fortran.h>
@@ -29,6 +30,8 @@
 #include <ks_force_quda.h>
 
 #include <multigrid.h>
+#include <worker.h>
+#include <deque>
 
 #ifdef NUMA_AFFINITY
 #include <numa_affinity.h>
@@ -139,6 +142,138 @@ cudaGaugeField *extendedGaugeResident = NULL;
 
 std::vector<cudaColorSpinorField*> solutionResident;
 
+// basis of previous solutions for the extrapolated initial guess of invertQuda
+static MinResExt *chronoResident = NULL;
+static uint64_t chronoKey = 0;
+
+/**
+   Fingerprint of the host data and parameters that the resident
+   fields were last loaded from.  Repeated calls to loadGaugeQuda and
+   loadCloverQuda with unchanged input find a matching fingerprint
+   and reuse the resident fields instead of reordering, uploading and
+   rebuilding them.  Any operation that changes the resident fields
+   other than a load invalidates the fingerprint.
+ */
+struct ResidentFingerprint {
+  bool valid;
+  uint64_t key;
+  QudaLinkType type; // link type of a resident gauge field
+  double GiB;        // footprint reported back to the caller on a hit
+  double trlog[2];   // clover trace log reported back on a hit
+  ResidentFingerprint() : valid(false), key(0), type(QUDA_INVALID_LINKS), GiB(0.0) { trlog[0] = trlog[1] = 0.0; }
+};
+
+static ResidentFingerprint fingerprintGauge; // Wilson or fat links (these share storage)
+static ResidentFingerprint fingerprintLong;  // long links
+static ResidentFingerprint fingerprintClover;
+
+// number of loads and other changes of the resident fields
+static uint64_t gaugeVersion = 0;
+static uint64_t cloverVersion = 0;
+
+static void invalidateGaugeFingerprint() {
+  fingerprintGauge.valid = false;
+  fingerprintLong.valid = false;
+  gaugeVersion++;
+}
+
+static void invalidateCloverFingerprint() {
+  fingerprintClover.valid = false;
+  cloverVersion++;
+}
+
+static inline uint64_t mixFingerprint(uint64_t x) {
+  x ^= x >> 30; x *= 0xbf58476d1ce4e5b9ULL;
+  x ^= x >> 27; x *= 0x94d049bb133111ebULL;
+  x ^= x >> 31;
+  return x;
+}
+
+/**
+   Position-dependent hash of a host buffer.  Every word is mixed with
+   its index and the results are summed, so the hash reduces over
+   threads and runs at memory bandwidth, while still detecting both
+   changed and permuted data.
+ */
+static uint64_t fingerprintBuffer(const void *buffer, size_t bytes, uint64_t seed) {
+  const char *data = static_cast<const char*>(buffer);
+  const long n = bytes / sizeof(uint64_t);
+  uint64_t sum = 0;
+#pragma omp parallel for reduction(+:sum)
+  for (long i=0; i<n; i++) {
+    uint64_t w;
+    memcpy(&w, data + i*sizeof(uint64_t), sizeof(uint64_t));
+    sum += mixFingerprint(w + (seed + i)*0x9e3779b97f4a7c15ULL);
+  }
+  const size_t tail = bytes % sizeof(uint64_t);
+  if (tail) {
+    uint64_t w = 0;
+    memcpy(&w, data + n*sizeof(uint64_t), tail);
+    sum += mixFingerprint(w + (seed + n)*0x9e3779b97f4a7c15ULL);
+  }
+  return mixFingerprint(sum ^ seed);
+}
+
+static uint64_t gaugeFingerprint(void *h_gauge, const QudaGaugeParam &param) {
+  const int ikey[] = { param.X[0], param.X[1], param.X[2], param.X[3], param.type, param.gauge_order,
+		       param.t_boundary, param.cpu_prec, param.cuda_prec, param.reconstruct,
+		       param.cuda_prec_sloppy, param.reconstruct_sloppy, param.cuda_prec_precondition,
+		       param.reconstruct_precondition, param.gauge_fix, param.ga_pad,
+		       param.staggered_phase_type, param.staggered_phase_applied, param.overlap };
+  const double dkey[] = { param.anisotropy, param.tadpole_coeff, param.scale, param.i_mu };
+  uint64_t key = fingerprintBuffer(ikey, sizeof(ikey), 0);
+  key = fingerprintBuffer(dkey, sizeof(dkey), key);
+
+  const size_t bytes = (size_t)param.X[0]*param.X[1]*param.X[2]*param.X[3]*18*param.cpu_prec; // per direction
+  if (param.gauge_order == QUDA_QDP_GAUGE_ORDER || param.gauge_order == QUDA_QDPJIT_GAUGE_ORDER) {
+    for (int d=0; d<4; d++) key = fingerprintBuffer(static_cast<void**>(h_gauge)[d], bytes, key);
+  } else {
+    key = fingerprintBuffer(h_gauge, 4*bytes, key);
+  }
+  return key;
+}
+
+static uint64_t cloverFingerprint(void *h_clover, void *h_clovinv, const QudaInvertParam &param,
+				  bool pc_solve, bool device_calc) {
+  const int ikey[] = { param.dslash_type, param.clover_cpu_prec, param.clover_order, param.clover_cuda_prec,
+		       param.clover_cuda_prec_sloppy, param.clover_cuda_prec_precondition, param.cuda_prec,
+		       param.cl_pad, pc_solve, param.compute_clover_trlog, param.clover_location,
+		       param.clover_calc_location,
+		       device_calc, h_clover ? 1 : 0, h_clovinv ? 1 : 0 };
+  const double dkey[] = { param.clover_coeff, param.kappa, param.mu, param.epsilon };
+  uint64_t key = fingerprintBuffer(ikey, sizeof(ikey), 0);
+  key = fingerprintBuffer(dkey, sizeof(dkey), key);
+
+  if (device_calc) { // the clover term is built from the resident gauge field
+    key = fingerprintBuffer(&fingerprintGauge.key, sizeof(uint64_t), key);
+  } else {
+    const size_t bytes = (size_t)gaugePrecise->Volume()*72*param.clover_cpu_prec;
+    if (h_clover) key = fingerprintBuffer(h_clover, bytes, key);
+    if (h_clovinv) key = fingerprintBuffer(h_clovinv, bytes, key);
+  }
+  return key;
+}
+
+/**
+   @return Whether the fingerprint matches the resident one on every
+   process, so that all processes take the same path
+ */
+static bool matchFingerprint(const ResidentFingerprint &resident, uint64_t key, bool resident_exists) {
+  int miss = (resident.valid && resident_exists && resident.key == key) ? 0 : 1;
+  comm_allreduce_int(&miss);
+  return miss == 0;
+}
+
+namespace quda {
+
+  // the fingerprint of the last load, mixed with the version since a
+  // change other than a load leaves the fingerprint unchanged
+  uint64_t residentGaugeKey() { return fingerprintBuffer(&gaugeVersion, sizeof(uint64_t), fingerprintGauge.key); }
+
+  uint64_t residentCloverKey() { return fingerprintBuffer(&cloverVersion, sizeof(uint64_t), fingerprintClover.key); }
+
+}
+
 // Mapped memory buffer used to hold unitarization failures
 static int *num_failures_h = NULL;
 static int *num_failures_d = NULL;
@@ -163,6 +298,12 @@ static TimeProfile profileClover("loadCloverQuda");
 //!< Profiler for invertQuda
 static TimeProfile profileInvert("invertQuda");
 
+//!< Profiler for invertMultiSrcQuda
+static TimeProfile profileMultiSrc("invertMultiSrcQuda");
+
+//!< Profiler for invertQudaAsync / waitQuda, kept out of the global profile since it runs concurrently with the solves
+static TimeProfile profileAsync("invertQudaAsync", false);
+
 //!< Profiler for invertMultiShiftQuda
 static TimeProfile profileMulti("invertMultiShiftQuda");
 
@@ -342,6 +483,8 @@ static void init_default_comms()
   }
 #elif defined(MPI_COMMS)
   errorQuda("When using MPI for communications, initCommsGridQuda() must be called before initQuda()");
+#elif defined(THREAD_COMMS)
+  errorQuda("When using threaded communications, initCommsGridQuda() must be called before initQuda()");
 #else // single-GPU
   const int dims[4] = {1, 1, 1, 1};
   initCommsGridQuda(4, dims, NULL, NULL);
@@ -501,6 +644,20 @@ void initQuda(int dev)
 }
 
 
+static void freeResidentLinks(cudaGaugeField *&precise, cudaGaugeField *&sloppy,
+			      cudaGaugeField *&precondition, cudaGaugeField *&extended)
+{
+  if (sloppy != precondition && precondition) delete precondition;
+  if (precise != sloppy && sloppy) delete sloppy;
+  if (precise) delete precise;
+  if (extended) delete extended;
+
+  precondition = NULL;
+  sloppy = NULL;
+  precise = NULL;
+  extended = NULL;
+}
+
 void loadGaugeQuda(void *h_gauge, QudaGaugeParam *param)
 {
   //printfQuda("loadGaugeQuda use_resident_gauge = %d phase=%d\n",
@@ -513,6 +670,39 @@ void loadGaugeQuda(void *h_gauge, QudaGaugeParam *param)
 
   checkGaugeParam(param);
 
+  // skip the reorder and upload if the resident field was loaded from identical input
+  ResidentFingerprint &resident = (param->type == QUDA_ASQTAD_LONG_LINKS) ? fingerprintLong : fingerprintGauge;
+  const bool use_fingerprint = param->location == QUDA_CPU_FIELD_LOCATION && !param->use_resident_gauge;
+  uint64_t fingerprint = 0;
+  if (use_fingerprint) {
+    profileGauge.TPSTART(QUDA_PROFILE_FINGERPRINT);
+    fingerprint = gaugeFingerprint(h_gauge, *param);
+    profileGauge.TPSTOP(QUDA_PROFILE_FINGERPRINT);
+
+    bool resident_exists = (param->type == QUDA_ASQTAD_LONG_LINKS) ?
+      (gaugeLongPrecise && gaugeLongSloppy && gaugeLongPrecondition && (!param->overlap || gaugeLongExtended)) :
+      (gaugePrecise && gaugeSloppy && gaugePrecondition && (!param->overlap || gaugeExtended));
+
+    if (matchFingerprint(resident, fingerprint, resident_exists)) {
+      profileGauge.TPSTART(QUDA_PROFILE_RESIDENT_HIT);
+      param->gaugeGiB += resident.GiB;
+      if (getVerbosity() >= QUDA_VERBOSE)
+	printfQuda("Resident gauge field fingerprint %016llx matches, skipping load\n", (unsigned long long)fingerprint);
+      profileGauge.TPSTOP(QUDA_PROFILE_RESIDENT_HIT);
+      profileGauge.TPSTOP(QUDA_PROFILE_TOTAL);
+      return;
+    }
+  }
+  // reloading fat or long links replaces any resident links of that
+  // type, including those whose fingerprint has been invalidated
+  if (param->type == QUDA_ASQTAD_FAT_LINKS)
+    freeResidentLinks(gaugeFatPrecise, gaugeFatSloppy, gaugeFatPrecondition, gaugeFatExtended);
+  else if (param->type == QUDA_ASQTAD_LONG_LINKS)
+    freeResidentLinks(gaugeLongPrecise, gaugeLongSloppy, gaugeLongPrecondition, gaugeLongExtended);
+  resident.valid = false;
+  gaugeVersion++;
+  const double gaugeGiB = param->gaugeGiB;
+
   profileGauge.TPSTART(QUDA_PROFILE_INIT);
   // Set the specific input parameters and create the cpu gauge field
   GaugeFieldParam gauge_param(h_gauge, *param);
@@ -658,6 +848,13 @@ void loadGaugeQuda(void *h_gauge, QudaGaugeParam *param)
   delete in;
   profileGauge.TPSTOP(QUDA_PROFILE_FREE);
 
+  if (use_fingerprint) {
+    resident.valid = true;
+    resident.key = fingerprint;
+    resident.type = param->type;
+    resident.GiB = param->gaugeGiB - gaugeGiB;
+  }
+
   profileGauge.TPSTOP(QUDA_PROFILE_TOTAL);
 }
 
@@ -750,6 +947,37 @@ void loadCloverQuda(void *h_clover, void *h_clovinv, QudaInvertParam *inv_param)
     warningQuda("Uninverted clover term not loaded");
   }
 
+  // skip the upload and rebuild if the resident clover was created from identical input
+  bool use_fingerprint = device_calc ? fingerprintGauge.valid : inv_param->clover_location == QUDA_CPU_FIELD_LOCATION;
+  uint64_t fingerprint = 0;
+  if (use_fingerprint) {
+    profileClover.TPSTART(QUDA_PROFILE_FINGERPRINT);
+    fingerprint = cloverFingerprint(h_clover, h_clovinv, *inv_param, pc_solve, device_calc);
+    profileClover.TPSTOP(QUDA_PROFILE_FINGERPRINT);
+
+    bool resident_exists = cloverPrecise && cloverSloppy && cloverPrecondition;
+#ifndef DYNAMIC_CLOVER
+    if (inv_param->dslash_type == QUDA_TWISTED_CLOVER_DSLASH)
+      resident_exists = resident_exists && cloverInvPrecise && cloverInvSloppy && cloverInvPrecondition;
+#endif
+
+    if (matchFingerprint(fingerprintClover, fingerprint, resident_exists)) {
+      profileClover.TPSTART(QUDA_PROFILE_RESIDENT_HIT);
+      inv_param->cloverGiB = fingerprintClover.GiB;
+      if (inv_param->compute_clover_trlog) {
+	inv_param->trlogA[0] = fingerprintClover.trlog[0];
+	inv_param->trlogA[1] = fingerprintClover.trlog[1];
+      }
+      if (getVerbosity() >= QUDA_VERBOSE)
+	printfQuda("Resident clover field fingerprint %016llx matches, skipping load\n", (unsigned long long)fingerprint);
+      profileClover.TPSTOP(QUDA_PROFILE_RESIDENT_HIT);
+      popVerbosity();
+      profileClover.TPSTOP(QUDA_PROFILE_TOTAL);
+      return;
+    }
+  }
+  invalidateCloverFingerprint();
+
   CloverFieldParam clover_param;
   CloverField *in=NULL, *inInv=NULL;
 
@@ -858,7 +1086,10 @@ void loadCloverQuda(void *h_clover, void *h_clovinv, QudaInvertParam *inv_param)
   }
 
   // inverted clover term is required when applying preconditioned operator
-  if ((!h_clovinv && pc_solve) && inv_param->dslash_type != QUDA_TWISTED_CLOVER_DSLASH) {
+  // the host construction computes the inverse (and trace log) in the same pass
+  bool host_calc = device_calc && inv_param->clover_calc_location == QUDA_CPU_FIELD_LOCATION;
+
+  if ((!h_clovinv && pc_solve) && inv_param->dslash_type != QUDA_TWISTED_CLOVER_DSLASH && !host_calc) {
     profileClover.TPSTART(QUDA_PROFILE_COMPUTE);
     cloverInvert(*cloverPrecise, inv_param->compute_clover_trlog, QUDA_CUDA_FIELD_LOCATION);
     profileClover.TPSTOP(QUDA_PROFILE_COMPUTE);
@@ -976,6 +1207,21 @@ void loadCloverQuda(void *h_clover, void *h_clovinv, QudaInvertParam *inv_param)
     profileClover.TPSTOP(QUDA_PROFILE_D2H);
 
     checkCudaError();
+
+    // the host clover field now holds the odd inverse, so fingerprint what the caller will pass next time
+    if (use_fingerprint) {
+      profileClover.TPSTART(QUDA_PROFILE_FINGERPRINT);
+      fingerprint = cloverFingerprint(h_clover, h_clovinv, *inv_param, pc_solve, device_calc);
+      profileClover.TPSTOP(QUDA_PROFILE_FINGERPRINT);
+    }
+  }
+
+  if (use_fingerprint) {
+    fingerprintClover.valid = true;
+    fingerprintClover.key = fingerprint;
+    fingerprintClover.GiB = inv_param->cloverGiB;
+    fingerprintClover.trlog[0] = inv_param->trlogA[0];
+    fingerprintClover.trlog[1] = inv_param->trlogA[1];
   }
 
   if(!device_calc)
@@ -994,6 +1240,7 @@ void loadCloverQuda(void *h_clover, void *h_clovinv, QudaInvertParam *inv_param)
 void freeGaugeQuda(void)
 {
   if (!initialized) errorQuda("QUDA not initialized");
+  invalidateGaugeFingerprint();
   if (gaugeSloppy != gaugePrecondition && gaugePrecondition) delete gaugePrecondition;
   if (gaugePrecise != gaugeSloppy && gaugeSloppy) delete gaugeSloppy;
   if (gaugePrecise) delete gaugePrecise;
@@ -1038,6 +1285,7 @@ void freeGaugeQuda(void)
 void freeSloppyGaugeQuda(void)
 {
   if (!initialized) errorQuda("QUDA not initialized");
+  invalidateGaugeFingerprint();
   if (gaugeSloppy != gaugePrecondition && gaugePrecondition) delete gaugePrecondition;
   if (gaugePrecise != gaugeSloppy && gaugeSloppy) delete gaugeSloppy;
 
@@ -1060,6 +1308,9 @@ void freeSloppyGaugeQuda(void)
 
 void loadSloppyGaugeQuda(QudaPrecision prec_sloppy, QudaPrecision prec_precondition)
 {
+  // the rebuilt fields no longer match the parameters of the last load
+  invalidateGaugeFingerprint();
+
   // first do SU3 links (if they exist)
   if (gaugePrecise) {
     GaugeFieldParam gauge_param(*gaugePrecise);
@@ -1164,6 +1415,7 @@ void loadSloppyGaugeQuda(QudaPrecision prec_sloppy, QudaPrecision prec_precondit
 void freeCloverQuda(void)
 {
   if (!initialized) errorQuda("QUDA not initialized");
+  invalidateCloverFingerprint();
   if (cloverPrecondition != cloverSloppy && cloverPrecondition) delete cloverPrecondition;
   if (cloverSloppy != cloverPrecise && cloverSloppy) delete cloverSloppy;
   if (cloverPrecise) delete cloverPrecise;
@@ -1183,12 +1435,16 @@ void freeCloverQuda(void)
   }
 }
 
+static void drainAsyncQuda();
+
 void endQuda(void)
 {
   profileEnd.TPSTART(QUDA_PROFILE_TOTAL);
 
   if (!initialized) return;
 
+  drainAsyncQuda();
+
   LatticeField::freeBuffer(0);
   LatticeField::freeBuffer(1);
   cudaColorSpinorField::freeBuffer(0);
@@ -1209,6 +1465,9 @@ void endQuda(void)
   solutionResident.clear();
   if(momResident) delete momResident;
 
+  if (chronoResident) delete chronoResident;
+  chronoResident = NULL;
+
   blas::end();
 
   host_free(num_failures_h);
@@ -1247,6 +1506,8 @@ void endQuda(void)
     profileCloverCreate.Print();
     profileClover.Print();
     profileInvert.Print();
+    profileMultiSrc.Print();
+    profileAsync.Print();
     profileMulti.Print();
     profileMultiMixed.Print();
     profileFatLink.Print();
@@ -1259,6 +1520,7 @@ void endQuda(void)
     profileStaggeredOprod.Print();
     profileAsqtadForce.Print();
     profileHISQForce.Print();
+    profileHISQForceComplete.Print();
     profileContract.Print();
     profileCovDev.Print();
     profilePlaq.Print();
@@ -2155,32 +2417,123 @@ void lanczosQuda(int k0, int m, void *hp_Apsi, void *hp_r, void *hp_V,
   profileInvert.TPSTOP(QUDA_PROFILE_TOTAL);
 }
 
+int eigensolveQuda(void **h_evecs, double *h_evals, QudaEigParam *eig_param)
+{
+  QudaInvertParam *param = eig_param->invert_param;
+  setTuning(param->tune);
+
+  if (param->dslash_type == QUDA_DOMAIN_WALL_DSLASH ||
+      param->dslash_type == QUDA_DOMAIN_WALL_4D_DSLASH ||
+      param->dslash_type == QUDA_MOBIUS_DWF_DSLASH) setKernelPackT(true);
+  if (gaugePrecise == NULL) errorQuda("Gauge field not allocated");
+
+  profileInvert.TPSTART(QUDA_PROFILE_TOTAL);
+
+  if (!initialized) errorQuda("QUDA not initialized");
+
+  pushVerbosity(param->verbosity);
+  if (getVerbosity() >= QUDA_DEBUG_VERBOSE) printQudaInvertParam(param);
+
+  checkInvertParam(param);
+
+  // check the gauge fields have been created
+  cudaGaugeField *cudaGauge = checkGauge(param);
+
+  checkEigParam(eig_param);
+
+  // Lanczos requires a Hermitian operator
+  if (eig_param->RitzMat_lanczos != QUDA_MATDAG_MAT_SOLUTION &&
+      eig_param->RitzMat_lanczos != QUDA_MATPCDAG_MATPC_SOLUTION &&
+      eig_param->RitzMat_lanczos != QUDA_MATPCDAG_MATPC_SHIFT_SOLUTION)
+    errorQuda("Invalid ritz matrix type %d for thick-restart Lanczos", eig_param->RitzMat_lanczos);
+
+  bool pc_solution = (eig_param->RitzMat_lanczos != QUDA_MATDAG_MAT_SOLUTION);
+
+  // create the dirac operator
+  DiracParam diracParam;
+  setDiracParam(diracParam, param, pc_solution);
+  Dirac *d = Dirac::create(diracParam);
+
+  profileInvert.TPSTART(QUDA_PROFILE_H2D);
+
+  const int *X = cudaGauge->X();
+  const int nk = eig_param->nk;
+
+  // wrap CPU host side pointers
+  std::vector<ColorSpinorField*> h_V(nk);
+  ColorSpinorParam cpuParam(h_evecs[0], *param, X, pc_solution);
+  for (int k=0; k<nk; k++) {
+    cpuParam.v = h_evecs[k];
+    h_V[k] = new cpuColorSpinorField(cpuParam);
+  }
+
+  // host fields are used directly, otherwise download the starting vector
+  std::vector<ColorSpinorField*> V(nk);
+  if (eig_param->location == QUDA_CPU_FIELD_LOCATION) {
+    for (int k=0; k<nk; k++) V[k] = h_V[k];
+  } else {
+    ColorSpinorParam cudaParam(cpuParam, *param);
+    cudaParam.create = QUDA_ZERO_FIELD_CREATE;
+    for (int k=0; k<nk; k++) V[k] = new cudaColorSpinorField(cudaParam);
+    *V[0] = *h_V[0];
+  }
+
+  profileInvert.TPSTOP(QUDA_PROFILE_H2D);
+
+  // the shifted solution type computes the eigenpairs of M^dag M + eigen_shift
+  DiracMdagM mat(*d);
+  if (eig_param->RitzMat_lanczos == QUDA_MATPCDAG_MATPC_SHIFT_SOLUTION) mat.shift = eig_param->eigen_shift;
+  RitzMat ritz_mat(mat, *eig_param);
+  ThickRestartLanczos eig_solve(ritz_mat, *eig_param, profileInvert);
+  int nconv = eig_solve(h_evals, V);
+
+  profileInvert.TPSTART(QUDA_PROFILE_D2H);
+  if (eig_param->location != QUDA_CPU_FIELD_LOCATION) {
+    for (int k=0; k<nk; k++) {
+      *h_V[k] = *V[k];
+      delete V[k];
+    }
+  }
+  profileInvert.TPSTOP(QUDA_PROFILE_D2H);
+
+  for (int k=0; k<nk; k++) delete h_V[k];
+
+  delete d;
+
+  popVerbosity();
+
+  saveTuneCache(getVerbosity());
+  profileInvert.TPSTOP(QUDA_PROFILE_TOTAL);
+
+  return nconv;
+}
+
 multigrid_solver::multigrid_solver(QudaMultigridParam &mg_param, TimeProfile &profile)
-  : profile(profile) {
+  : d(0), dSloppy(0), dPre(0), m(0), mSloppy(0), mPre(0), B_c(0), mgParam(0), mg(0), profile(profile) {
+  Timer timer;
+  timer.Start(__func__, __FILE__, __LINE__);
   profile.TPSTART(QUDA_PROFILE_INIT);
   QudaInvertParam *param = mg_param.invert_param;
 
   cudaGaugeField *cudaGauge = checkGauge(param);
   checkInvertParam(param);
+  checkMultigridParam(&mg_param);
 
   setTuning(param->tune);
   pushVerbosity(param->verbosity);
-  if (getVerbosity() >= QUDA_DEBUG_VERBOSE) printQudaInvertParam(param);
+  if (getVerbosity() >= QUDA_DEBUG_VERBOSE) {
+    printQudaInvertParam(param);
+    printQudaMultigridParam(&mg_param);
+  }
   param->secs = 0;
   param->gflops = 0;
   param->iter = 0;
 
   bool pc_solution = (param->solution_type == QUDA_MATPC_SOLUTION) ||
     (param->solution_type == QUDA_MATPCDAG_MATPC_SOLUTION);
-  bool pc_solve = (param->solve_type == QUDA_DIRECT_PC_SOLVE) ||
-    (param->solve_type == QUDA_NORMOP_PC_SOLVE);
 
   // create the dirac operators
-  createDirac(d, dSloppy, dPre, *param, pc_solve);
-
-  m = new DiracM(*d);
-  mSloppy = new DiracM(*dSloppy);
-  mPre = new DiracM(*dPre);
+  createOperators(*param);
 
   printfQuda("Creating vector of null space fields of length %d\n", mg_param.n_vec[0]);
 
@@ -2190,12 +2543,110 @@ multigrid_solver::multigrid_solver(QudaMultigridParam &mg_param, TimeProfile &pr
   B.resize(mg_param.n_vec[0]);
   for (int i=0; i<mg_param.n_vec[0]; i++) B[i] = new cpuColorSpinorField(cpuParam);
 
+  createHierarchy(mg_param, false);
+
+  // reference for judging the refined null space of later updates
+  null_residual = nullSpaceResidual(*mSloppy, B, mg_param.location[0]);
+
+  // the null space is only needed again by update
+  if (mg_param.compress_null_vectors > 0) B_c = compressVectors(B, mg_param.compress_null_vectors);
+  profile.TPSTOP(QUDA_PROFILE_INIT);
+
+  timer.Stop(__func__, __FILE__, __LINE__);
+  setup_time = timer.Last();
+}
+
+void multigrid_solver::createOperators(QudaInvertParam &param) {
+  bool pc_solve = (param.solve_type == QUDA_DIRECT_PC_SOLVE) ||
+    (param.solve_type == QUDA_NORMOP_PC_SOLVE);
+
+  createDirac(d, dSloppy, dPre, param, pc_solve);
+
+  m = new DiracM(*d);
+  mSloppy = new DiracM(*dSloppy);
+  mPre = new DiracM(*dPre);
+}
+
+void multigrid_solver::destroyOperators() {
+  if (mg && getVerbosity() >= QUDA_SUMMARIZE) mg->printStats();
+  delete mg;
+  delete mgParam;
+
+  delete m;
+  delete mSloppy;
+  delete mPre;
+
+  delete d;
+  delete dSloppy;
+  delete dPre;
+
+  mg = 0;
+  mgParam = 0;
+  m = mSloppy = mPre = 0;
+  d = dSloppy = dPre = 0;
+}
+
+void multigrid_solver::createHierarchy(QudaMultigridParam &mg_param, bool reuse_null_vectors) {
   // fill out the MG parameters for the fine level
   mgParam = new MGParam(mg_param, B, *mSloppy, *mSloppy);
+  mgParam->reuse_null_vectors = reuse_null_vectors;
 
   mg = new MG(*mgParam, profile);
-  mgParam->updateInvertParam(*param);
+  mgParam->updateInvertParam(*mg_param.invert_param);
+}
+
+void multigrid_solver::update(QudaMultigridParam &mg_param) {
+  Timer timer;
+  timer.Start(__func__, __FILE__, __LINE__);
+  profile.TPSTART(QUDA_PROFILE_INIT);
+  QudaInvertParam *param = mg_param.invert_param;
+
+  checkGauge(param);
+  checkInvertParam(param);
+  checkMultigridParam(&mg_param);
+
+  setTuning(param->tune);
+  pushVerbosity(param->verbosity);
+
+  // the operators refer to the previous gauge field
+  destroyOperators();
+  createOperators(*param);
+  if (B_c) decompressVectors(B, B_c);
+
+  // refine the existing null space against the new operator
+  const double tol = 5e-4;
+  int k = relaxNullVectors(*mSloppy, B, mg_param.setup_refine_iter, tol, false, mg_param.location[0]);
+  double residual = nullSpaceResidual(*mSloppy, B, mg_param.location[0]);
+  printfQuda("Refined null space in %d iterations, residual = %e (%e after the last full setup)\n",
+	     k, residual, null_residual);
+
+  bool full_setup = !(residual <= mg_param.setup_refine_tol * null_residual);
+  if (full_setup) {
+    warningQuda("Null space residual grew by more than a factor %e, doing a full setup", mg_param.setup_refine_tol);
+    // reloading the null space from file would not adapt it to the new gauge field
+    const QudaComputeNullVector compute_null_vector = mg_param.compute_null_vector;
+    if (compute_null_vector == QUDA_COMPUTE_NULL_VECTOR_NO) {
+      warningQuda("Generating the null space instead of reloading it");
+      mg_param.compute_null_vector = QUDA_COMPUTE_NULL_VECTOR_YES;
+    }
+    createHierarchy(mg_param, false);
+    mg_param.compute_null_vector = compute_null_vector;
+    null_residual = nullSpaceResidual(*mSloppy, B, mg_param.location[0]);
+  } else {
+    createHierarchy(mg_param, true);
+  }
+  if (mg_param.compress_null_vectors > 0) B_c = compressVectors(B, mg_param.compress_null_vectors);
   profile.TPSTOP(QUDA_PROFILE_INIT);
+
+  timer.Stop(__func__, __FILE__, __LINE__);
+  if (full_setup) {
+    setup_time = timer.Last();
+  } else {
+    printfQuda("Multigrid update took %e s, saving %e s (%.1f%%) over a full setup\n", timer.Last(),
+	       setup_time - timer.Last(), 100.0 * (setup_time - timer.Last()) / setup_time);
+  }
+
+  popVerbosity();
 }
 
 void* newMultigridQuda(QudaMultigridParam *mg_param) {
@@ -2207,11 +2658,67 @@ void* newMultigridQuda(QudaMultigridParam *mg_param) {
   return static_cast<void*>(mg);
 }
 
+void updateMultigridQuda(void *mg, QudaMultigridParam *mg_param) {
+  profileInvert.TPSTART(QUDA_PROFILE_TOTAL);
+
+  static_cast<multigrid_solver*>(mg)->update(*mg_param);
+
+  profileInvert.TPSTOP(QUDA_PROFILE_TOTAL);
+}
+
 void destroyMultigridQuda(void *mg) {
   delete static_cast<multigrid_solver*>(mg);
 }
 
 
+/**
+   Identifies the normal operator of a solve: the resident gauge and
+   clover fields and the parameters that enter the operator.
+ */
+static uint64_t chronoOperatorKey(const QudaInvertParam &param) {
+  const int ikey[] = { param.dslash_type, param.solve_type, param.matpc_type, param.dagger, param.cuda_prec,
+		       param.twist_flavor, param.Ls };
+  const double dkey[] = { param.kappa, param.mass, param.m5, param.mu, param.epsilon, param.clover_coeff };
+  uint64_t key = fingerprintBuffer(ikey, sizeof(ikey), residentGaugeKey());
+  key = fingerprintBuffer(dkey, sizeof(dkey), key);
+  if (param.dslash_type == QUDA_MOBIUS_DWF_DSLASH) {
+    key = fingerprintBuffer(param.b_5, sizeof(param.b_5), key);
+    key = fingerprintBuffer(param.c_5, sizeof(param.c_5), key);
+  }
+  if (param.dslash_type == QUDA_CLOVER_WILSON_DSLASH || param.dslash_type == QUDA_TWISTED_CLOVER_DSLASH) {
+    const uint64_t clover_key = residentCloverKey();
+    key = fingerprintBuffer(&clover_key, sizeof(uint64_t), key);
+  }
+  return key;
+}
+
+/**
+   @return The extrapolation basis for a normal-operator solve with
+   operator m, which is emptied when the operator has changed since
+   the previous solve, or NULL if param->chrono_max_dim is zero
+ */
+static MinResExt* chronoBasis(DiracMatrix &m, const QudaInvertParam &param) {
+  if (param.chrono_max_dim <= 0) {
+    if (chronoResident) delete chronoResident;
+    chronoResident = NULL;
+    return NULL;
+  }
+
+  const uint64_t key = chronoOperatorKey(param);
+  if (chronoResident && chronoResident->MaxDim() != param.chrono_max_dim) {
+    delete chronoResident;
+    chronoResident = NULL;
+  }
+  if (!chronoResident) {
+    chronoResident = new MinResExt(m, profileInvert, param.chrono_max_dim);
+  } else if (key != chronoKey) {
+    chronoResident->reset();
+  }
+  chronoResident->setMatrix(m);
+  chronoKey = key;
+  return chronoResident;
+}
+
 void invertQuda(void *hp_x, void *hp_b, QudaInvertParam *param)
 {
   setTuning(param->tune);
@@ -2400,10 +2907,21 @@ void invertQuda(void *hp_x, void *hp_b, QudaInvertParam *param)
   } else if (!norm_error_solve) {
     DiracMdagM m(dirac), mSloppy(diracSloppy), mPre(diracPre);
     SolverParam solverParam(*param);
+
+    // extrapolate the initial guess from the previous solutions
+    MinResExt *chrono = chronoBasis(m, *param);
+    if (chrono && chrono->Dim() > 0 && param->use_init_guess == QUDA_USE_INIT_GUESS_NO) {
+      cudaColorSpinorField r(*in);
+      (*chrono)(*out, r);
+      solverParam.use_init_guess = QUDA_USE_INIT_GUESS_YES;
+    }
+
     Solver *solve = Solver::create(solverParam, m, mSloppy, mPre, profileInvert);
     (*solve)(*out, *in);
     solverParam.updateInvertParam(*param);
     delete solve;
+
+    if (chrono) chrono->append(*out);
   } else { // norm_error_solve
     DiracMMdag m(dirac), mSloppy(diracSloppy), mPre(diracPre);
     cudaColorSpinorField tmp(*out);
@@ -2412,58 +2930,618 @@ void invertQuda(void *hp_x, void *hp_b, QudaInvertParam *param)
     (*solve)(tmp, *in); // y = (M M^\dag) b
     dirac.Mdag(*out, tmp);  // x = M^dag y
     solverParam.updateInvertParam(*param);
-    delete solve;
-  }
+    delete solve;
+  }
+
+  if (getVerbosity() >= QUDA_VERBOSE){
+    double nx = blas::norm2(*x);
+   printfQuda("Solution = %g\n",nx);
+  }
+
+  profileInvert.TPSTART(QUDA_PROFILE_EPILOGUE);
+  dirac.reconstruct(*x, *b, param->solution_type);
+  profileInvert.TPSTOP(QUDA_PROFILE_EPILOGUE);
+
+  if (param->solver_normalization == QUDA_SOURCE_NORMALIZATION) {
+    // rescale the solution
+    blas::ax(sqrt(nb), *x);
+  }
+
+  if (!param->make_resident_solution) {
+    profileInvert.TPSTART(QUDA_PROFILE_D2H);
+    *h_x = *x;
+    profileInvert.TPSTOP(QUDA_PROFILE_D2H);
+  }
+
+  if (param->make_resident_solution) {
+    for (unsigned int i=0; i<solutionResident.size(); i++) {
+      if (solutionResident[i]) delete solutionResident[i];
+    }
+    solutionResident.resize(1);
+    solutionResident[0] = static_cast<cudaColorSpinorField*>(x);
+  }
+
+  if (getVerbosity() >= QUDA_VERBOSE){
+    double nx = blas::norm2(*x);
+    double nh_x = blas::norm2(*h_x);
+    printfQuda("Reconstructed: CUDA solution = %g, CPU copy = %g\n", nx, nh_x);
+  }
+
+  delete h_b;
+  delete h_x;
+  delete b;
+  if (!param->make_resident_solution) delete x;
+
+  delete d;
+  delete dSloppy;
+  delete dPre;
+
+  popVerbosity();
+
+  // FIXME: added temporarily so that the cache is written out even if a long benchmarking job gets interrupted
+  saveTuneCache(getVerbosity());
+
+  profileInvert.TPSTOP(QUDA_PROFILE_TOTAL);
+}
+
+/**
+   Arguments for the helper thread that overlaps the host-side work
+   of the multi-source solver with the solve of the current source.
+   The helper reorders the solution of the previous source into the
+   host application's order, and the next source into the device
+   order in a pinned staging buffer, ready for upload.
+ */
+struct MultiSrcStage {
+  ColorSpinorField *h_x;     // host solution to reorder into (or NULL)
+  ColorSpinorField *x;       // device solution field (layout of the staged solution)
+  void *x_buffer;            // pinned buffer holding the downloaded solution
+  ColorSpinorField *h_b;     // host source to stage (or NULL)
+  ColorSpinorField *b;       // device source field (layout of the staged source)
+  void *b_buffer;            // pinned buffer receiving the reordered source
+};
+
+static void* stageMultiSrc(void *arg) {
+  MultiSrcStage &stage = *static_cast<MultiSrcStage*>(arg);
+  if (stage.h_x) {
+    copyGenericColorSpinor(*stage.h_x, *stage.x, QUDA_CPU_FIELD_LOCATION, 0, stage.x_buffer,
+			   0, static_cast<char*>(stage.x_buffer) + stage.x->Bytes());
+  }
+  if (stage.h_b) {
+    copyGenericColorSpinor(*stage.b, *stage.h_b, QUDA_CPU_FIELD_LOCATION, stage.b_buffer, 0,
+			   static_cast<char*>(stage.b_buffer) + stage.b->Bytes(), 0);
+  }
+  return NULL;
+}
+
+/**
+   Solves all of the sources of invertMultiSrcQuda as a single block
+   with a block solver.  All sources and solutions are resident on the
+   device at once, so there is no staging overlap here.
+ */
+static void solveBlockSrc(std::vector<ColorSpinorField*> &h_x, std::vector<ColorSpinorField*> &h_b,
+			  Dirac &dirac, DiracMatrix &m, DiracMatrix &mSloppy, SolverParam &solverParam,
+			  QudaInvertParam &param, const ColorSpinorParam &cudaParam, bool prepare_mdag)
+{
+  const int n = param.num_src;
+  std::vector<ColorSpinorField*> b(n), x(n), in(n), out(n);
+  std::vector<double> nb(n);
+
+  profileMultiSrc.TPSTART(QUDA_PROFILE_H2D);
+  for (int k=0; k<n; k++) {
+    b[k] = new cudaColorSpinorField(cudaParam);
+    x[k] = new cudaColorSpinorField(cudaParam);
+    *b[k] = *h_b[k];
+    if (param.use_init_guess == QUDA_USE_INIT_GUESS_YES) {
+      *x[k] = *h_x[k];
+    } else {
+      blas::zero(*x[k]);
+    }
+  }
+  profileMultiSrc.TPSTOP(QUDA_PROFILE_H2D);
+
+  for (int k=0; k<n; k++) {
+    nb[k] = blas::norm2(*b[k]);
+    if (nb[k]==0.0) errorQuda("Source %d has zero norm", k);
+
+    // rescale the source and solution vectors to help prevent the onset of underflow
+    if (param.solver_normalization == QUDA_SOURCE_NORMALIZATION) {
+      blas::ax(1.0/sqrt(nb[k]), *b[k]);
+      blas::ax(1.0/sqrt(nb[k]), *x[k]);
+    }
+
+    massRescale(*static_cast<cudaColorSpinorField*>(b[k]), param);
+    dirac.prepare(in[k], out[k], *x[k], *b[k], param.solution_type);
+
+    if (prepare_mdag) { // prepare source: b' = A^dag b
+      cudaColorSpinorField tmp(*in[k]);
+      dirac.Mdag(*in[k], tmp);
+    }
+  }
+
+  solverParam.iter = 0;
+  solverParam.secs = 0;
+  solverParam.gflops = 0;
+
+  BlockCG solve(m, mSloppy, solverParam, profileMultiSrc);
+  solve(out, in);
+  solverParam.updateInvertParam(param);
+
+  for (int k=0; k<n; k++) {
+    profileMultiSrc.TPSTART(QUDA_PROFILE_EPILOGUE);
+    dirac.reconstruct(*x[k], *b[k], param.solution_type);
+    profileMultiSrc.TPSTOP(QUDA_PROFILE_EPILOGUE);
+
+    if (param.solver_normalization == QUDA_SOURCE_NORMALIZATION) {
+      // rescale the solution
+      blas::ax(sqrt(nb[k]), *x[k]);
+    }
+
+    if (param.make_resident_solution) {
+      solutionResident[k] = static_cast<cudaColorSpinorField*>(x[k]);
+      x[k] = NULL;
+    } else {
+      profileMultiSrc.TPSTART(QUDA_PROFILE_D2H);
+      *h_x[k] = *x[k];
+      profileMultiSrc.TPSTOP(QUDA_PROFILE_D2H);
+    }
+  }
+
+  for (int k=0; k<n; k++) {
+    delete b[k];
+    if (x[k]) delete x[k];
+  }
+}
+
+void invertMultiSrcQuda(void **_hp_x, void **_hp_b, QudaInvertParam *param)
+{
+  setTuning(param->tune);
+
+  if (param->dslash_type == QUDA_DOMAIN_WALL_DSLASH ||
+      param->dslash_type == QUDA_DOMAIN_WALL_4D_DSLASH ||
+      param->dslash_type == QUDA_MOBIUS_DWF_DSLASH) setKernelPackT(true);
+
+  profileMultiSrc.TPSTART(QUDA_PROFILE_TOTAL);
+
+  if (!initialized) errorQuda("QUDA not initialized");
+
+  pushVerbosity(param->verbosity);
+  if (getVerbosity() >= QUDA_DEBUG_VERBOSE) printQudaInvertParam(param);
+
+  checkInvertParam(param);
+  if (param->num_src < 1) errorQuda("Invalid number of sources %d", param->num_src);
+
+  // check the gauge fields have been created
+  cudaGaugeField *cudaGauge = checkGauge(param);
+
+  bool pc_solution = (param->solution_type == QUDA_MATPC_SOLUTION) ||
+    (param->solution_type == QUDA_MATPCDAG_MATPC_SOLUTION);
+  bool pc_solve = (param->solve_type == QUDA_DIRECT_PC_SOLVE) ||
+    (param->solve_type == QUDA_NORMOP_PC_SOLVE) || (param->solve_type == QUDA_NORMERR_PC_SOLVE);
+  bool mat_solution = (param->solution_type == QUDA_MAT_SOLUTION) ||
+    (param->solution_type ==  QUDA_MATPC_SOLUTION);
+  bool direct_solve = (param->solve_type == QUDA_DIRECT_SOLVE) ||
+    (param->solve_type == QUDA_DIRECT_PC_SOLVE);
+  bool norm_error_solve = (param->solve_type == QUDA_NORMERR_SOLVE) ||
+    (param->solve_type == QUDA_NORMERR_PC_SOLVE);
+
+  if (pc_solution && !pc_solve) {
+    errorQuda("Preconditioned (PC) solution_type requires a PC solve_type");
+  }
+
+  if (!mat_solution && !pc_solution && pc_solve) {
+    errorQuda("Unpreconditioned MATDAG_MAT solution_type requires an unpreconditioned solve_type");
+  }
+
+  if (!mat_solution && norm_error_solve) {
+    errorQuda("Normal-error solve requires Mat solution");
+  }
+
+  if (param->inv_type_precondition == QUDA_MG_INVERTER && (pc_solve || pc_solution || !direct_solve || !mat_solution))
+      errorQuda("Multigrid preconditioning only supported for direct non-red-black solve");
+
+  if (param->use_init_guess == QUDA_USE_INIT_GUESS_YES &&
+      (param->solution_type == QUDA_MATDAG_MAT_SOLUTION || param->solution_type == QUDA_MATPCDAG_MATPC_SOLUTION) &&
+      (param->solve_type == QUDA_DIRECT_SOLVE || param->solve_type == QUDA_DIRECT_PC_SOLVE)) {
+    errorQuda("Initial guess not supported for two-pass solver");
+  }
+
+  param->spinorGiB = cudaGauge->VolumeCB() * spinorSiteSize;
+  if (!pc_solve) param->spinorGiB *= 2;
+  param->spinorGiB *= (param->cuda_prec == QUDA_DOUBLE_PRECISION ? sizeof(double) : sizeof(float));
+  if (param->preserve_source == QUDA_PRESERVE_SOURCE_NO) {
+    param->spinorGiB *= (param->inv_type == QUDA_CG_INVERTER ? 5 : 7)/(double)(1<<30);
+  } else {
+    param->spinorGiB *= (param->inv_type == QUDA_CG_INVERTER ? 8 : 9)/(double)(1<<30);
+  }
+
+  param->secs = 0;
+  param->gflops = 0;
+  param->iter = 0;
+  param->src_per_sec = 0;
+
+  Timer batch;
+  batch.Start(__func__, __FILE__, __LINE__);
+
+  profileMultiSrc.TPSTART(QUDA_PROFILE_INIT);
+
+  // the operators and solvers are created once and shared by all sources
+  Dirac *d = NULL;
+  Dirac *dSloppy = NULL;
+  Dirac *dPre = NULL;
+  createDirac(d, dSloppy, dPre, *param, pc_solve);
+
+  Dirac &dirac = *d;
+  Dirac &diracSloppy = *dSloppy;
+  Dirac &diracPre = *dPre;
+
+  DiracMatrix *m, *mSloppy, *mPre;
+  if (direct_solve) {
+    m = new DiracM(dirac); mSloppy = new DiracM(diracSloppy); mPre = new DiracM(diracPre);
+  } else if (!norm_error_solve) {
+    m = new DiracMdagM(dirac); mSloppy = new DiracMdagM(diracSloppy); mPre = new DiracMdagM(diracPre);
+  } else {
+    m = new DiracMMdag(dirac); mSloppy = new DiracMMdag(diracSloppy); mPre = new DiracMMdag(diracPre);
+  }
+  // block solvers iterate on all of the sources together
+  const bool block = param->inv_type == QUDA_BLOCKCG_INVERTER;
+
+  SolverParam solverParam(*param);
+  Solver *solve = block ? NULL : Solver::create(solverParam, *m, *mSloppy, *mPre, profileMultiSrc);
+
+  // first of two solves, A^dag y = b, for the MATDAG_MAT solution with a direct solve
+  bool two_pass = !mat_solution && direct_solve;
+  if (block && (direct_solve || norm_error_solve))
+    errorQuda("Block solver requires a normal-operator solve");
+  DiracMdag *mdag = NULL, *mdagSloppy = NULL, *mdagPre = NULL;
+  SolverParam solverParamDag(*param);
+  Solver *solveDag = NULL;
+  if (two_pass) {
+    mdag = new DiracMdag(dirac); mdagSloppy = new DiracMdag(diracSloppy); mdagPre = new DiracMdag(diracPre);
+    solveDag = Solver::create(solverParamDag, *mdag, *mdagSloppy, *mdagPre, profileMultiSrc);
+  }
+
+  const int *X = cudaGauge->X();
+
+  // wrap CPU host side pointers
+  std::vector<ColorSpinorField*> h_b(param->num_src);
+  std::vector<ColorSpinorField*> h_x(param->num_src);
+  ColorSpinorParam cpuParam(_hp_b[0], *param, X, pc_solution, param->input_location);
+  for (int k=0; k<param->num_src; k++) {
+    cpuParam.v = _hp_b[k];
+    cpuParam.location = param->input_location;
+    h_b[k] = ColorSpinorField::Create(cpuParam);
+
+    cpuParam.v = _hp_x[k];
+    cpuParam.location = param->output_location;
+    h_x[k] = ColorSpinorField::Create(cpuParam);
+  }
+
+  // the block solver creates its own fields for all of the sources
+  ColorSpinorParam cudaParam(cpuParam, *param);
+  cudaParam.create = QUDA_ZERO_FIELD_CREATE;
+  cudaColorSpinorField *b = block ? NULL : new cudaColorSpinorField(cudaParam);
+  cudaColorSpinorField *x = NULL;
+
+  // host sources and solutions are reordered on a helper thread via pinned staging buffers
+  const bool stage_b = !block && param->input_location == QUDA_CPU_FIELD_LOCATION;
+  const bool stage_x = !block && param->output_location == QUDA_CPU_FIELD_LOCATION && !param->make_resident_solution;
+  void *b_buffer = stage_b ? pinned_malloc(b->Bytes() + b->NormBytes()) : NULL;
+  void *x_buffer = stage_x ? pinned_malloc(b->Bytes() + b->NormBytes()) : NULL;
+  if (b_buffer) memset(b_buffer, 0, b->Bytes() + b->NormBytes()); // padding is never written
+
+  if (param->make_resident_solution) {
+    for (unsigned int i=0; i<solutionResident.size(); i++) {
+      if (solutionResident[i]) delete solutionResident[i];
+    }
+    solutionResident.resize(param->num_src);
+  } else if (!block) {
+    x = new cudaColorSpinorField(cudaParam);
+  }
+
+  profileMultiSrc.TPSTOP(QUDA_PROFILE_INIT);
+
+  MultiSrcStage stage = { NULL, b, x_buffer, stage_b ? h_b[0] : NULL, b, b_buffer };
+  if (stage_b) stageMultiSrc(&stage);
+
+  if (block) solveBlockSrc(h_x, h_b, dirac, *m, *mSloppy, solverParam, *param, cudaParam,
+			   mat_solution);
+
+  for (int k=0; !block && k<param->num_src; k++) {
+
+    profileMultiSrc.TPSTART(QUDA_PROFILE_H2D);
+    if (stage_b) {
+      cudaMemcpy(b->V(), b_buffer, b->Bytes(), cudaMemcpyHostToDevice);
+      cudaMemcpy(b->Norm(), static_cast<char*>(b_buffer) + b->Bytes(), b->NormBytes(), cudaMemcpyHostToDevice);
+    } else {
+      *b = *h_b[k];
+    }
+
+    if (param->make_resident_solution) {
+      x = new cudaColorSpinorField(cudaParam);
+      solutionResident[k] = x;
+    }
+    if (param->use_init_guess == QUDA_USE_INIT_GUESS_YES) {
+      *x = *h_x[k];
+    } else {
+      blas::zero(*x);
+    }
+    profileMultiSrc.TPSTOP(QUDA_PROFILE_H2D);
+
+    // reorder the previous solution and the next source while this source is solved
+    stage.h_x = (stage_x && k > 0) ? h_x[k-1] : NULL;
+    stage.x = x;
+    stage.h_b = (stage_b && k+1 < param->num_src) ? h_b[k+1] : NULL;
+    pthread_t stage_thread;
+    bool staging = stage.h_x || stage.h_b;
+    if (staging && pthread_create(&stage_thread, NULL, stageMultiSrc, &stage))
+      errorQuda("pthread_create failed");
+
+    double nb = blas::norm2(*b);
+    if (nb==0.0) errorQuda("Source %d has zero norm", k);
+
+    // rescale the source and solution vectors to help prevent the onset of underflow
+    if (param->solver_normalization == QUDA_SOURCE_NORMALIZATION) {
+      blas::ax(1.0/sqrt(nb), *b);
+      blas::ax(1.0/sqrt(nb), *x);
+    }
+
+    massRescale(*b, *param);
+
+    ColorSpinorField *in = NULL;
+    ColorSpinorField *out = NULL;
+    dirac.prepare(in, out, *x, *b, param->solution_type);
+
+    solverParam.iter = 0;
+    solverParam.secs = 0;
+    solverParam.gflops = 0;
+
+    if (mat_solution && !direct_solve && !norm_error_solve) { // prepare source: b' = A^dag b
+      cudaColorSpinorField tmp(*in);
+      dirac.Mdag(*in, tmp);
+    } else if (two_pass) { // perform the first of two solves: A^dag y = b
+      solverParamDag.iter = 0;
+      solverParamDag.secs = 0;
+      solverParamDag.gflops = 0;
+      (*solveDag)(*out, *in);
+      blas::copy(*in, *out);
+      solverParamDag.updateInvertParam(*param);
+    }
+
+    if (!norm_error_solve) {
+      (*solve)(*out, *in);
+    } else {
+      cudaColorSpinorField tmp(*out);
+      (*solve)(tmp, *in); // y = (M M^\dag) b
+      dirac.Mdag(*out, tmp);  // x = M^dag y
+    }
+    solverParam.updateInvertParam(*param);
 
-  if (getVerbosity() >= QUDA_VERBOSE){
-    double nx = blas::norm2(*x);
-   printfQuda("Solution = %g\n",nx);
-  }
+    profileMultiSrc.TPSTART(QUDA_PROFILE_EPILOGUE);
+    dirac.reconstruct(*x, *b, param->solution_type);
+    profileMultiSrc.TPSTOP(QUDA_PROFILE_EPILOGUE);
 
-  profileInvert.TPSTART(QUDA_PROFILE_EPILOGUE);
-  dirac.reconstruct(*x, *b, param->solution_type);
-  profileInvert.TPSTOP(QUDA_PROFILE_EPILOGUE);
+    if (param->solver_normalization == QUDA_SOURCE_NORMALIZATION) {
+      // rescale the solution
+      blas::ax(sqrt(nb), *x);
+    }
 
-  if (param->solver_normalization == QUDA_SOURCE_NORMALIZATION) {
-    // rescale the solution
-    blas::ax(sqrt(nb), *x);
-  }
+    if (staging && pthread_join(stage_thread, NULL)) errorQuda("pthread_join failed");
 
-  if (!param->make_resident_solution) {
-    profileInvert.TPSTART(QUDA_PROFILE_D2H);
-    *h_x = *x;
-    profileInvert.TPSTOP(QUDA_PROFILE_D2H);
+    if (!param->make_resident_solution) {
+      profileMultiSrc.TPSTART(QUDA_PROFILE_D2H);
+      if (stage_x) {
+	cudaMemcpy(x_buffer, x->V(), x->Bytes(), cudaMemcpyDeviceToHost);
+	cudaMemcpy(static_cast<char*>(x_buffer) + x->Bytes(), x->Norm(), x->NormBytes(), cudaMemcpyDeviceToHost);
+      } else {
+	*h_x[k] = *x;
+      }
+      profileMultiSrc.TPSTOP(QUDA_PROFILE_D2H);
+    }
+
+    if (getVerbosity() >= QUDA_VERBOSE)
+      printfQuda("Source %d of %d: %d iterations, true residual = %e\n", k+1, param->num_src, solverParam.iter, param->true_res);
   }
 
-  if (param->make_resident_solution) {
-    for (unsigned int i=0; i<solutionResident.size(); i++) {
-      if (solutionResident[i]) delete solutionResident[i];
-    }
-    solutionResident.resize(1);
-    solutionResident[0] = static_cast<cudaColorSpinorField*>(x);
+  // reorder the last solution
+  if (stage_x) {
+    profileMultiSrc.TPSTART(QUDA_PROFILE_D2H);
+    stage.h_x = h_x[param->num_src-1];
+    stage.x = x;
+    stage.h_b = NULL;
+    stageMultiSrc(&stage);
+    profileMultiSrc.TPSTOP(QUDA_PROFILE_D2H);
   }
 
-  if (getVerbosity() >= QUDA_VERBOSE){
-    double nx = blas::norm2(*x);
-    double nh_x = blas::norm2(*h_x);
-    printfQuda("Reconstructed: CUDA solution = %g, CPU copy = %g\n", nx, nh_x);
+  checkCudaError();
+
+  profileMultiSrc.TPSTART(QUDA_PROFILE_FREE);
+  if (b_buffer) host_free(b_buffer);
+  if (x_buffer) host_free(x_buffer);
+  for (int k=0; k<param->num_src; k++) {
+    delete h_b[k];
+    delete h_x[k];
   }
+  if (b) delete b;
+  if (x && !param->make_resident_solution) delete x;
 
-  delete h_b;
-  delete h_x;
-  delete b;
-  if (!param->make_resident_solution) delete x;
+  delete solve;
+  delete m;
+  delete mSloppy;
+  delete mPre;
+  if (two_pass) {
+    delete solveDag;
+    delete mdag;
+    delete mdagSloppy;
+    delete mdagPre;
+  }
 
   delete d;
   delete dSloppy;
   delete dPre;
+  profileMultiSrc.TPSTOP(QUDA_PROFILE_FREE);
+
+  batch.Stop(__func__, __FILE__, __LINE__);
+  param->src_per_sec = param->num_src / batch.time;
+  if (getVerbosity() >= QUDA_SUMMARIZE)
+    printfQuda("Solved %d sources in %g secs (%g sources per second), %d iterations in total\n",
+	       param->num_src, batch.time, param->src_per_sec, param->iter);
 
   popVerbosity();
 
   // FIXME: added temporarily so that the cache is written out even if a long benchmarking job gets interrupted
   saveTuneCache(getVerbosity());
 
-  profileInvert.TPSTOP(QUDA_PROFILE_TOTAL);
+  profileMultiSrc.TPSTOP(QUDA_PROFILE_TOTAL);
+}
+
+/**
+   An asynchronous solve.  The request is a Worker, so that it can be
+   applied by whichever thread drives the device; here that is the
+   dedicated thread that serves invertQudaAsync.  The request keeps
+   its own copy of the parameters, so the caller may reuse its
+   QudaInvertParam for the next request straight away; the host
+   fields h_x and h_b stay owned by QUDA until waitQuda returns.
+   Whether the solve converged is recorded in the request and
+   reported by waitQuda, rather than acted upon in the worker thread.
+ */
+class InvertRequest : public Worker {
+
+public:
+  void *h_x;
+  void *h_b;
+  QudaInvertParam param;
+  bool done;
+  int status; // 0 if the solve converged
+
+  InvertRequest(void *h_x, void *h_b, const QudaInvertParam &param)
+    : h_x(h_x), h_b(h_b), param(param), done(false), status(0) { }
+  virtual ~InvertRequest() { }
+
+  void apply(const cudaStream_t &stream) {
+    invertQuda(h_x, h_b, &param);
+
+    bool converged = true;
+    if (param.residual_type & QUDA_L2_RELATIVE_RESIDUAL) converged = converged && param.true_res <= param.tol;
+    if (param.residual_type & QUDA_HEAVY_QUARK_RESIDUAL) converged = converged && param.true_res_hq <= param.tol_hq;
+    status = converged ? 0 : 1;
+  }
+};
+
+static pthread_t async_thread;
+static bool async_thread_running = false;
+static bool async_shutdown = false;
+static std::deque<InvertRequest*> async_queue; // front is the request being solved
+static std::vector<InvertRequest*> async_requests; // requests not yet waited for
+static pthread_mutex_t async_mutex = PTHREAD_MUTEX_INITIALIZER;
+static pthread_cond_t async_submit = PTHREAD_COND_INITIALIZER;
+static pthread_cond_t async_complete = PTHREAD_COND_INITIALIZER;
+
+static void* asyncInvertThread(void *) {
+  // the device is set per thread
+  cudaSetDevice(comm_gpuid());
+
+  pthread_mutex_lock(&async_mutex);
+  while (true) {
+    while (async_queue.empty() && !async_shutdown) pthread_cond_wait(&async_submit, &async_mutex);
+    if (async_queue.empty()) break; // shutting down and nothing left to do
+    InvertRequest *request = async_queue.front();
+    pthread_mutex_unlock(&async_mutex);
+
+    cudaStream_t stream = 0;
+    request->apply(stream);
+
+    pthread_mutex_lock(&async_mutex);
+    async_queue.pop_front();
+    request->done = true;
+    pthread_cond_broadcast(&async_complete);
+  }
+  pthread_mutex_unlock(&async_mutex);
+  return NULL;
+}
+
+/**
+   Complete all outstanding requests and stop the worker thread
+ */
+static void drainAsyncQuda() {
+  if (!async_thread_running) return;
+  pthread_mutex_lock(&async_mutex);
+  async_shutdown = true;
+  pthread_cond_signal(&async_submit);
+  pthread_mutex_unlock(&async_mutex);
+  if (pthread_join(async_thread, NULL)) errorQuda("pthread_join failed");
+  async_thread_running = false;
+  async_shutdown = false;
+
+  // release requests that were never waited for
+  for (unsigned int i=0; i<async_requests.size(); i++) delete async_requests[i];
+  async_requests.clear();
+}
+
+void* invertQudaAsync(void *hp_x, void *hp_b, QudaInvertParam *param)
+{
+  profileAsync.TPSTART(QUDA_PROFILE_INIT);
+
+  // validate in the calling thread, so that errors are reported where the request was made
+  if (!initialized) errorQuda("QUDA not initialized");
+  checkInvertParam(param);
+  if (!hp_x || !hp_b) errorQuda("Invalid host fields %p %p", hp_x, hp_b);
+  if (param->make_resident_solution || param->use_resident_solution)
+    errorQuda("Resident solutions not supported by invertQudaAsync");
+  // the worker thread communicates on behalf of the thread that initialized the communications
+  if (!comm_serialized_threads())
+    errorQuda("invertQudaAsync requires communications initialized with at least MPI_THREAD_SERIALIZED");
+
+  InvertRequest *request = new InvertRequest(hp_x, hp_b, *param);
+
+  pthread_mutex_lock(&async_mutex);
+  if (!async_thread_running) {
+    if (pthread_create(&async_thread, NULL, asyncInvertThread, NULL)) errorQuda("pthread_create failed");
+    async_thread_running = true;
+  }
+  async_queue.push_back(request);
+  async_requests.push_back(request);
+  pthread_cond_signal(&async_submit);
+  pthread_mutex_unlock(&async_mutex);
+
+  profileAsync.TPSTOP(QUDA_PROFILE_INIT);
+  return request;
+}
+
+int waitQuda(void *handle, QudaInvertParam *param)
+{
+  profileAsync.TPSTART(QUDA_PROFILE_WAIT);
+
+  InvertRequest *request = static_cast<InvertRequest*>(handle);
+
+  pthread_mutex_lock(&async_mutex);
+  std::vector<InvertRequest*>::iterator it = std::find(async_requests.begin(), async_requests.end(), request);
+  if (it == async_requests.end()) {
+    pthread_mutex_unlock(&async_mutex);
+    errorQuda("Unknown request handle %p", handle);
+  }
+  async_requests.erase(it);
+  while (!request->done) pthread_cond_wait(&async_complete, &async_mutex);
+  pthread_mutex_unlock(&async_mutex);
+
+  profileAsync.TPSTOP(QUDA_PROFILE_WAIT);
+
+  // return the solver results
+  if (param) {
+    param->iter = request->param.iter;
+    param->secs = request->param.secs;
+    param->gflops = request->param.gflops;
+    param->true_res = request->param.true_res;
+    param->true_res_hq = request->param.true_res_hq;
+    param->spinorGiB = request->param.spinorGiB;
+  }
+
+  const int status = request->status;
+  if (status) warningQuda("Solve of request %p did not converge: residual %e (tol %e), heavy-quark residual %e (tol %e)",
+			  handle, request->param.true_res, request->param.tol,
+			  request->param.true_res_hq, request->param.tol_hq);
+
+  delete request;
+  return status;
 }
 
 
@@ -2801,7 +3879,7 @@ void incrementalEigQuda(void *_h_x, void *_h_b, QudaInvertParam *param, void *_h
 {
   setTuning(param->tune);
 
-  if(!InitMagma) openMagma();
+  if(param->dense_linalg == QUDA_MAGMA_DENSE_LINALG && !InitMagma) openMagma();
 
   if (param->dslash_type == QUDA_DOMAIN_WALL_DSLASH) setKernelPackT(true);
 
@@ -3363,6 +4441,59 @@ int computeGaugeForceQuda(void* mom, void* siteLink,  int*** input_path_buf, int
   for (int d=0; d<4; d++) gParamEx.x[d] = gParam.x[d] + 4;
 #endif
 
+  if (qudaGaugeParam->compute_location == QUDA_CPU_FIELD_LOCATION) {
+    if (qudaGaugeParam->use_resident_gauge || qudaGaugeParam->use_resident_mom ||
+	qudaGaugeParam->make_resident_gauge || qudaGaugeParam->make_resident_mom)
+      errorQuda("Resident fields not supported with host gauge force");
+
+    gParam.create = QUDA_REFERENCE_FIELD_CREATE;
+    gParam.gauge = siteLink;
+    cpuGaugeField *cpuSiteLink = new cpuGaugeField(gParam);
+
+#ifdef MULTI_GPU
+    gParamEx.create = QUDA_ZERO_FIELD_CREATE;
+    cpuGaugeField *cpuGauge = new cpuGaugeField(gParamEx);
+    copyExtendedGauge(*cpuGauge, *cpuSiteLink, QUDA_CPU_FIELD_LOCATION);
+    int R[4] = {2, 2, 2, 2}; // radius of the extended region in each dimension / direction
+    profileGaugeForce.TPSTOP(QUDA_PROFILE_INIT);
+
+    profileGaugeForce.TPSTART(QUDA_PROFILE_COMMS);
+    cpuGauge->exchangeExtendedGhost(R);
+    profileGaugeForce.TPSTOP(QUDA_PROFILE_COMMS);
+    profileGaugeForce.TPSTART(QUDA_PROFILE_INIT);
+#else
+    cpuGaugeField *cpuGauge = cpuSiteLink;
+#endif
+
+    // the momentum follows the gauge order as on the device path
+    GaugeFieldParam &gParamMom = gParam;
+    gParamMom.order = qudaGaugeParam->gauge_order;
+    if (gParamMom.order == QUDA_QDP_GAUGE_ORDER) gParamMom.order = QUDA_MILC_GAUGE_ORDER;
+    if (gParamMom.order != QUDA_MILC_GAUGE_ORDER && gParamMom.order != QUDA_TIFR_GAUGE_ORDER)
+      errorQuda("Momentum order %d not supported with host gauge force", gParamMom.order);
+    gParamMom.precision = qudaGaugeParam->cpu_prec;
+    gParamMom.link_type = QUDA_ASQTAD_MOM_LINKS;
+    gParamMom.create = QUDA_REFERENCE_FIELD_CREATE;
+    gParamMom.gauge = mom;
+    gParamMom.reconstruct = (gParamMom.order == QUDA_TIFR_GAUGE_ORDER) ? QUDA_RECONSTRUCT_NO : QUDA_RECONSTRUCT_10;
+    cpuGaugeField *cpuMom = new cpuGaugeField(gParamMom);
+    if (qudaGaugeParam->overwrite_mom) memset(mom, 0, cpuMom->Bytes());
+    profileGaugeForce.TPSTOP(QUDA_PROFILE_INIT);
+
+    profileGaugeForce.TPSTART(QUDA_PROFILE_COMPUTE);
+    gauge_force_cpu(*cpuMom, eb3, *cpuGauge, input_path_buf, path_length, loop_coeff, num_paths, max_length);
+    profileGaugeForce.TPSTOP(QUDA_PROFILE_COMPUTE);
+
+    profileGaugeForce.TPSTART(QUDA_PROFILE_FREE);
+    if (cpuGauge != cpuSiteLink) delete cpuGauge;
+    delete cpuSiteLink;
+    delete cpuMom;
+    profileGaugeForce.TPSTOP(QUDA_PROFILE_FREE);
+
+    profileGaugeForce.TPSTOP(QUDA_PROFILE_TOTAL);
+    return 0;
+  }
+
   gParam.create = QUDA_REFERENCE_FIELD_CREATE;
   gParam.gauge = siteLink;
   cpuGaugeField *cpuSiteLink = (!qudaGaugeParam->use_resident_gauge) ? new cpuGaugeField(gParam) : NULL;
@@ -3464,6 +4595,7 @@ int computeGaugeForceQuda(void* mom, void* siteLink,  int*** input_path_buf, int
   if (qudaGaugeParam->make_resident_gauge) {
     if (gaugePrecise && gaugePrecise != cudaSiteLink) delete gaugePrecise;
     gaugePrecise = cudaSiteLink;
+    invalidateGaugeFingerprint();
   } else {
     delete cudaSiteLink;
   }
@@ -3498,8 +4630,91 @@ int computeGaugeForceQuda(void* mom, void* siteLink,  int*** input_path_buf, int
 }
 
 
+/*
+  Build the clover term and its inverse on the host from the resident
+  gauge field, and upload both to cloverPrecise.
+*/
+static void createCloverHost(QudaInvertParam* invertParam)
+{
+  if (invertParam->dslash_type == QUDA_TWISTED_CLOVER_DSLASH)
+    errorQuda("Host clover construction not supported for twisted clover");
+  if (gaugePrecise->Precision() == QUDA_HALF_PRECISION)
+    errorQuda("Host clover construction not supported for half precision gauge field");
+
+  profileCloverCreate.TPSTART(QUDA_PROFILE_INIT);
+  GaugeFieldParam gParam(gaugePrecise->X(), gaugePrecise->Precision(), QUDA_RECONSTRUCT_NO,
+			 0, QUDA_VECTOR_GEOMETRY, QUDA_GHOST_EXCHANGE_NO);
+  gParam.create = QUDA_NULL_FIELD_CREATE;
+  gParam.order = QUDA_MILC_GAUGE_ORDER;
+  gParam.siteSubset = QUDA_FULL_SITE_SUBSET;
+  gParam.t_boundary = gaugePrecise->TBoundary();
+  gParam.nFace = 1;
+  cpuGaugeField *cpuGauge = new cpuGaugeField(gParam);
+
+  CloverFieldParam cpuParam;
+  cpuParam.nDim = 4;
+  for (int i=0; i<4; i++) cpuParam.x[i] = gaugePrecise->X()[i];
+  cpuParam.precision = gaugePrecise->Precision();
+  cpuParam.order = QUDA_PACKED_CLOVER_ORDER;
+  cpuParam.pad = 0;
+  cpuParam.direct = true;
+  cpuParam.inverse = true;
+  cpuParam.clover = NULL;
+  cpuParam.norm = 0;
+  cpuParam.cloverInv = NULL;
+  cpuParam.invNorm = 0;
+  cpuParam.create = QUDA_NULL_FIELD_CREATE;
+  cpuParam.siteSubset = QUDA_FULL_SITE_SUBSET;
+  cpuParam.twisted = false;
+  cpuParam.mu2 = 0.;
+  cpuCloverField *cpuClover = new cpuCloverField(cpuParam);
+  profileCloverCreate.TPSTOP(QUDA_PROFILE_INIT);
+
+  profileCloverCreate.TPSTART(QUDA_PROFILE_D2H);
+  gaugePrecise->saveCPUField(*cpuGauge, QUDA_CPU_FIELD_LOCATION);
+  profileCloverCreate.TPSTOP(QUDA_PROFILE_D2H);
+
+#ifdef MULTI_GPU
+  profileCloverCreate.TPSTART(QUDA_PROFILE_INIT);
+  int R[4] = {1, 1, 1, 1}; // the clover leaf only needs nearest neighbors
+  for (int d=0; d<4; d++) gParam.x[d] += 2*R[d];
+  gParam.create = QUDA_ZERO_FIELD_CREATE;
+  cpuGaugeField *cpuGaugeEx = new cpuGaugeField(gParam);
+  copyExtendedGauge(*cpuGaugeEx, *cpuGauge, QUDA_CPU_FIELD_LOCATION);
+  profileCloverCreate.TPSTOP(QUDA_PROFILE_INIT);
+
+  profileCloverCreate.TPSTART(QUDA_PROFILE_COMMS);
+  cpuGaugeEx->exchangeExtendedGhost(R);
+  profileCloverCreate.TPSTOP(QUDA_PROFILE_COMMS);
+
+  delete cpuGauge;
+  cpuGauge = cpuGaugeEx;
+#endif
+
+  profileCloverCreate.TPSTART(QUDA_PROFILE_COMPUTE);
+  computeCloverCPU(*cpuClover, *cpuGauge, invertParam->clover_coeff, true, invertParam->compute_clover_trlog);
+  profileCloverCreate.TPSTOP(QUDA_PROFILE_COMPUTE);
+
+  profileCloverCreate.TPSTART(QUDA_PROFILE_H2D);
+  cloverPrecise->copy(*cpuClover, true);
+  profileCloverCreate.TPSTOP(QUDA_PROFILE_H2D);
+
+  if (invertParam->compute_clover_trlog) {
+    for (int i=0; i<2; i++) {
+      cloverPrecise->TrLog()[i] = cpuClover->TrLog()[i];
+      invertParam->trlogA[i] = cpuClover->TrLog()[i];
+    }
+  }
+
+  profileCloverCreate.TPSTART(QUDA_PROFILE_FREE);
+  delete cpuClover;
+  delete cpuGauge;
+  profileCloverCreate.TPSTOP(QUDA_PROFILE_FREE);
+}
+
 void createCloverQuda(QudaInvertParam* invertParam)
 {
+  invalidateCloverFingerprint();
   profileCloverCreate.TPSTART(QUDA_PROFILE_TOTAL);
   profileCloverCreate.TPSTART(QUDA_PROFILE_INIT);
   if(!cloverPrecise){
@@ -3534,6 +4749,13 @@ void createCloverQuda(QudaInvertParam* invertParam)
     }
   }
 
+  if (invertParam->clover_calc_location == QUDA_CPU_FIELD_LOCATION) {
+    profileCloverCreate.TPSTOP(QUDA_PROFILE_INIT);
+    createCloverHost(invertParam);
+    profileCloverCreate.TPSTOP(QUDA_PROFILE_TOTAL);
+    return;
+  }
+
   int R[4] = {2,2,2,2}; // radius of the extended region in each dimension / direction
   int y[4];
   for(int dir=0; dir<4; ++dir) y[dir] = gaugePrecise->X()[dir] + 2*R[dir];
@@ -4118,28 +5340,108 @@ computeHISQForceCompleteQuda(void* const milc_momentum,
                              const void* const u_link,
                              const QudaGaugeParam* gParam)
 {
+#if defined(GPU_HISQ_FORCE) && defined(GPU_STAGGERED_OPROD)
+  using namespace quda::fermion_force;
 
-/*
-  void* oprod[2];
+  // Only the host pipeline is implemented: the device path is
+  // computeStaggeredOprodQuda followed by computeHISQForceQuda
+  if (gParam->compute_location != QUDA_CPU_FIELD_LOCATION)
+    errorQuda("computeHISQForceCompleteQuda requires compute_location = QUDA_CPU_FIELD_LOCATION");
+  if (gParam->use_resident_mom || gParam->make_resident_mom)
+    errorQuda("Resident momentum not supported with host HISQ force");
 
-  computeStaggeredOprodQuda(void** oprod,
-    void** fermion,
-    int num_terms,
-    double** coeff,
-    QudaGaugeParam* gParam)
-
-  computeHISQForceQuda(milc_momentum,
-                       level2_coeff,
-                       fat7_coeff,
-                       staple_src,
-                       one_link_src,
-                       naik_src,
-                       w_link,
-                       v_link,
-                       u_link,
-                       gParam);
+  profileHISQForceComplete.TPSTART(QUDA_PROFILE_TOTAL);
+  profileHISQForceComplete.TPSTART(QUDA_PROFILE_INIT);
 
-*/
+  GaugeFieldParam param(0, *gParam);
+  param.precision = gParam->cpu_prec;
+  param.create = QUDA_REFERENCE_FIELD_CREATE;
+  param.order  = QUDA_MILC_GAUGE_ORDER;
+  param.link_type = QUDA_ASQTAD_MOM_LINKS;
+  param.reconstruct = QUDA_RECONSTRUCT_10;
+  param.gauge = (void*)milc_momentum;
+  cpuGaugeField cpuMom(param);
+
+  param.link_type = QUDA_GENERAL_LINKS;
+  param.reconstruct = QUDA_RECONSTRUCT_NO;
+  param.ghostExchange = QUDA_GHOST_EXCHANGE_NO;
+  param.gauge = (void*)w_link;
+  cpuGaugeField cpuWLink(param);
+  param.gauge = (void*)v_link;
+  cpuGaugeField cpuVLink(param);
+  param.gauge = (void*)u_link;
+  cpuGaugeField cpuULink(param);
+
+  // all intermediate fields are kept in MILC order to match the links
+  param.create = QUDA_ZERO_FIELD_CREATE;
+  cpuGaugeField cpuStapleOprod(param);
+  cpuGaugeField cpuNaikOprod(param);
+  cpuGaugeField cpuForce(param);
+  cpuGaugeField cpuUnitarizedForce(param);
+
+  {
+    // default settings for the unitarization
+    const double unitarize_eps = 1e-14;
+    const double hisq_force_filter = 5e-5;
+    const double max_det_error = 1e-10;
+    const bool   allow_svd = true;
+    const bool   svd_only = false;
+    const double svd_rel_err = 1e-8;
+    const double svd_abs_err = 1e-8;
+
+    setUnitarizeForceConstants(unitarize_eps,
+        hisq_force_filter,
+        max_det_error,
+        allow_svd,
+        svd_only,
+        svd_rel_err,
+        svd_abs_err);
+  }
+  profileHISQForceComplete.TPSTOP(QUDA_PROFILE_INIT);
+
+  profileHISQForceComplete.TPSTART(QUDA_PROFILE_COMPUTE);
+
+  // a single pass over all pseudofermion terms for both outer products
+  computeStaggeredOprod(cpuStapleOprod, cpuNaikOprod, quark_array, num_terms, quark_coeff);
+
+  // As in computeHISQForceQuda, the staples are driven by the bare
+  // one-hop outer product, while the one-link source is the same
+  // product weighted by the one-link coefficient and seeds the force.
+  // The Naik coefficient is absorbed into the three-hop quark coefficients.
+  {
+    const size_t length = cpuForce.Bytes() / cpuForce.Precision();
+    if (cpuForce.Precision() == QUDA_DOUBLE_PRECISION) {
+      double *force = (double*)cpuForce.Gauge_p();
+      const double *oprod = (const double*)cpuStapleOprod.Gauge_p();
+#pragma omp parallel for
+      for (size_t i=0; i<length; i++) force[i] = level2_coeff[0] * oprod[i];
+    } else {
+      float *force = (float*)cpuForce.Gauge_p();
+      const float *oprod = (const float*)cpuStapleOprod.Gauge_p();
+#pragma omp parallel for
+      for (size_t i=0; i<length; i++) force[i] = level2_coeff[0] * oprod[i];
+    }
+  }
+
+  double act_path_coeff[6] = {0,1,level2_coeff[2],level2_coeff[3],level2_coeff[4],level2_coeff[5]};
+  hisqStaplesForceCPU(act_path_coeff, *gParam, cpuStapleOprod, cpuWLink, &cpuForce);
+  hisqLongLinkForceCPU(act_path_coeff[1], *gParam, cpuNaikOprod, cpuWLink, &cpuForce);
+
+  int num_failures = 0;
+  unitarizeForceCPU(cpuForce, cpuVLink, &cpuUnitarizedForce, &num_failures);
+  if (num_failures > 0)
+    errorQuda("Error in the unitarization component of the hisq fermion force: %d failures\n", num_failures);
+
+  // reuse the outer-product field for the fat7 stage
+  memset(cpuForce.Gauge_p(), 0, cpuForce.Bytes());
+  hisqStaplesForceCPU(fat7_coeff, *gParam, cpuUnitarizedForce, cpuULink, &cpuForce);
+  hisqCompleteForceCPU(*gParam, cpuForce, cpuULink, &cpuMom);
+
+  profileHISQForceComplete.TPSTOP(QUDA_PROFILE_COMPUTE);
+  profileHISQForceComplete.TPSTOP(QUDA_PROFILE_TOTAL);
+#else
+  errorQuda("HISQ force has not been built");
+#endif
   return;
 }
 
@@ -4849,6 +6151,45 @@ void computeCloverForceQuda(void *h_mom, double dt, void **h_x, void **h_p,
 
 
 
+// update the host gauge field in place, optionally returning the momentum action
+static double updateGaugeFieldHost(void* gauge, void* momentum, double dt, int conj_mom, int exact,
+				   QudaGaugeParam* param, bool compute_action)
+{
+  if (param->use_resident_gauge || param->use_resident_mom ||
+      param->make_resident_gauge || param->make_resident_mom)
+    errorQuda("Resident fields not supported with host gauge update");
+
+  profileGaugeUpdate.TPSTART(QUDA_PROFILE_INIT);
+  GaugeFieldParam gParam(0, *param);
+  gParam.pad = 0;
+  gParam.create = QUDA_REFERENCE_FIELD_CREATE;
+  gParam.link_type = QUDA_SU3_LINKS;
+  gParam.reconstruct = QUDA_RECONSTRUCT_NO;
+  gParam.gauge = gauge;
+  gParam.ghostExchange = QUDA_GHOST_EXCHANGE_NO;
+  cpuGaugeField *cpuGauge = new cpuGaugeField(gParam);
+
+  gParam.order = QUDA_MILC_GAUGE_ORDER;
+  gParam.reconstruct = QUDA_RECONSTRUCT_10;
+  gParam.link_type = QUDA_ASQTAD_MOM_LINKS;
+  gParam.gauge = momentum;
+  cpuGaugeField *cpuMom = new cpuGaugeField(gParam);
+  profileGaugeUpdate.TPSTOP(QUDA_PROFILE_INIT);
+
+  profileGaugeUpdate.TPSTART(QUDA_PROFILE_COMPUTE);
+  double action = 0.0;
+  updateGaugeFieldCPU(*cpuGauge, dt, *cpuGauge, *cpuMom, (bool)conj_mom, (bool)exact,
+		      compute_action ? &action : NULL);
+  profileGaugeUpdate.TPSTOP(QUDA_PROFILE_COMPUTE);
+
+  profileGaugeUpdate.TPSTART(QUDA_PROFILE_FREE);
+  delete cpuMom;
+  delete cpuGauge;
+  profileGaugeUpdate.TPSTOP(QUDA_PROFILE_FREE);
+
+  return action;
+}
+
 void updateGaugeFieldQuda(void* gauge,
     void* momentum,
     double dt,
@@ -4860,6 +6201,12 @@ void updateGaugeFieldQuda(void* gauge,
 
   checkGaugeParam(param);
 
+  if (param->compute_location == QUDA_CPU_FIELD_LOCATION) {
+    updateGaugeFieldHost(gauge, momentum, dt, conj_mom, exact, param, false);
+    profileGaugeUpdate.TPSTOP(QUDA_PROFILE_TOTAL);
+    return;
+  }
+
   profileGaugeUpdate.TPSTART(QUDA_PROFILE_INIT);
   GaugeFieldParam gParam(0, *param);
 
@@ -4903,6 +6250,7 @@ void updateGaugeFieldQuda(void* gauge,
     if (!gaugePrecise) errorQuda("No resident gauge field allocated");
     cudaInGauge = gaugePrecise;
     gaugePrecise = NULL;
+    invalidateGaugeFingerprint();
   }
 
   if (!param->use_resident_mom) {
@@ -4933,6 +6281,7 @@ void updateGaugeFieldQuda(void* gauge,
   if (param->make_resident_gauge) {
     if (gaugePrecise != NULL) delete gaugePrecise;
     gaugePrecise = cudaOutGauge;
+    invalidateGaugeFingerprint();
   } else {
     delete cudaOutGauge;
   }
@@ -4955,6 +6304,21 @@ void updateGaugeFieldQuda(void* gauge,
   return;
 }
 
+double updateGaugeFieldMomActionQuda(void* gauge, void* momentum, double dt,
+				     int conj_mom, int exact, QudaGaugeParam* param)
+{
+  profileGaugeUpdate.TPSTART(QUDA_PROFILE_TOTAL);
+
+  checkGaugeParam(param);
+  if (param->compute_location != QUDA_CPU_FIELD_LOCATION)
+    errorQuda("updateGaugeFieldMomActionQuda requires compute_location = QUDA_CPU_FIELD_LOCATION");
+
+  double action = updateGaugeFieldHost(gauge, momentum, dt, conj_mom, exact, param, true);
+
+  profileGaugeUpdate.TPSTOP(QUDA_PROFILE_TOTAL);
+  return action;
+}
+
  void projectSU3Quda(void *gauge_h, double tol, QudaGaugeParam *param) {
    profileProject.TPSTART(QUDA_PROFILE_TOTAL);
 
@@ -5006,6 +6370,7 @@ void updateGaugeFieldQuda(void* gauge,
    if (param->make_resident_gauge) {
      if (gaugePrecise != NULL && cudaGauge != gaugePrecise) delete gaugePrecise;
      gaugePrecise = cudaGauge;
+     invalidateGaugeFingerprint();
    } else {
      delete cudaGauge;
    }
@@ -5066,6 +6431,7 @@ void updateGaugeFieldQuda(void* gauge,
    if (param->make_resident_gauge) {
      if (gaugePrecise != NULL && cudaGauge != gaugePrecise) delete gaugePrecise;
      gaugePrecise = cudaGauge;
+     invalidateGaugeFingerprint();
    } else {
      delete cudaGauge;
    }
@@ -5085,6 +6451,33 @@ double momActionQuda(void* momentum, QudaGaugeParam* param)
   profileMomAction.TPSTART(QUDA_PROFILE_INIT);
   checkGaugeParam(param);
 
+  if (param->compute_location == QUDA_CPU_FIELD_LOCATION) {
+    if (param->use_resident_mom || param->make_resident_mom)
+      errorQuda("Resident fields not supported with host momentum action");
+
+    GaugeFieldParam gParam(0, *param);
+    gParam.pad = 0;
+    gParam.create = QUDA_REFERENCE_FIELD_CREATE;
+    gParam.ghostExchange = QUDA_GHOST_EXCHANGE_NO;
+    gParam.order = QUDA_MILC_GAUGE_ORDER;
+    gParam.reconstruct = QUDA_RECONSTRUCT_10;
+    gParam.link_type = QUDA_ASQTAD_MOM_LINKS;
+    gParam.gauge = momentum;
+    cpuGaugeField *cpuMom = new cpuGaugeField(gParam);
+    profileMomAction.TPSTOP(QUDA_PROFILE_INIT);
+
+    profileMomAction.TPSTART(QUDA_PROFILE_COMPUTE);
+    double action = computeMomActionCPU(*cpuMom);
+    profileMomAction.TPSTOP(QUDA_PROFILE_COMPUTE);
+
+    profileMomAction.TPSTART(QUDA_PROFILE_FREE);
+    delete cpuMom;
+    profileMomAction.TPSTOP(QUDA_PROFILE_FREE);
+
+    profileMomAction.TPSTOP(QUDA_PROFILE_TOTAL);
+    return action;
+  }
+
   // create the momentum fields
   GaugeFieldParam gParam(0, *param);
   gParam.pad = 0;
@@ -5216,6 +6609,7 @@ void apply_staggered_phase_quda_() {
   printfQuda("applying staggered phase\n");
   if (gaugePrecise) {
     gaugePrecise->applyStaggeredPhase();
+    invalidateGaugeFingerprint();
   } else {
     errorQuda("No persistent gauge field");
   }
@@ -5226,6 +6620,7 @@ void remove_staggered_phase_quda_() {
   printfQuda("removing staggered phase\n");
   if (gaugePrecise) {
     gaugePrecise->removeStaggeredPhase();
+    invalidateGaugeFingerprint();
   } else {
     errorQuda("No persistent gauge field");
   }
@@ -5481,6 +6876,40 @@ void performSTOUTnStep(unsigned int nSteps, double rho)
 }
 
 
+// gauge fix the host field in place; no device fields are touched
+static void gaugeFixingHost(void* gauge, QudaGaugeParam* param, TimeProfile &profile, double* timeinfo,
+			    bool fft, const unsigned int gauge_dir, const unsigned int Nsteps,
+			    const unsigned int verbose_interval, const double relax_boost_or_alpha,
+			    const unsigned int autotune, const double tolerance,
+			    const unsigned int reunit_interval, const unsigned int stopWtheta)
+{
+  if (param->use_resident_gauge || param->make_resident_gauge)
+    errorQuda("Resident fields not supported with host gauge fixing");
+
+  profile.TPSTART(QUDA_PROFILE_INIT);
+  GaugeFieldParam gParam(gauge, *param);
+  gParam.ghostExchange = QUDA_GHOST_EXCHANGE_NO;
+  cpuGaugeField *cpuGauge = new cpuGaugeField(gParam);
+  profile.TPSTOP(QUDA_PROFILE_INIT);
+
+  profile.TPSTART(QUDA_PROFILE_COMPUTE);
+  if (fft) {
+    gaugefixingFFTCPU(*cpuGauge, gauge_dir, Nsteps, verbose_interval, relax_boost_or_alpha, autotune, tolerance, stopWtheta);
+  } else {
+    gaugefixingOVRCPU(*cpuGauge, gauge_dir, Nsteps, verbose_interval, relax_boost_or_alpha, tolerance,
+		      reunit_interval, stopWtheta);
+  }
+  profile.TPSTOP(QUDA_PROFILE_COMPUTE);
+
+  delete cpuGauge;
+
+  if (timeinfo) {
+    timeinfo[0] = 0.0;
+    timeinfo[1] = profile.Last(QUDA_PROFILE_COMPUTE);
+    timeinfo[2] = 0.0;
+  }
+}
+
 int computeGaugeFixingOVRQuda(void* gauge, const unsigned int gauge_dir,  const unsigned int Nsteps, \
   const unsigned int verbose_interval, const double relax_boost, const double tolerance, const unsigned int reunit_interval, \
   const unsigned int  stopWtheta, QudaGaugeParam* param , double* timeinfo)
@@ -5490,6 +6919,13 @@ int computeGaugeFixingOVRQuda(void* gauge, const unsigned int gauge_dir,  const
 
   checkGaugeParam(param);
 
+  if (param->compute_location == QUDA_CPU_FIELD_LOCATION) {
+    gaugeFixingHost(gauge, param, GaugeFixOVRQuda, timeinfo, false, gauge_dir, Nsteps, verbose_interval,
+		    relax_boost, 0, tolerance, reunit_interval, stopWtheta);
+    GaugeFixOVRQuda.TPSTOP(QUDA_PROFILE_TOTAL);
+    return 0;
+  }
+
   GaugeFixOVRQuda.TPSTART(QUDA_PROFILE_INIT);
   GaugeFieldParam gParam(gauge, *param);
   cpuGaugeField *cpuGauge = new cpuGaugeField(gParam);
@@ -5581,6 +7017,7 @@ int computeGaugeFixingOVRQuda(void* gauge, const unsigned int gauge_dir,  const
   if (param->make_resident_gauge) {
     if (gaugePrecise != NULL) delete gaugePrecise;
     gaugePrecise = cudaInGauge;
+    invalidateGaugeFingerprint();
   } else {
     delete cudaInGauge;
   }
@@ -5607,6 +7044,13 @@ int computeGaugeFixingFFTQuda(void* gauge, const unsigned int gauge_dir,  const
 
   checkGaugeParam(param);
 
+  if (param->compute_location == QUDA_CPU_FIELD_LOCATION) {
+    gaugeFixingHost(gauge, param, GaugeFixFFTQuda, timeinfo, true, gauge_dir, Nsteps, verbose_interval,
+		    alpha, autotune, tolerance, 0, stopWtheta);
+    GaugeFixFFTQuda.TPSTOP(QUDA_PROFILE_TOTAL);
+    return 0;
+  }
+
   GaugeFixFFTQuda.TPSTART(QUDA_PROFILE_INIT);
 
   GaugeFieldParam gParam(gauge, *param);
@@ -5659,6 +7103,7 @@ int computeGaugeFixingFFTQuda(void* gauge, const unsigned int gauge_dir,  const
   if (param->make_resident_gauge) {
     if (gaugePrecise != NULL) delete gaugePrecise;
     gaugePrecise = cudaInGauge;
+    invalidateGaugeFingerprint();
   } else {
     delete cudaInGauge;
   }
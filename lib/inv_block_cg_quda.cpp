@@ -0,0 +1,439 @@
+#include <stdio.h>
+#include <stdlib.h>
+#include <math.h>
+#include <float.h>
+#include <vector>
+
+#include <quda_internal.h>
+#include <color_spinor_field.h>
+#include <blas_quda.h>
+#include <dslash_quda.h>
+#include <invert_quda.h>
+#include <util_quda.h>
+#include <face_quda.h>
+
+/*!
+ * Breakdown-free block CG, following Ji and Li, "A breakdown-free
+ * block conjugate gradient method", BIT Numer. Math. 57 (2017) 379.
+ *
+ * The N x N (or smaller) dense algebra of each step is done
+ * redundantly on every process, in double precision, and all of the
+ * dense matrices are stored row major.
+ */
+
+namespace quda {
+
+  BlockCG::BlockCG(DiracMatrix &mat, DiracMatrix &matSloppy, SolverParam &param, TimeProfile &profile) :
+    BlockSolver(param, profile), mat(mat), matSloppy(matSloppy)
+  {
+
+  }
+
+  BlockCG::~BlockCG() {
+
+  }
+
+  /**
+     Computes the local contribution to the inner products (a_i, b_j)
+     for i < na and j < nb, storing them in G[i*nb + j].  When
+     hermitian is set a and b are assumed to give a Hermitian matrix
+     and only the upper triangle is computed.  The caller reduces all
+     of the local results of a step with a single global reduction.
+   */
+  static void localInnerProducts(Complex *G, std::vector<ColorSpinorField*> &a, int na,
+				 std::vector<ColorSpinorField*> &b, int nb, bool hermitian=false)
+  {
+    bool reduceState = globalReduce;
+    globalReduce = false;
+    for (int i=0; i<na; i++)
+      for (int j=(hermitian ? i : 0); j<nb; j++) G[i*nb+j] = blas::cDotProduct(*a[i], *b[j]);
+    globalReduce = reduceState;
+  }
+
+  /** Fills in the lower triangle of a Hermitian matrix from the upper triangle */
+  static void hermitianFill(Complex *G, int n)
+  {
+    for (int i=0; i<n; i++) {
+      G[i*n+i] = Complex(G[i*n+i].real(), 0.0);
+      for (int j=0; j<i; j++) G[i*n+j] = conj(G[j*n+i]);
+    }
+  }
+
+  /**
+     In-place Cholesky factorization A = L L^dagger of a Hermitian
+     positive-definite matrix, leaving L in the lower triangle.
+     @return Whether the matrix was found to be positive definite
+   */
+  static bool cholesky(Complex *A, int n)
+  {
+    for (int j=0; j<n; j++) {
+      double d = A[j*n+j].real();
+      for (int k=0; k<j; k++) d -= norm(A[j*n+k]);
+      if (!(d > 0.0)) return false;
+      d = sqrt(d);
+      A[j*n+j] = d;
+      for (int i=j+1; i<n; i++) {
+	Complex s = A[i*n+j];
+	for (int k=0; k<j; k++) s -= A[i*n+k] * conj(A[j*n+k]);
+	A[i*n+j] = s / d;
+      }
+    }
+    return true;
+  }
+
+  /**
+     Solves L L^dagger X = B in place, where B is n x nrhs
+   */
+  static void choleskySolve(const Complex *L, int n, Complex *B, int nrhs)
+  {
+    for (int c=0; c<nrhs; c++) {
+      for (int i=0; i<n; i++) {
+	Complex s = B[i*nrhs+c];
+	for (int k=0; k<i; k++) s -= L[i*n+k] * B[k*nrhs+c];
+	B[i*nrhs+c] = s / L[i*n+i].real();
+      }
+      for (int i=n-1; i>=0; i--) {
+	Complex s = B[i*nrhs+c];
+	for (int k=i+1; k<n; k++) s -= conj(L[k*n+i]) * B[k*nrhs+c];
+	B[i*nrhs+c] = s / L[i*n+i].real();
+      }
+    }
+  }
+
+  /**
+     Cholesky factorization with diagonal pivoting of a Hermitian
+     positive semi-definite matrix, P^T A P = L L^dagger, stopping
+     once the largest remaining pivot is below tol.  On return the
+     leading rank x rank lower triangle of A holds L, and perm holds
+     the permutation.
+     @return The numerical rank of A
+   */
+  static int pivotedCholesky(Complex *A, int n, std::vector<int> &perm, double tol)
+  {
+    perm.resize(n);
+    for (int i=0; i<n; i++) perm[i] = i;
+
+    for (int k=0; k<n; k++) {
+      int p = k;
+      for (int j=k+1; j<n; j++) if (A[j*n+j].real() > A[p*n+p].real()) p = j;
+      if (!(A[p*n+p].real() > tol)) return k;
+
+      if (p != k) { // symmetric swap of rows and columns k and p
+	for (int j=0; j<n; j++) std::swap(A[k*n+j], A[p*n+j]);
+	for (int i=0; i<n; i++) std::swap(A[i*n+k], A[i*n+p]);
+	std::swap(perm[k], perm[p]);
+      }
+
+      const double d = sqrt(A[k*n+k].real());
+      A[k*n+k] = d;
+      for (int i=k+1; i<n; i++) A[i*n+k] /= d;
+      for (int i=k+1; i<n; i++)
+	for (int j=k+1; j<=i; j++) {
+	  A[i*n+j] -= A[i*n+k] * conj(A[j*n+k]);
+	  A[j*n+i] = conj(A[i*n+j]);
+	}
+    }
+    return n;
+  }
+
+  /**
+     Rank-revealing orthonormalization of the columns of W into P.
+     The columns are first normalized so that the rank decision only
+     depends on their linear dependence and not on their length, and
+     then P = W D Pi L^{-dagger} with D the normalization, Pi the
+     pivoting and L the leading factor of the pivoted Cholesky
+     factorization of the normalized Gram matrix.  W is not modified.
+     @return The number of columns of P, i.e., the numerical rank of W
+   */
+  static int orthonormalize(std::vector<ColorSpinorField*> &P, std::vector<ColorSpinorField*> &W,
+			    int n, double tol)
+  {
+    std::vector<Complex> G(n*n);
+    localInnerProducts(&G[0], W, n, W, n, true);
+    reduceDoubleArray(reinterpret_cast<double*>(&G[0]), 2*n*n);
+    hermitianFill(&G[0], n);
+
+    std::vector<double> D(n);
+    for (int i=0; i<n; i++) D[i] = G[i*n+i].real() > 0.0 ? 1.0 / sqrt(G[i*n+i].real()) : 0.0;
+    for (int i=0; i<n; i++)
+      for (int j=0; j<n; j++) G[i*n+j] *= D[i]*D[j];
+
+    std::vector<int> perm;
+    const int rank = pivotedCholesky(&G[0], n, perm, tol);
+
+    // invert the leading lower-triangular factor
+    std::vector<Complex> Linv(rank*rank, 0.0);
+    for (int j=0; j<rank; j++) {
+      Linv[j*rank+j] = 1.0 / G[j*n+j].real();
+      for (int i=j+1; i<rank; i++) {
+	Complex s = 0.0;
+	for (int k=j; k<i; k++) s -= G[i*n+k] * Linv[k*rank+j];
+	Linv[i*rank+j] = s / G[i*n+i].real();
+      }
+    }
+
+    // P_j = sum_{i<=j} W_perm[i] D_perm[i] conj(Linv(j,i))
+    for (int j=0; j<rank; j++) {
+      blas::zero(*P[j]);
+      for (int i=0; i<=j; i++)
+	blas::caxpy(D[perm[i]] * conj(Linv[j*rank+i]), *W[perm[i]], *P[j]);
+    }
+
+    return rank;
+  }
+
+  void BlockCG::operator()(std::vector<ColorSpinorField*> x, std::vector<ColorSpinorField*> b)
+  {
+    if (x.size() != b.size()) errorQuda("Number of solutions %lu does not match number of sources %lu", x.size(), b.size());
+    const int N = b.size();
+
+    if (param.residual_type & QUDA_HEAVY_QUARK_RESIDUAL)
+      errorQuda("Heavy quark residual not supported by block CG");
+
+    profile.TPSTART(QUDA_PROFILE_INIT);
+
+    std::vector<double> b2(N), stop(N), r2(N);
+    for (int i=0; i<N; i++) {
+      b2[i] = blas::norm2(*b[i]);
+      if (b2[i] == 0.0) errorQuda("Source %d has zero norm", i);
+      stop[i] = Solver::stopping(param.tol, b2[i], param.residual_type);
+    }
+
+    ColorSpinorParam csParam(*x[0]);
+    csParam.create = QUDA_ZERO_FIELD_CREATE;
+
+    std::vector<ColorSpinorField*> y(N), r(N);
+    for (int i=0; i<N; i++) {
+      y[i] = ColorSpinorField::Create(csParam); // high-precision accumulator
+      r[i] = ColorSpinorField::Create(csParam);
+    }
+    ColorSpinorField *tmpp = ColorSpinorField::Create(csParam);
+    ColorSpinorField &tmp = *tmpp;
+
+    for (int i=0; i<N; i++) {
+      mat(*r[i], *x[i], tmp);
+      r2[i] = blas::xmyNorm(*b[i], *r[i]);
+    }
+
+    csParam.setPrecision(param.precision_sloppy);
+
+    const bool sloppy_r = param.precision_sloppy != x[0]->Precision();
+    const bool sloppy_x = sloppy_r && param.use_sloppy_partial_accumulator;
+
+    std::vector<ColorSpinorField*> rSloppy(N), xSloppy(N), p(N), q(N), w(N);
+    for (int i=0; i<N; i++) {
+      rSloppy[i] = sloppy_r ? ColorSpinorField::Create(csParam) : r[i];
+      xSloppy[i] = sloppy_x ? ColorSpinorField::Create(csParam) : x[i];
+      p[i] = ColorSpinorField::Create(csParam);
+      q[i] = ColorSpinorField::Create(csParam);
+      w[i] = ColorSpinorField::Create(csParam);
+    }
+    ColorSpinorField *tmpSp = ColorSpinorField::Create(csParam);
+
+    // tmp2 only needed for multi-gpu Wilson-like kernels
+    ColorSpinorField *tmpS2p = !matSloppy.isStaggered() ? ColorSpinorField::Create(csParam) : tmpSp;
+
+    ColorSpinorField &tmpS = *tmpSp;
+    ColorSpinorField &tmpS2 = *tmpS2p;
+
+    for (int i=0; i<N; i++) {
+      if (sloppy_r) blas::copy(*rSloppy[i], *r[i]);
+      if (sloppy_x) {
+	blas::copy(*y[i], *x[i]);
+	blas::zero(*xSloppy[i]);
+      } else {
+	blas::zero(*y[i]);
+      }
+    }
+
+    profile.TPSTOP(QUDA_PROFILE_INIT);
+    profile.TPSTART(QUDA_PROFILE_PREAMBLE);
+
+    // directions whose normalized distance from the span of the others
+    // is below the noise level of the sloppy precision are dropped
+    const double eps = param.precision_sloppy == QUDA_DOUBLE_PRECISION ? DBL_EPSILON :
+      param.precision_sloppy == QUDA_SINGLE_PRECISION ? FLT_EPSILON : pow(2.0,-13);
+    const double rank_tol = N * eps;
+
+    std::vector<double> maxrr(N);
+    for (int i=0; i<N; i++) maxrr[i] = sqrt(r2[i]);
+
+    std::vector<Complex> PQ(N*N), alpha(N*N), beta(N*N);
+    std::vector<Complex> QR(N*N + N); // the trailing N entries hold the residual norms
+
+    int rUpdate = 0;
+    int rankDeficient = 0;
+
+    profile.TPSTOP(QUDA_PROFILE_PREAMBLE);
+    profile.TPSTART(QUDA_PROFILE_COMPUTE);
+    blas::flops = 0;
+
+    for (int i=0; i<N; i++) blas::copy(*w[i], *rSloppy[i]);
+    int m = orthonormalize(p, w, N, rank_tol);
+
+    int k = 0;
+    int steps_since_reliable = 1;
+
+    while (k < param.maxiter && m > 0) {
+      if (m < N) rankDeficient++;
+
+      for (int j=0; j<m; j++) matSloppy(*q[j], *p[j], tmpS, tmpS2);
+
+      // P^dagger A P and P^dagger R with one reduction
+      {
+	std::vector<Complex> local(m*m + m*N);
+	localInnerProducts(&local[0], p, m, q, m, true);
+	localInnerProducts(&local[m*m], p, m, rSloppy, N);
+	reduceDoubleArray(reinterpret_cast<double*>(&local[0]), 2*(m*m + m*N));
+	for (int i=0; i<m*m; i++) PQ[i] = local[i];
+	for (int i=0; i<m*N; i++) alpha[i] = local[m*m+i];
+      }
+      hermitianFill(&PQ[0], m);
+
+      if (!cholesky(&PQ[0], m)) {
+	warningQuda("BlockCG: P^dagger A P is not positive definite at iteration %d", k);
+	break;
+      }
+
+      // alpha = (P^dagger A P)^{-1} P^dagger R
+      choleskySolve(&PQ[0], m, &alpha[0], N);
+
+      for (int c=0; c<N; c++) {
+	for (int j=0; j<m; j++) {
+	  blas::caxpy(alpha[j*N+c], *p[j], *xSloppy[c]);
+	  blas::caxpy(-alpha[j*N+c], *q[j], *rSloppy[c]);
+	}
+      }
+      k++;
+
+      // Q^dagger R and the residual norms with one reduction
+      {
+	bool reduceState = globalReduce;
+	globalReduce = false;
+	localInnerProducts(&QR[0], q, m, rSloppy, N);
+	for (int c=0; c<N; c++) QR[m*N+c] = blas::norm2(*rSloppy[c]);
+	globalReduce = reduceState;
+	reduceDoubleArray(reinterpret_cast<double*>(&QR[0]), 2*(m*N + N));
+      }
+
+      bool converged = true;
+      bool updateR = false;
+      double r2max = 0.0, b2max = 1.0;
+      for (int c=0; c<N; c++) {
+	r2[c] = QR[m*N+c].real();
+	if (r2[c] > stop[c]) converged = false;
+	const double rNorm = sqrt(r2[c]);
+	if (rNorm > maxrr[c]) maxrr[c] = rNorm;
+	if (rNorm < param.delta*maxrr[c]) updateR = true;
+	if (r2[c]/b2[c] > r2max/b2max) { r2max = r2[c]; b2max = b2[c]; }
+      }
+
+      if (getVerbosity() >= QUDA_VERBOSE)
+	printfQuda("BlockCG: %d iterations, rank %d, max <r,r> = %e, |r|/|b| = %e\n", k, m, r2max, sqrt(r2max/b2max));
+      if (std::isnan(r2max)) errorQuda("Solver appears to have diverged");
+
+      // once converged, confirm it with the true residual (only if doing reliable updates)
+      if (converged) {
+	if (steps_since_reliable == 0 || param.delta < param.tol) break;
+	updateR = true;
+      }
+
+      if (updateR) {
+	converged = true;
+	for (int c=0; c<N; c++) {
+	  blas::copy(*x[c], *xSloppy[c]); // nop when these pointers alias
+	  blas::xpy(*x[c], *y[c]);
+	  mat(*r[c], *y[c], tmp);
+	  r2[c] = blas::xmyNorm(*b[c], *r[c]);
+	  blas::copy(*rSloppy[c], *r[c]); // nop when these pointers alias
+	  blas::zero(*xSloppy[c]);
+	  maxrr[c] = sqrt(r2[c]);
+	  if (r2[c] > stop[c]) converged = false;
+	}
+	rUpdate++;
+	steps_since_reliable = 0;
+	if (converged) break;
+
+	// Q^dagger R for the replaced residuals
+	localInnerProducts(&QR[0], q, m, rSloppy, N);
+	reduceDoubleArray(reinterpret_cast<double*>(&QR[0]), 2*m*N);
+      } else {
+	steps_since_reliable++;
+      }
+
+      // beta = -(P^dagger A P)^{-1} Q^dagger R, so that the new directions are A-orthogonal to P
+      for (int i=0; i<m*N; i++) beta[i] = -QR[i];
+      choleskySolve(&PQ[0], m, &beta[0], N);
+
+      for (int c=0; c<N; c++) {
+	blas::copy(*w[c], *rSloppy[c]);
+	for (int j=0; j<m; j++) blas::caxpy(beta[j*N+c], *p[j], *w[c]);
+      }
+
+      m = orthonormalize(p, w, N, rank_tol);
+    }
+
+    for (int c=0; c<N; c++) {
+      blas::copy(*x[c], *xSloppy[c]);
+      blas::xpy(*y[c], *x[c]);
+    }
+
+    profile.TPSTOP(QUDA_PROFILE_COMPUTE);
+    profile.TPSTART(QUDA_PROFILE_EPILOGUE);
+
+    param.secs = profile.Last(QUDA_PROFILE_COMPUTE);
+    double gflops = (blas::flops + mat.flops() + matSloppy.flops())*1e-9;
+    reduceDouble(gflops);
+    param.gflops = gflops;
+    param.iter += k;
+
+    if (k==param.maxiter)
+      warningQuda("Exceeded maximum iterations %d", param.maxiter);
+
+    if (getVerbosity() >= QUDA_VERBOSE)
+      printfQuda("BlockCG: Reliable updates = %d, rank-deficient iterations = %d\n", rUpdate, rankDeficient);
+
+    // compute the true residuals, reporting the worst of the block
+    param.true_res = 0.0;
+    param.true_res_hq = 0.0;
+    for (int c=0; c<N; c++) {
+      mat(*r[c], *x[c], tmp);
+      double true_res = sqrt(blas::xmyNorm(*b[c], *r[c]) / b2[c]);
+      double true_res_hq = sqrt(blas::HeavyQuarkResidualNorm(*x[c], *r[c]).z);
+      if (true_res > param.true_res) param.true_res = true_res;
+      if (true_res_hq > param.true_res_hq) param.true_res_hq = true_res_hq;
+      if (getVerbosity() >= QUDA_VERBOSE)
+	printfQuda("BlockCG: source %d, L2 relative residual: iterated = %e, true = %e\n", c, sqrt(r2[c]/b2[c]), true_res);
+    }
+
+    if (getVerbosity() >= QUDA_SUMMARIZE)
+      printfQuda("BlockCG: Convergence of %d sources at %d iterations, max L2 relative residual = %e\n",
+		 N, k, param.true_res);
+
+    // reset the flops counters
+    blas::flops = 0;
+    mat.flops();
+    matSloppy.flops();
+
+    profile.TPSTOP(QUDA_PROFILE_EPILOGUE);
+    profile.TPSTART(QUDA_PROFILE_FREE);
+
+    if (tmpS2p != tmpSp) delete tmpS2p;
+    delete tmpSp;
+    for (int i=0; i<N; i++) {
+      if (sloppy_r) delete rSloppy[i];
+      if (sloppy_x) delete xSloppy[i];
+      delete p[i];
+      delete q[i];
+      delete w[i];
+      delete r[i];
+      delete y[i];
+    }
+    delete tmpp;
+
+    profile.TPSTOP(QUDA_PROFILE_FREE);
+
+    return;
+  }
+
+} // namespace quda
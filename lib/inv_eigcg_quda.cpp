@@ -174,9 +174,11 @@ namespace quda {
       int nev;
       int ldm;
 
+      QudaDenseLinalgBackend dense_linalg;
+
       public:
 
-      EigCGArgs(int m, int nev);
+      EigCGArgs(int m, int nev, QudaDenseLinalgBackend dense_linalg);
       ~EigCGArgs();
 
       //methods for constructing Lanczos matrix:
@@ -194,13 +196,13 @@ namespace quda {
    };
 
    template<typename Float, typename CudaComplex>
-   EigCGArgs<Float, CudaComplex>::EigCGArgs(int m, int nev): m(m), nev(nev){
+   EigCGArgs<Float, CudaComplex>::EigCGArgs(int m, int nev, QudaDenseLinalgBackend dense_linalg): m(m), nev(nev), dense_linalg(dense_linalg){
     //include pad?
     ldm    = ((m+15)/16)*16;//too naive
 
     //magma initialization:
     const int prec = sizeof(Float);
-    eigcg_magma_args = new BlasMagmaArgs(m, 2*nev, ldm, prec);
+    eigcg_magma_args = new BlasMagmaArgs(m, 2*nev, ldm, prec, dense_linalg);
 
     hTm     = new std::complex<Float>[ldm*m];//VH A V
     hTvalm  = (Float*)safe_malloc(m*sizeof(Float));//eigenvalues of both T[m,  m  ] and T[m-1, m-1] (re-used)
@@ -354,7 +356,7 @@ namespace quda {
 
     double *evals   = (double*)calloc(nev, sizeof(double));
 
-    BlasMagmaArgs magma_args2(nev, nev, sizeof(double));//change precision..
+    BlasMagmaArgs magma_args2(nev, nev, sizeof(double), dense_linalg);//change precision..
 
     magma_args2.MagmaHEEVD(hproj, evals, nev, true);
 
@@ -558,7 +560,7 @@ namespace quda {
     }
 
     //create EigCG objects:
-    EigCGArgs<double, cuDoubleComplex> *eigcg_args = new EigCGArgs<double, cuDoubleComplex>(param.m, param.nev); //must be adjustable..
+    EigCGArgs<double, cuDoubleComplex> *eigcg_args = new EigCGArgs<double, cuDoubleComplex>(param.m, param.nev, param.dense_linalg); //must be adjustable..
 
     //EigCG additional parameters:
     double alpha0 = 1.0, beta0 = 0.0;
@@ -841,7 +843,7 @@ namespace quda {
 
      memcpy(projm, dpar->proj_matrix, dpar->ld*curr_evals*sizeof(Complex));
 
-     BlasMagmaArgs magma_args(dpar->tot_dim, dpar->ld, sizeof(double));//change precision..
+     BlasMagmaArgs magma_args(dpar->tot_dim, dpar->ld, sizeof(double), param.dense_linalg);//change precision..
 
      magma_args.MagmaHEEVD(projm, evals, curr_evals, true);
 
@@ -913,7 +915,7 @@ namespace quda {
 
      memcpy(projm, dpar->proj_matrix, dpar->ld*dpar->cur_dim*sizeof(Complex));
 
-     BlasMagmaArgs magma_args(dpar->tot_dim, dpar->ld, sizeof(double));//change precision..
+     BlasMagmaArgs magma_args(dpar->tot_dim, dpar->ld, sizeof(double), param.dense_linalg);//change precision..
 
      magma_args.MagmaHEEVD(projm, evals, dpar->cur_dim, true);
 
@@ -1023,7 +1025,7 @@ namespace quda {
     if(set2zero) zero(x);
     if(dpar->cur_dim == 0) return;//nothing to do
 
-    BlasMagmaArgs magma_args(sizeof(double));//change precision..
+    BlasMagmaArgs magma_args(sizeof(double), param.dense_linalg);//change precision..
 
     Complex  *vec   = new Complex[dpar->ld];
 
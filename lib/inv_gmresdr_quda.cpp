@@ -65,8 +65,10 @@ namespace quda {
       bool alloc_flag;
       bool init_flag;
 
-      GMResDRDeflationParam(const int ldm, const int nev, bool alloc = false, int proj_freq = 1, QudaProjectionType proj_type = QUDA_INVALID_PROJECTION) : projMat(0), projVecs(0),
-      projQRMat(0), projRMat(0), projTau(0), projType(proj_type), projFreq(proj_freq), ld(ldm), nv(nev), alloc_flag(alloc), init_flag(false)
+      QudaDenseLinalgBackend dense_linalg;//backend for the QR decomposition of the projection matrix
+
+      GMResDRDeflationParam(const int ldm, const int nev, QudaDenseLinalgBackend dense_linalg, bool alloc = false, int proj_freq = 1, QudaProjectionType proj_type = QUDA_INVALID_PROJECTION) : projMat(0), projVecs(0),
+      projQRMat(0), projRMat(0), projTau(0), projType(proj_type), projFreq(proj_freq), ld(ldm), nv(nev), alloc_flag(alloc), init_flag(false), dense_linalg(dense_linalg)
       {
         if(nev == 0) errorQuda("\nIncorrect deflation space parameters...\n");
         //Create deflation objects:
@@ -129,7 +131,7 @@ namespace quda {
          //perform QR decomposition of the projection matrix:
          if(projType == QUDA_MINRES_PROJECTION)
          {
-            BlasMagmaArgs magma_args(sizeof(double));
+            BlasMagmaArgs magma_args(sizeof(double), dense_linalg);
 
             memcpy(projQRMat, projMat, nv*ld*sizeof(Complex));//use this also for intermediate QR matrix
 
@@ -216,12 +218,14 @@ namespace quda {
       int ldm;//leading dimension (must be >= m+1)
       int nev;//number of harmonic eigenvectors used for the restart
 
+      QudaDenseLinalgBackend dense_linalg;
+
       bool init_flag;
       //public:
 
       GMResDRArgs( ) { };
 
-      GMResDRArgs(int m, int ldm, int nev);
+      GMResDRArgs(int m, int ldm, int nev, QudaDenseLinalgBackend dense_linalg);
 
       ~GMResDRArgs();
       //more implementations here:
@@ -244,8 +248,8 @@ namespace quda {
       void UpdateSolution(cudaColorSpinorField *x, cudaColorSpinorField *Vm, Complex *givensH, Complex *g, const int j);
    };
 
-  GMResDRArgs::GMResDRArgs(int m, int ldm, int nev): GMResDR_magma_args(0), harVecs(0), harVals(0), sortedHarVecs(0), sortedHarVals(0), harMat(0), qrH(0), tauH(0), srtRes(0),
-  m(m), ldm(ldm), nev(nev), init_flag(false) {
+  GMResDRArgs::GMResDRArgs(int m, int ldm, int nev, QudaDenseLinalgBackend dense_linalg): GMResDR_magma_args(0), harVecs(0), harVals(0), sortedHarVecs(0), sortedHarVals(0), harMat(0), qrH(0), tauH(0), srtRes(0),
+  m(m), ldm(ldm), nev(nev), dense_linalg(dense_linalg), init_flag(false) {
 
      int mp1 = m+1;
 
@@ -264,7 +268,7 @@ namespace quda {
   {
      if(init_flag) errorQuda("\nGMResDR resources were allocated.\n");
      //magma library initialization:
-     GMResDR_magma_args = new BlasMagmaArgs(m, nev+1, ldm, sizeof(double));
+     GMResDR_magma_args = new BlasMagmaArgs(m, nev+1, ldm, sizeof(double), dense_linalg);
 
      harVecs  = new Complex[ldm*m];//(m+1)xm (note that ldm >= m+1)
      harVals  = new Complex[m];//
@@ -509,7 +513,7 @@ namespace quda {
 
      int ldm    = mp1;//((mp1+15)/16)*16;//leading dimension
 
-     args = new GMResDRArgs(param.m, ldm, param.nev);//use_deflated_cycles flag is true by default
+     args = new GMResDRArgs(param.m, ldm, param.nev, param.dense_linalg);//use_deflated_cycles flag is true by default
 
      return;
  }
@@ -565,7 +569,7 @@ namespace quda {
     Complex *c    = new Complex[(dpar->nv+1)];
     Complex *d    = new Complex[dpar->ld];
 
-    BlasMagmaArgs magma_args(sizeof(double));
+    BlasMagmaArgs magma_args(sizeof(double), param.dense_linalg);
 
     //if(getVerbosity() >= QUDA_DEBUG_VERBOSE)
        printfQuda("\nUsing projection method %d\n", static_cast<int>(dpar->projType));
@@ -1347,7 +1351,7 @@ namespace quda {
  {
    if(!defl_param)
    {
-     defl_param = new GMResDRDeflationParam(args->ldm, args->nev);
+     defl_param = new GMResDRDeflationParam(args->ldm, args->nev, param.dense_linalg);
    }
 
    const double tol_threshold = 6.0;//for mixed precision version only.
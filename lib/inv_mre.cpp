@@ -1,33 +1,244 @@
 #include <invert_quda.h>
 #include <blas_quda.h>
+#include <face_quda.h>
+#include <vector>
+
+#ifdef _OPENMP
+#include <omp.h>
+#endif
 
 namespace quda {
 
-  MinResExt::MinResExt(DiracMatrix &mat, TimeProfile &profile) 
-    : mat(mat), profile(profile){
+  MinResExt::MinResExt(DiracMatrix &mat, TimeProfile &profile, int max_dim)
+    : mat(&mat), profile(profile), max_dim(max_dim), G((size_t)max_dim*max_dim) {
 
   }
 
   MinResExt::~MinResExt() {
+    reset();
+  }
+
+  void MinResExt::reset() {
+    for (unsigned int i=0; i<p.size(); i++) {
+      delete p[i];
+      delete q[i];
+    }
+    p.clear();
+    q.clear();
+  }
+
+  /**
+     Whether the host multi-vector kernels can be used: all fields on
+     the host with the same precision and length.
+   */
+  static bool hostBatch(const std::vector<ColorSpinorField*> &p, int begin, int end, const ColorSpinorField &v) {
+    if (v.Location() != QUDA_CPU_FIELD_LOCATION) return false;
+    if (v.Precision() != QUDA_DOUBLE_PRECISION && v.Precision() != QUDA_SINGLE_PRECISION) return false;
+    for (int i=begin; i<end; i++) {
+      if (p[i]->Location() != QUDA_CPU_FIELD_LOCATION || p[i]->Precision() != v.Precision() ||
+	  p[i]->Length() != v.Length() || p[i]->FieldOrder() != v.FieldOrder()) return false;
+    }
+    return true;
+  }
+
+  // number of reals processed per block by the host kernels, chosen
+  // such that a block of each vector stays resident in the L1 cache
+  static const long host_block = 1024;
+
+  /**
+     result[i-begin] = (p_i, v), local to this process, computed in a
+     single pass over v.  Each block of v is loaded once and reused
+     for all of the basis vectors.
+   */
+  template <typename Float>
+  static void hostMultiDot(double *result, const std::vector<ColorSpinorField*> &p, int begin, int end,
+			   const ColorSpinorField &v) {
+    const int n = end - begin;
+    const long length = v.Length();
+    const Float *y = static_cast<const Float*>(v.V());
+
+    for (int i=0; i<2*n; i++) result[i] = 0.0;
+
+#pragma omp parallel
+    {
+      std::vector<double> local(2*n, 0.0);
+#pragma omp for
+      for (long s0=0; s0<length; s0+=host_block) {
+	const long s1 = s0 + host_block < length ? s0 + host_block : length;
+	for (int i=0; i<n; i++) {
+	  const Float *a = static_cast<const Float*>(p[begin+i]->V());
+	  double re = 0.0, im = 0.0;
+	  for (long s=s0; s<s1; s+=2) {
+	    // conj(a) * y
+	    re += a[s]*y[s] + a[s+1]*y[s+1];
+	    im += a[s]*y[s+1] - a[s+1]*y[s];
+	  }
+	  local[2*i+0] += re;
+	  local[2*i+1] += im;
+	}
+      }
+#pragma omp critical
+      for (int i=0; i<2*n; i++) result[i] += local[i];
+    }
+  }
+
+  /**
+     Computes the inner products (p_i, v) for begin <= i < end with a
+     single global reduction.  Host fields are processed in a single
+     pass over v, otherwise the local inner products are batched.
+   */
+  static void multiDot(Complex *result, std::vector<ColorSpinorField*> &p, int begin, int end,
+		       ColorSpinorField &v) {
+    const int n = end - begin;
+    if (n <= 0) return;
+
+    if (hostBatch(p, begin, end, v)) {
+      if (v.Precision() == QUDA_DOUBLE_PRECISION)
+	hostMultiDot<double>(reinterpret_cast<double*>(result), p, begin, end, v);
+      else
+	hostMultiDot<float>(reinterpret_cast<double*>(result), p, begin, end, v);
+    } else {
+      bool reduceState = globalReduce;
+      globalReduce = false;
+      for (int i=0; i<n; i++) result[i] = blas::cDotProduct(*p[begin+i], v);
+      globalReduce = reduceState;
+    }
+
+    reduceDoubleArray(reinterpret_cast<double*>(result), 2*n);
+  }
 
+  template <typename Float>
+  static void hostMultiCaxpy(const Complex *a, const std::vector<ColorSpinorField*> &p, int begin, int end,
+			     ColorSpinorField &v) {
+    const int n = end - begin;
+    const long length = v.Length();
+    Float *y = static_cast<Float*>(v.V());
+
+#pragma omp parallel for
+    for (long s0=0; s0<length; s0+=host_block) {
+      const long s1 = s0 + host_block < length ? s0 + host_block : length;
+      for (int i=0; i<n; i++) {
+	const Float *x = static_cast<const Float*>(p[begin+i]->V());
+	const Float re = a[i].real(), im = a[i].imag();
+	for (long s=s0; s<s1; s+=2) {
+	  y[s+0] += re*x[s+0] - im*x[s+1];
+	  y[s+1] += re*x[s+1] + im*x[s+0];
+	}
+      }
+    }
+  }
+
+  /**
+     v += sum_i a[i-begin] p_i, done in a single pass over v for host
+     fields.
+   */
+  static void multiCaxpy(const Complex *a, std::vector<ColorSpinorField*> &p, int begin, int end,
+			 ColorSpinorField &v) {
+    if (hostBatch(p, begin, end, v)) {
+      if (v.Precision() == QUDA_DOUBLE_PRECISION) hostMultiCaxpy<double>(a, p, begin, end, v);
+      else hostMultiCaxpy<float>(a, p, begin, end, v);
+    } else {
+      for (int i=begin; i<end; i++) blas::caxpy(a[i-begin], *p[i], v);
+    }
+  }
+
+  /**
+     Orthonormalizes p_j against p_0 ... p_{j-1} with classical
+     Gram-Schmidt, applied twice for stability, so that each pass
+     needs a single sweep over p_j.
+     @return |p_j|^2 after the orthogonalization relative to before
+   */
+  static double orthonormalize(std::vector<ColorSpinorField*> &p, int j) {
+    const double v2 = blas::norm2(*p[j]);
+    std::vector<Complex> c(j > 0 ? j : 1);
+    for (int pass=0; pass<2; pass++) {
+      multiDot(&c[0], p, 0, j, *p[j]);
+      for (int i=0; i<j; i++) c[i] = -c[i];
+      multiCaxpy(&c[0], p, 0, j, *p[j]);
+    }
+    const double p2 = blas::norm2(*p[j]);
+    if (p2 > 0.0) blas::ax(1 / sqrt(p2), *p[j]);
+    return v2 > 0.0 ? p2 / v2 : 0.0;
+  }
+
+  /**
+     Sets q_j = A p_j and fills row and column j of G, which has
+     leading dimension ld.  This costs one operator application and a
+     single reduction over j+1 inner products.
+   */
+  static void extendGram(const DiracMatrix &mat, std::vector<ColorSpinorField*> &p,
+			 std::vector<ColorSpinorField*> &q, int j, Complex *G, int ld) {
+    mat(*q[j], *p[j]);
+    std::vector<Complex> c(j+1);
+    multiDot(&c[0], p, 0, j+1, *q[j]);
+    for (int i=0; i<j; i++) {
+      G[i*ld+j] = c[i];
+      G[j*ld+i] = conj(c[i]);
+    }
+    G[j*ld+j] = c[j].real();
   }
 
+  /**
+     Solves G alpha = (p, b) for the N x N matrix G with leading
+     dimension ld, and sets x = sum_i alpha_i p_i and b -= sum_i
+     alpha_i q_i.  G is Hermitian positive definite for a Hermitian
+     positive definite operator, so it is solved with a Cholesky
+     factorization of a copy.
+     @return Whether G was positive definite
+   */
+  static bool solveProjected(ColorSpinorField &x, ColorSpinorField &b, std::vector<ColorSpinorField*> &p,
+			     std::vector<ColorSpinorField*> &q, int N, const Complex *G_in, int ld) {
+    // Construct the rhs
+    std::vector<Complex> alpha(N);
+    multiDot(&alpha[0], p, 0, N, b);
+
+    std::vector<Complex> G(N*N);
+    for (int i=0; i<N; i++)
+      for (int j=0; j<N; j++) G[i*N+j] = G_in[i*ld+j];
+
+    for (int j=0; j<N; j++) {
+      double d = G[j*N+j].real();
+      for (int k=0; k<j; k++) d -= norm(G[j*N+k]);
+      if (!(d > 0.0)) return false;
+      d = sqrt(d);
+      G[j*N+j] = d;
+      for (int i=j+1; i<N; i++) {
+	Complex s = G[i*N+j];
+	for (int k=0; k<j; k++) s -= G[i*N+k] * conj(G[j*N+k]);
+	G[i*N+j] = s / d;
+      }
+    }
+
+    for (int i=0; i<N; i++) {
+      for (int k=0; k<i; k++) alpha[i] -= G[i*N+k] * alpha[k];
+      alpha[i] /= G[i*N+i].real();
+    }
+    for (int i=N-1; i>=0; i--) {
+      for (int k=i+1; k<N; k++) alpha[i] -= conj(G[k*N+i]) * alpha[k];
+      alpha[i] /= G[i*N+i].real();
+    }
+
+    // x = sum_i alpha_i p_i and b -= sum_i alpha_i q_i
+    blas::zero(x);
+    multiCaxpy(&alpha[0], p, 0, N, x);
+    for (int i=0; i<N; i++) alpha[i] = -alpha[i];
+    multiCaxpy(&alpha[0], q, 0, N, b);
+    return true;
+  }
 
   /*
     We want to find the best initial guess of the solution of
     A x = b, and we have N previous solutions x_i.
     The method goes something like this:
-    
+
     1. Orthonormalise the p_i and q_i
     2. Form the matrix G_ij = x_i^dagger A x_j
     3. Form the vector B_i = x_i^dagger b
     4. solve A_ij a_j  = B_i
     5. x = a_i p_i
   */
-  void MinResExt::operator()(ColorSpinorField &x, ColorSpinorField &b, 
+  void MinResExt::operator()(ColorSpinorField &x, ColorSpinorField &b,
 			     std::vector<ColorSpinorField*> p, std::vector<ColorSpinorField*> q, int N) {
-    if (Location(x, b) != QUDA_CUDA_FIELD_LOCATION) errorQuda("Not supported");    
-
     // if no guess is required, then set initial guess = 0
     if (N == 0) {
       blas::zero(x);
@@ -36,77 +247,84 @@ namespace quda {
 
     double b2 = blas::norm2(b);
 
-    // Array to hold the matrix elements
-    Complex **G = new Complex*[N];
-    for (int i=0; i<N; i++) G[i] = new Complex[N];
-    
-    // Solution and source vectors
-    Complex *alpha = new Complex[N];
-    Complex *beta = new Complex[N];
-
-    // Orthonormalise the vector basis
-    for (int i=0; i<N; i++) {
-      double p2 = blas::norm2(*p[i]);
-      blas::ax(1 / sqrt(p2), *p[i]);
-      for (int j=i+1; j<N; j++) {
-	Complex xp = blas::cDotProduct(*p[i], *p[j]);
-	blas::caxpy(-xp, *p[i], *p[j]);
-      }
+    // G is stored row major with leading dimension N
+    std::vector<Complex> G(N*N);
+    for (int j=0; j<N; j++) {
+      if (orthonormalize(p, j) == 0.0)
+	errorQuda("Basis vector %d is linearly dependent on the previous vectors", j);
+      extendGram(*mat, p, q, j, &G[0], N);
     }
 
-    // Perform sparse matrix multiplication and construct rhs
-    for (int i=0; i<N; i++) {
-      beta[i] = blas::cDotProduct(*p[i], b);
-      mat(*q[i], *p[i]);
-      G[i][i] = blas::reDotProduct(*q[i], *p[i]);
+    if (!solveProjected(x, b, p, q, N, &G[0], N)) {
+      warningQuda("MinResExt: projected matrix is not positive definite, using zero guess");
+      blas::zero(x);
+      return;
     }
 
-    // Construct the matrix
-    for (int j=0; j<N; j++) {
-      for (int k=j+1; k<N; k++) {
-	G[j][k] = blas::cDotProduct(*p[j], *q[k]);
-	G[k][j] = conj(G[j][k]);
-      }
-    }
+    double rsd = sqrt(blas::norm2(b) / b2 );
+    printfQuda("MinResExt: N = %d, |res| / |src| = %e\n", N, rsd);
+  }
 
-    // Gauss-Jordan elimination with partial pivoting
-    for (int i=0; i<N; i++) {
+  bool MinResExt::append(const ColorSpinorField &v) {
+    if (max_dim <= 0) return false;
 
-      // Perform partial pivoting
-      int k = i;
-      for (int j=i+1; j<N; j++) if (abs(G[j][j]) > abs(G[k][k])) k = j;
-      if (k != i) {
-	std::swap<Complex>(beta[k], beta[i]);
-	for (int j=0; j<N; j++) std::swap<Complex>(G[k][j], G[i][j]);
-      }
+    ColorSpinorField *pv, *qv;
+    if ((int)p.size() == max_dim) {
+      // drop the oldest direction and reuse its fields
+      pv = p[0];
+      qv = q[0];
+      p.erase(p.begin());
+      q.erase(q.begin());
+      const int n = p.size();
+      for (int i=0; i<n; i++)
+	for (int j=0; j<n; j++) G[i*max_dim+j] = G[(i+1)*max_dim+j+1];
+    } else {
+      ColorSpinorParam param(v);
+      param.create = QUDA_NULL_FIELD_CREATE;
+      pv = ColorSpinorField::Create(param);
+      qv = ColorSpinorField::Create(param);
+    }
 
-      // Convert matrix to upper triangular form
-      for (int j=i+1; j<N; j++) {
-	Complex xp = G[j][i]/G[i][i];
-	beta[j] -= xp * beta[i];
-	for (int k=0; k<N; k++) G[j][k] -= xp * G[i][k];
-      }
+    const int j = p.size();
+    blas::copy(*pv, v);
+    p.push_back(pv);
+    q.push_back(qv);
+
+    // a relative norm at the level of the rounding error means v is
+    // in the span of the basis and would only add noise
+    const double tol = v.Precision() == QUDA_DOUBLE_PRECISION ? 1e-24 : 1e-10;
+    if (!(orthonormalize(p, j) > tol)) {
+      p.pop_back();
+      q.pop_back();
+      delete pv;
+      delete qv;
+      if (getVerbosity() >= QUDA_VERBOSE) printfQuda("MinResExt: vector is in the span of the basis, not added\n");
+      return false;
     }
 
-    // Use Gaussian Elimination to solve equations and calculate initial guess
-    blas::zero(x);
-    for (int i=N-1; i>=0; i--) {
-      alpha[i] = 0.0;
-      for (int j=i+1; j<N; j++) alpha[i] += G[i][j] * alpha[j];
-      alpha[i] = (beta[i]-alpha[i])/G[i][i];
-      blas::caxpy(alpha[i], *p[i], x);
-      blas::caxpy(-alpha[i], *q[i], b);
-      //printfQuda("%d %e %e\n", i, real(alpha[i]), imag(alpha[i]));
+    extendGram(*mat, p, q, j, &G[0], max_dim);
+    return true;
+  }
+
+  void MinResExt::operator()(ColorSpinorField &x, ColorSpinorField &b) {
+    const int N = p.size();
+    if (N == 0) {
+      blas::zero(x);
+      return;
     }
 
-    double rsd = sqrt(blas::norm2(b) / b2 );
-    printfQuda("MinResExt: N = %d, |res| / |src| = %e\n", N, rsd);
-    
-    for (int j=0; j<N; j++) delete [] G[j];
+    double b2 = blas::norm2(b);
 
-    delete [] G;
-    delete [] alpha;
-    delete [] beta;
+    if (!solveProjected(x, b, p, q, N, &G[0], max_dim)) {
+      warningQuda("MinResExt: projected matrix is not positive definite, using zero guess");
+      blas::zero(x);
+      return;
+    }
+
+    if (getVerbosity() >= QUDA_VERBOSE) {
+      double rsd = sqrt(blas::norm2(b) / b2);
+      printfQuda("MinResExt: N = %d, |res| / |src| = %e\n", N, rsd);
+    }
   }
 
 } // namespace quda
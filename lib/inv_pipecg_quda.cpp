@@ -0,0 +1,289 @@
+#include <stdio.h>
+#include <stdlib.h>
+#include <math.h>
+
+#include <quda_internal.h>
+#include <color_spinor_field.h>
+#include <blas_quda.h>
+#include <dslash_quda.h>
+#include <invert_quda.h>
+#include <util_quda.h>
+
+#include <face_quda.h>
+
+namespace quda {
+
+  PipelinedCG::PipelinedCG(DiracMatrix &mat, DiracMatrix &matSloppy, SolverParam &param, TimeProfile &profile) :
+    Solver(param, profile), mat(mat), matSloppy(matSloppy)
+  {
+
+  }
+
+  PipelinedCG::~PipelinedCG() {
+
+  }
+
+  /**
+     Unpreconditioned pipelined CG, following Ghysels and Vanroose,
+     Parallel Computing 40 (2014) 224.  Alongside the usual x, r and
+     p we carry w = A r, s = A p and z = A s, so that the only
+     matrix-vector product of an iteration is n = A w, and this does
+     not depend on the inner products (r,r) and (r,w) of the same
+     iteration.  These are computed locally, started as a single
+     non-blocking global reduction, and only waited on once n has
+     been computed.
+   */
+  void PipelinedCG::operator()(ColorSpinorField &x, ColorSpinorField &b)
+  {
+    if (param.residual_type & QUDA_HEAVY_QUARK_RESIDUAL)
+      errorQuda("Heavy quark residual not supported by pipelined CG");
+
+    profile.TPSTART(QUDA_PROFILE_INIT);
+
+    // Check to see that we're not trying to invert on a zero-field source
+    const double b2 = blas::norm2(b);
+    if (b2 == 0) {
+      profile.TPSTOP(QUDA_PROFILE_INIT);
+      printfQuda("Warning: inverting on zero-field source\n");
+      x=b;
+      param.true_res = 0.0;
+      param.true_res_hq = 0.0;
+      return;
+    }
+
+    ColorSpinorParam csParam(x);
+    csParam.create = QUDA_ZERO_FIELD_CREATE;
+    ColorSpinorField *yp = ColorSpinorField::Create(csParam); // high-precision accumulator
+    ColorSpinorField *rp = ColorSpinorField::Create(csParam); // high-precision residual
+    ColorSpinorField *tmpp = ColorSpinorField::Create(csParam);
+    ColorSpinorField &y = *yp;
+    ColorSpinorField &r = *rp;
+    ColorSpinorField &tmp = *tmpp;
+
+    mat(r, x, tmp);
+    double r2 = blas::xmyNorm(b, r);
+
+    csParam.setPrecision(param.precision_sloppy);
+    ColorSpinorField *wp = ColorSpinorField::Create(csParam);
+    ColorSpinorField *pp = ColorSpinorField::Create(csParam);
+    ColorSpinorField *sp = ColorSpinorField::Create(csParam);
+    ColorSpinorField *zp = ColorSpinorField::Create(csParam);
+    ColorSpinorField *np = ColorSpinorField::Create(csParam);
+    ColorSpinorField *tmpSp = ColorSpinorField::Create(csParam);
+
+    // tmp2 only needed for multi-gpu Wilson-like kernels
+    ColorSpinorField *tmpS2p = !matSloppy.isStaggered() ? ColorSpinorField::Create(csParam) : tmpSp;
+
+    ColorSpinorField *r_sloppy;
+    if (param.precision_sloppy == x.Precision()) {
+      r_sloppy = &r;
+    } else {
+      r_sloppy = ColorSpinorField::Create(csParam);
+      blas::copy(*r_sloppy, r);
+    }
+
+    ColorSpinorField *x_sloppy;
+    if (param.precision_sloppy == x.Precision() ||
+	!param.use_sloppy_partial_accumulator) {
+      x_sloppy = &x;
+    } else {
+      x_sloppy = ColorSpinorField::Create(csParam);
+    }
+
+    ColorSpinorField &w = *wp;
+    ColorSpinorField &p = *pp;
+    ColorSpinorField &s = *sp;
+    ColorSpinorField &z = *zp;
+    ColorSpinorField &n = *np;
+    ColorSpinorField &tmpS = *tmpSp;
+    ColorSpinorField &tmpS2 = *tmpS2p;
+    ColorSpinorField &xSloppy = *x_sloppy;
+    ColorSpinorField &rSloppy = *r_sloppy;
+
+    if (&x != &xSloppy) {
+      blas::copy(y, x);
+      blas::zero(xSloppy);
+    } else {
+      blas::zero(y);
+    }
+
+    profile.TPSTOP(QUDA_PROFILE_INIT);
+    profile.TPSTART(QUDA_PROFILE_PREAMBLE);
+
+    const double stop = stopping(param.tol, b2, param.residual_type); // stopping condition of solver
+
+    double alpha = 0.0, alpha_old = 0.0, beta = 0.0;
+    double gamma = r2, gamma_old = 0.0, delta = 0.0;
+    int rUpdate = 0;
+
+    double rNorm = sqrt(r2);
+    double r0Norm = rNorm;
+    double maxrx = rNorm;
+    double maxrr = rNorm;
+
+    const int maxResIncrease = param.max_res_increase;
+    const int maxResIncreaseTotal = param.max_res_increase_total;
+    int resIncrease = 0;
+    int resIncreaseTotal = 0;
+
+    profile.TPSTOP(QUDA_PROFILE_PREAMBLE);
+    profile.TPSTART(QUDA_PROFILE_COMPUTE);
+    blas::flops = 0;
+
+    matSloppy(w, rSloppy, tmpS, tmpS2);
+
+    int k = 0;
+    int steps_since_reliable = 1;
+
+    while (k < param.maxiter) {
+      // local contributions to (r,r) and (r,w), reduced together below
+      bool reduceState = globalReduce;
+      globalReduce = false;
+      double3 rw = blas::cDotProductNormA(rSloppy, w);
+      globalReduce = reduceState;
+
+      double local[2] = { rw.z, rw.x };
+      MsgHandle *reduction = reduceDoubleArrayStart(local, 2);
+
+      // the operator application is independent of the reduction in flight
+      matSloppy(n, w, tmpS, tmpS2);
+
+      reduceDoubleArrayWait(reduction);
+      gamma = local[0];
+      delta = local[1];
+      r2 = gamma;
+
+      PrintStats("PipelinedCG", k, r2, b2, 0.0);
+
+      // reliable update conditions
+      rNorm = sqrt(r2);
+      if (rNorm > maxrx) maxrx = rNorm;
+      if (rNorm > maxrr) maxrr = rNorm;
+      int updateX = (rNorm < param.delta*r0Norm && r0Norm <= maxrx) ? 1 : 0;
+      int updateR = ((rNorm < param.delta*maxrr && r0Norm <= maxrr) || updateX) ? 1 : 0;
+
+      // once converged, confirm it with the true residual (only if doing reliable updates)
+      if (convergence(r2, 0.0, stop, param.tol_hq)) {
+	if (steps_since_reliable == 0 || param.delta < param.tol) break;
+	updateX = 1;
+      }
+
+      beta = k > 0 ? gamma / gamma_old : 0.0;
+      const double denom = k > 0 ? delta - beta * gamma / alpha_old : delta;
+
+      if (denom <= 0.0 && !(updateR || updateX)) {
+	// the recurrences have lost the positivity of (p, A p), so replace the residual
+	if (steps_since_reliable == 0) {
+	  warningQuda("PipelinedCG: breakdown with (p, A p) = %e after a reliable update", denom);
+	  break;
+	}
+	updateR = 1;
+      }
+
+      if ( !(updateR || updateX) ) {
+	alpha = gamma / denom;
+
+	blas::xpay(n, beta, z);        // z = n + beta z
+	blas::xpay(w, beta, s);        // s = w + beta s
+	blas::xpay(rSloppy, beta, p);  // p = r + beta p
+	blas::axpy(alpha, p, xSloppy); // x = x + alpha p
+	blas::axpy(-alpha, s, rSloppy); // r = r - alpha s
+	blas::axpy(-alpha, z, w);       // w = w - alpha z
+
+	gamma_old = gamma;
+	alpha_old = alpha;
+	steps_since_reliable++;
+	k++;
+      } else {
+	blas::copy(x, xSloppy); // nop when these pointers alias
+	blas::xpy(x, y);
+	mat(r, y, tmp);
+	r2 = blas::xmyNorm(b, r);
+
+	blas::copy(rSloppy, r); // nop when these pointers alias
+	blas::zero(xSloppy);
+
+	// residual replacement: the auxiliary vectors are recomputed
+	// from their definitions so they are consistent with the new r
+	matSloppy(w, rSloppy, tmpS, tmpS2);
+	matSloppy(s, p, tmpS, tmpS2);
+	matSloppy(z, s, tmpS, tmpS2);
+
+	// break-out check if we have reached the limit of the precision
+	if (sqrt(r2) > r0Norm && updateX) { // reuse r0Norm for this
+	  resIncrease++;
+	  resIncreaseTotal++;
+	  warningQuda("PipelinedCG: new reliable residual norm %e is greater than previous reliable residual norm %e (total #inc %i)",
+		      sqrt(r2), r0Norm, resIncreaseTotal);
+	  if (resIncrease > maxResIncrease or resIncreaseTotal > maxResIncreaseTotal) {
+	    warningQuda("PipelinedCG: solver exiting due to too many true residual norm increases");
+	    break;
+	  }
+	} else {
+	  resIncrease = 0;
+	}
+
+	rNorm = sqrt(r2);
+	maxrr = rNorm;
+	maxrx = rNorm;
+	r0Norm = rNorm;
+	rUpdate++;
+
+	// the iteration is repeated with the replaced residual, the
+	// direction p and the recurrence coefficients are retained
+	steps_since_reliable = 0;
+      }
+    }
+
+    blas::copy(x, xSloppy);
+    blas::xpy(y, x);
+
+    profile.TPSTOP(QUDA_PROFILE_COMPUTE);
+    profile.TPSTART(QUDA_PROFILE_EPILOGUE);
+
+    param.secs = profile.Last(QUDA_PROFILE_COMPUTE);
+    double gflops = (blas::flops + mat.flops() + matSloppy.flops())*1e-9;
+    reduceDouble(gflops);
+    param.gflops = gflops;
+    param.iter += k;
+
+    if (k==param.maxiter)
+      warningQuda("Exceeded maximum iterations %d", param.maxiter);
+
+    if (getVerbosity() >= QUDA_VERBOSE)
+      printfQuda("PipelinedCG: Reliable updates = %d\n", rUpdate);
+
+    // compute the true residuals
+    mat(r, x, tmp);
+    param.true_res = sqrt(blas::xmyNorm(b, r) / b2);
+    param.true_res_hq = sqrt(blas::HeavyQuarkResidualNorm(x,r).z);
+
+    PrintSummary("PipelinedCG", k, r2, b2);
+
+    // reset the flops counters
+    blas::flops = 0;
+    mat.flops();
+    matSloppy.flops();
+
+    profile.TPSTOP(QUDA_PROFILE_EPILOGUE);
+    profile.TPSTART(QUDA_PROFILE_FREE);
+
+    if (&rSloppy != &r) delete r_sloppy;
+    if (&xSloppy != &x) delete x_sloppy;
+    if (tmpS2p != tmpSp) delete tmpS2p;
+    delete tmpSp;
+    delete np;
+    delete zp;
+    delete sp;
+    delete pp;
+    delete wp;
+    delete tmpp;
+    delete rp;
+    delete yp;
+
+    profile.TPSTOP(QUDA_PROFILE_FREE);
+
+    return;
+  }
+
+} // namespace quda
@@ -117,6 +117,7 @@ namespace quda {
   template<typename Float, typename Oprod, typename Gauge, typename Mom>
     void completeKSForceCPU(KSForceArg<Oprod,Gauge,Mom>& arg)
     {
+#pragma omp parallel for
       for(int idx=0; idx<arg.threads; idx++){
         completeKSForceCore<Float,Oprod,Gauge,Mom>(arg,idx);
       }
@@ -332,6 +333,7 @@ __global__ void computeKSLongLinkForceKernel(KSLongLinkArg<Result,Oprod,Gauge> a
   template<typename Float, typename Result, typename Oprod, typename Gauge>
 void computeKSLongLinkForceCPU(KSLongLinkArg<Result,Oprod,Gauge>& arg)
 {
+#pragma omp parallel for
   for(int idx=0; idx<arg.threads; idx++){
     computeKSLongLinkForceCore<Float,Result,Oprod,Gauge>(arg,idx);
   }
@@ -4,6 +4,7 @@
 #include <map>
 #include <unistd.h> // for getpagesize()
 #include <execinfo.h> // for backtrace
+#include <pthread.h>
 #include <quda_internal.h>
 
 #ifdef USE_QDPJIT
@@ -54,6 +55,29 @@ namespace quda {
   static long total_host_bytes, max_total_host_bytes;
   static long total_pinned_bytes, max_total_pinned_bytes;
 
+  /**
+     The allocation tables are shared by every thread that allocates,
+     e.g., the ranks of the threaded communications backend, so they
+     are only accessed while holding this lock.
+   */
+  static pthread_mutex_t alloc_mutex = PTHREAD_MUTEX_INITIALIZER;
+
+  struct AllocLock {
+    AllocLock() { pthread_mutex_lock(&alloc_mutex); }
+    ~AllocLock() { pthread_mutex_unlock(&alloc_mutex); }
+  };
+
+  /**
+     @return The table in which ptr is tracked (N_ALLOC_TYPE if untracked)
+   */
+  static AllocType find_alloc(void *ptr)
+  {
+    AllocLock lock;
+    for (int type=0; type<N_ALLOC_TYPE; type++)
+      if (alloc[type].count(ptr)) return static_cast<AllocType>(type);
+    return N_ALLOC_TYPE;
+  }
+
   static void print_trace (void) {
     void *array[10];
     size_t size;
@@ -88,6 +112,7 @@ namespace quda {
 
   static void track_malloc(const AllocType &type, const MemAlloc &a, void *ptr)
   {
+    AllocLock lock;
     total_bytes[type] += a.base_size;
     if (total_bytes[type] > max_total_bytes[type]) {
       max_total_bytes[type] = total_bytes[type];
@@ -110,6 +135,7 @@ namespace quda {
 
   static void track_free(const AllocType &type, void *ptr)
   {
+    AllocLock lock;
     size_t size = alloc[type][ptr].base_size;
     total_bytes[type] -= size;
     if (type != DEVICE) {
@@ -247,7 +273,7 @@ namespace quda {
       printfQuda("ERROR: Attempt to free NULL device pointer (%s:%d in %s())\n", file, line, func);
       errorQuda("Aborting");
     }
-    if (!alloc[DEVICE].count(ptr)) {
+    if (find_alloc(ptr) != DEVICE) {
       printfQuda("ERROR: Attempt to free invalid device pointer (%s:%d in %s())\n", file, line, func);
       errorQuda("Aborting");
     }
@@ -271,16 +297,17 @@ namespace quda {
       printfQuda("ERROR: Attempt to free NULL host pointer (%s:%d in %s())\n", file, line, func);
       errorQuda("Aborting");
     }
-    if (alloc[HOST].count(ptr)) {
+    AllocType type = find_alloc(ptr);
+    if (type == HOST) {
       track_free(HOST, ptr);
-    } else if (alloc[PINNED].count(ptr)) {
+    } else if (type == PINNED) {
       cudaError_t err = cudaHostUnregister(ptr);
       if (err != cudaSuccess) {
 	printfQuda("ERROR: Failed to unregister pinned memory (%s:%d in %s())\n", file, line, func);
 	errorQuda("Aborting");
       }
       track_free(PINNED, ptr);
-    } else if (alloc[MAPPED].count(ptr)) {
+    } else if (type == MAPPED) {
       cudaError_t err = cudaHostUnregister(ptr);
       if (err != cudaSuccess) {
 	printfQuda("ERROR: Failed to unregister host-mapped memory (%s:%d in %s())\n", file, line, func);
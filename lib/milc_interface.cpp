@@ -775,6 +775,28 @@ static size_t getColorVectorOffset(QudaParity local_parity, bool even_odd_exchan
 }
 
 
+/**
+   Load the fat and long links supplied by MILC.  The resident links
+   are kept between solves: loadGaugeQuda fingerprints the host links
+   and skips the full-lattice reorder and upload when they have not
+   changed since the previous call, and replaces the resident links
+   when they have.
+ */
+static void loadFatLongLinks(const void *fatlink, const void *longlink, QudaGaugeParam &gaugeParam)
+{
+  const int fat_pad  = getFatLinkPadding(localDim);
+  gaugeParam.type = QUDA_GENERAL_LINKS;
+  gaugeParam.ga_pad = fat_pad;  // don't know if this is correct
+  gaugeParam.reconstruct = gaugeParam.reconstruct_sloppy = QUDA_RECONSTRUCT_NO;
+  loadGaugeQuda(const_cast<void*>(fatlink), &gaugeParam);
+
+  const int long_pad = 3*fat_pad;
+  gaugeParam.type = QUDA_THREE_LINKS;
+  gaugeParam.ga_pad = long_pad;
+  gaugeParam.reconstruct = gaugeParam.reconstruct_sloppy = QUDA_RECONSTRUCT_NO;
+  loadGaugeQuda(const_cast<void*>(longlink), &gaugeParam);
+}
+
 void qudaMultishiftInvert(int external_precision,
     int quda_precision,
     int num_offsets,
@@ -856,17 +878,7 @@ void qudaMultishiftInvert(int external_precision,
   }
 
   if(invalidate_quda_gauge || !create_quda_gauge ){
-    const int fat_pad  = getFatLinkPadding(localDim);
-    gaugeParam.type = QUDA_GENERAL_LINKS;
-    gaugeParam.ga_pad = fat_pad;  // don't know if this is correct
-    gaugeParam.reconstruct = gaugeParam.reconstruct_sloppy = QUDA_RECONSTRUCT_NO;
-    loadGaugeQuda(const_cast<void*>(fatlink), &gaugeParam);
-
-    const int long_pad = 3*fat_pad;
-    gaugeParam.type = QUDA_THREE_LINKS;
-    gaugeParam.ga_pad = long_pad;
-    gaugeParam.reconstruct = gaugeParam.reconstruct_sloppy = QUDA_RECONSTRUCT_NO;
-    loadGaugeQuda(const_cast<void*>(longlink), &gaugeParam);
+    loadFatLongLinks(fatlink, longlink, gaugeParam);
     invalidate_quda_gauge = false;
   }
 
@@ -886,8 +898,6 @@ void qudaMultishiftInvert(int external_precision,
     final_fermilab_residual[i] = invertParam.true_res_hq_offset[i];
   } // end loop over number of offsets
 
-  if(!create_quda_gauge) invalidateGaugeQuda();
-
   qudamilc_called<false>(__func__, verbosity);
   return;
 } // qudaMultiShiftInvert
@@ -966,25 +976,14 @@ void qudaInvert(int external_precision,
 
 
   const QudaPrecision milc_precision = (external_precision==2) ? QUDA_DOUBLE_PRECISION : QUDA_SINGLE_PRECISION;
-  const int fat_pad  = getFatLinkPadding(localDim);
-  const int long_pad = 3*fat_pad;
 
   // dirty hack to invalidate the cached gauge field without breaking interface compatability
   if (*num_iters == -1) {
     invalidateGaugeQuda();
   }
 
-  if(invalidate_quda_gauge || !create_quda_gauge){
-    gaugeParam.type = QUDA_GENERAL_LINKS;
-    gaugeParam.ga_pad = fat_pad;
-    gaugeParam.reconstruct = gaugeParam.reconstruct_sloppy = QUDA_RECONSTRUCT_NO;
-    loadGaugeQuda(const_cast<void*>(fatlink), &gaugeParam);
-
-    gaugeParam.type = QUDA_THREE_LINKS;
-    gaugeParam.ga_pad = long_pad;
-    gaugeParam.reconstruct = gaugeParam.reconstruct_sloppy = QUDA_RECONSTRUCT_NO;
-    loadGaugeQuda(const_cast<void*>(longlink), &gaugeParam);
-
+  if(invalidate_quda_gauge || !create_quda_gauge ){
+    loadFatLongLinks(fatlink, longlink, gaugeParam);
     invalidate_quda_gauge = false;
   }
 
@@ -999,8 +998,6 @@ void qudaInvert(int external_precision,
   *final_residual = invertParam.true_res;
   *final_fermilab_residual = invertParam.true_res_hq;
 
-  if(!create_quda_gauge) invalidateGaugeQuda();
-
   qudamilc_called<false>(__func__, verbosity);
   return;
 } // qudaInvert
@@ -1061,9 +1058,11 @@ void qudaEigCGInvert(int external_precision,
 
   if(rhs_idx == 0)
   {
+#ifdef MAGMA_LIB
      printfQuda("\nOpen MAGMA...\n");
 
      openMagma();
+#endif
 
      QudaGaugeParam gaugeParam = newQudaGaugeParam();
      // a basic set routine for the gauge parameters
@@ -1125,7 +1124,9 @@ void qudaEigCGInvert(int external_precision,
   {
     destroyDeflationQuda(&invertParam, localDim, ritzVects, ritzVals);
 
+#ifdef MAGMA_LIB
     closeMagma();
+#endif
     //
     freeGaugeQuda();
   }
@@ -1544,9 +1545,11 @@ void qudaEigCGCloverInvert(int external_precision,
 
   if(rhs_idx == 0)
   {
+#ifdef MAGMA_LIB
      printfQuda("\nOpen MAGMA...\n");
 
      openMagma();
+#endif
 
 //direct call for loadGaugeQuda:
      QudaGaugeParam gaugeParam = newQudaGaugeParam();
@@ -1583,7 +1586,9 @@ void qudaEigCGCloverInvert(int external_precision,
   {
     destroyDeflationQuda(&invertParam, localDim, ritzVects, ritzVals);
     //
+#ifdef MAGMA_LIB
     closeMagma();
+#endif
     //
     qudaFreeGaugeField();
     //
@@ -4,6 +4,7 @@
 #include <gauge_field_order.h>
 #include <launch_kernel.cuh>
 #include <cub_helper.cuh>
+#include <momentum.h>
 
 namespace quda {
 
@@ -128,6 +129,8 @@ using namespace gauge;
   double computeMomAction(const GaugeField& mom) {
     double action = 0.0;
 #ifdef GPU_GAUGE_TOOLS
+    if (mom.Location() == QUDA_CPU_FIELD_LOCATION) return computeMomActionCPU(mom);
+
     if (mom.Precision() == QUDA_DOUBLE_PRECISION) {
       action = momAction<double>(mom);
     } else if(mom.Precision() == QUDA_SINGLE_PRECISION) {
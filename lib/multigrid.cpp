@@ -1,18 +1,25 @@
 #include <multigrid.h>
 #include <qio_field.h>
+#include <native_field_io.h>
+#include <face_quda.h>
 #include <string.h>
+#include <algorithm>
 
 namespace quda {  
 
   static bool use_solver_residual = true;
   static bool debug = false;
 
+  // null-space generation options - need to expose these
+  static const int null_maxiter = 500;
+  static const double null_tol = 5e-4;
+
   MG::MG(MGParam &param, TimeProfile &profile_global) 
     : Solver(param, profile), param(param), presmoother(0), postsmoother(0), 
       profile_global(profile_global),
       profile( "MG level " + std::to_string(param.level+1), false ),
-      coarse(0), fine(param.fine), param_coarse(0), param_presmooth(0), param_postsmooth(0), r(0), r_coarse(0), x_coarse(0), 
-      diracCoarse(0), matCoarse(0) {
+      coarse(0), fine(param.fine), param_coarse(0), param_presmooth(0), param_postsmooth(0), B_coarse_c(0), r(0), r_coarse(0), x_coarse(0), 
+      x_staged(0), b_staged(0), diracCoarse(0), matCoarse(0) {
 
     // for reporting level 1 is the fine level but internally use level 0 for indexing
     sprintf(prefix,"MG level %d (%s): ", param.level+1, param.location == QUDA_CUDA_FIELD_LOCATION ? "GPU" : "CPU" );
@@ -20,9 +27,11 @@ namespace quda {
 
     printfQuda("Creating level %d of %d levels\n", param.level+1, param.Nlevel);
 
-    if (param.level == 0) { // null space generation only on level 1 currently
+    if (param.level == 0 && !param.reuse_null_vectors) { // null space generation only on level 1 currently
       if (param.mg_global.compute_null_vector == QUDA_COMPUTE_NULL_VECTOR_YES) {
 	generateNullVectors(param.B);
+      } else if (param.mg_global.compute_null_vector == QUDA_COMPUTE_NULL_VECTOR_BATCHED) {
+	generateNullVectorsBatched(param.B);
       } else {
 	loadVectors(param.B);
       }
@@ -51,8 +60,19 @@ namespace quda {
       param_presmooth->delta = 1e-2;
       param_presmooth->compute_true_res = false;
     }
-    presmoother = Solver::create(*param_presmooth, param_presmooth->matResidual,
-				 param_presmooth->matSmooth, param_presmooth->matSmooth, profile);
+    // an exact solve is used on small coarsest grids, otherwise GCR
+    const DiracCoarse *dirac_coarsest = param.level == param.Nlevel-1 && param.level > 0 ?
+      dynamic_cast<const DiracCoarse*>(param.matResidual.Expose()) : 0;
+    if (dirac_coarsest && CoarseLU::Supported(*dirac_coarsest, param.mg_global.coarse_direct_max_dim)) {
+      presmoother = new CoarseLU(*dirac_coarsest, *param_presmooth, profile);
+    } else {
+      if (dirac_coarsest && param.mg_global.coarse_direct_max_dim > 0)
+	warningQuda("Coarsest grid is distributed or larger than %d, using an iterative coarse solver",
+		    param.mg_global.coarse_direct_max_dim);
+      presmoother = Solver::create(*param_presmooth, param_presmooth->matResidual,
+				   param_presmooth->matSmooth, param_presmooth->matSmooth, profile);
+    }
+    param_presmooth->iter = 0; // accumulates the smoother iterations of this level
 
     if (param.level < param.Nlevel-1) {
 
@@ -68,6 +88,7 @@ namespace quda {
       param_postsmooth->inv_type_precondition = QUDA_INVALID_INVERTER;
       postsmoother = Solver::create(*param_postsmooth, param_postsmooth->matResidual, 
 				    param_postsmooth->matSmooth, param_postsmooth->matSmooth, profile);
+      param_postsmooth->iter = 0;
     }
 
     // create residual vectors
@@ -109,11 +130,14 @@ namespace quda {
       diracParam.dirac = const_cast<Dirac*>(param.matResidual.Expose());
       diracParam.kappa = param.matResidual.Expose()->Kappa();
       printfQuda("Kappa = %e\n", diracParam.kappa);
-      diracCoarse = new DiracCoarse(diracParam);
+      diracCoarse = new DiracCoarse(diracParam, param.mg_global.location[param.level+1] == QUDA_CUDA_FIELD_LOCATION);
       matCoarse = new DiracM(*diracCoarse);
 
       printfQuda("coarse operator of type %s created\n", typeid(matCoarse).name());
 
+      // the full-precision prolongator is no longer needed once the coarse operator exists
+      if (param.mg_global.compress_null_vectors > 0) transfer->CompressVectors(param.mg_global.compress_null_vectors);
+
       // coarse null space vectors (dummy for now)
       printfQuda("Creating coarse null-space vectors\n");
       B_coarse = new std::vector<ColorSpinorField*>();
@@ -159,12 +183,17 @@ namespace quda {
     // now we can run through the verificaion
     if (param.level < param.Nlevel-1) verify();  
 
+    // the coarse null space is only needed again if the hierarchy is rebuilt
+    if (param.level < param.Nlevel-1 && param.mg_global.compress_null_vectors > 0)
+      B_coarse_c = compressVectors(*B_coarse, param.mg_global.compress_null_vectors);
+
     setOutputPrefix("");
   }
 
   MG::~MG() {
     if (param.level < param.Nlevel-1) {
-      if (B_coarse) for (int i=0; i<param.Nvec; i++) delete (*B_coarse)[i];
+      if (B_coarse) for (int i=0; i<param.Nvec; i++) if ((*B_coarse)[i]) delete (*B_coarse)[i];
+      if (B_coarse_c) delete B_coarse_c;
       if (coarse) delete coarse;
       if (transfer) delete transfer;
       if (matCoarse) delete matCoarse;
@@ -176,6 +205,8 @@ namespace quda {
     if (r) delete r;
     if (r_coarse) delete r_coarse;
     if (x_coarse) delete x_coarse;
+    if (x_staged) delete x_staged;
+    if (b_staged) delete b_staged;
 
     if (param_coarse) delete param_coarse;
     if (param_presmooth) delete param_presmooth;
@@ -282,6 +313,21 @@ namespace quda {
   }
 
   void MG::operator()(ColorSpinorField &x, ColorSpinorField &b) {
+    // the calling solver may run in a different location than this level
+    if (b.Location() != param.location) {
+      if (!b_staged) {
+	ColorSpinorParam csParam(*r);
+	csParam.create = QUDA_NULL_FIELD_CREATE;
+	x_staged = ColorSpinorField::Create(csParam);
+	b_staged = ColorSpinorField::Create(csParam);
+      }
+      *b_staged = b; // no initial guess is used, so only the source is copied in
+      (*this)(*x_staged, *b_staged);
+      x = *x_staged;
+      return;
+    }
+
+    timer.Start(__func__, __FILE__, __LINE__);
     setOutputPrefix(prefix);
 
     if ( debug ) {
@@ -349,9 +395,24 @@ namespace quda {
     }
 
     setOutputPrefix("");
+    timer.Stop(__func__, __FILE__, __LINE__);
+  }
+
+  void MG::printStats() const {
+    setOutputPrefix(prefix);
+    double coarse_time = coarse ? coarse->timer.time : 0.0;
+    if (param.level < param.Nlevel-1) {
+      printfQuda("%d cycles, %d pre-smoother and %d post-smoother iterations, %e s (%e s excluding coarser levels)\n",
+		 timer.count, param_presmooth->iter, param_postsmooth->iter, timer.time, timer.time - coarse_time);
+    } else {
+      printfQuda("%d coarse solves, %d iterations, %e s\n", timer.count, param_presmooth->iter, timer.time);
+    }
+    setOutputPrefix("");
+
+    if (coarse) coarse->printStats();
   }
 
-  //supports seperate reading or single file read
+  // supports the native single-file vector set, or separate QIO files per vector
   void MG::loadVectors(std::vector<ColorSpinorField*> &B) {
     profile_global.TPSTOP(QUDA_PROFILE_INIT);
     profile_global.TPSTART(QUDA_PROFILE_IO);
@@ -368,7 +429,9 @@ namespace quda {
       }
     }
     
-    if (strcmp(vec_infile,"")!=0) {
+    if (strcmp(vec_infile,"")!=0 && isNativeVectorSet(vec_infile)) {
+      readNativeVectorSet(vec_infile, B);
+    } else if (strcmp(vec_infile,"")!=0) {
 #if 0
       read_spinor_field(vec_infile, &V[0], B[0]->Precision(), B[0]->X(), 
 			B[0]->Ncolor(), B[0]->Nspin(), Nvec, 0,  (char**)0);
@@ -422,30 +485,10 @@ namespace quda {
 
     if (strcmp(vec_outfile,"")!=0) {
       const int Nvec = B.size();
-      printfQuda("Start saving %d vectors from %s\n", Nvec, vec_outfile);
-
-      void **V = static_cast<void**>(safe_malloc(Nvec*sizeof(void*)));
-      for (int i=0; i<Nvec; i++) {
-	V[i] = B[i]->V();
-	if (V[i] == NULL) {
-	  printfQuda("Could not allocate V[%d]\n", i);
-	}
-      }
-
-#if 0
-      write_spinor_field(vec_outfile, &V[0], B[0]->Precision(), B[0]->X(),
-			 B[0]->Ncolor(), B[0]->Nspin(), Nvec, 0,  (char**)0);
-#else
-      for (int i=0; i<Nvec; i++) {
-	char filename[256];
-	sprintf(filename, "%s.%d", vec_outfile, i);
-	printf("Saving vector %d to file %s\n", i, filename);
-	write_spinor_field(filename, &V[i], B[i]->Precision(), B[i]->X(),
-			   B[i]->Ncolor(), B[i]->Nspin(), 1, 0,  (char**)0);
-      }
-#endif
+      printfQuda("Start saving %d vectors to %s\n", Nvec, vec_outfile);
 
-      host_free(V);
+      // all vectors of the level go to a single file, written in parallel
+      writeNativeVectorSet(vec_outfile, B, param.mg_global.vec_io_prec);
       printfQuda("Done saving vectors\n");
     }
 
@@ -453,15 +496,43 @@ namespace quda {
     profile_global.TPSTART(QUDA_PROFILE_INIT);
   }
 
+  /**
+     Fields used to generate and relax the null-space vectors, which
+     are stored on the host.  On the device these are in the native order.
+   */
+  static ColorSpinorParam nullVectorParam(const ColorSpinorField &b, QudaFieldLocation location) {
+    ColorSpinorParam csParam(b);
+    csParam.location = location;
+
+    if (location == QUDA_CUDA_FIELD_LOCATION) {
+      // to force setting the field to be native first set to double-precision native order
+      // then use the setPrecision method to set to native order
+      csParam.fieldOrder = QUDA_FLOAT2_FIELD_ORDER;
+      csParam.precision = QUDA_DOUBLE_PRECISION;
+      csParam.setPrecision(b.Precision());
+      csParam.gammaBasis = QUDA_UKQCD_GAMMA_BASIS;
+    }
+    return csParam;
+  }
+
   void MG::generateNullVectors(std::vector<ColorSpinorField*> B) {
     printfQuda("\nGenerate null vectors\n");
-    //Create spinor field parameters:
 
     SolverParam solverParam(param);
+    solveNullVectors(solverParam, param.matResidual, param.matSmooth, B, null_maxiter, null_tol,
+		     true, param.location, profile);
+
+    saveVectors(B);
+
+    return;
+  }
 
-    // set null-space generation options - need to expose these
-    solverParam.maxiter = 500;
-    solverParam.tol = 5e-4;
+  void solveNullVectors(SolverParam &solverParam, DiracMatrix &mat, DiracMatrix &matSloppy,
+			std::vector<ColorSpinorField*> &B, int maxiter, double tol, bool random_start,
+			QudaFieldLocation location, TimeProfile &profile) {
+    // set null-space generation options
+    solverParam.maxiter = maxiter;
+    solverParam.tol = tol;
     solverParam.use_init_guess = QUDA_USE_INIT_GUESS_YES;
     solverParam.delta = 1e-7;
     solverParam.inv_type = QUDA_BICGSTAB_INVERTER;
@@ -470,31 +541,23 @@ namespace quda {
     solverParam.residual_type = static_cast<QudaResidualType>(QUDA_L2_RELATIVE_RESIDUAL);
     solverParam.compute_null_vector = QUDA_COMPUTE_NULL_VECTOR_YES;
 
-    ColorSpinorParam csParam(*B[0]);
-
-    // to force setting the field to be native first set to double-precision native order
-    // then use the setPrecision method to set to native order
-    csParam.fieldOrder = QUDA_FLOAT2_FIELD_ORDER;
-    csParam.precision = QUDA_DOUBLE_PRECISION;
-    csParam.setPrecision(B[0]->Precision());
-
-    csParam.location = QUDA_CUDA_FIELD_LOCATION; // hard code to GPU location for null-space generation for now
-    csParam.gammaBasis = QUDA_UKQCD_GAMMA_BASIS;
+    ColorSpinorParam csParam = nullVectorParam(*B[0], location);
 
     // Generate sources and launch solver for each source:
     for(std::vector<ColorSpinorField*>::iterator nullvec = B.begin() ; nullvec != B.end(); ++nullvec) {
 	cpuColorSpinorField *curr_nullvec = static_cast<cpuColorSpinorField*> (*nullvec);
-	curr_nullvec->Source(QUDA_RANDOM_SOURCE);//random initial guess
+	if (random_start) curr_nullvec->Source(QUDA_RANDOM_SOURCE);//random initial guess
 
 	csParam.create = QUDA_ZERO_FIELD_CREATE;
-	ColorSpinorField *b = static_cast<ColorSpinorField*>(new cudaColorSpinorField(csParam));
+	ColorSpinorField *b = ColorSpinorField::Create(csParam);
 	//copy fields:
-	csParam.create = QUDA_COPY_FIELD_CREATE;
-	ColorSpinorField *x = static_cast<ColorSpinorField*>(new cudaColorSpinorField(*curr_nullvec, csParam));
+	csParam.create = QUDA_NULL_FIELD_CREATE;
+	ColorSpinorField *x = ColorSpinorField::Create(csParam);
+	*x = *curr_nullvec;
 
 	if (getVerbosity() >= QUDA_VERBOSE) printfQuda("Initial guess = %g\n", blas::norm2(*x));
 
-	Solver *solve = Solver::create(solverParam, param.matResidual, param.matSmooth, param.matSmooth, profile);
+	Solver *solve = Solver::create(solverParam, mat, matSloppy, matSloppy, profile);
 	(*solve)(*x, *b);
 	delete solve;
 
@@ -519,10 +582,207 @@ namespace quda {
 	delete x;
 
       }//stop for-loop:
+  }
 
-    saveVectors(B);
+  /**
+     Re(a_i, b_i) for all i with active[i] set, with a single global
+     reduction for the whole batch.
+   */
+  static void batchReDot(std::vector<double> &result, std::vector<ColorSpinorField*> &a,
+			 std::vector<ColorSpinorField*> &b, const std::vector<bool> &active) {
+    bool reduceState = globalReduce;
+    globalReduce = false;
+    for (unsigned int i=0; i<a.size(); i++) result[i] = active[i] ? blas::reDotProduct(*a[i], *b[i]) : 0.0;
+    globalReduce = reduceState;
+    reduceDoubleArray(&result[0], result.size());
+  }
 
-    return;
+  /**
+     Orthonormalize a set of vectors with classical Gram-Schmidt,
+     applied twice for stability, so that each pass over a vector
+     needs a single global reduction.
+   */
+  static void blockOrthonormalize(std::vector<ColorSpinorField*> &x) {
+    std::vector<Complex> c(x.size());
+    for (unsigned int j=0; j<x.size(); j++) {
+      for (int pass=0; pass<2 && j>0; pass++) {
+	bool reduceState = globalReduce;
+	globalReduce = false;
+	for (unsigned int i=0; i<j; i++) c[i] = blas::cDotProduct(*x[i], *x[j]);
+	globalReduce = reduceState;
+	reduceDoubleArray(reinterpret_cast<double*>(&c[0]), 2*j);
+	for (unsigned int i=0; i<j; i++) blas::caxpy(-c[i], *x[i], *x[j]);
+      }
+
+      double nrm2 = blas::norm2(*x[j]);
+      if (nrm2 > 1e-16) blas::ax(1.0 / sqrt(nrm2), *x[j]);
+      else errorQuda("\nCannot orthogonalize %u vector\n", j);
+    }
+  }
+
+  /**
+     The number of null-space vectors that fit in free device memory,
+     given that each one being relaxed needs four fields like tmp.
+   */
+  static int nullVectorBatch(const ColorSpinorField &tmp, int Nvec) {
+    if (tmp.Location() != QUDA_CUDA_FIELD_LOCATION) return Nvec;
+
+    size_t free_bytes, total_bytes;
+    cudaMemGetInfo(&free_bytes, &total_bytes);
+    // leave a tenth of the free memory for the operator and reductions
+    const size_t vector_bytes = 4 * (tmp.Bytes() + tmp.NormBytes());
+    const int batch = (int)(0.9 * free_bytes / vector_bytes);
+    if (batch < 1) errorQuda("Insufficient device memory to relax a null-space vector (%lu bytes free)", free_bytes);
+    return std::min(batch, Nvec);
+  }
+
+  /*
+    CG on M^dagger M x_i = 0 run in lock step for a batch of
+    vectors: each iteration applies the operator once to each search
+    direction and does all the inner products of the batch in two
+    global reductions.  CG on the normal equations minimizes |M x_i|
+    over the Krylov space, which is tracked as -(x_i, r_i), so a
+    vector has converged when |M x_i| < tol |M x_i^0|, the same
+    criterion as the BiCGstab solves of solveNullVectors.
+  */
+  static int relaxBatch(DiracMdagM &mat, std::vector<ColorSpinorField*> &B, ColorSpinorField &tmp,
+			int maxiter, double tol, bool random_start) {
+    const int Nvec = B.size();
+
+    ColorSpinorParam csParam(tmp);
+    csParam.create = QUDA_NULL_FIELD_CREATE;
+
+    std::vector<ColorSpinorField*> x(Nvec), r(Nvec), p(Nvec), q(Nvec);
+    for (int i=0; i<Nvec; i++) {
+      if (random_start) B[i]->Source(QUDA_RANDOM_SOURCE); // random initial guess
+      x[i] = ColorSpinorField::Create(csParam);
+      *x[i] = *B[i];
+      r[i] = ColorSpinorField::Create(csParam);
+      p[i] = ColorSpinorField::Create(csParam);
+      q[i] = ColorSpinorField::Create(csParam);
+    }
+
+    // r = - M^dagger M x since the source is zero
+    std::vector<bool> active(Nvec, true);
+    std::vector<double> r2(Nvec), Mx2(Nvec), stop(Nvec), pAp(Nvec);
+    for (int i=0; i<Nvec; i++) {
+      mat(*r[i], *x[i], tmp);
+      blas::ax(-1.0, *r[i]);
+      *p[i] = *r[i];
+    }
+    batchReDot(r2, r, r, active);
+    batchReDot(Mx2, x, r, active);
+    for (int i=0; i<Nvec; i++) stop[i] = -tol*tol*Mx2[i];
+
+    int k = 0;
+    int n_active = Nvec;
+    while (n_active > 0 && k < maxiter) {
+      for (int i=0; i<Nvec; i++) if (active[i]) mat(*q[i], *p[i], tmp);
+      batchReDot(pAp, p, q, active);
+
+      // |r_i|^2 and (x_i, r_i) = -|M x_i|^2 in a single global reduction
+      std::vector<double> norms(2*Nvec, 0.0);
+      bool reduceState = globalReduce;
+      globalReduce = false;
+      for (int i=0; i<Nvec; i++) {
+	if (!active[i]) continue;
+	double alpha = r2[i] / pAp[i];
+	blas::axpy(alpha, *p[i], *x[i]);
+	norms[2*i+0] = blas::axpyNorm(-alpha, *q[i], *r[i]);
+	norms[2*i+1] = blas::reDotProduct(*x[i], *r[i]);
+      }
+      globalReduce = reduceState;
+      reduceDoubleArray(&norms[0], 2*Nvec);
+
+      k++;
+      for (int i=0; i<Nvec; i++) {
+	if (!active[i]) continue;
+	if (-norms[2*i+1] < stop[i]) {
+	  active[i] = false;
+	  n_active--;
+	  continue;
+	}
+	blas::xpay(*r[i], norms[2*i+0] / r2[i], *p[i]);
+	r2[i] = norms[2*i+0];
+      }
+
+      if (getVerbosity() >= QUDA_DEBUG_VERBOSE)
+	printfQuda("Batched null-space iteration %d: %d vectors still active\n", k, n_active);
+    }
+
+    if (n_active > 0 && random_start)
+      warningQuda("%d null-space vectors did not converge in %d iterations", n_active, maxiter);
+
+    for (int i=0; i<Nvec; i++) {
+      *B[i] = *x[i];
+      delete x[i];
+      delete r[i];
+      delete p[i];
+      delete q[i];
+    }
+
+    return k;
+  }
+
+  int relaxNullVectors(DiracMatrix &matResidual, std::vector<ColorSpinorField*> &B,
+		       int maxiter, double tol, bool random_start, QudaFieldLocation location, int batch) {
+    const int Nvec = B.size();
+
+    ColorSpinorParam csParam = nullVectorParam(*B[0], location);
+    csParam.create = QUDA_NULL_FIELD_CREATE;
+    ColorSpinorField *tmp = ColorSpinorField::Create(csParam);
+
+    if (batch <= 0) batch = nullVectorBatch(*tmp, Nvec);
+    if (batch < Nvec && getVerbosity() >= QUDA_VERBOSE)
+      printfQuda("Relaxing the null-space vectors in batches of %d\n", batch);
+
+    DiracMdagM mat(matResidual.Expose());
+
+    int k = 0;
+    for (int i=0; i<Nvec; i+=batch) {
+      std::vector<ColorSpinorField*> B_batch(B.begin()+i, B.begin()+std::min(i+batch, Nvec));
+      k += relaxBatch(mat, B_batch, *tmp, maxiter, tol, random_start);
+    }
+    delete tmp;
+
+    // global orthonormalization of the generated null-space vectors
+    blockOrthonormalize(B);
+
+    return k;
+  }
+  double nullSpaceResidual(DiracMatrix &mat, std::vector<ColorSpinorField*> &B, QudaFieldLocation location) {
+    const int Nvec = B.size();
+    ColorSpinorParam csParam = nullVectorParam(*B[0], location);
+    csParam.create = QUDA_NULL_FIELD_CREATE;
+    ColorSpinorField *x = ColorSpinorField::Create(csParam);
+    ColorSpinorField *Mx = ColorSpinorField::Create(csParam);
+
+    std::vector<double> norms(2*Nvec);
+    bool reduceState = globalReduce;
+    globalReduce = false;
+    for (int i=0; i<Nvec; i++) {
+      *x = *B[i];
+      mat(*Mx, *x);
+      norms[2*i+0] = blas::norm2(*Mx);
+      norms[2*i+1] = blas::norm2(*x);
+    }
+    globalReduce = reduceState;
+    reduceDoubleArray(&norms[0], 2*Nvec);
+    delete x;
+    delete Mx;
+
+    double residual = 0.0;
+    for (int i=0; i<Nvec; i++) residual += sqrt(norms[2*i+0] / norms[2*i+1]);
+    return residual / Nvec;
+  }
+
+  void MG::generateNullVectorsBatched(std::vector<ColorSpinorField*> B) {
+    printfQuda("\nGenerate %lu null vectors in a batch\n", B.size());
+
+    int k = relaxNullVectors(param.matResidual, B, null_maxiter, null_tol, true, param.location);
+    if (getVerbosity() >= QUDA_SUMMARIZE) printfQuda("Batched null-space generation done in %d iterations\n", k);
+
+    saveVectors(B);
   }
 
 }
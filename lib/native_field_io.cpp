@@ -0,0 +1,513 @@
+#include <stdio.h>
+#include <string.h>
+#include <stdint.h>
+#include <fcntl.h>
+#include <unistd.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <vector>
+#include <typeinfo>
+
+#include <quda_internal.h>
+#include <comm_quda.h>
+#include <native_field_io.h>
+
+namespace quda {
+
+  static const char native_magic[8] = { 'Q', 'U', 'D', 'A', 'F', 'L', 'D', '\0' };
+  static const int32_t native_version = 2;
+  static const int32_t native_endian = 0x01020304;
+  static const size_t native_alignment = 4096; // the payload (and checksum table) start on a page boundary
+
+  enum NativeFieldType { NATIVE_GAUGE_FIELD = 0, NATIVE_COLOR_SPINOR_FIELD = 1, NATIVE_VECTOR_SET = 2 };
+
+  struct NativeFieldHeader {
+    char magic[8];
+    int32_t version;
+    int32_t endian;
+    int32_t field_type;
+    int32_t precision;
+    int32_t order;
+    int32_t nDim;
+    int32_t x[QUDA_MAX_DIM];
+    int32_t comm_dims[4];
+    int32_t comm_coords[4];
+
+    // gauge field parameters
+    int32_t reconstruct;
+    int32_t geometry;
+    int32_t link_type;
+    int32_t t_boundary;
+    int32_t fixed;
+    int32_t staggered_phase_type;
+    int32_t staggered_phase_applied;
+    int32_t ghost_exchange;
+    int32_t nFace;
+    int32_t r[QUDA_MAX_DIM]; // radius of the extended region
+    double anisotropy;
+    double tadpole;
+
+    // color-spinor field parameters
+    int32_t nColor;
+    int32_t nSpin;
+    int32_t siteSubset;
+    int32_t siteOrder;
+    int32_t gammaBasis;
+    int32_t twistFlavor;
+    int32_t PCtype;
+
+    uint64_t payload_bytes;
+    uint64_t alignment;       // alignment of the sections below the header
+    uint64_t data_offset;
+    uint64_t checksum;
+
+    // vector-set parameters
+    int32_t nVec;
+    int32_t nRank;
+    int32_t vector_precision; // precision of the vectors the set was written from
+    uint64_t table_offset;    // per-rank, per-vector checksum table
+    uint64_t vector_reals;    // number of reals per vector per rank
+  };
+
+  /**
+     Position-weighted 64-bit sum of the payload words, so that both
+     corrupted and transposed data are detected.  Unlike a CRC this
+     reduces trivially over threads, so verifying a mapped field runs
+     at memory bandwidth.
+   */
+  static uint64_t checksumSegment(const char *data, size_t bytes, uint64_t word_offset) {
+    const long n = bytes / sizeof(uint64_t);
+    uint64_t sum = 0;
+#pragma omp parallel for reduction(+:sum)
+    for (long i=0; i<n; i++) {
+      uint64_t w;
+      memcpy(&w, data + i*sizeof(uint64_t), sizeof(uint64_t));
+      sum += w * (2*(word_offset + i) + 1);
+    }
+    const size_t tail = bytes % sizeof(uint64_t);
+    if (tail) {
+      uint64_t w = 0;
+      memcpy(&w, data + n*sizeof(uint64_t), tail);
+      sum += w * (2*(word_offset + n) + 1);
+    }
+    return sum;
+  }
+
+  /**
+     @return The offset rounded up to the next multiple of native_alignment
+   */
+  static inline size_t alignOffset(size_t offset) {
+    return ((offset + native_alignment - 1) / native_alignment) * native_alignment;
+  }
+
+  static void initHeader(NativeFieldHeader &header, NativeFieldType type, QudaPrecision precision,
+			 int nDim, const int *x) {
+    memset(&header, 0, sizeof(header));
+    memcpy(header.magic, native_magic, sizeof(native_magic));
+    header.version = native_version;
+    header.endian = native_endian;
+    header.field_type = type;
+    header.precision = precision;
+    header.nDim = nDim;
+    for (int d=0; d<nDim; d++) header.x[d] = x[d];
+    for (int d=0; d<4; d++) {
+      header.comm_dims[d] = comm_dim(d);
+      header.comm_coords[d] = comm_coord(d);
+    }
+    header.alignment = native_alignment;
+    header.data_offset = alignOffset(sizeof(header));
+  }
+
+  static void writeNativeField(const char *filename, NativeFieldHeader &header,
+			       const char * const *segment, size_t segment_bytes, int n_segment) {
+    header.payload_bytes = segment_bytes * n_segment;
+    header.checksum = 0;
+    for (int s=0; s<n_segment; s++)
+      header.checksum += checksumSegment(segment[s], segment_bytes, (s*segment_bytes) / sizeof(uint64_t));
+
+    FILE *fp = fopen(filename, "wb");
+    if (!fp) errorQuda("Unable to open %s for writing", filename);
+
+    std::vector<char> block(header.data_offset, 0);
+    memcpy(&block[0], &header, sizeof(header));
+    if (fwrite(&block[0], 1, block.size(), fp) != block.size()) errorQuda("Failed to write header to %s", filename);
+    for (int s=0; s<n_segment; s++) {
+      if (fwrite(segment[s], 1, segment_bytes, fp) != segment_bytes) errorQuda("Failed to write payload to %s", filename);
+    }
+    if (fclose(fp)) errorQuda("Failed to close %s", filename);
+
+    if (getVerbosity() >= QUDA_VERBOSE)
+      printfQuda("Wrote %lu bytes to %s (checksum %016llx)\n", (unsigned long)header.payload_bytes, filename,
+		 (unsigned long long)header.checksum);
+  }
+
+  static char* mapNativeField(const char *filename, NativeFieldHeader &header, NativeFieldType type,
+			      NativeFieldMapping &mapping, bool verify) {
+    int fd = open(filename, O_RDONLY);
+    if (fd < 0) errorQuda("Unable to open %s", filename);
+
+    if (pread(fd, &header, sizeof(header), 0) != (ssize_t)sizeof(header)) errorQuda("Failed to read header from %s", filename);
+    if (memcmp(header.magic, native_magic, sizeof(native_magic))) errorQuda("%s is not a native QUDA field file", filename);
+    if (header.endian != native_endian) errorQuda("%s was written with a different byte order", filename);
+    if (header.version != native_version) errorQuda("%s has unsupported version %d", filename, header.version);
+    if (header.field_type != type) errorQuda("%s holds field type %d, expected %d", filename, header.field_type, type);
+    if (header.data_offset < sizeof(header) || header.data_offset % header.alignment)
+      errorQuda("%s has invalid data offset %lu", filename, (unsigned long)header.data_offset);
+
+    for (int d=0; d<4; d++) {
+      if (header.comm_dims[d] != comm_dim(d) || header.comm_coords[d] != comm_coord(d))
+	errorQuda("%s was written for process grid position %d in dimension %d of %d (this process is %d of %d)",
+		  filename, header.comm_coords[d], d, header.comm_dims[d], comm_coord(d), comm_dim(d));
+    }
+
+    struct stat st;
+    if (fstat(fd, &st)) errorQuda("Unable to stat %s", filename);
+    mapping.length = header.data_offset + header.payload_bytes;
+    if ((size_t)st.st_size < mapping.length) errorQuda("%s is truncated (%lu < %lu bytes)", filename,
+						       (unsigned long)st.st_size, (unsigned long)mapping.length);
+
+    mapping.base = mmap(NULL, mapping.length, PROT_READ | PROT_WRITE, MAP_PRIVATE, fd, 0);
+    if (mapping.base == MAP_FAILED) errorQuda("Failed to map %s", filename);
+    close(fd);
+
+    char *payload = (char*)mapping.base + header.data_offset;
+    if (verify) {
+      madvise(mapping.base, mapping.length, MADV_SEQUENTIAL);
+      uint64_t checksum = checksumSegment(payload, header.payload_bytes, 0);
+      if (checksum != header.checksum)
+	errorQuda("Checksum mismatch for %s (%016llx != %016llx)", filename,
+		  (unsigned long long)checksum, (unsigned long long)header.checksum);
+    }
+
+    return payload;
+  }
+
+  static int gaugeSiteDim(QudaFieldGeometry geometry, int nDim) {
+    if (geometry == QUDA_SCALAR_GEOMETRY) return 1;
+    else if (geometry == QUDA_VECTOR_GEOMETRY) return nDim;
+    else if (geometry == QUDA_TENSOR_GEOMETRY) return nDim * (nDim-1) / 2;
+    else errorQuda("Geometry %d not supported", geometry);
+    return 0;
+  }
+
+  void writeNativeGaugeField(const char *filename, const cpuGaugeField &u) {
+    NativeFieldHeader header;
+    initHeader(header, NATIVE_GAUGE_FIELD, u.Precision(), u.Ndim(), u.X());
+    header.order = u.Order();
+    header.reconstruct = u.Reconstruct();
+    header.geometry = u.Geometry();
+    header.link_type = u.LinkType();
+    header.t_boundary = u.TBoundary();
+    header.fixed = u.GaugeFixed();
+    header.staggered_phase_type = u.StaggeredPhase();
+    header.staggered_phase_applied = u.StaggeredPhaseApplied();
+    header.ghost_exchange = u.GhostExchange();
+    header.nFace = u.Nface();
+    for (int d=0; d<u.Ndim(); d++) header.r[d] = u.R()[d];
+    header.anisotropy = u.Anisotropy();
+    header.tadpole = u.Tadpole();
+
+    const int siteDim = gaugeSiteDim(u.Geometry(), u.Ndim());
+    const size_t dim_bytes = (size_t)u.Volume() * u.Reconstruct() * u.Precision();
+
+    if (u.Order() == QUDA_QDP_GAUGE_ORDER) {
+      const char * const *segment = (const char * const *)u.Gauge_p();
+      writeNativeField(filename, header, segment, dim_bytes, siteDim);
+    } else {
+      const char *segment = (const char*)u.Gauge_p();
+      writeNativeField(filename, header, &segment, siteDim * dim_bytes, 1);
+    }
+  }
+
+  cpuGaugeField* mapNativeGaugeField(const char *filename, NativeFieldMapping &mapping, bool verify) {
+    NativeFieldHeader header;
+    char *payload = mapNativeField(filename, header, NATIVE_GAUGE_FIELD, mapping, verify);
+
+    GaugeFieldParam param(header.x, (QudaPrecision)header.precision, (QudaReconstructType)header.reconstruct,
+			  0, (QudaFieldGeometry)header.geometry);
+    param.order = (QudaGaugeFieldOrder)header.order;
+    param.link_type = (QudaLinkType)header.link_type;
+    param.t_boundary = (QudaTboundary)header.t_boundary;
+    param.fixed = (QudaGaugeFixed)header.fixed;
+    param.staggeredPhaseType = (QudaStaggeredPhase)header.staggered_phase_type;
+    param.staggeredPhaseApplied = header.staggered_phase_applied;
+    param.ghostExchange = (QudaGhostExchange)header.ghost_exchange;
+    param.nFace = header.nFace;
+    for (int d=0; d<header.nDim; d++) param.r[d] = header.r[d];
+    param.anisotropy = header.anisotropy;
+    param.tadpole = header.tadpole;
+    param.siteSubset = QUDA_FULL_SITE_SUBSET;
+    param.create = QUDA_REFERENCE_FIELD_CREATE;
+
+    const int siteDim = gaugeSiteDim(param.geometry, header.nDim);
+    size_t volume = 1;
+    for (int d=0; d<header.nDim; d++) volume *= header.x[d];
+    const size_t dim_bytes = volume * header.reconstruct * header.precision;
+    if (siteDim * dim_bytes != header.payload_bytes)
+      errorQuda("Payload size %lu of %s does not match the field (%lu)", (unsigned long)header.payload_bytes,
+		filename, (unsigned long)(siteDim * dim_bytes));
+
+    void *gauge[QUDA_MAX_DIM*(QUDA_MAX_DIM-1)/2];
+    if (param.order == QUDA_QDP_GAUGE_ORDER) {
+      for (int d=0; d<siteDim; d++) gauge[d] = payload + d*dim_bytes;
+      param.gauge = (void*)gauge;
+    } else {
+      param.gauge = payload;
+    }
+
+    return new cpuGaugeField(param);
+  }
+
+  void writeNativeColorSpinorField(const char *filename, const cpuColorSpinorField &v) {
+    if (v.FieldOrder() == QUDA_QOP_DOMAIN_WALL_FIELD_ORDER)
+      errorQuda("Field order %d not supported", v.FieldOrder());
+
+    NativeFieldHeader header;
+    initHeader(header, NATIVE_COLOR_SPINOR_FIELD, v.Precision(), v.Ndim(), v.X());
+    header.order = v.FieldOrder();
+    header.nColor = v.Ncolor();
+    header.nSpin = v.Nspin();
+    header.siteSubset = v.SiteSubset();
+    header.siteOrder = v.SiteOrder();
+    header.gammaBasis = v.GammaBasis();
+    header.twistFlavor = v.TwistFlavor();
+    header.PCtype = v.DWFPCtype();
+
+    const char *segment = (const char*)v.V();
+    writeNativeField(filename, header, &segment, v.Bytes(), 1);
+  }
+
+  cpuColorSpinorField* mapNativeColorSpinorField(const char *filename, NativeFieldMapping &mapping, bool verify) {
+    NativeFieldHeader header;
+    char *payload = mapNativeField(filename, header, NATIVE_COLOR_SPINOR_FIELD, mapping, verify);
+
+    ColorSpinorParam param;
+    param.location = QUDA_CPU_FIELD_LOCATION;
+    param.nColor = header.nColor;
+    param.nSpin = header.nSpin;
+    param.nDim = header.nDim;
+    for (int d=0; d<header.nDim; d++) param.x[d] = header.x[d];
+    param.precision = (QudaPrecision)header.precision;
+    param.pad = 0;
+    param.fieldOrder = (QudaFieldOrder)header.order;
+    param.siteSubset = (QudaSiteSubset)header.siteSubset;
+    param.siteOrder = (QudaSiteOrder)header.siteOrder;
+    param.gammaBasis = (QudaGammaBasis)header.gammaBasis;
+    param.twistFlavor = (QudaTwistFlavorType)header.twistFlavor;
+    param.PCtype = (QudaDWFPCType)header.PCtype;
+    param.create = QUDA_REFERENCE_FIELD_CREATE;
+    param.v = payload;
+
+    cpuColorSpinorField *v = new cpuColorSpinorField(param);
+    if (v->Bytes() != header.payload_bytes)
+      errorQuda("Payload size %lu of %s does not match the field (%lu)", (unsigned long)header.payload_bytes,
+		filename, (unsigned long)v->Bytes());
+    return v;
+  }
+
+  void unmapNativeField(NativeFieldMapping &mapping) {
+    if (mapping.base && munmap(mapping.base, mapping.length)) errorQuda("Failed to unmap native field");
+    mapping.base = 0;
+    mapping.length = 0;
+  }
+
+  static bool pwriteAll(int fd, const char *buf, size_t bytes, off_t offset) {
+    while (bytes > 0) {
+      ssize_t n = pwrite(fd, buf, bytes, offset);
+      if (n <= 0) return false;
+      buf += n; bytes -= n; offset += n;
+    }
+    return true;
+  }
+
+  static bool preadAll(int fd, char *buf, size_t bytes, off_t offset) {
+    while (bytes > 0) {
+      ssize_t n = pread(fd, buf, bytes, offset);
+      if (n <= 0) return false;
+      buf += n; bytes -= n; offset += n;
+    }
+    return true;
+  }
+
+  template <typename dst_t, typename src_t>
+  static void convertReals(dst_t *dst, const src_t *src, size_t n) {
+    for (size_t i=0; i<n; i++) dst[i] = src[i];
+  }
+
+  static void convertReals(void *dst, QudaPrecision dst_prec, const void *src, QudaPrecision src_prec, size_t n) {
+    if (dst_prec == QUDA_DOUBLE_PRECISION && src_prec == QUDA_SINGLE_PRECISION) {
+      convertReals((double*)dst, (const float*)src, n);
+    } else if (dst_prec == QUDA_SINGLE_PRECISION && src_prec == QUDA_DOUBLE_PRECISION) {
+      convertReals((float*)dst, (const double*)src, n);
+    } else {
+      errorQuda("Conversion from precision %d to %d not supported", src_prec, dst_prec);
+    }
+  }
+
+  static void checkVectorSet(const std::vector<ColorSpinorField*> &B) {
+    if (B.size() == 0) errorQuda("Empty vector set");
+    for (unsigned int i=0; i<B.size(); i++) {
+      if (typeid(*B[i]) != typeid(cpuColorSpinorField)) errorQuda("Vector set I/O requires host fields");
+      if (B[i]->Precision() != B[0]->Precision() || B[i]->Bytes() != B[0]->Bytes())
+	errorQuda("Vector %d does not match the first vector of the set", i);
+      if (B[i]->FieldOrder() == QUDA_QOP_DOMAIN_WALL_FIELD_ORDER)
+	errorQuda("Field order %d not supported", B[i]->FieldOrder());
+    }
+  }
+
+  void writeNativeVectorSet(const char *filename, const std::vector<ColorSpinorField*> &B, QudaPrecision file_prec) {
+    checkVectorSet(B);
+    const ColorSpinorField &b = *B[0];
+    if (file_prec == QUDA_INVALID_PRECISION) file_prec = b.Precision();
+    if (file_prec != QUDA_DOUBLE_PRECISION && file_prec != QUDA_SINGLE_PRECISION)
+      errorQuda("File precision %d not supported", file_prec);
+
+    const int nVec = B.size();
+    const int nRank = comm_size();
+    const int rank = comm_rank();
+    const size_t reals = b.Bytes() / b.Precision();
+    const size_t vec_bytes = reals * file_prec;
+
+    NativeFieldHeader header;
+    initHeader(header, NATIVE_VECTOR_SET, file_prec, b.Ndim(), b.X());
+    header.order = b.FieldOrder();
+    header.nColor = b.Ncolor();
+    header.nSpin = b.Nspin();
+    header.siteSubset = b.SiteSubset();
+    header.siteOrder = b.SiteOrder();
+    header.gammaBasis = b.GammaBasis();
+    header.twistFlavor = b.TwistFlavor();
+    header.PCtype = b.DWFPCtype();
+    header.nVec = nVec;
+    header.nRank = nRank;
+    header.vector_precision = b.Precision();
+    header.vector_reals = reals;
+    header.table_offset = header.data_offset;
+    const size_t table_bytes = (size_t)nRank * nVec * sizeof(uint64_t);
+    header.data_offset = alignOffset(header.table_offset + table_bytes);
+    header.payload_bytes = (size_t)nRank * nVec * vec_bytes;
+
+    Timer timer;
+    timer.Start(__func__, __FILE__, __LINE__);
+
+    // rank 0 creates the file and lays down the header, then every
+    // rank writes its own block of vectors at a fixed offset
+    if (rank == 0) {
+      int fd = open(filename, O_WRONLY | O_CREAT | O_TRUNC, 0644);
+      if (fd < 0) errorQuda("Unable to open %s for writing", filename);
+      std::vector<char> block(header.table_offset, 0);
+      memcpy(&block[0], &header, sizeof(header));
+      if (!pwriteAll(fd, &block[0], block.size(), 0)) errorQuda("Failed to write header to %s", filename);
+      if (ftruncate(fd, header.data_offset + header.payload_bytes)) errorQuda("Failed to size %s", filename);
+      close(fd);
+    }
+    comm_barrier();
+
+    int fd = open(filename, O_WRONLY);
+    if (fd < 0) errorQuda("Unable to open %s for writing", filename);
+
+    const off_t rank_offset = header.data_offset + (off_t)rank * nVec * vec_bytes;
+    std::vector<uint64_t> checksum(nVec);
+    int failed = 0;
+
+#pragma omp parallel for schedule(dynamic) reduction(+:failed)
+    for (int i=0; i<nVec; i++) {
+      std::vector<char> buffer;
+      const char *src = (const char*)B[i]->V();
+      if (file_prec != B[i]->Precision()) {
+	buffer.resize(vec_bytes);
+	convertReals(&buffer[0], file_prec, B[i]->V(), B[i]->Precision(), reals);
+	src = &buffer[0];
+      }
+      checksum[i] = checksumSegment(src, vec_bytes, 0);
+      if (!pwriteAll(fd, src, vec_bytes, rank_offset + (off_t)i * vec_bytes)) failed++;
+    }
+
+    if (!pwriteAll(fd, (const char*)&checksum[0], nVec*sizeof(uint64_t),
+		   header.table_offset + (off_t)rank * nVec * sizeof(uint64_t))) failed++;
+    if (close(fd)) failed++;
+
+    comm_allreduce_int(&failed);
+    if (failed) errorQuda("Failed to write vector set %s", filename);
+
+    timer.Stop(__func__, __FILE__, __LINE__);
+    if (getVerbosity() >= QUDA_SUMMARIZE)
+      printfQuda("Wrote %d vectors to %s in %.3f s (%.2f GB/s)\n", nVec, filename, timer.Last(),
+		 header.payload_bytes / (1e9 * timer.Last()));
+  }
+
+  bool isNativeVectorSet(const char *filename) {
+    int fd = open(filename, O_RDONLY);
+    if (fd < 0) return false;
+    NativeFieldHeader header;
+    bool native = preadAll(fd, (char*)&header, sizeof(header), 0) &&
+      !memcmp(header.magic, native_magic, sizeof(native_magic)) && header.field_type == NATIVE_VECTOR_SET;
+    close(fd);
+    return native;
+  }
+
+  void readNativeVectorSet(const char *filename, std::vector<ColorSpinorField*> &B) {
+    checkVectorSet(B);
+    const ColorSpinorField &b = *B[0];
+    const int nVec = B.size();
+    const int rank = comm_rank();
+
+    int fd = open(filename, O_RDONLY);
+    if (fd < 0) errorQuda("Unable to open %s", filename);
+
+    NativeFieldHeader header;
+    if (!preadAll(fd, (char*)&header, sizeof(header), 0)) errorQuda("Failed to read header from %s", filename);
+    if (memcmp(header.magic, native_magic, sizeof(native_magic))) errorQuda("%s is not a native QUDA field file", filename);
+    if (header.endian != native_endian) errorQuda("%s was written with a different byte order", filename);
+    if (header.version != native_version) errorQuda("%s has unsupported version %d", filename, header.version);
+    if (header.field_type != NATIVE_VECTOR_SET) errorQuda("%s is not a vector set", filename);
+    if (header.nRank != comm_size()) errorQuda("%s was written by %d processes, not %d", filename, header.nRank, comm_size());
+    for (int d=0; d<4; d++)
+      if (header.comm_dims[d] != comm_dim(d)) errorQuda("%s was written with a different process grid", filename);
+    if (header.nVec != nVec) errorQuda("%s holds %d vectors, expected %d", filename, header.nVec, nVec);
+    if (header.nDim != b.Ndim() || header.nColor != b.Ncolor() || header.nSpin != b.Nspin() ||
+	header.order != b.FieldOrder() || header.siteSubset != b.SiteSubset())
+      errorQuda("Vectors in %s do not match the requested fields", filename);
+    for (int d=0; d<b.Ndim(); d++)
+      if (header.x[d] != b.X()[d]) errorQuda("Local dimension %d of %s is %d, expected %d", d, filename, header.x[d], b.X()[d]);
+
+    const QudaPrecision file_prec = (QudaPrecision)header.precision;
+    const size_t reals = b.Bytes() / b.Precision();
+    if (header.vector_reals != reals) errorQuda("Vector length of %s does not match", filename);
+    const size_t vec_bytes = reals * file_prec;
+
+    Timer timer;
+    timer.Start(__func__, __FILE__, __LINE__);
+
+    std::vector<uint64_t> checksum(nVec);
+    if (!preadAll(fd, (char*)&checksum[0], nVec*sizeof(uint64_t),
+		  header.table_offset + (off_t)rank * nVec * sizeof(uint64_t)))
+      errorQuda("Failed to read checksums from %s", filename);
+
+    const off_t rank_offset = header.data_offset + (off_t)rank * nVec * vec_bytes;
+    int failed = 0;
+
+#pragma omp parallel for schedule(dynamic) reduction(+:failed)
+    for (int i=0; i<nVec; i++) {
+      std::vector<char> buffer;
+      char *dst = (char*)B[i]->V();
+      if (file_prec != B[i]->Precision()) {
+	buffer.resize(vec_bytes);
+	dst = &buffer[0];
+      }
+      if (!preadAll(fd, dst, vec_bytes, rank_offset + (off_t)i * vec_bytes)) { failed++; continue; }
+      if (checksumSegment(dst, vec_bytes, 0) != checksum[i]) { failed++; continue; }
+      if (file_prec != B[i]->Precision()) convertReals(B[i]->V(), B[i]->Precision(), dst, file_prec, reals);
+    }
+    close(fd);
+
+    comm_allreduce_int(&failed);
+    if (failed) errorQuda("Failed to read %d vectors from %s (I/O error or checksum mismatch)", failed, filename);
+
+    timer.Stop(__func__, __FILE__, __LINE__);
+    if (getVerbosity() >= QUDA_SUMMARIZE)
+      printfQuda("Read %d vectors from %s in %.3f s (%.2f GB/s)\n", nVec, filename, timer.Last(),
+		 header.payload_bytes / (1e9 * timer.Last()));
+  }
+
+} // namespace quda
@@ -1,5 +1,6 @@
 #include <color_spinor_field.h>
 #include <color_spinor_field_order.h>
+#include <compressed_vector_set.h>
 #include <tune_quda.h>
 #include <typeinfo>
 
@@ -75,6 +76,7 @@ namespace quda {
   template <typename Float, int fineSpin, int fineColor, int coarseSpin, int coarseColor, int fine_colors_per_thread, typename Arg>
   void Prolongate(Arg &arg) {
     for (int parity=0; parity<2; parity++) {
+#pragma omp parallel for
       for (int x_cb=0; x_cb<arg.out.VolumeCB(); x_cb++) {
 	complex<Float> tmp[fineSpin*coarseColor];
 	prolongate<Float,fineSpin,coarseColor>(tmp, arg.in, parity, x_cb, arg.geo_map, arg.spin_map, arg.out.Volume());
@@ -202,18 +204,18 @@ namespace quda {
 
   };
 
-  template <typename Float, int fineSpin, int fineColor, int coarseSpin, int coarseColor, QudaFieldOrder order>
-  void Prolongate(ColorSpinorField &out, const ColorSpinorField &in, const ColorSpinorField &v,
+  template <typename Float, int fineSpin, int fineColor, int coarseSpin, int coarseColor, QudaFieldOrder order, typename vField>
+  void Prolongate(ColorSpinorField &out, const ColorSpinorField &in, const vField &v,
 		  const int *fine_to_coarse) {
 
     typedef FieldOrderCB<Float,fineSpin,fineColor,1,order> fineSpinor;
     typedef FieldOrderCB<Float,coarseSpin,coarseColor,1,order> coarseSpinor;
-    typedef FieldOrderCB<Float,fineSpin,fineColor,coarseColor,order> packedSpinor;
+    typedef typename rotator_mapper<Float,fineSpin,fineColor,coarseColor,order,vField>::type packedSpinor;
     typedef ProlongateArg<fineSpinor,coarseSpinor,packedSpinor,fineSpin,coarseSpin> Arg;
 
     fineSpinor   Out(const_cast<ColorSpinorField&>(out));
     coarseSpinor In(const_cast<ColorSpinorField&>(in));
-    packedSpinor V(const_cast<ColorSpinorField&>(v));
+    packedSpinor V(v);
 
     // for fine grid we keep 3 colors per thread else use fine grained
     constexpr int fine_colors_per_thread = fineColor == 3 ? fineColor : 1;
@@ -227,8 +229,8 @@ namespace quda {
   }
 
 
-  template <typename Float, int fineSpin, int fineColor, int coarseSpin, QudaFieldOrder order>
-  void Prolongate(ColorSpinorField &out, const ColorSpinorField &in, const ColorSpinorField &v,
+  template <typename Float, int fineSpin, int fineColor, int coarseSpin, QudaFieldOrder order, typename vField>
+  void Prolongate(ColorSpinorField &out, const ColorSpinorField &in, const vField &v,
 		  int nVec, const int *fine_to_coarse, const int *spin_map) {
 
     // first check that the spin_map matches the spin_mapper
@@ -257,8 +259,8 @@ namespace quda {
     }
   }
 
-  template <typename Float, int fineSpin, QudaFieldOrder order>
-  void Prolongate(ColorSpinorField &out, const ColorSpinorField &in, const ColorSpinorField &v,
+  template <typename Float, int fineSpin, QudaFieldOrder order, typename vField>
+  void Prolongate(ColorSpinorField &out, const ColorSpinorField &in, const vField &v,
 		  int Nvec, const int *fine_to_coarse, const int *spin_map) {
 
     if (in.Nspin() != 2) errorQuda("Coarse spin %d is not supported", in.Nspin());
@@ -280,8 +282,8 @@ namespace quda {
     }
   }
 
-  template <typename Float, QudaFieldOrder order>
-  void Prolongate(ColorSpinorField &out, const ColorSpinorField &in, const ColorSpinorField &v,
+  template <typename Float, QudaFieldOrder order, typename vField>
+  void Prolongate(ColorSpinorField &out, const ColorSpinorField &in, const vField &v,
 		  int Nvec, const int *fine_to_coarse, const int *spin_map) {
 
     if (out.Nspin() == 4) {
@@ -315,8 +317,37 @@ namespace quda {
       errorQuda("Unsupported field type %d", out.FieldOrder());
     }
   }
+  template <typename Float>
+  void Prolongate(ColorSpinorField &out, const ColorSpinorField &in, const CompressedVectorSet &v,
+		  int Nvec, const int *fine_to_coarse, const int *spin_map) {
+
+    if (out.FieldOrder() != QUDA_SPACE_SPIN_COLOR_FIELD_ORDER || in.FieldOrder() != QUDA_SPACE_SPIN_COLOR_FIELD_ORDER ||
+	v.FieldOrder() != QUDA_SPACE_SPIN_COLOR_FIELD_ORDER)
+      errorQuda("Compressed null-space vectors require space-spin-color order (out=%d, in=%d, v=%d)",
+		out.FieldOrder(), in.FieldOrder(), v.FieldOrder());
+
+    Prolongate<Float,QUDA_SPACE_SPIN_COLOR_FIELD_ORDER>(out, in, v, Nvec, fine_to_coarse, spin_map);
+  }
 #endif // GPU_MULTIGRID
 
+  void Prolongate(ColorSpinorField &out, const ColorSpinorField &in, const CompressedVectorSet &v,
+		  int Nvec, const int *fine_to_coarse, const int *spin_map) {
+#ifdef GPU_MULTIGRID
+    if (out.Precision() != in.Precision())
+      errorQuda("Precision mismatch out=%d in=%d", out.Precision(), in.Precision());
+
+    if (out.Precision() == QUDA_DOUBLE_PRECISION) {
+      Prolongate<double>(out, in, v, Nvec, fine_to_coarse, spin_map);
+    } else if (out.Precision() == QUDA_SINGLE_PRECISION) {
+      Prolongate<float>(out, in, v, Nvec, fine_to_coarse, spin_map);
+    } else {
+      errorQuda("Unsupported precision %d", out.Precision());
+    }
+#else
+    errorQuda("Multigrid has not been built");
+#endif
+  }
+
   void Prolongate(ColorSpinorField &out, const ColorSpinorField &in, const ColorSpinorField &v,
 		  int Nvec, const int *fine_to_coarse, const int *spin_map) {
 #ifdef GPU_MULTIGRID
@@ -1,5 +1,6 @@
 #include <color_spinor_field.h>
 #include <color_spinor_field_order.h>
+#include <compressed_vector_set.h>
 #include <tune_quda.h>
 #include <cub/cub.cuh>
 #include <typeinfo>
@@ -58,21 +59,24 @@ namespace quda {
 
   template <typename Float, int fineSpin, int fineColor, int coarseSpin, int coarseColor, int coarse_colors_per_thread, typename Arg>
   void Restrict(Arg arg) {
-    for (int parity_coarse=0; parity_coarse<2; parity_coarse++) 
-      for (int x_coarse_cb=0; x_coarse_cb<arg.out.VolumeCB(); x_coarse_cb++)
-	for (int s=0; s<coarseSpin; s++) 
-	  for (int c=0; c<coarseColor; c++)
-	    arg.out(parity_coarse, x_coarse_cb, s, c) = 0.0;
-
-    // loop over fine degrees of freedom
-    for (int parity=0; parity<2; parity++) {
-      for (int x_cb=0; x_cb<arg.in.VolumeCB(); x_cb++) {
-
-	int x = parity*arg.in.VolumeCB() + x_cb;
-	int x_coarse = arg.fine_to_coarse[x];
-	int parity_coarse = (x_coarse >= arg.out.VolumeCB()) ? 1 : 0;
-	int x_coarse_cb = x_coarse - parity_coarse*arg.out.VolumeCB();
-	
+    // coarse_to_fine lists the fine points of each aggregate contiguously,
+    // so each coarse site can be accumulated independently of the others
+    const int aggregate_size = arg.in.Volume() / arg.out.Volume();
+
+#pragma omp parallel for
+    for (int x_coarse=0; x_coarse<arg.out.Volume(); x_coarse++) {
+      int parity_coarse = (x_coarse >= arg.out.VolumeCB()) ? 1 : 0;
+      int x_coarse_cb = x_coarse - parity_coarse*arg.out.VolumeCB();
+
+      complex<Float> reduced[coarseSpin*coarseColor];
+      for (int i=0; i<coarseSpin*coarseColor; i++) reduced[i] = 0.0;
+
+      // loop over fine degrees of freedom in this aggregate
+      for (int j=0; j<aggregate_size; j++) {
+	int x = arg.coarse_to_fine[x_coarse*aggregate_size + j];
+	int parity = (x >= arg.in.VolumeCB()) ? 1 : 0;
+	int x_cb = x - parity*arg.in.VolumeCB();
+
 	for (int coarse_color_block=0; coarse_color_block<coarseColor; coarse_color_block+=coarse_colors_per_thread) {
 	  complex<Float> tmp[fineSpin*coarse_colors_per_thread];
 	  rotateCoarseColor<Float,fineSpin,fineColor,coarseColor,coarse_colors_per_thread>(tmp, arg.in, arg.V, parity, x_cb, coarse_color_block);
@@ -80,11 +84,15 @@ namespace quda {
 	  for (int s=0; s<fineSpin; s++) {
 	    for (int coarse_color_local=0; coarse_color_local<coarse_colors_per_thread; coarse_color_local++) {
 	      int c = coarse_color_block + coarse_color_local;
-	      arg.out(parity_coarse,x_coarse_cb,arg.spin_map(s),c) += tmp[s*coarse_colors_per_thread+coarse_color_local];
+	      reduced[arg.spin_map(s)*coarseColor+c] += tmp[s*coarse_colors_per_thread+coarse_color_local];
 	    }
 	  }
 	}
       }
+
+      for (int s=0; s<coarseSpin; s++)
+	for (int c=0; c<coarseColor; c++)
+	  arg.out(parity_coarse, x_coarse_cb, s, c) = reduced[s*coarseColor+c];
     }
 
   }
@@ -277,18 +285,18 @@ namespace quda {
 
   };
 
-  template <typename Float, int fineSpin, int fineColor, int coarseSpin, int coarseColor, QudaFieldOrder order>
-  void Restrict(ColorSpinorField &out, const ColorSpinorField &in, const ColorSpinorField &v,
+  template <typename Float, int fineSpin, int fineColor, int coarseSpin, int coarseColor, QudaFieldOrder order, typename vField>
+  void Restrict(ColorSpinorField &out, const ColorSpinorField &in, const vField &v,
 		const int *fine_to_coarse, const int *coarse_to_fine) {
 
     typedef FieldOrderCB<Float,fineSpin,fineColor,1,order> fineSpinor;
     typedef FieldOrderCB<Float,coarseSpin,coarseColor,1,order> coarseSpinor;
-    typedef FieldOrderCB<Float,fineSpin,fineColor,coarseColor,order> packedSpinor;
+    typedef typename rotator_mapper<Float,fineSpin,fineColor,coarseColor,order,vField>::type packedSpinor;
     typedef RestrictArg<coarseSpinor,fineSpinor,packedSpinor,fineSpin,coarseSpin> Arg;
 
     coarseSpinor Out(const_cast<ColorSpinorField&>(out));
     fineSpinor   In(const_cast<ColorSpinorField&>(in));
-    packedSpinor V(const_cast<ColorSpinorField&>(v));
+    packedSpinor V(v);
 
     // this seems like a reasonable value for both fine and coarse grids
     constexpr int coarse_colors_per_thread = 2;
@@ -300,8 +308,8 @@ namespace quda {
     if (Location(out, in, v) == QUDA_CUDA_FIELD_LOCATION) checkCudaError();
   }
 
-  template <typename Float, int fineSpin, int fineColor, int coarseSpin, QudaFieldOrder order>
-  void Restrict(ColorSpinorField &out, const ColorSpinorField &in, const ColorSpinorField &v,
+  template <typename Float, int fineSpin, int fineColor, int coarseSpin, QudaFieldOrder order, typename vField>
+  void Restrict(ColorSpinorField &out, const ColorSpinorField &in, const vField &v,
 		int nVec, const int *fine_to_coarse, const int *coarse_to_fine, const int *spin_map) {
 
     // first check that the spin_map matches the spin_mapper
@@ -330,8 +338,8 @@ namespace quda {
     }
   }
 
-  template <typename Float, int fineSpin, QudaFieldOrder order>
-  void Restrict(ColorSpinorField &out, const ColorSpinorField &in, const ColorSpinorField &v,
+  template <typename Float, int fineSpin, QudaFieldOrder order, typename vField>
+  void Restrict(ColorSpinorField &out, const ColorSpinorField &in, const vField &v,
 		int Nvec, const int *fine_to_coarse, const int *coarse_to_fine, const int *spin_map) {
 
     if (out.Nspin() != 2) errorQuda("Unsupported nSpin %d", out.Nspin());
@@ -353,8 +361,8 @@ namespace quda {
     }
   }
 
-  template <typename Float, QudaFieldOrder order>
-  void Restrict(ColorSpinorField &out, const ColorSpinorField &in, const ColorSpinorField &v,
+  template <typename Float, QudaFieldOrder order, typename vField>
+  void Restrict(ColorSpinorField &out, const ColorSpinorField &in, const vField &v,
 		int Nvec, const int *fine_to_coarse, const int *coarse_to_fine, const int *spin_map) {
 
     if (in.Nspin() == 4) {
@@ -390,8 +398,39 @@ namespace quda {
     }
   }
 
+  template <typename Float>
+  void Restrict(ColorSpinorField &out, const ColorSpinorField &in, const CompressedVectorSet &v,
+		int Nvec, const int *fine_to_coarse, const int *coarse_to_fine, const int *spin_map) {
+
+    if (out.FieldOrder() != QUDA_SPACE_SPIN_COLOR_FIELD_ORDER || in.FieldOrder() != QUDA_SPACE_SPIN_COLOR_FIELD_ORDER ||
+	v.FieldOrder() != QUDA_SPACE_SPIN_COLOR_FIELD_ORDER)
+      errorQuda("Compressed null-space vectors require space-spin-color order (out=%d, in=%d, v=%d)",
+		out.FieldOrder(), in.FieldOrder(), v.FieldOrder());
+
+    Restrict<Float,QUDA_SPACE_SPIN_COLOR_FIELD_ORDER>(out, in, v, Nvec, fine_to_coarse, coarse_to_fine, spin_map);
+  }
+
 #endif // GPU_MULTIGRID
 
+  void Restrict(ColorSpinorField &out, const ColorSpinorField &in, const CompressedVectorSet &v,
+		int Nvec, const int *fine_to_coarse, const int *coarse_to_fine, const int *spin_map) {
+
+#ifdef GPU_MULTIGRID
+    if (out.Precision() != in.Precision())
+      errorQuda("Precision mismatch out=%d in=%d", out.Precision(), in.Precision());
+
+    if (out.Precision() == QUDA_DOUBLE_PRECISION) {
+      Restrict<double>(out, in, v, Nvec, fine_to_coarse, coarse_to_fine, spin_map);
+    } else if (out.Precision() == QUDA_SINGLE_PRECISION) {
+      Restrict<float>(out, in, v, Nvec, fine_to_coarse, coarse_to_fine, spin_map);
+    } else {
+      errorQuda("Unsupported precision %d", out.Precision());
+    }
+#else
+    errorQuda("Multigrid has not been built");
+#endif
+  }
+
   void Restrict(ColorSpinorField &out, const ColorSpinorField &in, const ColorSpinorField &v,
 		int Nvec, const int *fine_to_coarse, const int *coarse_to_fine, const int *spin_map) {
 
@@ -15,10 +15,15 @@
 
 namespace quda {
 
-  void RitzMat::operator()(cudaColorSpinorField &out, const cudaColorSpinorField &in) const
+  void RitzMat::operator()(ColorSpinorField &out, const ColorSpinorField &in) const
   {
     using namespace blas;
-    
+
+    if (N_Poly == 0) {
+      dirac_mat(out, in);
+      return;
+    }
+
     const double alpha = pow(cheby_param[0], 2);
     const double beta  = pow(cheby_param[1]+fabs(shift), 2);
 
@@ -28,10 +33,11 @@ namespace quda {
     bool reset1 = newTmp( &tmp1, in);
     bool reset2 = newTmp( &tmp2, in);
 
-    *(tmp2) = in;
+    copy(*tmp2, in);
     dirac_mat( *(tmp1), in);
 
-    axpby(-0.5*c1, const_cast<cudaColorSpinorField&>(in), 0.5*c0*c1, *(tmp1));
+    axpby(-0.5*c1, const_cast<ColorSpinorField&>(in), 0.5*c0*c1, *(tmp1));
+    if (N_Poly == 1) copy(out, *tmp1);
     for(int i=2; i < N_Poly+1; ++i)
     {
       dirac_mat(out,*(tmp1));
@@ -43,10 +49,10 @@ namespace quda {
       {
         // tmp2 = tmp
         // tmp = out
-        cudaColorSpinorField *swap_Tmp = tmp2;
+        ColorSpinorField *swap_Tmp = tmp2;
         tmp2 = tmp1;
         tmp1 = swap_Tmp;
-        *(tmp1) = out;
+        copy(*tmp1, out);
       }
     }
     deleteTmp(&(tmp1), reset1);
@@ -54,15 +60,15 @@ namespace quda {
 
   }
   RitzMat::~RitzMat() {;}
-  bool RitzMat::newTmp(cudaColorSpinorField **tmp, const cudaColorSpinorField &a) const{
+  bool RitzMat::newTmp(ColorSpinorField **tmp, const ColorSpinorField &a) const{
     if (*tmp) return false;
     ColorSpinorParam param(a);
     param.create = QUDA_ZERO_FIELD_CREATE;
-    *tmp = new cudaColorSpinorField(a, param);
+    *tmp = ColorSpinorField::Create(param);
     return true;
   }
 
-  void RitzMat::deleteTmp(cudaColorSpinorField **a, const bool &reset) const{
+  void RitzMat::deleteTmp(ColorSpinorField **a, const bool &reset) const{
     if (reset) {
       delete *a;
       *a = NULL;
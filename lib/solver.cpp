@@ -26,6 +26,10 @@ namespace quda {
       report("CG");
       solver = new CG(mat, matSloppy, param, profile);
       break;
+    case QUDA_PIPECG_INVERTER:
+      report("PipelinedCG");
+      solver = new PipelinedCG(mat, matSloppy, param, profile);
+      break;
     case QUDA_BICGSTAB_INVERTER:
       report("BiCGstab");
       solver = new BiCGstab(mat, matSloppy, matPrecon, param, profile);
@@ -67,6 +71,9 @@ namespace quda {
       report("MPBICGSTAB");
       solver = new MPBiCGstab(mat, param, profile);
       break;
+    case QUDA_BLOCKCG_INVERTER:
+      errorQuda("Block CG solves a block of sources at once and is only supported by invertMultiSrcQuda");
+      break;
     default:
       errorQuda("Invalid solver type %d", param.inv_type);
     }
@@ -0,0 +1,127 @@
+#include <quda_internal.h>
+#include <gauge_field.h>
+#include <gauge_field_order.h>
+#include <quda_matrix.h>
+#include <index_helper.cuh>
+#include <staggered_oprod.h>
+
+namespace quda {
+
+#ifdef GPU_STAGGERED_OPROD
+
+  using namespace gauge;
+
+  template <typename Float, typename Output>
+  struct StaggeredOprodCPUArg {
+    Output outA;
+    Output outB;
+    const Float * const *quark;
+    int num_terms;
+    double * const *coeff;
+    int X[4];
+    int volumeCB;
+
+    StaggeredOprodCPUArg(const Output &outA, const Output &outB, const GaugeField &meta,
+                         const Float * const *quark, int num_terms, double * const *coeff)
+      : outA(outA), outB(outB), quark(quark), num_terms(num_terms), coeff(coeff), volumeCB(meta.VolumeCB()) {
+      for (int d=0; d<4; d++) X[d] = meta.X()[d];
+    }
+  };
+
+  /**
+     Accumulate the one- and three-hop outer products of every quark
+     term at a single site, so that each output link is read and
+     written once regardless of the number of terms.
+   */
+  template <typename Float, typename Output>
+  void staggeredOprodSite(StaggeredOprodCPUArg<Float,Output> &arg, int x_cb, int parity) {
+    typedef typename ComplexTypeId<Float>::Type Cmplx;
+
+    int x[4];
+    getCoords(x, x_cb, arg.X, parity);
+    const int site = parity*arg.volumeCB + x_cb;
+
+    for (int dir=0; dir<4; dir++) {
+      int dx[4] = {0, 0, 0, 0};
+      dx[dir] = 1;
+      const int first = (1-parity)*arg.volumeCB + linkIndexShift(x, dx, arg.X);
+      dx[dir] = 3;
+      const int third = (1-parity)*arg.volumeCB + linkIndexShift(x, dx, arg.X);
+
+      Matrix<Cmplx,3> A, B;
+      setZero(&A);
+      setZero(&B);
+
+      for (int t=0; t<arg.num_terms; t++) {
+        const Cmplx *q = reinterpret_cast<const Cmplx*>(arg.quark[t]);
+        const Float c1 = arg.coeff[t][0];
+        const Float c3 = arg.coeff[t][1];
+        for (int i=0; i<3; i++) {
+          const Cmplx b = Conj(q[3*site + i]);
+          for (int j=0; j<3; j++) {
+            A(j,i) += (c1*q[3*first + j])*b;
+            B(j,i) += (c3*q[3*third + j])*b;
+          }
+        }
+      }
+
+      Matrix<Cmplx,3> O;
+      arg.outA.load((Float*)(O.data), x_cb, dir, parity);
+      O += A;
+      arg.outA.save((Float*)(O.data), x_cb, dir, parity);
+      arg.outB.load((Float*)(O.data), x_cb, dir, parity);
+      O += B;
+      arg.outB.save((Float*)(O.data), x_cb, dir, parity);
+    }
+  }
+
+  template <typename Float, typename Output>
+  void computeStaggeredOprodCPU(const Output &outA, const Output &outB, const GaugeField &meta,
+                                void **quark, int num_terms, double **coeff) {
+    StaggeredOprodCPUArg<Float,Output> arg(outA, outB, meta, (const Float* const*)quark, num_terms, coeff);
+#pragma omp parallel for
+    for (int i=0; i<2*arg.volumeCB; i++) {
+      const int parity = i / arg.volumeCB;
+      staggeredOprodSite<Float>(arg, i - parity*arg.volumeCB, parity);
+    }
+  }
+
+  template <typename Float>
+  void computeStaggeredOprodCPU(cpuGaugeField &outA, cpuGaugeField &outB, void **quark, int num_terms, double **coeff) {
+    if (outA.Order() == QUDA_QDP_GAUGE_ORDER) {
+      computeStaggeredOprodCPU<Float>(QDPOrder<Float,18>(outA), QDPOrder<Float,18>(outB), outA, quark, num_terms, coeff);
+    } else if (outA.Order() == QUDA_MILC_GAUGE_ORDER) {
+      computeStaggeredOprodCPU<Float>(MILCOrder<Float,18>(outA), MILCOrder<Float,18>(outB), outA, quark, num_terms, coeff);
+    } else {
+      errorQuda("Gauge field order %d not supported", outA.Order());
+    }
+  }
+
+#endif // GPU_STAGGERED_OPROD
+
+  void computeStaggeredOprod(cpuGaugeField &outA, cpuGaugeField &outB, void **quark, int num_terms, double **coeff)
+  {
+#ifdef GPU_STAGGERED_OPROD
+    if (outA.Precision() != outB.Precision() || outA.Order() != outB.Order())
+      errorQuda("Outer-product fields must have matching precision and order");
+
+    for (int d=0; d<4; d++) {
+      if (outA.X()[d] != outB.X()[d]) errorQuda("Outer-product field dimensions do not match");
+#ifdef MULTI_GPU
+      if (commDimPartitioned(d)) errorQuda("Host staggered outer product does not support partitioned dimension %d", d);
+#endif
+    }
+
+    if (outA.Precision() == QUDA_DOUBLE_PRECISION) {
+      computeStaggeredOprodCPU<double>(outA, outB, quark, num_terms, coeff);
+    } else if (outA.Precision() == QUDA_SINGLE_PRECISION) {
+      computeStaggeredOprodCPU<float>(outA, outB, quark, num_terms, coeff);
+    } else {
+      errorQuda("Precision %d not supported", outA.Precision());
+    }
+#else
+    errorQuda("Staggered oprod has not been built");
+#endif
+  }
+
+} // namespace quda
@@ -35,7 +35,8 @@ namespace quda {
   }
 
   std::string TimeProfile::pname[] = { "download",  "upload", "init", "preamble", "compute", 
-				       "epilogue", "free", "dummy", "pack kernel", "dslash kernel", 
+				       "epilogue", "free", "fingerprint", "resident hit", "wait", "dummy",
+				       "pack kernel", "dslash kernel", 
 				       "gather", "scatter", "event record", 
 				       "event query", "stream wait event", 
 				       "comms", "comms start", "comms query", "constant", "file i/o",
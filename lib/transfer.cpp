@@ -20,7 +20,7 @@ namespace quda {
 
   Transfer::Transfer(const std::vector<ColorSpinorField*> &B, int Nvec, int *geo_bs, int spin_bs,
 		     bool enable_gpu, TimeProfile &profile)
-    : B(B), Nvec(Nvec), V_h(0), V_d(0), fine_tmp_h(0), fine_tmp_d(0), coarse_tmp_h(0), coarse_tmp_d(0), geo_bs(0),
+    : B(B), Nvec(Nvec), V_h(0), V_d(0), V_c(0), fine_tmp_h(0), fine_tmp_d(0), coarse_tmp_h(0), coarse_tmp_d(0), geo_bs(0),
       fine_to_coarse_h(0), coarse_to_fine_h(0), 
       fine_to_coarse_d(0), coarse_to_fine_d(0), 
       spin_bs(spin_bs), spin_map(0),
@@ -132,6 +132,30 @@ namespace quda {
     }
   }
 
+  void Transfer::CompressVectors(int block_sites) {
+    if (V_c) return;
+    V_c = new CompressedVectorSet(*V_h, 1, block_sites);
+    V_c->Compress(0, *V_h);
+    printfQuda("Transfer: compressed prolongator from %lu to %lu bytes\n", V_h->Bytes(), V_c->Bytes());
+    delete V_h;
+    V_h = 0;
+  }
+
+  const ColorSpinorField& Transfer::Vectors() const {
+    if (!V_h) errorQuda("Prolongator is compressed, use DecompressedVectors() instead");
+    return *V_h;
+  }
+
+  ColorSpinorField* Transfer::DecompressedVectors() const {
+    ColorSpinorParam param(V_c ? V_c->Param() : ColorSpinorParam(*V_h));
+    param.location = QUDA_CPU_FIELD_LOCATION;
+    param.create = QUDA_NULL_FIELD_CREATE;
+    ColorSpinorField *V = ColorSpinorField::Create(param);
+    if (V_c) V_c->Decompress(*V, 0);
+    else *V = *V_h;
+    return V;
+  }
+
   Transfer::~Transfer() {
     if (spin_map) host_free(spin_map);
     if (coarse_to_fine_d) device_free(coarse_to_fine_d);
@@ -140,6 +164,7 @@ namespace quda {
     if (fine_to_coarse_h) host_free(fine_to_coarse_h);
     if (V_h) delete V_h;
     if (V_d) delete V_d;
+    if (V_c) delete V_c;
 
     if (fine_tmp_h) delete fine_tmp_h;
     if (fine_tmp_d) delete fine_tmp_d;
@@ -220,6 +245,9 @@ namespace quda {
     ColorSpinorField *output = &out;
     const ColorSpinorField *V = use_gpu ? V_d : V_h;
     const int *fine_to_coarse = use_gpu ? fine_to_coarse_d : fine_to_coarse_h;
+    const bool compressed = !use_gpu && V_c;
+    const QudaGammaBasis basis = compressed ? V_c->Param().gammaBasis : V->GammaBasis();
+    const int nSpin = compressed ? V_c->Param().nSpin : V->Nspin();
 
     if (use_gpu) {
       if (in.Location() == QUDA_CPU_FIELD_LOCATION) input = coarse_tmp_d;
@@ -232,12 +260,13 @@ namespace quda {
 
     *input = in; // copy result to input field (aliasing handled automatically)
     
-    if ((V->Nspin() != 1) && ((output->GammaBasis() != V->GammaBasis()) || (input->GammaBasis() != V->GammaBasis()))){
+    if ((nSpin != 1) && ((output->GammaBasis() != basis) || (input->GammaBasis() != basis))){
       errorQuda("Cannot apply prolongator using fields in a different basis from the null space (%d,%d) != %d",
-		output->GammaBasis(), in.GammaBasis(), V->GammaBasis());
+		output->GammaBasis(), in.GammaBasis(), basis);
     }
 
-    Prolongate(*output, *input, *V, Nvec, fine_to_coarse, spin_map);
+    if (compressed) Prolongate(*output, *input, *V_c, Nvec, fine_to_coarse, spin_map);
+    else Prolongate(*output, *input, *V, Nvec, fine_to_coarse, spin_map);
 
     out = *output; // copy result to out field (aliasing handled automatically)
 
@@ -253,6 +282,9 @@ namespace quda {
     const ColorSpinorField *V = use_gpu ? V_d : V_h;
     const int *fine_to_coarse = use_gpu ? fine_to_coarse_d : fine_to_coarse_h;
     const int *coarse_to_fine = use_gpu ? coarse_to_fine_d : coarse_to_fine_h;
+    const bool compressed = !use_gpu && V_c;
+    const QudaGammaBasis basis = compressed ? V_c->Param().gammaBasis : V->GammaBasis();
+    const int nSpin = compressed ? V_c->Param().nSpin : V->Nspin();
 
     if (use_gpu) {
       if (out.Location() == QUDA_CPU_FIELD_LOCATION) output = coarse_tmp_d;
@@ -265,11 +297,12 @@ namespace quda {
 
     *input = in; // copy result to input field (aliasing handled automatically)  
     
-    if ( V->Nspin() != 1 && ( output->GammaBasis() != V->GammaBasis() || input->GammaBasis() != V->GammaBasis() ) )
+    if ( nSpin != 1 && ( output->GammaBasis() != basis || input->GammaBasis() != basis ) )
       errorQuda("Cannot apply restrictor using fields in a different basis from the null space (%d,%d) != %d",
-		out.GammaBasis(), input->GammaBasis(), V->GammaBasis());
+		out.GammaBasis(), input->GammaBasis(), basis);
 
-    Restrict(*output, *input, *V, Nvec, fine_to_coarse, coarse_to_fine, spin_map);
+    if (compressed) Restrict(*output, *input, *V_c, Nvec, fine_to_coarse, coarse_to_fine, spin_map);
+    else Restrict(*output, *input, *V, Nvec, fine_to_coarse, coarse_to_fine, spin_map);
 
     out = *output; // copy result to out field (aliasing handled automatically)
 
@@ -554,51 +554,60 @@ static double HOST_REUNIT_SVD_ABS_ERROR;
     } // getUnitarizeForceField
 
 
-    void unitarizeForceCPU(cpuGaugeField& cpuOldForce, cpuGaugeField& cpuGauge, cpuGaugeField* cpuNewForce)
+    void unitarizeForceCPU(cpuGaugeField& cpuOldForce, cpuGaugeField& cpuGauge, cpuGaugeField* cpuNewForce,
+			   int* unitarization_failed)
     {
       
       int num_failures = 0;	
-      Matrix<double2,3> old_force, new_force, v;
 
       // I can change this code to make it much more compact
 
       const QudaGaugeFieldOrder order = cpuGauge.Order();
 
       if(order == QUDA_MILC_GAUGE_ORDER){
+#pragma omp parallel for reduction(+:num_failures)
         for(int i=0; i<cpuGauge.Volume(); ++i){
+          Matrix<double2,3> old_force, new_force, v;
+          int site_failures = 0;
 	  for(int dir=0; dir<4; ++dir){
 	    if(cpuGauge.Precision() == QUDA_SINGLE_PRECISION){
 	      copyArrayToLink(&old_force, ((float*)(cpuOldForce.Gauge_p()) + (i*4 + dir)*18)); 
 	      copyArrayToLink(&v, ((float*)(cpuGauge.Gauge_p()) + (i*4 + dir)*18)); 
-	      getUnitarizeForceSite<double2>(v, old_force, &new_force, &num_failures);
+	      getUnitarizeForceSite<double2>(v, old_force, &new_force, &site_failures);
 	      copyLinkToArray(((float*)(cpuNewForce->Gauge_p()) + (i*4 + dir)*18), new_force); 
 	    }else if(cpuGauge.Precision() == QUDA_DOUBLE_PRECISION){
 	      copyArrayToLink(&old_force, ((double*)(cpuOldForce.Gauge_p()) + (i*4 + dir)*18)); 
 	      copyArrayToLink(&v, ((double*)(cpuGauge.Gauge_p()) + (i*4 + dir)*18)); 
-	      getUnitarizeForceSite<double2>(v, old_force, &new_force, &num_failures);
+	      getUnitarizeForceSite<double2>(v, old_force, &new_force, &site_failures);
 	      copyLinkToArray(((double*)(cpuNewForce->Gauge_p()) + (i*4 + dir)*18), new_force); 
 	    } // precision?
 	  } // dir
+          num_failures += site_failures;
         } // i
       }else if(order == QUDA_QDP_GAUGE_ORDER){
         for(int dir=0; dir<4; ++dir){
+#pragma omp parallel for reduction(+:num_failures)
           for(int i=0; i<cpuGauge.Volume(); ++i){
+            Matrix<double2,3> old_force, new_force, v;
+            int site_failures = 0;
 	    if(cpuGauge.Precision() == QUDA_SINGLE_PRECISION){
 	      copyArrayToLink(&old_force, ((float**)(cpuOldForce.Gauge_p()))[dir] + i*18);
 	      copyArrayToLink(&v, ((float**)(cpuGauge.Gauge_p()))[dir] + i*18);
-	      getUnitarizeForceSite<double2>(v, old_force, &new_force, &num_failures);
+	      getUnitarizeForceSite<double2>(v, old_force, &new_force, &site_failures);
 	      copyLinkToArray(((float**)(cpuNewForce->Gauge_p()))[dir] + i*18, new_force);
 	    }else if(cpuGauge.Precision() == QUDA_DOUBLE_PRECISION){
 	      copyArrayToLink(&old_force, ((double**)(cpuOldForce.Gauge_p()))[dir] + i*18);
 	      copyArrayToLink(&v, ((double**)(cpuGauge.Gauge_p()))[dir] + i*18);
-	      getUnitarizeForceSite<double2>(v, old_force, &new_force, &num_failures);
+	      getUnitarizeForceSite<double2>(v, old_force, &new_force, &site_failures);
 	      copyLinkToArray(((double**)(cpuNewForce->Gauge_p()))[dir] + i*18, new_force);
 	    }
+            num_failures += site_failures;
           }
         }
       }else{
         errorQuda("Only MILC and QDP gauge orders supported\n");
       }
+      if (unitarization_failed) *unitarization_failed = num_failures;
       return;
     } // unitarize_force_cpu
 
@@ -0,0 +1,141 @@
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <math.h>
+#include <vector>
+#include <algorithm>
+
+#include <quda.h>
+#include <quda_internal.h>
+#include <gauge_field.h>
+#include <color_spinor_field.h>
+#include <multigrid.h>
+#include <comm_quda.h>
+#include <test_util.h>
+#include <gtest.h>
+
+using namespace quda;
+
+extern int xdim;
+extern int ydim;
+extern int zdim;
+extern int tdim;
+extern int gridsize_from_cmdline[];
+
+// Checks the dense coarse operator assembled by CoarseMatrix, which
+// the coarse-grid LU solver factorizes, against ApplyCoarse: column j
+// of the matrix must equal the coarse operator applied to the j-th
+// unit vector, for random coarse link and clover fields on host.
+
+const int coarse_spin = 2;
+const int coarse_color = 4;
+const double kappa = 0.1;
+
+static void fillRandom(GaugeField &u) {
+  const size_t reals = (size_t)u.Volume() * 2 * u.Ncolor() * u.Ncolor();
+  for (int d=0; d<u.Geometry(); d++) {
+    void *v = ((void**)u.Gauge_p())[d];
+    for (size_t i=0; i<reals; i++) {
+      double r = rand() / (double)RAND_MAX - 0.5;
+      if (u.Precision() == QUDA_DOUBLE_PRECISION) ((double*)v)[i] = r;
+      else ((float*)v)[i] = r;
+    }
+  }
+}
+
+class CoarseMatrixTest : public ::testing::TestWithParam<QudaPrecision> { };
+
+TEST_P(CoarseMatrixTest, unitVectors) {
+  const QudaPrecision precision = GetParam();
+
+  GaugeFieldParam gParam;
+  gParam.x[0] = xdim; gParam.x[1] = ydim; gParam.x[2] = zdim; gParam.x[3] = tdim;
+  gParam.nColor = coarse_spin*coarse_color;
+  gParam.reconstruct = QUDA_RECONSTRUCT_NO;
+  gParam.order = QUDA_QDP_GAUGE_ORDER;
+  gParam.link_type = QUDA_COARSE_LINKS;
+  gParam.t_boundary = QUDA_PERIODIC_T;
+  gParam.create = QUDA_ZERO_FIELD_CREATE;
+  gParam.precision = precision;
+  gParam.nDim = 4;
+  gParam.siteSubset = QUDA_FULL_SITE_SUBSET;
+  gParam.ghostExchange = QUDA_GHOST_EXCHANGE_PAD;
+  gParam.nFace = 1;
+
+  gParam.geometry = QUDA_VECTOR_GEOMETRY;
+  cpuGaugeField Y(gParam);
+  gParam.geometry = QUDA_SCALAR_GEOMETRY;
+  cpuGaugeField X(gParam);
+  fillRandom(Y);
+  fillRandom(X);
+
+  ColorSpinorParam param;
+  param.location = QUDA_CPU_FIELD_LOCATION;
+  param.nColor = coarse_color;
+  param.nSpin = coarse_spin;
+  param.nDim = 4;
+  param.x[0] = xdim; param.x[1] = ydim; param.x[2] = zdim; param.x[3] = tdim;
+  param.precision = precision;
+  param.pad = 0;
+  param.fieldOrder = QUDA_SPACE_SPIN_COLOR_FIELD_ORDER;
+  param.siteSubset = QUDA_FULL_SITE_SUBSET;
+  param.siteOrder = QUDA_EVEN_ODD_SITE_ORDER;
+  param.gammaBasis = QUDA_DEGRAND_ROSSI_GAMMA_BASIS;
+  param.twistFlavor = QUDA_TWIST_NO;
+  param.PCtype = QUDA_4D_PC;
+  param.create = QUDA_ZERO_FIELD_CREATE;
+  cpuColorSpinorField e(param), Ae(param);
+
+  const int n = e.Length() / 2; // matrix order
+  std::vector<Complex> A((size_t)n*n, Complex(0.0, 0.0));
+  CoarseMatrix(&A[0], n, Y, X, kappa);
+
+  const double tol = precision == QUDA_DOUBLE_PRECISION ? 1e-12 : 1e-5;
+  double max_dev = 0.0;
+  for (int j=0; j<n; j++) {
+    memset(e.V(), 0, e.Bytes());
+    if (precision == QUDA_DOUBLE_PRECISION) static_cast<double*>(e.V())[2*j] = 1.0;
+    else static_cast<float*>(e.V())[2*j] = 1.0;
+
+    ApplyCoarse(Ae, e, e, Y, X, kappa);
+
+    for (int i=0; i<n; i++) {
+      Complex ae;
+      if (precision == QUDA_DOUBLE_PRECISION) {
+	const double *v = static_cast<const double*>(Ae.V());
+	ae = Complex(v[2*i], v[2*i+1]);
+      } else {
+	const float *v = static_cast<const float*>(Ae.V());
+	ae = Complex(v[2*i], v[2*i+1]);
+      }
+      max_dev = std::max(max_dev, abs(ae - A[i + (size_t)j*n]));
+    }
+  }
+
+  printfQuda("order %d: maximum deviation = %e\n", n, max_dev);
+  EXPECT_LT(max_dev, tol);
+}
+
+INSTANTIATE_TEST_CASE_P(Double, CoarseMatrixTest, ::testing::Values(QUDA_DOUBLE_PRECISION));
+INSTANTIATE_TEST_CASE_P(Single, CoarseMatrixTest, ::testing::Values(QUDA_SINGLE_PRECISION));
+
+int main(int argc, char **argv) {
+  // initalize google test, includes command line options
+  ::testing::InitGoogleTest(&argc, argv);
+  // the dense matrix has order 8 V, so keep the default lattice small
+  xdim=ydim=zdim=tdim=4;
+  for (int i=1; i<argc; i++){
+    if(process_command_line_option(argc, argv, &i) == 0){
+      continue;
+    }
+    fprintf(stderr, "ERROR: Invalid option:%s\n", argv[i]);
+  }
+
+  initComms(argc, argv, gridsize_from_cmdline);
+  if (comm_size() > 1) errorQuda("coarse_matrix_test requires a single process");
+
+  int test_rc = RUN_ALL_TESTS();
+  finalizeComms();
+
+  return test_rc;
+}
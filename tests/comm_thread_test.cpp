@@ -0,0 +1,161 @@
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <pthread.h>
+#include <vector>
+
+#include <quda_internal.h>
+#include <comm_quda.h>
+
+// Exercises the threaded communications layer, in which every rank
+// is a thread created by comm_thread_run().  Each rank repeatedly
+// exchanges contiguous and strided messages with its neighbours in
+// the partitioned dimensions, and checks allreduce and broadcast.
+// The checks catch messages that are lost or matched out of order;
+// to also check for data races in the layer, build QUDA and this test
+// with -fsanitize=thread (e.g., CXXFLAGS="-g -O1 -fsanitize=thread")
+// and run it as usual.
+
+#ifndef THREAD_COMMS
+#error "comm_thread_test requires the threaded communications layer (THREAD_COMMS)"
+#endif
+
+static const int grid[4] = {2, 1, 1, 2};
+static const int iterations = 200;
+static const int length = 100;
+
+static int failures = 0;
+static pthread_mutex_t failure_lock = PTHREAD_MUTEX_INITIALIZER;
+
+static void fail(const char *check, int rank, int iter) {
+  pthread_mutex_lock(&failure_lock);
+  if (failures < 10) printf("Rank %d: %s check failed in iteration %d\n", rank, check, iter);
+  failures++;
+  pthread_mutex_unlock(&failure_lock);
+}
+
+static int lexRank(const int *coords, void *) {
+  int rank = coords[0];
+  for (int d=1; d<4; d++) rank = rank*grid[d] + coords[d];
+  return rank;
+}
+
+static int neighbour(int dim, int dir) {
+  int displacement[4] = {0, 0, 0, 0};
+  displacement[dim] = dir;
+  return comm_rank_displaced(comm_default_topology(), displacement);
+}
+
+// value sent by rank in the given direction, distinct for every message
+static double message(int rank, int iter, int dim, int dir) {
+  return dir * (1000.0*rank + 10.0*iter + dim + 1);
+}
+
+static void exchange(int rank, int iter) {
+  for (int dim=0; dim<4; dim++) {
+    if (!comm_dim_partitioned(dim)) continue;
+
+    std::vector<double> send_fwd(length, message(rank, iter, dim, +1));
+    std::vector<double> send_back(length, message(rank, iter, dim, -1));
+    std::vector<double> recv_fwd(length, 0.0), recv_back(length, 0.0);
+    const size_t bytes = length*sizeof(double);
+
+    MsgHandle *mh_recv_back = comm_declare_receive_relative(&recv_back[0], dim, -1, bytes);
+    MsgHandle *mh_recv_fwd = comm_declare_receive_relative(&recv_fwd[0], dim, +1, bytes);
+    MsgHandle *mh_send_fwd = comm_declare_send_relative(&send_fwd[0], dim, +1, bytes);
+    MsgHandle *mh_send_back = comm_declare_send_relative(&send_back[0], dim, -1, bytes);
+
+    comm_start(mh_recv_back);
+    comm_start(mh_recv_fwd);
+    comm_start(mh_send_fwd);
+    comm_start(mh_send_back);
+
+    comm_wait(mh_send_fwd);
+    comm_wait(mh_send_back);
+    comm_wait(mh_recv_back);
+    comm_wait(mh_recv_fwd);
+
+    // the backward neighbour sent forwards and vice versa
+    for (int i=0; i<length; i++) {
+      if (recv_back[i] != message(neighbour(dim, -1), iter, dim, +1)) { fail("exchange", rank, iter); break; }
+      if (recv_fwd[i] != message(neighbour(dim, +1), iter, dim, -1)) { fail("exchange", rank, iter); break; }
+    }
+
+    comm_free(mh_recv_back);
+    comm_free(mh_recv_fwd);
+    comm_free(mh_send_fwd);
+    comm_free(mh_send_back);
+  }
+}
+
+// strided send of every other element into a contiguous receive
+static void exchangeStrided(int rank, int iter) {
+  for (int dim=0; dim<4; dim++) {
+    if (!comm_dim_partitioned(dim)) continue;
+
+    std::vector<double> send(2*length, -1.0);
+    for (int i=0; i<length; i++) send[2*i] = message(rank, iter, dim, +1) + i;
+    std::vector<double> recv(length, 0.0);
+
+    MsgHandle *mh_recv = comm_declare_receive_relative(&recv[0], dim, -1, length*sizeof(double));
+    MsgHandle *mh_send = comm_declare_strided_send_relative(&send[0], dim, +1, sizeof(double), length,
+							    2*sizeof(double));
+    comm_start(mh_send);
+    comm_start(mh_recv);
+    comm_wait(mh_recv);
+    comm_wait(mh_send);
+
+    for (int i=0; i<length; i++) {
+      if (recv[i] != message(neighbour(dim, -1), iter, dim, +1) + i) { fail("strided exchange", rank, iter); break; }
+    }
+
+    comm_free(mh_recv);
+    comm_free(mh_send);
+  }
+}
+
+static void collectives(int rank, int iter) {
+  const int size = comm_size();
+
+  double sum = rank + 1;
+  comm_allreduce(&sum);
+  if (sum != 0.5*size*(size+1)) fail("allreduce", rank, iter);
+
+  double max = rank;
+  comm_allreduce_max(&max);
+  if (max != size-1) fail("allreduce_max", rank, iter);
+
+  double array[3] = { 1.0, (double)rank, (double)iter };
+  comm_allreduce_array(array, 3);
+  if (array[0] != size || array[1] != 0.5*size*(size-1) || array[2] != (double)size*iter)
+    fail("allreduce_array", rank, iter);
+
+  int count = 1;
+  comm_allreduce_int(&count);
+  if (count != size) fail("allreduce_int", rank, iter);
+
+  int value = rank == 0 ? 42 + iter : -1;
+  comm_broadcast(&value, sizeof(int));
+  if (value != 42 + iter) fail("broadcast", rank, iter);
+
+  comm_barrier();
+}
+
+static void rankMain(void *) {
+  initCommsGridQuda(4, grid, lexRank, NULL);
+  const int rank = comm_rank();
+
+  for (int iter=0; iter<iterations; iter++) {
+    exchange(rank, iter);
+    exchangeStrided(rank, iter);
+    collectives(rank, iter);
+  }
+}
+
+int main(int argc, char **argv) {
+  const int size = grid[0]*grid[1]*grid[2]*grid[3];
+  comm_thread_run(size, rankMain, NULL);
+
+  printf("%d ranks, %d iterations: %s (%d failures)\n", size, iterations, failures ? "FAILED" : "PASSED", failures);
+  return failures ? 1 : 0;
+}
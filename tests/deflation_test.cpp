@@ -44,6 +44,7 @@ extern QudaPrecision  prec_sloppy;
 extern double tol; // tolerance for inverter
 
 extern QudaInverterType inv_type; // solver type
+extern QudaDenseLinalgBackend dense_linalg; // dense linear algebra of the deflated solvers
 
 extern double mass; // mass of Dirac operator
 extern double anisotropy;
@@ -189,6 +190,7 @@ int main(int argc, char **argv)
 
   //! For deflated solvers only:
   inv_param.inv_type = inv_type;
+  if (dense_linalg != QUDA_INVALID_DENSE_LINALG) inv_param.dense_linalg = dense_linalg;
 
   inv_param.rhs_idx = 0;
 
@@ -380,11 +382,15 @@ int main(int argc, char **argv)
   // initialize the QUDA library
   initQuda(device);
 
-  printfQuda("\nOpen MAGMA...\n");
+  printfQuda("\nDense linear algebra backend: %s\n", get_dense_linalg_str(inv_param.dense_linalg));
 
-  openMagma();
+  if (inv_param.dense_linalg == QUDA_MAGMA_DENSE_LINALG) {
+    printfQuda("\nOpen MAGMA...\n");
 
-  printfQuda("\n...done.\n");
+    openMagma();
+
+    printfQuda("\n...done.\n");
+  }
 
   // load the gauge field
   loadGaugeQuda((void*)gauge, &gauge_param);
@@ -464,7 +470,7 @@ int main(int argc, char **argv)
 
   destroyDeflationQuda(&inv_param, NULL, NULL, NULL);
 
-  closeMagma();
+  if (inv_param.dense_linalg == QUDA_MAGMA_DENSE_LINALG) closeMagma();
     
   printfQuda("Device memory used:\n   Spinor: %f GiB\n    Gauge: %f GiB\n", 
 	 inv_param.spinorGiB, gauge_param.gaugeGiB);
@@ -0,0 +1,288 @@
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <math.h>
+#include <vector>
+#include <algorithm>
+
+#include <quda.h>
+#include <quda_internal.h>
+#include <dense_linalg.h>
+#include <blas_magma.h>
+#include <util_quda.h>
+
+#include <test_util.h>
+
+// google test frame work
+#include <gtest.h>
+
+using namespace quda;
+
+extern int device;
+extern int gridsize_from_cmdline[];
+
+// Checks the dense linear algebra used by the deflated solvers.  Each
+// BlasMagmaArgs routine is run with every available backend and
+// checked through the residual of its result; when QUDA is built with
+// MAGMA, the results of the host backend are also compared against
+// those of MAGMA.  The time taken by each backend is reported, so the
+// backends can be benchmarked with --niter.
+
+extern int niter;
+
+static std::vector<QudaDenseLinalgBackend> backends() {
+  std::vector<QudaDenseLinalgBackend> b;
+  b.push_back(QUDA_HOST_DENSE_LINALG);
+#ifdef MAGMA_LIB
+  b.push_back(QUDA_MAGMA_DENSE_LINALG);
+#endif
+  return b;
+}
+
+static const char *backendName(QudaDenseLinalgBackend backend) {
+  return backend == QUDA_MAGMA_DENSE_LINALG ? "MAGMA" : "host";
+}
+
+static void fillRandom(Complex *A, int n) {
+  for (int i=0; i<n; i++) A[i] = Complex(rand() / (double)RAND_MAX - 0.5, rand() / (double)RAND_MAX - 0.5);
+}
+
+// matrices are passed to MAGMA in pinned memory
+static Complex *newMatrix(int n) { return static_cast<Complex*>(pinned_malloc(n*sizeof(Complex))); }
+
+TEST(BlasMagmaArgs, HEEVD) {
+  const int n = 96, ldm = 112;
+  std::vector<Complex> A(ldm*n);
+  fillRandom(&A[0], ldm*n);
+  for (int j=0; j<n; j++) {
+    for (int i=0; i<j; i++) A[j*ldm+i] = conj(A[i*ldm+j]);
+    A[j*ldm+j] = A[j*ldm+j].real();
+  }
+
+  std::vector<QudaDenseLinalgBackend> b = backends();
+  std::vector<std::vector<double> > evals(b.size(), std::vector<double>(n));
+  Complex *V = newMatrix(ldm*n);
+
+  for (unsigned int k=0; k<b.size(); k++) {
+    BlasMagmaArgs args(n, ldm, sizeof(double), b[k]);
+    Timer timer;
+    for (int iter=0; iter<niter; iter++) {
+      memcpy(V, &A[0], ldm*n*sizeof(Complex));
+      timer.Start(__func__, __FILE__, __LINE__);
+      args.MagmaHEEVD(V, &evals[k][0], n, true);
+      timer.Stop(__func__, __FILE__, __LINE__);
+    }
+    printfQuda("HEEVD n = %d, %s: %e seconds\n", n, backendName(b[k]), timer.time / niter);
+
+    // A v_j = lambda_j v_j with orthonormal v_j, and ascending eigenvalues
+    double max_res = 0.0, max_orth = 0.0;
+    for (int j=0; j<n; j++) {
+      if (j > 0) EXPECT_LE(evals[k][j-1], evals[k][j]);
+      for (int i=0; i<n; i++) {
+	Complex Av = 0.0;
+	for (int l=0; l<n; l++) Av += A[l*ldm+i] * V[j*ldm+l];
+	max_res = std::max(max_res, abs(Av - evals[k][j] * V[j*ldm+i]));
+      }
+      for (int l=0; l<=j; l++) {
+	Complex dot = 0.0;
+	for (int i=0; i<n; i++) dot += conj(V[l*ldm+i]) * V[j*ldm+i];
+	max_orth = std::max(max_orth, abs(dot - (l == j ? 1.0 : 0.0)));
+      }
+    }
+    EXPECT_LT(max_res, 1e-12 * n);
+    EXPECT_LT(max_orth, 1e-12 * n);
+  }
+
+  for (unsigned int k=1; k<b.size(); k++)
+    for (int j=0; j<n; j++) EXPECT_NEAR(evals[0][j], evals[k][j], 1e-12 * n);
+
+  host_free(V);
+}
+
+TEST(BlasMagmaArgs, SolveProjMatrix) {
+  const int n = 64, ldH = 72;
+  std::vector<Complex> H(ldH*n), b0(n);
+  fillRandom(&H[0], ldH*n);
+  for (int i=0; i<n; i++) H[i*ldH+i] += 2.0; // keep it well conditioned
+  fillRandom(&b0[0], n);
+
+  std::vector<QudaDenseLinalgBackend> b = backends();
+  std::vector<std::vector<Complex> > x(b.size(), std::vector<Complex>(n));
+  Complex *Hp = newMatrix(ldH*n);
+  Complex *xp = newMatrix(n);
+  memcpy(Hp, &H[0], ldH*n*sizeof(Complex));
+
+  for (unsigned int k=0; k<b.size(); k++) {
+    BlasMagmaArgs args(sizeof(double), b[k]);
+    Timer timer;
+    for (int iter=0; iter<niter; iter++) {
+      memcpy(xp, &b0[0], n*sizeof(Complex));
+      timer.Start(__func__, __FILE__, __LINE__);
+      args.SolveProjMatrix(xp, n, n, Hp, ldH);
+      timer.Stop(__func__, __FILE__, __LINE__);
+    }
+    printfQuda("SolveProjMatrix n = %d, %s: %e seconds\n", n, backendName(b[k]), timer.time / niter);
+    memcpy(&x[k][0], xp, n*sizeof(Complex));
+
+    // the matrix is left unchanged and H x = b
+    EXPECT_EQ(0, memcmp(Hp, &H[0], ldH*n*sizeof(Complex)));
+    double max_res = 0.0;
+    for (int i=0; i<n; i++) {
+      Complex Hx = 0.0;
+      for (int j=0; j<n; j++) Hx += H[j*ldH+i] * x[k][j];
+      max_res = std::max(max_res, abs(Hx - b0[i]));
+    }
+    EXPECT_LT(max_res, 1e-12 * n);
+  }
+
+  for (unsigned int k=1; k<b.size(); k++)
+    for (int i=0; i<n; i++) EXPECT_LT(abs(x[0][i] - x[k][i]), 1e-12 * n);
+
+  host_free(xp);
+  host_free(Hp);
+}
+
+TEST(BlasMagmaArgs, QR) {
+  const int m = 80, nev = 24, ldm = 96;
+  std::vector<Complex> A(ldm*nev);
+  fillRandom(&A[0], ldm*nev);
+
+  std::vector<QudaDenseLinalgBackend> b = backends();
+  std::vector<std::vector<Complex> > R(b.size(), std::vector<Complex>(ldm*nev));
+  Complex *QR = newMatrix(ldm*nev);
+  Complex *tau = newMatrix(nev);
+
+  for (unsigned int k=0; k<b.size(); k++) {
+    BlasMagmaArgs args(sizeof(double), b[k]);
+    memcpy(QR, &A[0], ldm*nev*sizeof(Complex));
+    args.ComputeQR(nev, QR, m, ldm, tau);
+
+    // Q^H A = R, with R in the upper triangle of the factorization
+    memcpy(&R[k][0], &A[0], ldm*nev*sizeof(Complex));
+    args.LeftConjZUNMQR(nev, nev, &R[k][0], m, ldm, QR, ldm, tau);
+    double max_dev = 0.0;
+    for (int j=0; j<nev; j++)
+      for (int i=0; i<m; i++) max_dev = std::max(max_dev, abs(R[k][j*ldm+i] - (i <= j ? QR[j*ldm+i] : 0.0)));
+    EXPECT_LT(max_dev, 1e-12 * m);
+  }
+
+  // the factorizations agree up to the phases of the rows of R
+  for (unsigned int k=1; k<b.size(); k++)
+    for (int j=0; j<nev; j++)
+      for (int i=0; i<=j; i++) EXPECT_NEAR(abs(R[0][j*ldm+i]), abs(R[k][j*ldm+i]), 1e-12 * m);
+
+  host_free(tau);
+  host_free(QR);
+}
+
+static bool lessComplex(const Complex &a, const Complex &b) {
+  return a.real() < b.real() || (a.real() == b.real() && a.imag() < b.imag());
+}
+
+TEST(BlasMagmaArgs, GEEV) {
+  const int m = 48, ldH = 56;
+  std::vector<Complex> A(ldH*m);
+  fillRandom(&A[0], ldH*m);
+
+  std::vector<QudaDenseLinalgBackend> b = backends();
+  std::vector<std::vector<Complex> > evals(b.size(), std::vector<Complex>(m));
+  Complex *H = newMatrix(ldH*m);
+  Complex *vr = newMatrix(ldH*m);
+
+  for (unsigned int k=0; k<b.size(); k++) {
+    BlasMagmaArgs args(sizeof(double), b[k]);
+    Timer timer;
+    for (int iter=0; iter<niter; iter++) {
+      memcpy(H, &A[0], ldH*m*sizeof(Complex));
+      timer.Start(__func__, __FILE__, __LINE__);
+      args.Compute_harmonic_matrix_eigenpairs(H, m, ldH, vr, &evals[k][0], ldH);
+      timer.Stop(__func__, __FILE__, __LINE__);
+    }
+    printfQuda("GEEV n = %d, %s: %e seconds\n", m, backendName(b[k]), timer.time / niter);
+
+    // A v_j = lambda_j v_j with unit v_j
+    double max_res = 0.0;
+    for (int j=0; j<m; j++) {
+      double v2 = 0.0;
+      for (int i=0; i<m; i++) {
+	Complex Av = 0.0;
+	for (int l=0; l<m; l++) Av += A[l*ldH+i] * vr[j*ldH+l];
+	max_res = std::max(max_res, abs(Av - evals[k][j] * vr[j*ldH+i]));
+	v2 += norm(vr[j*ldH+i]);
+      }
+      EXPECT_NEAR(1.0, v2, 1e-12 * m);
+    }
+    EXPECT_LT(max_res, 1e-11 * m);
+
+    std::sort(evals[k].begin(), evals[k].end(), lessComplex);
+  }
+
+  // the eigenvalues agree, each matched to the nearest one
+  for (unsigned int k=1; k<b.size(); k++) {
+    for (int j=0; j<m; j++) {
+      double min_dev = abs(evals[0][j] - evals[k][0]);
+      for (int i=1; i<m; i++) min_dev = std::min(min_dev, abs(evals[0][j] - evals[k][i]));
+      EXPECT_LT(min_dev, 1e-11 * m);
+    }
+  }
+
+  host_free(vr);
+  host_free(H);
+}
+
+template <typename Float>
+static void testRotateBasis() {
+  const int vlen = 3000, vld = 3072, m = 16, l = 10, ldt = 20;
+  std::vector<std::complex<Float> > V(vld*m), V0;
+  std::vector<Complex> T(ldt*m);
+  for (int i=0; i<vld*m; i++) V[i] = std::complex<Float>(rand() / (Float)RAND_MAX - 0.5, rand() / (Float)RAND_MAX - 0.5);
+  fillRandom(&T[0], ldt*m);
+  V0 = V;
+
+  rotateBasis(&V[0], sizeof(Float), vld, vlen, &T[0], ldt, m, l);
+
+  // V(:, 0:l) = V0(:, 0:m) T and the remaining columns are unchanged
+  const double tol = sizeof(Float) == sizeof(double) ? 1e-13 : 1e-5;
+  double max_dev = 0.0;
+  for (int j=0; j<l; j++) {
+    for (int s=0; s<vlen; s++) {
+      Complex sum = 0.0;
+      for (int i=0; i<m; i++) sum += Complex(V0[i*vld+s]) * T[j*ldt+i];
+      max_dev = std::max(max_dev, abs(sum - Complex(V[j*vld+s])));
+    }
+  }
+  EXPECT_LT(max_dev, tol * m);
+  for (int j=l; j<m; j++)
+    for (int s=0; s<vlen; s++) EXPECT_EQ(V0[j*vld+s], V[j*vld+s]);
+}
+
+TEST(rotateBasis, double) { testRotateBasis<double>(); }
+TEST(rotateBasis, single) { testRotateBasis<float>(); }
+
+int main(int argc, char **argv) {
+  // initalize google test, includes command line options
+  ::testing::InitGoogleTest(&argc, argv);
+  niter = 1;
+  for (int i=1; i<argc; i++){
+    if(process_command_line_option(argc, argv, &i) == 0){
+      continue;
+    }
+    fprintf(stderr, "ERROR: Invalid option:%s\n", argv[i]);
+  }
+
+  initComms(argc, argv, gridsize_from_cmdline);
+  initQuda(device);
+#ifdef MAGMA_LIB
+  openMagma();
+#endif
+
+  int test_rc = RUN_ALL_TESTS();
+
+#ifdef MAGMA_LIB
+  closeMagma();
+#endif
+  endQuda();
+  finalizeComms();
+
+  return test_rc;
+}
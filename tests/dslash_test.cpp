@@ -877,6 +877,31 @@ TEST(dslash, verify) {
   ASSERT_LE(deviation, tol) << "CPU and CUDA implementations do not agree";
 }
 
+// Applies the operator on the host spinor itself, which the Wilson
+// and clover operators do with host copies of the resident gauge and
+// clover fields, and compares with the reference implementation.
+TEST(dslash, host) {
+  if (transfer || !dirac) return;
+  if (dslash_type == QUDA_WILSON_DSLASH) {
+    if (test_type != 0 && test_type != 2) return;
+  } else if (dslash_type == QUDA_CLOVER_WILSON_DSLASH) {
+    if (test_type != 2) return;
+  } else {
+    return;
+  }
+
+  ColorSpinorParam param(*spinorRef);
+  param.create = QUDA_ZERO_FIELD_CREATE;
+  cpuColorSpinorField hostOut(param);
+
+  if (test_type == 0) dirac->Dslash(hostOut, *spinor, parity);
+  else dirac->M(hostOut, *spinor);
+
+  double deviation = pow(10, -(double)(cpuColorSpinorField::Compare(*spinorRef, hostOut)));
+  double tol = (inv_param.cpu_prec == QUDA_DOUBLE_PRECISION ? 1e-12 : 1e-3);
+  ASSERT_LE(deviation, tol) << "Host operator and reference implementation do not agree";
+}
+
 int main(int argc, char **argv)
 {
   // initalize google test, includes command line options
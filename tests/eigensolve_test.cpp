@@ -0,0 +1,214 @@
+#include <stdio.h>
+#include <stdlib.h>
+#include <math.h>
+#include <vector>
+
+#include <quda.h>
+#include <quda_internal.h>
+#include <color_spinor_field.h>
+#include <dirac_quda.h>
+#include <dense_linalg.h>
+#include <blas_quda.h>
+#include <util_quda.h>
+#include <comm_quda.h>
+
+#include <test_util.h>
+#include "misc.h"
+
+// google test frame work
+#include <gtest.h>
+
+using namespace quda;
+
+// Checks the dense symmetric eigensolver against a matrix with a known
+// spectrum, and the lowest eigenvalues computed by eigensolveQuda
+// (thick-restart Lanczos) for the even-odd preconditioned Wilson
+// M^dagger M on a small lattice against a dense eigensolve of the
+// same operator, built column by column from unit vectors, also for
+// the operator shifted by eigen_shift.
+
+QudaGaugeParam gauge_param;
+QudaInvertParam inv_param;
+
+Dirac *dirac = NULL;
+DiracMdagM *mat = NULL;
+
+const int nk = 4;
+const int np = 16;
+const double stop_residual = 1e-8;
+
+// lowest eigenvalues of the dense operator, computed once
+std::vector<double> evals_ref;
+
+TEST(symmetricEigensolve, tridiagonal) {
+  // the eigenvalues of the n x n tridiagonal Toeplitz matrix with
+  // diagonal a and off-diagonal b are a + 2 b cos(k pi / (n+1))
+  const int n = 50;
+  const double a = 2.0, b = -1.0;
+  std::vector<double> A(n*n, 0.0), evals(n), evecs(n*n);
+  for (int i=0; i<n; i++) {
+    A[i*n+i] = a;
+    if (i > 0) A[i*n+i-1] = A[(i-1)*n+i] = b;
+  }
+
+  symmetricEigensolve(&evals[0], &evecs[0], &A[0], n);
+
+  for (int k=0; k<n; k++) {
+    const double lambda = a + 2*b*cos((k+1)*M_PI/(n+1));
+    EXPECT_NEAR(lambda, evals[k], 1e-12);
+  }
+
+  // A v_j = lambda_j v_j with orthonormal v_j
+  for (int j=0; j<n; j++) {
+    for (int i=0; i<n; i++) {
+      double Av = 0.0;
+      for (int k=0; k<n; k++) Av += A[i*n+k] * evecs[k*n+j];
+      EXPECT_NEAR(evals[j]*evecs[i*n+j], Av, 1e-12);
+    }
+    for (int l=0; l<=j; l++) {
+      double dot = 0.0;
+      for (int i=0; i<n; i++) dot += evecs[i*n+l] * evecs[i*n+j];
+      EXPECT_NEAR(l == j ? 1.0 : 0.0, dot, 1e-12);
+    }
+  }
+}
+
+/**
+   Computes the lowest n eigenvalues of mat on host parity fields by
+   building the dense matrix H from its action on unit vectors.  The
+   Hermitian H = A + iB is embedded in the real symmetric matrix
+   [[A, -B], [B, A]], which has every eigenvalue of H twice.
+ */
+static void denseEigenvalues(std::vector<double> &evals, int n) {
+  if (comm_size() > 1) errorQuda("The dense reference requires a single process");
+
+  ColorSpinorParam cpuParam(NULL, inv_param, gauge_param.X, true);
+  cpuParam.create = QUDA_ZERO_FIELD_CREATE;
+  cpuColorSpinorField e(cpuParam), He(cpuParam);
+
+  const int N = e.Length() / 2; // complex dimension
+  const int M = 2*N;
+  std::vector<double> S(M*M), S_evals(M), S_evecs(M*M);
+
+  double *e_v = static_cast<double*>(e.V());
+  const double *He_v = static_cast<const double*>(He.V());
+  for (int j=0; j<N; j++) {
+    blas::zero(e);
+    e_v[2*j] = 1.0;
+    (*mat)(He, e);
+    for (int i=0; i<N; i++) {
+      const double re = He_v[2*i+0], im = He_v[2*i+1];
+      S[i*M+j] = re;
+      S[(i+N)*M+j+N] = re;
+      S[(i+N)*M+j] = im;
+      S[i*M+j+N] = -im;
+    }
+  }
+
+  symmetricEigensolve(&S_evals[0], &S_evecs[0], &S[0], M);
+
+  evals.resize(n);
+  for (int i=0; i<n; i++) evals[i] = S_evals[2*i];
+}
+
+/**
+   Runs eigensolveQuda for the nk lowest eigenpairs of M^dag M + shift
+   and checks them against the dense reference
+ */
+static void checkLowest(QudaFieldLocation location, double shift) {
+  QudaEigParam eig_param = newQudaEigParam();
+  eig_param.invert_param = &inv_param;
+  eig_param.RitzMat_lanczos = shift != 0.0 ? QUDA_MATPCDAG_MATPC_SHIFT_SOLUTION : QUDA_MATPCDAG_MATPC_SOLUTION;
+  eig_param.NPoly = 0;
+  eig_param.eigen_shift = shift;
+  eig_param.Stp_residual = stop_residual;
+  eig_param.nk = nk;
+  eig_param.np = np;
+  eig_param.f_size = nk + np;
+  eig_param.location = location;
+  eig_param.max_restarts = 1000;
+
+  ColorSpinorParam cpuParam(NULL, inv_param, gauge_param.X, true);
+  cpuParam.create = QUDA_ZERO_FIELD_CREATE;
+  std::vector<cpuColorSpinorField*> evecs(nk);
+  std::vector<void*> h_evecs(nk);
+  for (int k=0; k<nk; k++) {
+    evecs[k] = new cpuColorSpinorField(cpuParam);
+    h_evecs[k] = evecs[k]->V();
+  }
+  evecs[0]->Source(QUDA_RANDOM_SOURCE);
+
+  std::vector<double> evals(nk);
+  int nconv = eigensolveQuda(&h_evecs[0], &evals[0], &eig_param);
+  EXPECT_EQ(nk, nconv);
+
+  cpuColorSpinorField r(cpuParam);
+  for (int k=0; k<nk; k++) {
+    const double ref = evals_ref[k] + shift;
+    const double deviation = fabs(evals[k] - ref) / ref;
+    printfQuda("eigenvalue %d = %e, reference = %e, deviation = %e\n", k, evals[k], ref, deviation);
+    EXPECT_LT(deviation, 1e-7);
+
+    // the eigenvectors satisfy |A v - lambda v| <= tol lambda |v|
+    (*mat)(r, *evecs[k]);
+    blas::axpy(shift - evals[k], *evecs[k], r);
+    EXPECT_LT(sqrt(blas::norm2(r) / blas::norm2(*evecs[k])) / evals[k], 10*stop_residual);
+  }
+
+  for (int k=0; k<nk; k++) delete evecs[k];
+}
+
+class EigensolveTest : public ::testing::TestWithParam<QudaFieldLocation> { };
+
+TEST_P(EigensolveTest, lowest) {
+  checkLowest(GetParam(), 0.0);
+}
+
+// the shifted operator has the same eigenvectors, with the eigenvalues shifted
+TEST_P(EigensolveTest, shifted) {
+  checkLowest(GetParam(), 0.1);
+}
+
+INSTANTIATE_TEST_CASE_P(CPU, EigensolveTest, ::testing::Values(QUDA_CPU_FIELD_LOCATION));
+INSTANTIATE_TEST_CASE_P(CUDA, EigensolveTest, ::testing::Values(QUDA_CUDA_FIELD_LOCATION));
+
+int main(int argc, char **argv) {
+  // initalize google test, includes command line options
+  ::testing::InitGoogleTest(&argc, argv);
+  // the dense reference has order 24 V, so keep the default lattice small
+  const int X[4] = {4, 4, 2, 2};
+  initWilsonGtest(argc, argv, X, gauge_param, inv_param);
+  inv_param.inv_type = QUDA_CG_INVERTER;
+  inv_param.Ls = 1;
+  inv_param.solution_type = QUDA_MATPC_SOLUTION;
+  inv_param.solve_type = QUDA_NORMOP_PC_SOLVE;
+  inv_param.tol = 1e-10;
+  inv_param.maxiter = 1000;
+  inv_param.reliable_delta = 1e-1;
+  inv_param.gcrNkrylov = 10;
+  inv_param.inv_type_precondition = QUDA_INVALID_INVERTER;
+  inv_param.tol_precondition = 1e-1;
+  inv_param.maxiter_precondition = 10;
+  inv_param.verbosity_precondition = QUDA_SILENT;
+  inv_param.preserve_source = QUDA_PRESERVE_SOURCE_YES;
+  inv_param.input_location = QUDA_CPU_FIELD_LOCATION;
+  inv_param.output_location = QUDA_CPU_FIELD_LOCATION;
+  inv_param.sp_pad = 0;
+  inv_param.cl_pad = 0;
+  inv_param.tune = QUDA_TUNE_YES;
+
+  DiracParam diracParam;
+  setDiracParam(diracParam, &inv_param, true);
+  dirac = Dirac::create(diracParam);
+  mat = new DiracMdagM(*dirac);
+
+  denseEigenvalues(evals_ref, nk);
+
+  int test_rc = RUN_ALL_TESTS();
+
+  delete mat;
+  delete dirac;
+  endWilsonGtest();
+
+  return test_rc;
+}
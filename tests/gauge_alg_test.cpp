@@ -89,6 +89,44 @@ class GaugeAlgTest : public ::testing::Test {
     cudaMemset(num_failures_dev, 0, sizeof(int));
   }
 
+  cpuGaugeField* CopyGaugeToHost(){
+    GaugeFieldParam gParam(0, param);
+    gParam.pad = 0;
+    gParam.ghostExchange = QUDA_GHOST_EXCHANGE_NO;
+    gParam.create      = QUDA_NULL_FIELD_CREATE;
+    gParam.link_type   = param.type;
+    gParam.reconstruct = QUDA_RECONSTRUCT_NO;
+    cpuGaugeField *cpuGauge = new cpuGaugeField(gParam);
+    cudaInGauge->saveCPUField(*cpuGauge, QUDA_CPU_FIELD_LOCATION);
+    return cpuGauge;
+  }
+
+  void CopyGaugeToDevice(cpuGaugeField *cpuGauge){
+    cudaInGauge->loadCPUField(*cpuGauge, QUDA_CPU_FIELD_LOCATION);
+    delete cpuGauge;
+  }
+
+  /**
+     Fix the gauge on a host copy of the field, stopping on theta,
+     and check that theta reached the tolerance and the plaquette
+     is unchanged.
+   */
+  void HostGaugeFix(bool fft, int gauge_dir){
+    const double tolerance = 1e-8;
+    const int reunit_interval = 10;
+    cpuGaugeField *cpuGauge = CopyGaugeToHost();
+    double theta0 = gaugeFixQualityCPU(*cpuGauge, gauge_dir).y;
+    Timer t; t.Start(__func__, __FILE__, __LINE__);
+    if (fft) gaugefixingFFTCPU(*cpuGauge, gauge_dir, 2000, 100, 0.08, 1, tolerance, 1);
+    else gaugefixingOVRCPU(*cpuGauge, gauge_dir, 5000, 100, 1.5, tolerance, reunit_interval, 1);
+    t.Stop(__func__, __FILE__, __LINE__);
+    double theta = gaugeFixQualityCPU(*cpuGauge, gauge_dir).y;
+    printfQuda("Time host %s -> %.6f s, theta %e -> %e\n", fft ? "FFT" : "OVR", t.Last(), theta0, theta);
+    CopyGaugeToDevice(cpuGauge);
+    EXPECT_LT(theta, tolerance);
+    ASSERT_TRUE(comparePlaquette(plaq, plaquette( *cudaInGauge, QUDA_CUDA_FIELD_LOCATION)));
+  }
+
   virtual void SetUp() {
     setVerbosity(QUDA_VERBOSE);
     if (true) {
@@ -269,6 +307,33 @@ TEST_F(GaugeAlgTest,Coulomb_FFT){
 
 
 
+TEST_F(GaugeAlgTest,Landau_Overrelaxation_CPU){
+  if(!checkDimsPartitioned()){
+    printfQuda("Landau gauge fixing with overrelaxation on the host\n");
+    HostGaugeFix(false, 4);
+  }
+}
+
+TEST_F(GaugeAlgTest,Coulomb_Overrelaxation_CPU){
+  if(!checkDimsPartitioned()){
+    printfQuda("Coulomb gauge fixing with overrelaxation on the host\n");
+    HostGaugeFix(false, 3);
+  }
+}
+
+TEST_F(GaugeAlgTest,Landau_FFT_CPU){
+  if(!checkDimsPartitioned()){
+    printfQuda("Landau gauge fixing with steepest descent method with FFTs on the host\n");
+    HostGaugeFix(true, 4);
+  }
+}
+
+TEST_F(GaugeAlgTest,Coulomb_FFT_CPU){
+  if(!checkDimsPartitioned()){
+    printfQuda("Coulomb gauge fixing with steepest descent method with FFTs on the host\n");
+    HostGaugeFix(true, 3);
+  }
+}
 
 
 
@@ -31,6 +31,7 @@ extern void usage(char** argv);
 extern bool tune;
 
 int attempts = 1;
+QudaFieldLocation compute_location = QUDA_CUDA_FIELD_LOCATION;
 
 extern QudaReconstructType link_recon;
 QudaPrecision  link_prec = QUDA_SINGLE_PRECISION;
@@ -378,6 +379,7 @@ gauge_force_test(void)
   qudaGaugeParam.gauge_fix = QUDA_GAUGE_FIXED_NO;
   qudaGaugeParam.ga_pad = 0;
   qudaGaugeParam.mom_ga_pad = 0;
+  qudaGaugeParam.compute_location = compute_location;
 
   size_t gSize = qudaGaugeParam.cpu_prec;
     
@@ -594,13 +596,14 @@ display_test_info()
 {
   printf("running the following test:\n");
     
-  printf("link_precision           link_reconstruct           space_dim(x/y/z)              T_dimension        Gauge_order    Attempts\n");
-  printf("%s                       %s                         %d/%d/%d                       %d                  %s           %d\n",  
+  printf("link_precision           link_reconstruct           space_dim(x/y/z)              T_dimension        Gauge_order    Attempts    Location\n");
+  printf("%s                       %s                         %d/%d/%d                       %d                  %s           %d           %s\n",  
 	 get_prec_str(link_prec),
 	 get_recon_str(link_recon), 
 	 xdim,ydim,zdim, tdim, 
 	 get_gauge_order_str(gauge_order),
-	 attempts);
+	 attempts,
+	 compute_location == QUDA_CPU_FIELD_LOCATION ? "cpu" : "cuda");
   return ;
     
 }
@@ -611,6 +614,7 @@ usage_extra(char** argv )
   printf("Extra options:\n");
   printf("    --gauge-order  <qdp/milc>                 # Gauge storing order in CPU\n");
   printf("    --attempts  <n>                           # Number of tests\n");
+  printf("    --compute-location  <cpu/cuda>            # Where the force is computed (default cuda)\n");
   return ;
 }
 
@@ -653,6 +657,23 @@ main(int argc, char **argv)
       continue;
     }
      
+    if( strcmp(argv[i], "--compute-location") == 0){
+      if(i+1 >= argc){
+	usage(argv);
+      }
+
+      if(strcmp(argv[i+1], "cpu") == 0){
+	compute_location = QUDA_CPU_FIELD_LOCATION;
+      }else if(strcmp(argv[i+1], "cuda") == 0){
+	compute_location = QUDA_CUDA_FIELD_LOCATION;
+      }else{
+	fprintf(stderr, "Error: unsupported compute location\n");
+	exit(1);
+      }
+      i++;
+      continue;
+    }
+
     if( strcmp(argv[i], "--verify") == 0){
       verify_results=1;
       continue;	    
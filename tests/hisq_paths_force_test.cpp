@@ -32,6 +32,11 @@ cudaGaugeField *cudaMom = NULL;
 cpuGaugeField *cpuMom  = NULL;
 cpuGaugeField *refMom  = NULL;
 
+// outputs of the threaded host force engine
+cpuGaugeField *hostForce = NULL;
+cpuGaugeField *hostForce_ex = NULL;
+cpuGaugeField *hostMom = NULL;
+
 static QudaGaugeParam qudaGaugeParam;
 static QudaGaugeParam qudaGaugeParam_ex;
 static void* hw; // the array of half_wilson_vector
@@ -370,6 +375,7 @@ hisq_force_init()
   gParam_ex.create = QUDA_ZERO_FIELD_CREATE;
   gParam_ex.order = gauge_order;
   cpuForce_ex = new cpuGaugeField(gParam_ex); 
+  hostForce_ex = new cpuGaugeField(gParam_ex);
   gParam_ex.order = QUDA_FLOAT2_GAUGE_ORDER; 
   gParam_ex.reconstruct = QUDA_RECONSTRUCT_NO;
   cudaForce_ex = new cudaGaugeField(gParam_ex); 
@@ -379,6 +385,7 @@ hisq_force_init()
   gParam.create = QUDA_ZERO_FIELD_CREATE;
   gParam.order = gauge_order;
   cpuForce = new cpuGaugeField(gParam); 
+  hostForce = new cpuGaugeField(gParam);
   gParam.order = QUDA_FLOAT2_GAUGE_ORDER;
   gParam.reconstruct = QUDA_RECONSTRUCT_NO;
   gParam.order = QUDA_FLOAT2_GAUGE_ORDER;
@@ -393,6 +400,7 @@ hisq_force_init()
   gParam.create = QUDA_ZERO_FIELD_CREATE;
   cpuMom = new cpuGaugeField(gParam);
   refMom = new cpuGaugeField(gParam);  
+  hostMom = new cpuGaugeField(gParam);
 
   //createMomCPU(cpuMom->Gauge_p(), mom_prec);
 
@@ -515,16 +523,19 @@ hisq_force_end()
   delete cpuGauge;
   delete cpuMom;
   delete refMom;
+  delete hostMom;
   delete cpuOprod;  
   delete cpuLongLinkOprod;
 
 #ifdef MULTI_GPU
   delete cpuGauge_ex;
   delete cpuForce_ex;
+  delete hostForce_ex;
   delete cpuOprod_ex;  
   delete cpuLongLinkOprod_ex;
 #else
   delete cpuForce;
+  delete hostForce;
 #endif
 
   free(hw);
@@ -534,6 +545,90 @@ hisq_force_end()
   return;
 }
 
+#ifndef MULTI_GPU
+/**
+   Check computeHISQForceCompleteQuda, which fuses the outer products
+   of all terms and runs the force on the host, against the two-stage
+   device pipeline computeStaggeredOprodQuda + computeHISQForceQuda.
+   The MILC-order links in siteLink_1d serve as the W, V and U links.
+ */
+  static int
+hisq_force_complete_test(const double level2_coeff[6], const double fat7_coeff[6])
+{
+  const int num_terms = 2;
+  const size_t prec_size = qudaGaugeParam.cpu_prec;
+  const size_t link_bytes = V*gaugeSiteSize*prec_size;
+
+  void* quark[num_terms];
+  double coeff_data[num_terms][2] = { {0.5, -0.25}, {0.75, 0.125} };
+  double* quark_coeff[num_terms];
+  for (int t=0; t<num_terms; t++) {
+    quark[t] = malloc(V*6*prec_size);
+    for (int i=0; i<V*6; i++) {
+      double r = 2.0*rand()/RAND_MAX - 1.0;
+      if (qudaGaugeParam.cpu_prec == QUDA_DOUBLE_PRECISION) ((double*)quark[t])[i] = r;
+      else ((float*)quark[t])[i] = r;
+    }
+    quark_coeff[t] = coeff_data[t];
+  }
+
+  // QDP-order outer products for the device pipeline
+  void* oprod_dir[3][4];
+  for (int k=0; k<3; k++) {
+    for (int dir=0; dir<4; dir++) {
+      oprod_dir[k][dir] = malloc(link_bytes);
+      memset(oprod_dir[k][dir], 0, link_bytes);
+    }
+  }
+  void* oprod[2] = { (void*)oprod_dir[0], (void*)oprod_dir[1] };
+
+  QudaGaugeParam param = qudaGaugeParam;
+  param.gauge_order = QUDA_MILC_GAUGE_ORDER;
+  param.use_resident_mom = 0;
+  param.make_resident_mom = 0;
+  param.return_result_mom = 1;
+
+  computeStaggeredOprodQuda(oprod, quark, num_terms, quark_coeff, &param);
+
+  // the one-link source is the one-hop product weighted by the one-link coefficient
+  for (int dir=0; dir<4; dir++) {
+    for (int i=0; i<V*gaugeSiteSize; i++) {
+      if (param.cpu_prec == QUDA_DOUBLE_PRECISION)
+        ((double*)oprod_dir[2][dir])[i] = level2_coeff[0]*((double*)oprod_dir[0][dir])[i];
+      else
+        ((float*)oprod_dir[2][dir])[i] = level2_coeff[0]*((float*)oprod_dir[0][dir])[i];
+    }
+  }
+
+  GaugeFieldParam momParam(0, qudaGaugeParam);
+  momParam.pad = 0;
+  momParam.reconstruct = QUDA_RECONSTRUCT_10;
+  momParam.link_type = QUDA_ASQTAD_MOM_LINKS;
+  momParam.order = QUDA_MILC_GAUGE_ORDER;
+  momParam.create = QUDA_ZERO_FIELD_CREATE;
+  cpuGaugeField deviceMom(momParam);
+  cpuGaugeField completeMom(momParam);
+
+  long long flops = 0;
+  computeHISQForceQuda(deviceMom.Gauge_p(), &flops, level2_coeff, fat7_coeff,
+                       (const void**)oprod_dir[0], (const void**)oprod_dir[2], (const void**)oprod_dir[1],
+                       siteLink_1d, siteLink_1d, siteLink_1d, &param);
+
+  param.compute_location = QUDA_CPU_FIELD_LOCATION;
+  computeHISQForceCompleteQuda(completeMom.Gauge_p(), level2_coeff, fat7_coeff, quark, num_terms, quark_coeff,
+                               siteLink_1d, siteLink_1d, siteLink_1d, &param);
+
+  int res = compare_floats(completeMom.Gauge_p(), deviceMom.Gauge_p(), 4*V*momSiteSize,
+                           param.cpu_prec == QUDA_DOUBLE_PRECISION ? 1e-8 : 1e-4, param.cpu_prec);
+  printfQuda("Complete host force test %s\n", (1 == res) ? "PASSED" : "FAILED");
+
+  for (int k=0; k<3; k++) for (int dir=0; dir<4; dir++) free(oprod_dir[k][dir]);
+  for (int t=0; t<num_terms; t++) free(quark[t]);
+
+  return res;
+}
+#endif
+
   static int 
 hisq_force_test(void)
 {
@@ -608,6 +703,20 @@ hisq_force_test(void)
 
   gettimeofday(&ht1, NULL);
 
+  // the threaded host force engine
+  struct timeval et0, et1;
+  gettimeofday(&et0, NULL);
+#ifdef MULTI_GPU
+  fermion_force::hisqStaplesForceCPU(d_act_path_coeff, qudaGaugeParam, *cpuOprod_ex, *cpuGauge_ex, hostForce_ex);
+  fermion_force::hisqLongLinkForceCPU(d_act_path_coeff[1], qudaGaugeParam, *cpuLongLinkOprod_ex, *cpuGauge_ex, hostForce_ex);
+  fermion_force::hisqCompleteForceCPU(qudaGaugeParam, *hostForce_ex, *cpuGauge_ex, hostMom);
+#else
+  fermion_force::hisqStaplesForceCPU(d_act_path_coeff, qudaGaugeParam, *cpuOprod, *cpuGauge, hostForce);
+  fermion_force::hisqLongLinkForceCPU(d_act_path_coeff[1], qudaGaugeParam, *cpuLongLinkOprod, *cpuGauge, hostForce);
+  fermion_force::hisqCompleteForceCPU(qudaGaugeParam, *hostForce, *cpuGauge, hostMom);
+#endif
+  gettimeofday(&et1, NULL);
+
   struct timeval t0, t1, t2, t3;
 
   gettimeofday(&t0, NULL);
@@ -671,6 +780,16 @@ hisq_force_test(void)
 
     accuracy_level = strong_check_mom(cpuMom->Gauge_p(), refMom->Gauge_p(), 4*cpuMom->Volume(), qudaGaugeParam.cpu_prec);
     printfQuda("Test %s\n",(1 == res) ? "PASSED" : "FAILED");
+
+    int host_res = compare_floats(hostMom->Gauge_p(), refMom->Gauge_p(), 4*hostMom->Volume()*momSiteSize,
+                                  qudaGaugeParam.cpu_prec == QUDA_DOUBLE_PRECISION ? 1e-10 : 1e-5, qudaGaugeParam.cpu_prec);
+    printfQuda("Host engine test %s\n",(1 == host_res) ? "PASSED" : "FAILED");
+    if (host_res != 1) accuracy_level = 0;
+
+#ifndef MULTI_GPU
+    double fat7_coeff[6] = {0.125, -0.0625, 0.015625, -0.00260417, -0.0104167, 0.0};
+    if (hisq_force_complete_test(d_act_path_coeff, fat7_coeff) != 1) accuracy_level = 0;
+#endif
   }
   double total_io;
   double total_flops;
@@ -681,6 +800,7 @@ hisq_force_test(void)
   printfQuda("Staples time: %.2f ms, perf = %.2f GFLOPS, achieved bandwidth= %.2f GB/s\n", TDIFF(t0,t1)*1000, perf_flops, perf);
   printfQuda("Staples time : %g ms\t LongLink time : %g ms\t Completion time : %g ms\n", TDIFF(t0,t1)*1000, TDIFF(t1,t2)*1000, TDIFF(t2,t3)*1000);
   printfQuda("Host time (half-wilson fermion force) : %g ms\n", TDIFF(ht0, ht1)*1000);
+  printfQuda("Host engine time (threaded fermion force) : %g ms\n", TDIFF(et0, et1)*1000);
 
   hisq_force_end();
 
@@ -56,6 +56,8 @@ extern QudaMassNormalization normalization; // mass normalization of Dirac opera
 extern QudaMatPCType matpc_type; // preconditioning type
 
 extern int niter; // max solver iterations
+extern bool async_solve; // whether to use the asynchronous interface
+extern int Nsrc; // number of sources to solve together with the block solver
 extern char latfile[];
 
 extern void usage(char** );
@@ -203,7 +205,8 @@ int main(int argc, char **argv)
       dslash_type == QUDA_MOBIUS_DWF_DSLASH ||
       dslash_type == QUDA_TWISTED_MASS_DSLASH || 
       dslash_type == QUDA_TWISTED_CLOVER_DSLASH || 
-      multishift || inv_type == QUDA_CG_INVERTER) {
+      multishift || inv_type == QUDA_CG_INVERTER || inv_type == QUDA_PIPECG_INVERTER ||
+      inv_type == QUDA_BLOCKCG_INVERTER) {
     inv_param.solve_type = QUDA_NORMOP_PC_SOLVE;
   } else {
     inv_param.solve_type = QUDA_DIRECT_PC_SOLVE;
@@ -391,6 +394,34 @@ int main(int argc, char **argv)
   // perform the inversion
   if (multishift) {
     invertMultiShiftQuda(spinorOutMulti, spinorIn, &inv_param);
+  } else if (inv_type == QUDA_BLOCKCG_INVERTER) {
+    // the block is made up of Nsrc random sources, and the last one is verified
+    inv_param.num_src = Nsrc;
+    void **spinorInBlock = (void**)malloc(Nsrc*sizeof(void*));
+    void **spinorOutBlock = (void**)malloc(Nsrc*sizeof(void*));
+    for (int i=0; i<Nsrc; i++) {
+      spinorInBlock[i] = (i == Nsrc-1) ? spinorIn : malloc(V*spinorSiteSize*sSize*inv_param.Ls);
+      spinorOutBlock[i] = (i == Nsrc-1) ? spinorOut : malloc(V*spinorSiteSize*sSize*inv_param.Ls);
+      memset(spinorOutBlock[i], 0, inv_param.Ls*V*spinorSiteSize*sSize);
+      if (i == Nsrc-1) continue;
+      if (inv_param.cpu_prec == QUDA_SINGLE_PRECISION) {
+	for (int j=0; j<inv_param.Ls*V*spinorSiteSize; j++) ((float*)spinorInBlock[i])[j] = rand() / (float)RAND_MAX;
+      } else {
+	for (int j=0; j<inv_param.Ls*V*spinorSiteSize; j++) ((double*)spinorInBlock[i])[j] = rand() / (double)RAND_MAX;
+      }
+    }
+
+    invertMultiSrcQuda(spinorOutBlock, spinorInBlock, &inv_param);
+
+    for (int i=0; i<Nsrc-1; i++) {
+      free(spinorInBlock[i]);
+      free(spinorOutBlock[i]);
+    }
+    free(spinorInBlock);
+    free(spinorOutBlock);
+  } else if (async_solve) {
+    void *request = invertQudaAsync(spinorOut, spinorIn, &inv_param);
+    waitQuda(request, &inv_param);
   } else {
     invertQuda(spinorOut, spinorIn, &inv_param);
   }
@@ -1029,6 +1029,10 @@ get_solver_type(char* s)
     ret = QUDA_FGMRESDR_INVERTER;
   } else if (strcmp(s, "mg") == 0){
     ret = QUDA_MG_INVERTER;
+  } else if (strcmp(s, "pipecg") == 0){
+    ret = QUDA_PIPECG_INVERTER;
+  } else if (strcmp(s, "blockcg") == 0){
+    ret = QUDA_BLOCKCG_INVERTER;
   } else {
     fprintf(stderr, "Error: invalid solver type\n");	
     exit(1);
@@ -1088,6 +1092,12 @@ get_solver_str(QudaInverterType type)
   case QUDA_MG_INVERTER:
     ret= "mg";
     break;
+  case QUDA_PIPECG_INVERTER:
+    ret = "pipecg";
+    break;
+  case QUDA_BLOCKCG_INVERTER:
+    ret = "blockcg";
+    break;
   default:
     ret = "unknown";
     errorQuda("Error: invalid solver type %d\n", type);
@@ -1097,6 +1107,80 @@ get_solver_str(QudaInverterType type)
   return ret;
 }
 
+QudaDenseLinalgBackend
+get_dense_linalg_type(char* s)
+{
+  QudaDenseLinalgBackend ret = QUDA_INVALID_DENSE_LINALG;
+
+  if (strcmp(s, "magma") == 0){
+    ret = QUDA_MAGMA_DENSE_LINALG;
+  } else if (strcmp(s, "host") == 0){
+    ret = QUDA_HOST_DENSE_LINALG;
+  } else {
+    fprintf(stderr, "Error: invalid dense linear algebra backend\n");
+    exit(1);
+  }
+
+  return ret;
+}
+
+const char*
+get_dense_linalg_str(QudaDenseLinalgBackend type)
+{
+  const char* ret;
+
+  switch(type){
+  case QUDA_MAGMA_DENSE_LINALG:
+    ret = "magma";
+    break;
+  case QUDA_HOST_DENSE_LINALG:
+    ret = "host";
+    break;
+  default:
+    ret = "unknown";
+    break;
+  }
+
+  return ret;
+}
+
+QudaFieldLocation
+get_location_type(char* s)
+{
+  QudaFieldLocation ret = QUDA_INVALID_FIELD_LOCATION;
+
+  if (strcmp(s, "cpu") == 0){
+    ret = QUDA_CPU_FIELD_LOCATION;
+  } else if (strcmp(s, "cuda") == 0){
+    ret = QUDA_CUDA_FIELD_LOCATION;
+  } else {
+    fprintf(stderr, "Error: invalid field location\n");
+    exit(1);
+  }
+
+  return ret;
+}
+
+const char*
+get_location_str(QudaFieldLocation location)
+{
+  const char* ret;
+
+  switch(location){
+  case QUDA_CPU_FIELD_LOCATION:
+    ret = "cpu";
+    break;
+  case QUDA_CUDA_FIELD_LOCATION:
+    ret = "cuda";
+    break;
+  default:
+    ret = "unknown";
+    break;
+  }
+
+  return ret;
+}
+
 const char* 
 get_quda_ver_str()
 {
@@ -36,6 +36,12 @@ extern "C" {
   QudaInverterType get_solver_type(char* s);
   const char* get_solver_str(QudaInverterType type);
 
+  QudaDenseLinalgBackend get_dense_linalg_type(char* s);
+  const char* get_dense_linalg_str(QudaDenseLinalgBackend type);
+
+  QudaFieldLocation get_location_type(char* s);
+  const char* get_location_str(QudaFieldLocation location);
+
   const char* get_quda_ver_str();
 #ifdef __cplusplus
 }
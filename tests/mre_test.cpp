@@ -0,0 +1,237 @@
+#include <stdio.h>
+#include <stdlib.h>
+#include <math.h>
+#include <vector>
+#include <algorithm>
+
+#include <quda.h>
+#include <quda_internal.h>
+#include <color_spinor_field.h>
+#include <dirac_quda.h>
+#include <invert_quda.h>
+#include <blas_quda.h>
+#include <util_quda.h>
+
+#include <test_util.h>
+#include "misc.h"
+
+// google test frame work
+#include <gtest.h>
+
+using namespace quda;
+
+// Checks the minimum residual extrapolation (MinResExt) on host
+// fields against a direct solve of the projected normal equations
+// (p_i, A p_j) a_j = (p_i, b) in the raw basis, with A = M^dagger M
+// for the Wilson operator on a random gauge field, and the persistent
+// basis built with append() against the extrapolation over the same
+// vectors.
+
+QudaGaugeParam gauge_param;
+QudaInvertParam inv_param;
+
+Dirac *dirac = NULL;
+DiracMdagM *mat = NULL;
+TimeProfile profile("mre_test");
+
+/**
+   Solves the dense n x n system A x = b (row major) in place with
+   Gaussian elimination and partial pivoting
+ */
+static void denseSolve(std::vector<Complex> &A, std::vector<Complex> &b, int n) {
+  for (int k=0; k<n; k++) {
+    int pivot = k;
+    for (int i=k+1; i<n; i++) if (abs(A[i*n+k]) > abs(A[pivot*n+k])) pivot = i;
+    if (pivot != k) {
+      for (int j=0; j<n; j++) std::swap(A[k*n+j], A[pivot*n+j]);
+      std::swap(b[k], b[pivot]);
+    }
+    for (int i=k+1; i<n; i++) {
+      Complex l = A[i*n+k] / A[k*n+k];
+      for (int j=k; j<n; j++) A[i*n+j] -= l * A[k*n+j];
+      b[i] -= l * b[k];
+    }
+  }
+  for (int i=n-1; i>=0; i--) {
+    for (int j=i+1; j<n; j++) b[i] -= A[i*n+j] * b[j];
+    b[i] /= A[i*n+i];
+  }
+}
+
+class MinResExtTest : public ::testing::TestWithParam<int> { };
+
+TEST_P(MinResExtTest, guess) {
+  const int N = GetParam();
+  ColorSpinorParam param;
+  setWilsonSpinorParam(param);
+
+  std::vector<ColorSpinorField*> p(N), q(N), p_raw(N), Ap_raw(N);
+  for (int i=0; i<N; i++) {
+    p[i] = ColorSpinorField::Create(param);
+    q[i] = ColorSpinorField::Create(param);
+    p_raw[i] = ColorSpinorField::Create(param);
+    Ap_raw[i] = ColorSpinorField::Create(param);
+    static_cast<cpuColorSpinorField*>(p_raw[i])->Source(QUDA_RANDOM_SOURCE);
+    *p[i] = *p_raw[i];
+  }
+
+  ColorSpinorField *b = ColorSpinorField::Create(param);
+  ColorSpinorField *r = ColorSpinorField::Create(param);
+  ColorSpinorField *x = ColorSpinorField::Create(param);
+  ColorSpinorField *x_ref = ColorSpinorField::Create(param);
+  ColorSpinorField *tmp = ColorSpinorField::Create(param);
+  static_cast<cpuColorSpinorField*>(b)->Source(QUDA_RANDOM_SOURCE);
+  *r = *b;
+
+  // the extrapolation orthonormalizes p, sets q = A p and leaves the residual in r
+  MinResExt mre(*mat, profile);
+  mre(*x, *r, p, q, N);
+
+  // reference: solve the projected system in the raw basis
+  for (int j=0; j<N; j++) (*mat)(*Ap_raw[j], *p_raw[j]);
+  std::vector<Complex> G(N*N), a(N);
+  for (int i=0; i<N; i++) {
+    for (int j=0; j<N; j++) G[i*N+j] = blas::cDotProduct(*p_raw[i], *Ap_raw[j]);
+    a[i] = blas::cDotProduct(*p_raw[i], *b);
+  }
+  denseSolve(G, a, N);
+
+  blas::zero(*x_ref);
+  for (int i=0; i<N; i++) blas::caxpy(a[i], *p_raw[i], *x_ref);
+
+  // the guesses agree
+  const double x2 = blas::norm2(*x_ref);
+  const double guess_deviation = sqrt(blas::xmyNorm(*x_ref, *x) / x2);
+  printfQuda("N = %d: guess deviation = %e\n", N, guess_deviation);
+  EXPECT_LT(guess_deviation, 1e-10);
+
+  // the returned residual is b - A x
+  (*mat)(*tmp, *x_ref);
+  blas::xpay(*b, -1.0, *tmp);
+  const double residual_deviation = sqrt(blas::xmyNorm(*tmp, *r) / blas::norm2(*tmp));
+  printfQuda("N = %d: residual deviation = %e\n", N, residual_deviation);
+  EXPECT_LT(residual_deviation, 1e-10);
+
+  // q holds A applied to the orthonormalized basis
+  for (int i=0; i<N; i++) {
+    (*mat)(*tmp, *p[i]);
+    EXPECT_LT(sqrt(blas::xmyNorm(*q[i], *tmp) / blas::norm2(*q[i])), 1e-12);
+  }
+
+  for (int i=0; i<N; i++) {
+    delete p[i];
+    delete q[i];
+    delete p_raw[i];
+    delete Ap_raw[i];
+  }
+  delete b;
+  delete r;
+  delete x;
+  delete x_ref;
+  delete tmp;
+}
+
+INSTANTIATE_TEST_CASE_P(MinResExt, MinResExtTest, ::testing::Values(1, 2, 4, 8));
+
+// Appending the vectors one at a time to the persistent basis gives
+// the same guess and residual as the extrapolation over all of them
+TEST(MinResExtAppend, matchesRebuild) {
+  const int N = 4;
+  ColorSpinorParam param;
+  setWilsonSpinorParam(param);
+
+  MinResExt chrono(*mat, profile, N);
+  std::vector<ColorSpinorField*> p(N), q(N);
+  for (int i=0; i<N; i++) {
+    p[i] = ColorSpinorField::Create(param);
+    q[i] = ColorSpinorField::Create(param);
+    static_cast<cpuColorSpinorField*>(p[i])->Source(QUDA_RANDOM_SOURCE);
+    EXPECT_TRUE(chrono.append(*p[i]));
+    EXPECT_EQ(i+1, chrono.Dim());
+  }
+
+  ColorSpinorField *b = ColorSpinorField::Create(param);
+  ColorSpinorField *r = ColorSpinorField::Create(param);
+  ColorSpinorField *r_ref = ColorSpinorField::Create(param);
+  ColorSpinorField *x = ColorSpinorField::Create(param);
+  ColorSpinorField *x_ref = ColorSpinorField::Create(param);
+  static_cast<cpuColorSpinorField*>(b)->Source(QUDA_RANDOM_SOURCE);
+  *r = *b;
+  *r_ref = *b;
+
+  chrono(*x, *r);
+  MinResExt mre(*mat, profile);
+  mre(*x_ref, *r_ref, p, q, N);
+
+  const double guess_deviation = sqrt(blas::xmyNorm(*x_ref, *x) / blas::norm2(*x_ref));
+  const double residual_deviation = sqrt(blas::xmyNorm(*r_ref, *r) / blas::norm2(*r_ref));
+  printfQuda("append: guess deviation = %e, residual deviation = %e\n", guess_deviation, residual_deviation);
+  EXPECT_LT(guess_deviation, 1e-10);
+  EXPECT_LT(residual_deviation, 1e-10);
+
+  // a vector in the span of the basis is not added
+  EXPECT_FALSE(chrono.append(*p[0]));
+  EXPECT_EQ(N, chrono.Dim());
+
+  for (int i=0; i<N; i++) {
+    delete p[i];
+    delete q[i];
+  }
+  delete b;
+  delete r;
+  delete r_ref;
+  delete x;
+  delete x_ref;
+}
+
+// Once the basis is full the oldest direction is dropped, and the
+// latest vector is always in the span: for b = A v the guess is v
+TEST(MinResExtAppend, overflow) {
+  const int max_dim = 3;
+  ColorSpinorParam param;
+  setWilsonSpinorParam(param);
+
+  MinResExt chrono(*mat, profile, max_dim);
+  ColorSpinorField *v = ColorSpinorField::Create(param);
+  ColorSpinorField *b = ColorSpinorField::Create(param);
+  ColorSpinorField *x = ColorSpinorField::Create(param);
+
+  for (int k=0; k<2*max_dim; k++) {
+    static_cast<cpuColorSpinorField*>(v)->Source(QUDA_RANDOM_SOURCE);
+    EXPECT_TRUE(chrono.append(*v));
+    EXPECT_EQ(std::min(k+1, max_dim), chrono.Dim());
+
+    (*mat)(*b, *v);
+    chrono(*x, *b);
+    const double guess_deviation = sqrt(blas::xmyNorm(*v, *x) / blas::norm2(*v));
+    printfQuda("vector %d: guess deviation = %e\n", k, guess_deviation);
+    EXPECT_LT(guess_deviation, 1e-10);
+  }
+
+  chrono.reset();
+  EXPECT_EQ(0, chrono.Dim());
+
+  delete v;
+  delete b;
+  delete x;
+}
+
+int main(int argc, char **argv) {
+  // initalize google test, includes command line options
+  ::testing::InitGoogleTest(&argc, argv);
+  const int X[4] = {8, 8, 8, 8};
+  initWilsonGtest(argc, argv, X, gauge_param, inv_param);
+
+  DiracParam diracParam;
+  setDiracParam(diracParam, &inv_param, false);
+  dirac = Dirac::create(diracParam);
+  mat = new DiracMdagM(*dirac);
+
+  int test_rc = RUN_ALL_TESTS();
+
+  delete mat;
+  delete dirac;
+  endWilsonGtest();
+
+  return test_rc;
+}
@@ -51,6 +51,7 @@ extern int nvec;
 extern int mg_levels;
 
 extern bool generate_nullspace;
+extern bool generate_nullspace_batched;
 extern int nu_pre;
 extern int nu_post;
 extern int geo_block_size[];
@@ -59,6 +60,12 @@ extern QudaInverterType precon_type;
 
 extern char vec_infile[];
 extern char vec_outfile[];
+extern QudaPrecision vec_io_prec;
+extern int compress_vec;
+extern int coarse_direct_max_dim;
+extern int setup_refine_iter;
+extern QudaFieldLocation mg_location;
+extern int Nsrc;
 
 extern void usage(char** );
 
@@ -66,6 +73,36 @@ namespace quda {
   extern void setTransferGPU(bool);
 }
 
+/**
+   Perturb every link by right multiplication with the SU(3) matrix
+   diag(exp(i a), exp(i b), exp(-i (a+b))), with a and b uniform in
+   (-epsilon, epsilon), to mimic the change of the gauge field
+   between HMC trajectories
+ */
+template <typename Float>
+static void perturbGaugeField(Float **gauge, double epsilon) {
+  for (int dir=0; dir<4; dir++) {
+    for (int i=0; i<V; i++) {
+      double a = epsilon * (2.0*rand()/(double)RAND_MAX - 1.0);
+      double b = epsilon * (2.0*rand()/(double)RAND_MAX - 1.0);
+      double phase[3] = { a, b, -(a+b) };
+      Float *u = gauge[dir] + i*gaugeSiteSize;
+      for (int row=0; row<3; row++) {
+	for (int col=0; col<3; col++) {
+	  Float re = u[(row*3+col)*2+0], im = u[(row*3+col)*2+1];
+	  u[(row*3+col)*2+0] = re*cos(phase[col]) - im*sin(phase[col]);
+	  u[(row*3+col)*2+1] = re*sin(phase[col]) + im*cos(phase[col]);
+	}
+      }
+    }
+  }
+}
+
+static void perturbGaugeField(void **gauge, double epsilon, QudaPrecision precision) {
+  if (precision == QUDA_DOUBLE_PRECISION) perturbGaugeField((double**)gauge, epsilon);
+  else perturbGaugeField((float**)gauge, epsilon);
+}
+
 void
 display_test_info()
 {
@@ -82,6 +119,8 @@ display_test_info()
   printfQuda(" - number of null-space vectors %d\n", nvec);
   printfQuda(" - number of pre-smoother applications %d\n", nu_pre);
   printfQuda(" - number of post-smoother applications %d\n", nu_post);
+  printfQuda(" - multigrid location %s\n", mg_location == QUDA_CPU_FIELD_LOCATION ?
+	     "host levels, device outer solve" : get_location_str(mg_location));
 
   printfQuda("Grid partition info:     X  Y  Z  T\n"); 
   printfQuda("                         %d  %d  %d  %d\n", 
@@ -271,8 +310,8 @@ int main(int argc, char **argv)
 
   inv_param.verbosity = QUDA_VERBOSE;
 
-  QudaMultigridParam mg_param;
-  
+  QudaMultigridParam mg_param = newQudaMultigridParam();
+
   mg_param.invert_param = &inv_param;
   mg_param.n_level = mg_levels;
   for (int i=0; i<mg_param.n_level; i++) {
@@ -288,9 +327,11 @@ int main(int argc, char **argv)
 
     mg_param.location[i] = QUDA_CPU_FIELD_LOCATION;
   }
-  mg_param.location[0] = QUDA_CUDA_FIELD_LOCATION;
-  mg_param.location[1] = QUDA_CUDA_FIELD_LOCATION;
-  mg_param.location[2] = QUDA_CUDA_FIELD_LOCATION;
+  if (mg_location == QUDA_CUDA_FIELD_LOCATION) {
+    mg_param.location[0] = QUDA_CUDA_FIELD_LOCATION;
+    mg_param.location[1] = QUDA_CUDA_FIELD_LOCATION;
+    mg_param.location[2] = QUDA_CUDA_FIELD_LOCATION;
+  }
 
   // only coarsen the spin on the first restriction
   mg_param.spin_block_size[0] = 2;
@@ -298,12 +339,17 @@ int main(int argc, char **argv)
   // coarse grid solver is GCR
   mg_param.smoother[mg_levels-1] = QUDA_GCR_INVERTER;
 
-  mg_param.compute_null_vector = generate_nullspace ? QUDA_COMPUTE_NULL_VECTOR_YES
+  mg_param.compute_null_vector = generate_nullspace ?
+    (generate_nullspace_batched ? QUDA_COMPUTE_NULL_VECTOR_BATCHED : QUDA_COMPUTE_NULL_VECTOR_YES)
     : QUDA_COMPUTE_NULL_VECTOR_NO;
 
   // set file i/o parameters
   strcpy(mg_param.vec_infile, vec_infile);
   strcpy(mg_param.vec_outfile, vec_outfile);
+  mg_param.vec_io_prec = vec_io_prec;
+  mg_param.compress_null_vectors = compress_vec;
+  mg_param.coarse_direct_max_dim = coarse_direct_max_dim;
+  mg_param.setup_refine_iter = setup_refine_iter;
 
   // *** Everything between here and the call to initQuda() is
   // *** application-specific.
@@ -380,26 +426,101 @@ int main(int argc, char **argv)
   // load the clover term, if desired
   if (dslash_type == QUDA_CLOVER_WILSON_DSLASH) loadCloverQuda(clover, clover_inv, &inv_param);
 
+  // with compressed null-space vectors the solve is repeated with an
+  // uncompressed hierarchy built from the same vectors, which are
+  // saved for this if they are generated
+  const bool compress_check = compress_vec > 0 && Nsrc == 1 && setup_refine_iter == 0 &&
+    (generate_nullspace || strcmp(vec_infile,""));
+  if (compress_check && generate_nullspace && !strcmp(mg_param.vec_outfile,""))
+    strcpy(mg_param.vec_outfile, "mg_compress_check.dat");
+
   // setup the multigrid solver
   void *mg_preconditioner = newMultigridQuda(&mg_param);
   inv_param.preconditioner = mg_preconditioner;
 
-  const int nSrc = 1;
-  for (int i=0; i<nSrc; i++) {
+  // exercise the setup update done between HMC trajectories by
+  // loading a perturbed gauge field and refining the existing null
+  // space; the solve below is then checked against the new field
+  if (setup_refine_iter > 0) {
+    perturbGaugeField(gauge, 0.1, gauge_param.cpu_prec);
+    loadGaugeQuda((void*)gauge, &gauge_param);
+    if (dslash_type == QUDA_CLOVER_WILSON_DSLASH) loadCloverQuda(clover, clover_inv, &inv_param);
+    updateMultigridQuda(mg_preconditioner, &mg_param);
+  }
+
+  // with more than one source, all are solved together and the last one is verified
+  inv_param.num_src = Nsrc;
+  void **spinorInMulti = (void**)malloc(Nsrc*sizeof(void*));
+  void **spinorOutMulti = (void**)malloc(Nsrc*sizeof(void*));
+  for (int i=0; i<Nsrc; i++) {
+    spinorInMulti[i] = (i == Nsrc-1) ? spinorIn : malloc(V*spinorSiteSize*sSize*inv_param.Ls);
+    spinorOutMulti[i] = (i == Nsrc-1) ? spinorOut : malloc(V*spinorSiteSize*sSize*inv_param.Ls);
+
     // create a point source at 0 (in each subvolume...  FIXME)
-    memset(spinorIn, 0, inv_param.Ls*V*spinorSiteSize*sSize);
-    memset(spinorCheck, 0, inv_param.Ls*V*spinorSiteSize*sSize);
-    memset(spinorOut, 0, inv_param.Ls*V*spinorSiteSize*sSize);
+    memset(spinorInMulti[i], 0, inv_param.Ls*V*spinorSiteSize*sSize);
+    memset(spinorOutMulti[i], 0, inv_param.Ls*V*spinorSiteSize*sSize);
 
     if (inv_param.cpu_prec == QUDA_SINGLE_PRECISION) {
       //((float*)spinorIn)[i] = 1.0;
-      for (int i=0; i<inv_param.Ls*V*spinorSiteSize; i++) ((float*)spinorIn)[i] = rand() / (float)RAND_MAX;
+      for (int j=0; j<inv_param.Ls*V*spinorSiteSize; j++) ((float*)spinorInMulti[i])[j] = rand() / (float)RAND_MAX;
     } else {
       //((double*)spinorIn)[i] = 1.0;
-      for (int i=0; i<inv_param.Ls*V*spinorSiteSize; i++) ((double*)spinorIn)[i] = rand() / (double)RAND_MAX;
+      for (int j=0; j<inv_param.Ls*V*spinorSiteSize; j++) ((double*)spinorInMulti[i])[j] = rand() / (double)RAND_MAX;
     }
+  }
+  memset(spinorCheck, 0, inv_param.Ls*V*spinorSiteSize*sSize);
 
+  if (Nsrc == 1) {
     invertQuda(spinorOut, spinorIn, &inv_param);
+  } else {
+    invertMultiSrcQuda(spinorOutMulti, spinorInMulti, &inv_param);
+    printfQuda("Solved %d sources at %g sources per second\n", Nsrc, inv_param.src_per_sec);
+  }
+
+  for (int i=0; i<Nsrc-1; i++) {
+    free(spinorInMulti[i]);
+    free(spinorOutMulti[i]);
+  }
+  free(spinorInMulti);
+  free(spinorOutMulti);
+
+  int test_rc = 0;
+  if (compress_check) {
+    const int iter = inv_param.iter;
+    const double secs = inv_param.secs, gflops = inv_param.gflops;
+    const double true_res = inv_param.true_res, true_res_hq = inv_param.true_res_hq;
+
+    QudaMultigridParam ref_param = mg_param;
+    ref_param.compress_null_vectors = 0;
+    ref_param.compute_null_vector = QUDA_COMPUTE_NULL_VECTOR_NO;
+    strcpy(ref_param.vec_infile, generate_nullspace ? mg_param.vec_outfile : vec_infile);
+    strcpy(ref_param.vec_outfile, "");
+    void *mg_reference = newMultigridQuda(&ref_param);
+
+    void *spinorRef = malloc(V*spinorSiteSize*sSize*inv_param.Ls);
+    memset(spinorRef, 0, inv_param.Ls*V*spinorSiteSize*sSize);
+    inv_param.preconditioner = mg_reference;
+    invertQuda(spinorRef, spinorIn, &inv_param);
+
+    int len = (inv_param.solution_type == QUDA_MAT_SOLUTION ? V : Vh)*spinorSiteSize*inv_param.Ls;
+    double x2 = norm_2(spinorOut, len, inv_param.cpu_prec);
+    mxpy(spinorOut, spinorRef, len, inv_param.cpu_prec);
+    double deviation = sqrt(norm_2(spinorRef, len, inv_param.cpu_prec) / x2);
+    printfQuda("Compressed null space: %d iterations, uncompressed: %d iterations, solution deviation = %e\n",
+	       iter, inv_param.iter, deviation);
+    if (abs(iter - inv_param.iter) > 1 + inv_param.iter/10) {
+      printfQuda("Solve with compressed null-space vectors does not match the uncompressed solve\n");
+      test_rc = 1;
+    }
+
+    free(spinorRef);
+    destroyMultigridQuda(mg_reference);
+    inv_param.preconditioner = mg_preconditioner;
+    inv_param.iter = iter;
+    inv_param.secs = secs;
+    inv_param.gflops = gflops;
+    inv_param.true_res = true_res;
+    inv_param.true_res_hq = true_res_hq;
   }
 
   // free the multigrid solver
@@ -500,5 +621,5 @@ int main(int argc, char **argv)
   MPI_Finalize();
 #endif
 
-  return 0;
+  return test_rc;
 }
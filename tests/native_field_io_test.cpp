@@ -0,0 +1,204 @@
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <unistd.h>
+#include <math.h>
+#include <vector>
+#include <algorithm>
+
+#include <quda.h>
+#include <quda_internal.h>
+#include <gauge_field.h>
+#include <color_spinor_field.h>
+#include <comm_quda.h>
+#include <native_field_io.h>
+#include <test_util.h>
+#include <gtest.h>
+
+using namespace quda;
+
+extern int xdim;
+extern int ydim;
+extern int zdim;
+extern int tdim;
+extern int gridsize_from_cmdline[];
+
+// Round-trip tests of the native field format: every field is written,
+// read back, and compared byte for byte together with its metadata
+
+static void fillRandom(void *v, size_t bytes, QudaPrecision precision) {
+  const size_t n = bytes / precision;
+  for (size_t i=0; i<n; i++) {
+    double r = rand() / (double)RAND_MAX - 0.5;
+    if (precision == QUDA_DOUBLE_PRECISION) ((double*)v)[i] = r;
+    else ((float*)v)[i] = r;
+  }
+}
+
+static std::string fileName(const char *name) {
+  char filename[256];
+  sprintf(filename, "native_io_test_%s_%d.dat", name, comm_rank());
+  return std::string(filename);
+}
+
+static ColorSpinorParam spinorParam(QudaPrecision precision) {
+  ColorSpinorParam param;
+  param.location = QUDA_CPU_FIELD_LOCATION;
+  param.nColor = 3;
+  param.nSpin = 4;
+  param.nDim = 4;
+  param.x[0] = xdim; param.x[1] = ydim; param.x[2] = zdim; param.x[3] = tdim;
+  param.precision = precision;
+  param.pad = 0;
+  param.fieldOrder = QUDA_SPACE_SPIN_COLOR_FIELD_ORDER;
+  param.siteSubset = QUDA_FULL_SITE_SUBSET;
+  param.siteOrder = QUDA_EVEN_ODD_SITE_ORDER;
+  param.gammaBasis = QUDA_DEGRAND_ROSSI_GAMMA_BASIS;
+  param.twistFlavor = QUDA_TWIST_NO;
+  param.PCtype = QUDA_4D_PC;
+  param.create = QUDA_NULL_FIELD_CREATE;
+  return param;
+}
+
+class NativeFieldIOTest : public ::testing::TestWithParam<QudaGaugeFieldOrder> { };
+
+TEST_P(NativeFieldIOTest, gauge) {
+  QudaGaugeParam gauge_param = newQudaGaugeParam();
+  gauge_param.X[0] = xdim; gauge_param.X[1] = ydim; gauge_param.X[2] = zdim; gauge_param.X[3] = tdim;
+  gauge_param.cpu_prec = QUDA_DOUBLE_PRECISION;
+  gauge_param.ga_pad = 0;
+  gauge_param.gauge_order = GetParam();
+  gauge_param.type = QUDA_WILSON_LINKS;
+  gauge_param.t_boundary = QUDA_ANTI_PERIODIC_T;
+  gauge_param.anisotropy = 2.0;
+  gauge_param.staggered_phase_type = QUDA_MILC_STAGGERED_PHASE;
+  gauge_param.staggered_phase_applied = 1;
+
+  GaugeFieldParam param(0, gauge_param);
+  param.create = QUDA_NULL_FIELD_CREATE;
+  param.reconstruct = QUDA_RECONSTRUCT_NO;
+  param.ghostExchange = QUDA_GHOST_EXCHANGE_NO;
+  cpuGaugeField u(param);
+
+  const size_t dim_bytes = (size_t)u.Volume() * u.Reconstruct() * u.Precision();
+  if (u.Order() == QUDA_QDP_GAUGE_ORDER) {
+    for (int d=0; d<4; d++) fillRandom(((void**)u.Gauge_p())[d], dim_bytes, u.Precision());
+  } else {
+    fillRandom(u.Gauge_p(), 4*dim_bytes, u.Precision());
+  }
+
+  std::string filename = fileName("gauge");
+  writeNativeGaugeField(filename.c_str(), u);
+
+  NativeFieldMapping mapping;
+  cpuGaugeField *v = mapNativeGaugeField(filename.c_str(), mapping, true);
+
+  EXPECT_EQ(u.Order(), v->Order());
+  EXPECT_EQ(u.Precision(), v->Precision());
+  EXPECT_EQ(u.Reconstruct(), v->Reconstruct());
+  EXPECT_EQ(u.TBoundary(), v->TBoundary());
+  EXPECT_EQ(u.Anisotropy(), v->Anisotropy());
+  EXPECT_EQ(u.StaggeredPhase(), v->StaggeredPhase());
+  EXPECT_EQ(u.StaggeredPhaseApplied(), v->StaggeredPhaseApplied());
+  EXPECT_EQ(u.GhostExchange(), v->GhostExchange());
+  for (int d=0; d<4; d++) {
+    EXPECT_EQ(u.X()[d], v->X()[d]);
+    EXPECT_EQ(u.R()[d], v->R()[d]);
+  }
+
+  if (u.Order() == QUDA_QDP_GAUGE_ORDER) {
+    for (int d=0; d<4; d++)
+      EXPECT_EQ(0, memcmp(((void**)u.Gauge_p())[d], ((void**)v->Gauge_p())[d], dim_bytes));
+  } else {
+    EXPECT_EQ(0, memcmp(u.Gauge_p(), v->Gauge_p(), 4*dim_bytes));
+  }
+
+  delete v;
+  unmapNativeField(mapping);
+  unlink(filename.c_str());
+}
+
+INSTANTIATE_TEST_CASE_P(QDP, NativeFieldIOTest, ::testing::Values(QUDA_QDP_GAUGE_ORDER));
+INSTANTIATE_TEST_CASE_P(MILC, NativeFieldIOTest, ::testing::Values(QUDA_MILC_GAUGE_ORDER));
+
+TEST(NativeFieldIO, colorSpinor) {
+  cpuColorSpinorField u(spinorParam(QUDA_DOUBLE_PRECISION));
+  fillRandom(u.V(), u.Bytes(), u.Precision());
+
+  std::string filename = fileName("spinor");
+  writeNativeColorSpinorField(filename.c_str(), u);
+
+  NativeFieldMapping mapping;
+  cpuColorSpinorField *v = mapNativeColorSpinorField(filename.c_str(), mapping, true);
+
+  EXPECT_EQ(u.Ncolor(), v->Ncolor());
+  EXPECT_EQ(u.Nspin(), v->Nspin());
+  EXPECT_EQ(u.FieldOrder(), v->FieldOrder());
+  EXPECT_EQ(u.SiteSubset(), v->SiteSubset());
+  EXPECT_EQ(u.GammaBasis(), v->GammaBasis());
+  EXPECT_EQ(u.Bytes(), v->Bytes());
+  EXPECT_EQ(0, memcmp(u.V(), v->V(), u.Bytes()));
+
+  delete v;
+  unmapNativeField(mapping);
+  unlink(filename.c_str());
+}
+
+TEST(NativeFieldIO, vectorSet) {
+  const int nVec = 3;
+  std::vector<ColorSpinorField*> B, C, D;
+  for (int i=0; i<nVec; i++) {
+    B.push_back(new cpuColorSpinorField(spinorParam(QUDA_DOUBLE_PRECISION)));
+    C.push_back(new cpuColorSpinorField(spinorParam(QUDA_DOUBLE_PRECISION)));
+    D.push_back(new cpuColorSpinorField(spinorParam(QUDA_SINGLE_PRECISION)));
+    fillRandom(B[i]->V(), B[i]->Bytes(), B[i]->Precision());
+  }
+
+  std::string filename = fileName("vectors");
+
+  // same precision: exact round trip
+  writeNativeVectorSet(filename.c_str(), B);
+  EXPECT_TRUE(isNativeVectorSet(filename.c_str()));
+  readNativeVectorSet(filename.c_str(), C);
+  for (int i=0; i<nVec; i++) EXPECT_EQ(0, memcmp(B[i]->V(), C[i]->V(), B[i]->Bytes()));
+
+  // stored in single precision and read into double precision
+  writeNativeVectorSet(filename.c_str(), B, QUDA_SINGLE_PRECISION);
+  readNativeVectorSet(filename.c_str(), C);
+  readNativeVectorSet(filename.c_str(), D);
+  const size_t reals = B[0]->Bytes() / B[0]->Precision();
+  for (int i=0; i<nVec; i++) {
+    double max_dev = 0.0;
+    for (size_t j=0; j<reals; j++) {
+      double b = ((double*)B[i]->V())[j];
+      max_dev = std::max(max_dev, fabs(b - ((double*)C[i]->V())[j]));
+      EXPECT_EQ((float)b, ((float*)D[i]->V())[j]);
+    }
+    EXPECT_LE(max_dev, 1e-7);
+  }
+
+  unlink(filename.c_str());
+  for (int i=0; i<nVec; i++) {
+    delete B[i];
+    delete C[i];
+    delete D[i];
+  }
+}
+
+int main(int argc, char **argv) {
+  // initalize google test, includes command line options
+  ::testing::InitGoogleTest(&argc, argv);
+  xdim=ydim=zdim=tdim=8;
+  for (int i=1; i<argc; i++){
+    if(process_command_line_option(argc, argv, &i) == 0){
+      continue;
+    }
+    fprintf(stderr, "ERROR: Invalid option:%s\n", argv[i]);
+  }
+
+  initComms(argc, argv, gridsize_from_cmdline);
+  int test_rc = RUN_ALL_TESTS();
+  finalizeComms();
+
+  return test_rc;
+}
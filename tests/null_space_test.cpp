@@ -0,0 +1,119 @@
+#include <stdio.h>
+#include <stdlib.h>
+#include <math.h>
+#include <vector>
+
+#include <quda.h>
+#include <quda_internal.h>
+#include <color_spinor_field.h>
+#include <dirac_quda.h>
+#include <invert_quda.h>
+#include <multigrid.h>
+#include <blas_quda.h>
+#include <util_quda.h>
+
+#include <test_util.h>
+#include "misc.h"
+
+// google test frame work
+#include <gtest.h>
+
+using namespace quda;
+
+// Compares the batched null-space relaxation (CG on M^dagger M for
+// all vectors in lock step) with the sequential generation (one
+// BiCGstab solve of M x = 0 per vector) used by the multigrid setup,
+// for the Wilson operator on a random gauge field.  Both start from
+// the same vectors and stop at the same reduction of |M x|, so the
+// null spaces they produce must be of comparable quality.  The
+// batched relaxation must also not depend on the batch size.
+
+QudaGaugeParam gauge_param;
+QudaInvertParam inv_param;
+
+Dirac *dirac = NULL;
+DiracM *mat = NULL;
+TimeProfile profile("null_space_test");
+
+const int Nvec = 6;
+const int maxiter = 500;
+const double tol = 5e-4;
+
+static void expectOrthonormal(std::vector<ColorSpinorField*> &B) {
+  for (int i=0; i<Nvec; i++) {
+    for (int j=0; j<=i; j++) {
+      Complex dot = blas::cDotProduct(*B[j], *B[i]);
+      EXPECT_LT(abs(dot - Complex(i == j ? 1.0 : 0.0, 0.0)), 1e-10);
+    }
+  }
+}
+
+class NullSpaceTest : public ::testing::TestWithParam<QudaFieldLocation> { };
+
+TEST_P(NullSpaceTest, batchedVsSequential) {
+  const QudaFieldLocation location = GetParam();
+  ColorSpinorParam param;
+  setWilsonSpinorParam(param);
+
+  std::vector<ColorSpinorField*> B_seq(Nvec), B_batch(Nvec), B_chunk(Nvec);
+  for (int i=0; i<Nvec; i++) {
+    B_seq[i] = ColorSpinorField::Create(param);
+    B_batch[i] = ColorSpinorField::Create(param);
+    B_chunk[i] = ColorSpinorField::Create(param);
+    static_cast<cpuColorSpinorField*>(B_seq[i])->Source(QUDA_RANDOM_SOURCE);
+    *B_batch[i] = *B_seq[i];
+    *B_chunk[i] = *B_seq[i];
+  }
+
+  SolverParam solverParam(inv_param);
+  solveNullVectors(solverParam, *mat, *mat, B_seq, maxiter, tol, false, location, profile);
+  const int k_batch = relaxNullVectors(*mat, B_batch, maxiter, tol, false, location, Nvec);
+  const int k_chunk = relaxNullVectors(*mat, B_chunk, maxiter, tol, false, location, 4);
+
+  const double residual_seq = nullSpaceResidual(*mat, B_seq, location);
+  const double residual_batch = nullSpaceResidual(*mat, B_batch, location);
+  printfQuda("sequential residual = %e, batched residual = %e in %d iterations\n",
+	     residual_seq, residual_batch, k_batch);
+
+  expectOrthonormal(B_seq);
+  expectOrthonormal(B_batch);
+
+  // the batched null space is no worse than the sequential one
+  EXPECT_LT(residual_batch, 2.0*residual_seq);
+
+  // the vectors are relaxed independently, so splitting the batch
+  // only changes the iteration count
+  EXPECT_GE(k_chunk, k_batch);
+  for (int i=0; i<Nvec; i++) EXPECT_LT(sqrt(blas::xmyNorm(*B_batch[i], *B_chunk[i])), 1e-12);
+
+  for (int i=0; i<Nvec; i++) {
+    delete B_seq[i];
+    delete B_batch[i];
+    delete B_chunk[i];
+  }
+}
+
+INSTANTIATE_TEST_CASE_P(CPU, NullSpaceTest, ::testing::Values(QUDA_CPU_FIELD_LOCATION));
+INSTANTIATE_TEST_CASE_P(CUDA, NullSpaceTest, ::testing::Values(QUDA_CUDA_FIELD_LOCATION));
+
+int main(int argc, char **argv) {
+  // initalize google test, includes command line options
+  ::testing::InitGoogleTest(&argc, argv);
+  const int X[4] = {4, 4, 4, 4};
+  initWilsonGtest(argc, argv, X, gauge_param, inv_param);
+  inv_param.inv_type = QUDA_BICGSTAB_INVERTER;
+  inv_param.preserve_source = QUDA_PRESERVE_SOURCE_NO;
+
+  DiracParam diracParam;
+  setDiracParam(diracParam, &inv_param, false);
+  dirac = Dirac::create(diracParam);
+  mat = new DiracM(*dirac);
+
+  int test_rc = RUN_ALL_TESTS();
+
+  delete mat;
+  delete dirac;
+  endWilsonGtest();
+
+  return test_rc;
+}
@@ -0,0 +1,131 @@
+#include <stdio.h>
+#include <stdlib.h>
+#include <math.h>
+#include <algorithm>
+
+#include <quda.h>
+#include <quda_internal.h>
+#include <color_spinor_field.h>
+#include <dirac_quda.h>
+#include <invert_quda.h>
+#include <blas_quda.h>
+#include <face_quda.h>
+#include <comm_quda.h>
+#include <util_quda.h>
+
+#include <test_util.h>
+#include "misc.h"
+
+// google test frame work
+#include <gtest.h>
+
+using namespace quda;
+
+// Checks the split-phase reduction used by the pipelined CG against
+// the blocking one, and the pipelined CG itself against CG on the
+// even-odd preconditioned Wilson M^dagger M on a random gauge field,
+// with and without reliable updates.  With a reliable update
+// tolerance of 0.1 and a solver tolerance of 1e-10 the residual is
+// replaced about ten times, which exercises the recomputation of the
+// auxiliary vectors w, s and z.
+
+QudaGaugeParam gauge_param;
+QudaInvertParam inv_param;
+
+Dirac *dirac = NULL;
+DiracMdagM *mat = NULL;
+TimeProfile profile("pipecg_test");
+
+const double tol = 1e-10;
+const int maxiter = 1000;
+
+TEST(reduceDoubleArray, splitPhase) {
+  const int n = 4;
+  double blocking[n], split[n];
+  for (int i=0; i<n; i++) blocking[i] = split[i] = (i+1)*(comm_rank()+1);
+
+  reduceDoubleArray(blocking, n);
+  MsgHandle *reduction = reduceDoubleArrayStart(split, n);
+  reduceDoubleArrayWait(reduction);
+
+  const int size = comm_size();
+  for (int i=0; i<n; i++) {
+    EXPECT_EQ((i+1)*size*(size+1)/2.0, blocking[i]);
+    EXPECT_EQ(blocking[i], split[i]);
+  }
+}
+
+static SolverParam solverParam(double delta) {
+  SolverParam param(inv_param);
+  param.tol = tol;
+  param.maxiter = maxiter;
+  param.delta = delta;
+  param.residual_type = QUDA_L2_RELATIVE_RESIDUAL;
+  param.use_init_guess = QUDA_USE_INIT_GUESS_NO;
+  param.precision = QUDA_DOUBLE_PRECISION;
+  param.precision_sloppy = QUDA_DOUBLE_PRECISION;
+  param.use_sloppy_partial_accumulator = false;
+  param.iter = 0;
+  return param;
+}
+
+class PipelinedCGTest : public ::testing::TestWithParam<double> { };
+
+TEST_P(PipelinedCGTest, versusCG) {
+  const double delta = GetParam();
+
+  ColorSpinorParam param(NULL, inv_param, gauge_param.X, true);
+  param.create = QUDA_ZERO_FIELD_CREATE;
+  cpuColorSpinorField hostSource(param);
+  hostSource.Source(QUDA_RANDOM_SOURCE);
+
+  param.location = QUDA_CUDA_FIELD_LOCATION;
+  param.fieldOrder = QUDA_FLOAT2_FIELD_ORDER;
+  param.gammaBasis = QUDA_UKQCD_GAMMA_BASIS;
+  cudaColorSpinorField b(param), x_cg(param), x_pipe(param);
+  b = hostSource;
+
+  SolverParam cgParam = solverParam(delta);
+  CG cg(*mat, *mat, cgParam, profile);
+  cg(x_cg, b);
+
+  SolverParam pipeParam = solverParam(delta);
+  PipelinedCG pipecg(*mat, *mat, pipeParam, profile);
+  pipecg(x_pipe, b);
+
+  printfQuda("delta = %e: CG %d iterations, true residual %e; PipelinedCG %d iterations, true residual %e\n",
+	     delta, cgParam.iter, cgParam.true_res, pipeParam.iter, pipeParam.true_res);
+
+  EXPECT_LT(cgParam.iter, maxiter);
+  EXPECT_LT(pipeParam.iter, maxiter);
+  EXPECT_LT(pipeParam.true_res, 10*tol);
+
+  // both solve the same system, so the solutions agree to the
+  // tolerance and the recurrences take a similar number of steps
+  const double deviation = sqrt(blas::xmyNorm(x_cg, x_pipe) / blas::norm2(x_cg));
+  EXPECT_LT(deviation, 1e-8);
+  EXPECT_LE(abs(pipeParam.iter - cgParam.iter), std::max(2, cgParam.iter/10));
+}
+
+INSTANTIATE_TEST_CASE_P(NoReliable, PipelinedCGTest, ::testing::Values(0.0));
+INSTANTIATE_TEST_CASE_P(Reliable, PipelinedCGTest, ::testing::Values(0.1));
+
+int main(int argc, char **argv) {
+  // initalize google test, includes command line options
+  ::testing::InitGoogleTest(&argc, argv);
+  const int X[4] = {8, 8, 8, 8};
+  initWilsonGtest(argc, argv, X, gauge_param, inv_param);
+
+  DiracParam diracParam;
+  setDiracParam(diracParam, &inv_param, true);
+  dirac = Dirac::create(diracParam);
+  mat = new DiracMdagM(*dirac);
+
+  int test_rc = RUN_ALL_TESTS();
+
+  delete mat;
+  delete dirac;
+  endWilsonGtest();
+
+  return test_rc;
+}
@@ -2,6 +2,7 @@
 #include <stdlib.h>
 #include <stdio.h>
 #include <string.h>
+#include <algorithm>
 #include <short.h>
 
 #if defined(QMP_COMMS)
@@ -15,6 +16,7 @@
 
 #include <face_quda.h>
 #include <dslash_quda.h>
+#include <color_spinor_field.h>
 #include "misc.h"
 
 using namespace std;
@@ -59,7 +61,9 @@ void initComms(int argc, char **argv, const int *commDims)
   int provided;
   MPI_Init_thread(&argc, &argv, MPI_THREAD_MULTIPLE, &provided);
 #else
-  MPI_Init(&argc, &argv);
+  // invertQudaAsync solves from a worker thread
+  int provided;
+  MPI_Init_thread(&argc, &argv, MPI_THREAD_SERIALIZED, &provided);
 #endif
 
 #endif
@@ -1577,11 +1581,19 @@ QudaDslashType dslash_type = QUDA_WILSON_DSLASH;
 char latfile[256] = "";
 bool tune = true;
 int niter = 100;
+int Nsrc = 1;
+bool async_solve = false;
 int test_type = 0;
 int nvec  = 1;
 char vec_infile[256] = "";
 char vec_outfile[256] = "";
+QudaPrecision vec_io_prec = QUDA_INVALID_PRECISION;
+int compress_vec = 0;
+int coarse_direct_max_dim = 0;
+int setup_refine_iter = 0;
+QudaFieldLocation mg_location = QUDA_CUDA_FIELD_LOCATION;
 QudaInverterType inv_type;
+QudaDenseLinalgBackend dense_linalg = QUDA_INVALID_DENSE_LINALG;
 QudaInverterType precon_type = QUDA_INVALID_INVERTER;
 int multishift = 0;
 bool verify_results = true;
@@ -1599,6 +1611,7 @@ int mg_levels = 2;
 int nu_pre = 2;
 int nu_post = 2;
 bool generate_nullspace = true;
+bool generate_nullspace_batched = false;
 
 int geo_block_size[] = {4, 4, 4, 4, 4};
 
@@ -1643,7 +1656,11 @@ void usage(char** argv )
   printf("    --flavor <type>                           # Set the twisted mass flavor type (minus (default), plus, deg_doublet, nondeg_doublet)\n");
   printf("    --load-gauge file                         # Load gauge field \"file\" for the test (requires QIO)\n");
   printf("    --niter <n>                               # The number of iterations to perform (default 10)\n");
-  printf("    --inv_type <cg/bicgstab/gcr>              # The type of solver to use (default cg)\n");
+  printf("    --nsrc <n>                                # The number of sources to solve, more than one uses invertMultiSrcQuda (default 1)\n"
+         "                                                  With blockcg all sources are solved as one block\n");
+  printf("    --async <true/false>                      # Whether to solve with invertQudaAsync and waitQuda (default false)\n");
+  printf("    --inv_type <cg/pipecg/blockcg/bicgstab/gcr>  # The type of solver to use (default cg)\n");
+  printf("    --dense-linalg <magma/host>               # Dense linear algebra of the deflated solvers (default magma if built with MAGMA, else host)\n");
   printf("    --precon_type <mr/ (unspecified)>         # The type of solver to use (default none (=unspecified)).\n"
 	 "                                                  For multigrid this sets the smoother type.\n");
   printf("    --multishift <true/false>                 # Whether to do a multi-shift solver test or not (default false)\n");     
@@ -1662,9 +1679,14 @@ void usage(char** argv )
   printf("    --mg-nu-pre  <1-20>                       # The number of pre-smoother applications to do at each multigrid level (default 2)\n");
   printf("    --mg-nu-post <1-20>                       # The number of post-smoother applications to do at each multigrid level (default 2)\n");
   printf("    --mg-block-size <x y z t>                 # Set the geometric block size for the each multigrid level's transfer operator (default 4 4 4 4)\n");
-  printf("    --mg-generate-nullspace <true/false>      # Generate the null-space vector dynamically (default true)\n");
-  printf("    --mg-load-vec file                        # Load the vectors \"file\" for the multigrid_test (requires QIO)\n");
-  printf("    --mg-save-vec file                        # Save the generated null-space vectors \"file\" from the multigrid_test (requires QIO)\n");
+  printf("    --mg-generate-nullspace <true/batched/false> # Generate the null-space vector dynamically, one at a time or all together (default true)\n");
+  printf("    --mg-load-vec file                        # Load the vectors \"file\" for the multigrid_test (single native file, or per-vector files with QIO)\n");
+  printf("    --mg-save-vec file                        # Save the generated null-space vectors to the single native file \"file\" from the multigrid_test\n");
+  printf("    --mg-vec-io-prec <double/single>          # Precision in which to save the null-space vectors (default the generated precision)\n");
+  printf("    --mg-compress-vec <n>                     # Store the host null-space vectors in 16 bits with a scale per n sites (default 0, no compression)\n");
+  printf("    --mg-coarse-direct <n>                    # Solve the coarsest level with a dense LU if it has at most n dof (default 0, use GCR)\n");
+  printf("    --mg-setup-refine-iter <n>                # Test the multigrid update with n null-space refinement iterations (default 0, no update)\n");
+  printf("    --mg-location <cpu/cuda>                  # Where to run the multigrid levels, cpu gives host MG levels under a device outer solve, so a GPU is still required (default cuda)\n");
   printf("    --help                                    # Print out this message\n"); 
 
   usage_extra(argv); 
@@ -2100,6 +2122,16 @@ int process_command_line_option(int argc, char** argv, int* idx)
     goto out;
   }
   
+  if( strcmp(argv[i], "--dense-linalg") == 0){
+    if (i+1 >= argc){
+      usage(argv);
+    }
+    dense_linalg = get_dense_linalg_type(argv[i+1]);
+    i++;
+    ret = 0;
+    goto out;
+  }
+
   if( strcmp(argv[i], "--precon_type") == 0){
     if (i+1 >= argc){
       usage(argv);
@@ -2303,6 +2335,10 @@ int process_command_line_option(int argc, char** argv, int* idx)
 
     if (strcmp(argv[i+1], "true") == 0){
       generate_nullspace = true;
+      generate_nullspace_batched = false;
+    }else if (strcmp(argv[i+1], "batched") == 0){
+      generate_nullspace = true;
+      generate_nullspace_batched = true;
     }else if (strcmp(argv[i+1], "false") == 0){
       generate_nullspace = false;
     }else{
@@ -2334,6 +2370,68 @@ int process_command_line_option(int argc, char** argv, int* idx)
     ret = 0;
     goto out;
   }
+
+  if( strcmp(argv[i], "--mg-vec-io-prec") == 0){
+    if (i+1 >= argc){
+      usage(argv);
+    }
+    vec_io_prec = get_prec(argv[i+1]);
+    i++;
+    ret = 0;
+    goto out;
+  }
+
+  if( strcmp(argv[i], "--mg-compress-vec") == 0){
+    if (i+1 >= argc){
+      usage(argv);
+    }
+    compress_vec = atoi(argv[i+1]);
+    if (compress_vec < 0){
+      printf("ERROR: invalid compression block size (%d)\n", compress_vec);
+      usage(argv);
+    }
+    i++;
+    ret = 0;
+    goto out;
+  }
+
+  if( strcmp(argv[i], "--mg-setup-refine-iter") == 0){
+    if (i+1 >= argc){
+      usage(argv);
+    }
+    setup_refine_iter = atoi(argv[i+1]);
+    if (setup_refine_iter < 0){
+      printf("ERROR: invalid number of refinement iterations (%d)\n", setup_refine_iter);
+      usage(argv);
+    }
+    i++;
+    ret = 0;
+    goto out;
+  }
+
+  if( strcmp(argv[i], "--mg-location") == 0){
+    if (i+1 >= argc){
+      usage(argv);
+    }
+    mg_location = get_location_type(argv[i+1]);
+    i++;
+    ret = 0;
+    goto out;
+  }
+
+  if( strcmp(argv[i], "--mg-coarse-direct") == 0){
+    if (i+1 >= argc){
+      usage(argv);
+    }
+    coarse_direct_max_dim = atoi(argv[i+1]);
+    if (coarse_direct_max_dim < 0){
+      printf("ERROR: invalid coarse direct solve dimension (%d)\n", coarse_direct_max_dim);
+      usage(argv);
+    }
+    i++;
+    ret = 0;
+    goto out;
+  }
   
   if( strcmp(argv[i], "--niter") == 0){
     if (i+1 >= argc){
@@ -2349,6 +2447,39 @@ int process_command_line_option(int argc, char** argv, int* idx)
     goto out;
   }
 
+  if( strcmp(argv[i], "--async") == 0){
+    if (i+1 >= argc){
+      usage(argv);
+    }
+
+    if (strcmp(argv[i+1], "true") == 0){
+      async_solve = true;
+    }else if (strcmp(argv[i+1], "false") == 0){
+      async_solve = false;
+    }else{
+      fprintf(stderr, "ERROR: invalid async type\n");
+      exit(1);
+    }
+
+    i++;
+    ret = 0;
+    goto out;
+  }
+
+  if( strcmp(argv[i], "--nsrc") == 0){
+    if (i+1 >= argc){
+      usage(argv);
+    }
+    Nsrc = atoi(argv[i+1]);
+    if (Nsrc < 1 || Nsrc > 1024){
+      printf("ERROR: invalid number of sources (%d)\n", Nsrc);
+      usage(argv);
+    }
+    i++;
+    ret = 0;
+    goto out;
+  }
+
   if( strcmp(argv[i], "--version") == 0){
     printf("This program is linked with QUDA library, version %s,", 
 	   get_quda_ver_str());
@@ -2379,3 +2510,94 @@ double stopwatchReadSeconds() {
 }
 
 
+// host gauge field of the gtest-based Wilson tests
+static void *wilsonGtestGauge[4] = { NULL, NULL, NULL, NULL };
+
+void initWilsonGtest(int argc, char **argv, const int *X,
+		     QudaGaugeParam &gauge_param, QudaInvertParam &inv_param)
+{
+  xdim = X[0]; ydim = X[1]; zdim = X[2]; tdim = X[3];
+  for (int i=1; i<argc; i++){
+    if(process_command_line_option(argc, argv, &i) == 0){
+      continue;
+    }
+    fprintf(stderr, "ERROR: Invalid option:%s\n", argv[i]);
+  }
+
+  initComms(argc, argv, gridsize_from_cmdline);
+
+  gauge_param = newQudaGaugeParam();
+  gauge_param.X[0] = xdim; gauge_param.X[1] = ydim; gauge_param.X[2] = zdim; gauge_param.X[3] = tdim;
+  gauge_param.anisotropy = 1.0;
+  gauge_param.type = QUDA_WILSON_LINKS;
+  gauge_param.gauge_order = QUDA_QDP_GAUGE_ORDER;
+  gauge_param.t_boundary = QUDA_ANTI_PERIODIC_T;
+  gauge_param.cpu_prec = QUDA_DOUBLE_PRECISION;
+  gauge_param.cuda_prec = QUDA_DOUBLE_PRECISION;
+  gauge_param.reconstruct = QUDA_RECONSTRUCT_NO;
+  gauge_param.cuda_prec_sloppy = QUDA_DOUBLE_PRECISION;
+  gauge_param.reconstruct_sloppy = QUDA_RECONSTRUCT_NO;
+  gauge_param.cuda_prec_precondition = QUDA_DOUBLE_PRECISION;
+  gauge_param.reconstruct_precondition = QUDA_RECONSTRUCT_NO;
+  gauge_param.gauge_fix = QUDA_GAUGE_FIXED_NO;
+  gauge_param.ga_pad = 0;
+#ifdef MULTI_GPU
+  int x_face_size = gauge_param.X[1]*gauge_param.X[2]*gauge_param.X[3]/2;
+  int y_face_size = gauge_param.X[0]*gauge_param.X[2]*gauge_param.X[3]/2;
+  int z_face_size = gauge_param.X[0]*gauge_param.X[1]*gauge_param.X[3]/2;
+  int t_face_size = gauge_param.X[0]*gauge_param.X[1]*gauge_param.X[2]/2;
+  int pad_size = std::max(std::max(x_face_size, y_face_size), std::max(z_face_size, t_face_size));
+  gauge_param.ga_pad = pad_size;
+#endif
+
+  inv_param = newQudaInvertParam();
+  inv_param.dslash_type = QUDA_WILSON_DSLASH;
+  inv_param.kappa = 0.12;
+  inv_param.dagger = QUDA_DAG_NO;
+  inv_param.matpc_type = QUDA_MATPC_EVEN_EVEN;
+  inv_param.mass_normalization = QUDA_KAPPA_NORMALIZATION;
+  inv_param.dirac_order = QUDA_DIRAC_ORDER;
+  inv_param.gamma_basis = QUDA_DEGRAND_ROSSI_GAMMA_BASIS;
+  inv_param.cpu_prec = QUDA_DOUBLE_PRECISION;
+  inv_param.cuda_prec = QUDA_DOUBLE_PRECISION;
+  inv_param.cuda_prec_sloppy = QUDA_DOUBLE_PRECISION;
+  inv_param.cuda_prec_precondition = QUDA_DOUBLE_PRECISION;
+  inv_param.verbosity = QUDA_SUMMARIZE;
+
+  setDims(gauge_param.X);
+  for (int d=0; d<4; d++) wilsonGtestGauge[d] = malloc(V*gaugeSiteSize*sizeof(double));
+  construct_gauge_field(wilsonGtestGauge, 1, gauge_param.cpu_prec, &gauge_param); // random SU(3) field
+
+  initQuda(device);
+  loadGaugeQuda((void*)wilsonGtestGauge, &gauge_param);
+}
+
+void endWilsonGtest()
+{
+  freeGaugeQuda();
+  endQuda();
+  for (int d=0; d<4; d++) {
+    free(wilsonGtestGauge[d]);
+    wilsonGtestGauge[d] = NULL;
+  }
+
+  finalizeComms();
+}
+
+void setWilsonSpinorParam(quda::ColorSpinorParam &param)
+{
+  param.location = QUDA_CPU_FIELD_LOCATION;
+  param.nColor = 3;
+  param.nSpin = 4;
+  param.nDim = 4;
+  param.x[0] = xdim; param.x[1] = ydim; param.x[2] = zdim; param.x[3] = tdim;
+  param.precision = QUDA_DOUBLE_PRECISION;
+  param.pad = 0;
+  param.fieldOrder = QUDA_SPACE_SPIN_COLOR_FIELD_ORDER;
+  param.siteSubset = QUDA_FULL_SITE_SUBSET;
+  param.siteOrder = QUDA_EVEN_ODD_SITE_ORDER;
+  param.gammaBasis = QUDA_DEGRAND_ROSSI_GAMMA_BASIS;
+  param.twistFlavor = QUDA_TWIST_NO;
+  param.PCtype = QUDA_4D_PC;
+  param.create = QUDA_ZERO_FIELD_CREATE;
+}
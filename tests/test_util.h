@@ -3,6 +3,10 @@
 
 #include <quda.h>
 
+namespace quda {
+  class ColorSpinorParam;
+}
+
 #define gaugeSiteSize 18 // real numbers per link
 #define spinorSiteSize 24 // real numbers per spinor
 #define cloverSiteSize 72 // real numbers per block-diagonal clover matrix
@@ -95,6 +99,29 @@
   void stopwatchStart();
   double stopwatchReadSeconds();
 
+  /**
+     Sets up the double-precision Wilson problem shared by the
+     gtest-based solver tests: parses the command line, with the
+     lattice defaulting to X, initializes the communications and
+     QUDA and loads a random SU(3) gauge field.  inv_param is set to
+     a Wilson operator with kappa 0.12 in the DeGrand-Rossi basis, to
+     be specialized by the test before creating its operator.
+   */
+  void initWilsonGtest(int argc, char **argv, const int *X,
+		       QudaGaugeParam &gauge_param, QudaInvertParam &inv_param);
+
+  /**
+     Frees the gauge field loaded by initWilsonGtest and finalizes
+     QUDA and the communications
+   */
+  void endWilsonGtest();
+
+  /**
+     Fills param with a double-precision full Wilson spinor field on
+     the host, in the lattice set up by initWilsonGtest
+   */
+  void setWilsonSpinorParam(quda::ColorSpinorParam &param);
+
 #ifdef __cplusplus
 //}
 #endif